@@ -0,0 +1,94 @@
+/**
+ * @file append.h
+ * @author agent <agent@local>
+ * @standard C99
+ * @version 1.0
+ * @date 18th October 2026
+ *
+ * @brief Header file for the append and the concatenation of ".hfm" files.
+ *
+ * Both work on the blocks and the block index of the containers (@see @file
+ * container.h), without decoding what is already encrypted:
+ *  - appending a file codes only the new data. It is coded with the table of
+ *    the last blocks if it suits the new data, else with a new table given by a
+ *    table block (@see HFM_BLOCK_TABLE), else stored. The new blocks overwrite
+ *    the block index, which is written again after them with the header.
+ *  - concatenating files copies their blocks as they are, each file being
+ *    preceded by a table block giving its own table when needed. The checksum
+ *    of the whole file is combined from the ones of the files (@see @function
+ *    crc32cCombine), so nothing is decoded either.
+ *
+ * The key of a file coded with a key file is read in "<file>.key". The result
+ * is coded with the key of the first one, written in "<fileOut>.key", and the
+ * files coded with another key are preceded by a table block giving it.
+ *
+ * Overview about public functions of append:
+ *  - huffmanAppendFile
+ *  - concatenateFiles
+ */
+
+/* ========================================================= */
+/* ================== APPEND_H FILE HEADER ================= */
+/* ========================================================================== */
+
+#ifndef APPEND_H
+#define APPEND_H
+
+/* ============ Includes =========== */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "huffman.h" /**< Contains the huffman coding of the files  */
+
+/* =========== Functions =========== */
+
+/**
+ * @function huffmanAppendFile
+ * @brief Appends a file to the end of an encrypted file.
+ *
+ * The cost of the new data is estimated with the table of the last blocks of
+ * the archive, with a new table (table block included) and stored, and the
+ * smallest is written. The archive is not valid until its index is written
+ * again, at the end of the function.
+ *
+ * @param{char*} fileIn: name of the file to append.
+ * @param{char*} fileArchive: name of the ".hfm" file to extend.
+ * @param{char*} fileKey: name of the key of the archive, only read if its last
+ *                        blocks are coded with it (can be NULL).
+ * @param{double} samplingRate: part of fileIn read to build its table (@see
+ *                              @function charOccurrencesOfFileSampled).
+ *
+ * @return{int}: 0 if the file has been appended, -1 if a file can't be opened
+ *               or written or memory can't be allocated, -2 if fileArchive is
+ *               corrupted.
+ */
+int huffmanAppendFile(char *fileIn, char *fileArchive, char *fileKey, double samplingRate);
+
+/**
+ * @function concatenateFiles
+ * @brief Joins encrypted files in one, without decoding them.
+ *
+ * The table of the first file stays in the header when every file has its
+ * table in its header. Otherwise the result has no table in its header, and
+ * needs the key "<fileOut>.key", written too. The checksums kept are the ones
+ * every file has.
+ *
+ * A file can't be joined if its blocks go back to its own table after a table
+ * block (a file already joined) while it is not the table of the result.
+ *
+ * @param{char**} filesIn: names of the ".hfm" files, in order.
+ * @param{int} nbFiles: number of files.
+ * @param{char*} fileOut: name of the ".hfm" file to write.
+ *
+ * @return{int}: 0 if the files have been joined, -1 if a file or a key can't be
+ *               opened or written or memory can't be allocated, -2 if a file is
+ *               corrupted or can't be joined.
+ */
+int concatenateFiles(char **filesIn, int nbFiles, char *fileOut);
+
+
+#endif
+
+/* ========================================================================== */
+/* ========================================================================== */
@@ -0,0 +1,141 @@
+/**
+ * @file archive.h
+ * @author agent <agent@local>
+ * @standard C99
+ * @version 1.0
+ * @date 18th October 2026
+ *
+ * @brief Header file for the archives of many files (".hfa" files).
+ *
+ * An archive packs many files in one file, each coded with its own code table.
+ * It starts with a header of HFM_ARCHIVE_HEADER_SIZE bytes (little endian
+ * integers):
+ *  - the magic "HFMA" (4 bytes), the version (1 byte) and 3 reserved bytes
+ *  - the number of members (8 bytes)
+ *  - the offset of the central directory (8 bytes)
+ *  - the size of the central directory (8 bytes)
+ *
+ * The members come next. Each member is a whole ".hfm" container with its code
+ * table in its header (@see @file container.h), so that it can be decoded
+ * without reading the other members. The central directory ends the archive:
+ * for each member, the length of its name (2 bytes), its name (a relative path
+ * with '/' as separator), its permissions (4 bytes), its original size (8
+ * bytes), the offset of its container in the archive (8 bytes) and the size of
+ * its container (8 bytes). The CRC32C of the directory follows it (4 bytes).
+ *
+ * The directory is enough to list an archive, and to seek straight to a member
+ * to extract it. The members are coded and decoded by the workers of a
+ * scheduler, a task per file (@see @file scheduler.h). The members of at most
+ * HFM_ARCHIVE_MAX_MEMORY bytes are coded by their task, the blocks of the
+ * bigger ones by the tasks of all the workers, so that the workers having no
+ * file left help with the big ones. Each member is coded in memory and written
+ * at once, so the order of the members in the archive depends on the workers,
+ * but not the order of the directory, which is the one of the files given.
+ *
+ * With deduplication (version 2, flag HFM_ARCHIVE_DEDUP in the byte after the
+ * version), the members are cut in chunks and each unique chunk is stored once,
+ * in packs of chunks coded as ".hfm" containers (@see @file dedup.h). The packs
+ * replace the containers of the members. In the directory, the offset of a
+ * member is the index of its first chunk and its size is its number of chunks.
+ * The tables of the packs and the chunks follow the members, then the number
+ * of chunks of all the members (8 bytes) and the index of each chunk (4 bytes),
+ * member after member. The archives without deduplication keep the version 1.
+ *
+ * Overview about public functions of archive:
+ *  - huffmanArchiveFiles
+ *  - huffmanExtractFiles
+ *  - listArchiveMembers
+ */
+
+/* ========================================================= */
+/* ================= ARCHIVE_H FILE HEADER ================= */
+/* ========================================================================== */
+
+#ifndef ARCHIVE_H
+#define ARCHIVE_H
+
+/* ============ Includes =========== */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "huffman.h" /**< Contains the huffman coding of the files  */
+#include "cache.h" /**< Contains the cache of the files already coded  */
+#include "dedup.h" /**< Contains the deduplication of the chunks  */
+#include "scheduler.h" /**< Contains the workers coding the members  */
+
+/* ============ Defines ============ */
+
+#define HFM_ARCHIVE_MAGIC "HFMA" /**< First bytes of a ".hfa" file */
+#define HFM_ARCHIVE_VERSION 2 /**< Last version of the ".hfa" files */
+#define HFM_ARCHIVE_DEDUP 0x01 /**< Flag: the members are lists of chunks */
+#define HFM_ARCHIVE_HEADER_SIZE 32 /**< Size of the header of an archive */
+#define HFM_ARCHIVE_ENTRY_SIZE 30 /**< Size of an entry of the directory, name excluded */
+#define HFM_ARCHIVE_MAX_NAME 65535 /**< Maximal length of the name of a member */
+#define HFM_ARCHIVE_MAX_MEMORY (64 << 20) /**< Members coded by one task, the blocks of the bigger ones by all the workers */
+#define HFM_ARCHIVE_MAX_THREADS 64 /**< Maximal number of workers coding the members */
+
+/* =========== Functions =========== */
+
+/**
+ * @function huffmanArchiveFiles
+ * @brief Packs files and directories in an archive.
+ *
+ * The directories are walked through, with their sub-directories, and their
+ * regular files are added. A member is named after the path given, without
+ * its leading '/' and "./".
+ *
+ * @param{char**} paths: the files and the directories to pack.
+ * @param{int} nbPaths: number of paths.
+ * @param{char*} fileArchive: name of the archive to write.
+ * @param{unsigned int} checksums: checksums written in each member (@see
+ *                                 @function encryptBlocksOfFile).
+ * @param{int} nbThreads: number of workers coding the files (at most
+ *                        HFM_ARCHIVE_MAX_THREADS), 0 for one per processor.
+ * @param{cch} cache: the files already coded (NULL to code every file).
+ * @param{int} dedup: 1 to store the chunks shared by the files once, 0 to code
+ *                    each file in its own container.
+ *
+ * @return{int}: 0 if all the files have been packed, -1 otherwise (the archive
+ *               then holds the files which could be read).
+ */
+int huffmanArchiveFiles(char **paths, int nbPaths, char *fileArchive, unsigned int checksums, int nbThreads, cch cache, int dedup);
+
+/**
+ * @function huffmanExtractFiles
+ * @brief Extracts members of an archive.
+ *
+ * The members are written in the directory given, with the sub-directories of
+ * their names. A name given selects the member with this name, or the members
+ * of the directory with this name. The members with ".." in their name are not
+ * extracted.
+ *
+ * @param{char*} fileArchive: name of the archive.
+ * @param{char*} directory: directory receiving the members.
+ * @param{char**} members: names of the members to extract (can be NULL).
+ * @param{int} nbMembers: number of names, 0 to extract all the members.
+ * @param{int} nbThreads: number of workers decoding the members (at most
+ *                        HFM_ARCHIVE_MAX_THREADS), 0 for one per processor.
+ *
+ * @return{int}: 0 if the members have been extracted, -1 on an error of the
+ *               files, -2 if the archive is corrupted, -3 if a member does not
+ *               match its checksums.
+ */
+int huffmanExtractFiles(char *fileArchive, char *directory, char **members, int nbMembers, int nbThreads);
+
+/**
+ * @function listArchiveMembers
+ * @brief Prints the members of an archive, from its directory.
+ *
+ * @param{char*} fileArchive: name of the archive.
+ *
+ * @return{int}: 0 if the archive has been read, -1 if it can't be opened, -2 if
+ *               it is corrupted.
+ */
+int listArchiveMembers(char *fileArchive);
+
+
+#endif
+
+/* ========================================================================== */
+/* ========================================================================== */
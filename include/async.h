@@ -0,0 +1,250 @@
+/**
+ * @file async.h
+ * @author agent <agent@local>
+ * @standard C99
+ * @version 1.0
+ * @date 18th October 2026
+ *
+ * @brief Header file for the asynchronous coding of buffers by a pool of
+ * threads.
+ *
+ * A request gives a buffer to compress or to decompress and returns at once.
+ * The threads of the pool code it with the reentrant core (@see @file codec.h),
+ * each with its own scratch space, and its result is given:
+ *  - to its callback, called by the thread of the pool once it is done. The
+ *    request then belongs to the callback, which has to release it;
+ *  - or, without callback, to the caller, which waits for it, or polls it or
+ *    the file descriptor of the pool, and then releases it.
+ *
+ * The requests are the tasks of a work-stealing scheduler (@see @file
+ * scheduler.h), the pool's own or one shared with other work. A big buffer is
+ * cut in tasks of some blocks, coded by all the workers, while the small ones
+ * are each a task.
+ *
+ * Overview about the pool structure functions:
+ *  - createAsyncPool
+ *  - createAsyncPoolOnScheduler
+ *  - destroyAsyncPool
+ *  - getAsyncPoolFd
+ *
+ * Overview about the request structure functions:
+ *  - submitAsyncCompress
+ *  - submitAsyncDecompress
+ *  - isAsyncRequestDone
+ *  - waitAsyncRequest
+ *  - getAsyncRequestStatus
+ *  - takeAsyncRequestResult
+ *  - getAsyncRequestUserData
+ *  - releaseAsyncRequest
+ */
+
+/* ========================================================= */
+/* ================== ASYNC_H FILE HEADER ================== */
+/* ========================================================================== */
+
+#ifndef ASYNC_H
+#define ASYNC_H
+
+/* ============ Includes =========== */
+
+#include <stdlib.h>
+#include "codec.h" /**< Contains the reentrant core coding in memory  */
+#include "scheduler.h" /**< Contains the scheduler running the requests  */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============= Struct ============ */
+
+/**
+ * @typedef asp
+ * @brief Definition of asp, a pointer of the structure asyncPool.
+ *
+ * The struct asyncPool is said existing, but truly implemented in the file
+ * "async.c".
+ */
+typedef struct asyncPool* asp;
+
+/**
+ * @typedef asr
+ * @brief Definition of asr, a pointer of the structure asyncRequest.
+ *
+ * The struct asyncRequest is said existing, but truly implemented in the file
+ * "async.c".
+ */
+typedef struct asyncRequest* asr;
+
+/**
+ * @typedef asyncCallback
+ * @brief Function called by a thread of the pool once a request is done.
+ *
+ * It must not wait for a request, and has to release its request.
+ */
+typedef void (*asyncCallback)(asr request, void *userData);
+
+/* ======== Struct functions ======= */
+
+/**
+ * @function createAsyncPool
+ * @brief Creates a pool with its own scheduler.
+ *
+ * @param{int} nbThreads: number of threads (at most HFM_SCHEDULER_MAX_WORKERS),
+ *                        0 for one per processor.
+ *
+ * @return{asp}: the pool, NULL if it can't be created.
+ */
+asp createAsyncPool(int nbThreads);
+
+/**
+ * @function createAsyncPoolOnScheduler
+ * @brief Creates a pool running its requests on a scheduler, which has to
+ * outlive the pool.
+ *
+ * @param{sch} scheduler: the scheduler.
+ *
+ * @return{asp}: the pool, NULL if it can't be created.
+ */
+asp createAsyncPoolOnScheduler(sch scheduler);
+
+/**
+ * @function destroyAsyncPool
+ * @brief Stops a pool and sets its pointer to NULL.
+ *
+ * The requests already submitted are done (and their callbacks called) before
+ * it returns; the new ones are refused. Its own scheduler is then stopped. It
+ * must not be called by a callback.
+ *
+ * @param{asp*} pool: pointer on the pool (can point on NULL).
+ *
+ * @return{void}
+ */
+void destroyAsyncPool(asp *pool);
+
+/**
+ * @function getAsyncPoolFd
+ * @brief Gives the file descriptor readable when requests are done.
+ *
+ * It is an eventfd: each request done without callback adds 1 to its counter,
+ * and reading it (8 bytes) gives the counter and sets it back to 0. It is non
+ * blocking, and closed by destroyAsyncPool.
+ *
+ * @param{asp} pool: the pool.
+ *
+ * @return{int}: the file descriptor, -1 if the pool has none.
+ */
+int getAsyncPoolFd(asp pool);
+
+/**
+ * @function submitAsyncCompress
+ * @brief Submits data to write as a ".hfm" file (@see @function codecCompress).
+ *
+ * The data must stay unchanged until the request is done. The key is copied.
+ *
+ * @param{asp} pool: the pool.
+ * @param{const unsigned char*} data: the data.
+ * @param{size_t} size: size of the data.
+ * @param{const size_t*} key: occurrences of the 256 byte values giving the
+ *                            codes, NULL to put the code table in the header.
+ * @param{unsigned int} checksums: checksums to write.
+ * @param{asyncCallback} callback: function called once done (can be NULL).
+ * @param{void*} userData: given to the callback.
+ *
+ * @return{asr}: the request, NULL if it can't be submitted.
+ */
+asr submitAsyncCompress(asp pool, const unsigned char *data, size_t size, const size_t *key, unsigned int checksums, asyncCallback callback, void *userData);
+
+/**
+ * @function submitAsyncDecompress
+ * @brief Submits a ".hfm" file to decode (@see @function codecDecompress).
+ *
+ * The ".hfm" file must stay unchanged until the request is done. The key is
+ * copied.
+ *
+ * @param{asp} pool: the pool.
+ * @param{const unsigned char*} data: the ".hfm" file.
+ * @param{size_t} size: size of the ".hfm" file.
+ * @param{const size_t*} key: occurrences of the 256 byte values, used if the
+ *                            file has no code table (can be NULL).
+ * @param{size_t} maxSize: maximal size of the original data accepted (bigger
+ *                         gives HFM_ERROR_OVERFLOW).
+ * @param{asyncCallback} callback: function called once done (can be NULL).
+ * @param{void*} userData: given to the callback.
+ *
+ * @return{asr}: the request, NULL if it can't be submitted.
+ */
+asr submitAsyncDecompress(asp pool, const unsigned char *data, size_t size, const size_t *key, size_t maxSize, asyncCallback callback, void *userData);
+
+/**
+ * @function isAsyncRequestDone
+ * @brief Tells if a request is done, without waiting.
+ *
+ * @param{asr} request: the request.
+ *
+ * @return{int}: 1 if it is done, 0 otherwise.
+ */
+int isAsyncRequestDone(asr request);
+
+/**
+ * @function waitAsyncRequest
+ * @brief Waits for a request without callback.
+ *
+ * @param{asr} request: the request.
+ *
+ * @return{int}: its status (@see @function getAsyncRequestStatus).
+ */
+int waitAsyncRequest(asr request);
+
+/**
+ * @function getAsyncRequestStatus
+ * @brief Gives the status of a request done.
+ *
+ * @param{asr} request: the request.
+ *
+ * @return{int}: HFM_OK or an error code (@see @file codec.h).
+ */
+int getAsyncRequestStatus(asr request);
+
+/**
+ * @function takeAsyncRequestResult
+ * @brief Takes the result of a request done.
+ *
+ * @param{asr} request: the request.
+ * @param{size_t*} size: receives the size of the result (the size needed if
+ *                       the status is HFM_ERROR_OVERFLOW).
+ *
+ * @return{unsigned char*}: the result, to free, NULL if the request failed or
+ *                          the result has already been taken.
+ */
+unsigned char* takeAsyncRequestResult(asr request, size_t *size);
+
+/**
+ * @function getAsyncRequestUserData
+ * @brief Gives the data of the user of a request.
+ *
+ * @param{asr} request: the request.
+ *
+ * @return{void*}: the data given when it was submitted.
+ */
+void* getAsyncRequestUserData(asr request);
+
+/**
+ * @function releaseAsyncRequest
+ * @brief Frees a request, and its result if it is not taken, and sets its
+ * pointer to NULL. A request without callback not done is waited first.
+ *
+ * @param{asr*} request: pointer on the request (can point on NULL).
+ *
+ * @return{void}
+ */
+void releaseAsyncRequest(asr *request);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+/* ========================================================================== */
+/* ========================================================================== */
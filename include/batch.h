@@ -0,0 +1,102 @@
+/**
+ * @file batch.h
+ * @author agent <agent@local>
+ * @standard C99
+ * @version 1.0
+ * @date 18th October 2026
+ *
+ * @brief Header file for the encryption of many files in one process.
+ *
+ * Each file is encrypted in a ".hfm" file next to it (its name followed by
+ * ".hfm"), with the code table in the header, as by huffmanEncryptFile.
+ *
+ * On Linux, the files are read and written through io_uring: up to
+ * HFM_BATCH_DEPTH files are opened, read, written and closed at the same time
+ * by the calling thread, with a few system calls for many operations, while the
+ * workers of a scheduler code the files read (@see @file scheduler.h). The
+ * files up to HFM_BATCH_MAX_SIZE bytes are coded in memory, the bigger ones
+ * are mapped and coded straight in their mapped ".hfm" file, their blocks
+ * being coded by the tasks of all the workers: a worker having no file left
+ * helps with the big ones.
+ *
+ * Where io_uring is not available (older kernel, other system, forbidden by a
+ * sandbox), each file is a task reading, coding and writing the whole file
+ * with blocking calls.
+ *
+ * Overview about public functions of batch:
+ *  - listBatchFiles
+ *  - destroyBatchFiles
+ *  - huffmanEncryptBatch
+ */
+
+/* ========================================================= */
+/* ================== BATCH_H FILE HEADER ================== */
+/* ========================================================================== */
+
+#ifndef BATCH_H
+#define BATCH_H
+
+/* ============ Includes =========== */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "huffman.h" /**< Contains the huffman coding of the files  */
+#include "cache.h" /**< Contains the cache of the files already coded  */
+#include "scheduler.h" /**< Contains the workers coding the files  */
+
+/* ============ Defines ============ */
+
+#define HFM_BATCH_DEPTH 64 /**< Files read or written at the same time */
+#define HFM_BATCH_MAX_SIZE (1 << 20) /**< Files coded in memory, the bigger ones are mapped */
+#define HFM_BATCH_MAX_THREADS 64 /**< Maximal number of workers coding the files */
+
+/* =========== Functions =========== */
+
+/**
+ * @function listBatchFiles
+ * @brief Lists the files to encrypt.
+ *
+ * If the path is a directory, the regular files in it are listed (not in its
+ * sub-directories), except the ".hfm" files. Else the path is a text file
+ * giving a path per line.
+ *
+ * @param{char*} path: a directory or a list of files.
+ * @param{size_t*} nbFiles: receives the number of files.
+ *
+ * @return{char**}: the names of the files, NULL if the path can't be read.
+ */
+char** listBatchFiles(char *path, size_t *nbFiles);
+
+/**
+ * @function destroyBatchFiles
+ * @brief Frees the names given by listBatchFiles.
+ *
+ * @param{char***} files: pointer on the names.
+ * @param{size_t} nbFiles: number of names.
+ *
+ * @return{void}
+ */
+void destroyBatchFiles(char ***files, size_t nbFiles);
+
+/**
+ * @function huffmanEncryptBatch
+ * @brief Encrypts many files, each in its ".hfm" file.
+ *
+ * @param{char**} filesIn: names of the files.
+ * @param{size_t} nbFiles: number of files.
+ * @param{unsigned int} checksums: checksums to write (@see @function
+ *                                 encryptBlocksOfFile).
+ * @param{int} nbThreads: number of workers coding the files (at most
+ *                        HFM_BATCH_MAX_THREADS), 0 for one per processor.
+ * @param{cch} cache: the files already coded (NULL to code every file).
+ *
+ * @return{size_t}: number of files which can't be encrypted.
+ */
+size_t huffmanEncryptBatch(char **filesIn, size_t nbFiles, unsigned int checksums, int nbThreads, cch cache);
+
+
+#endif
+
+/* ========================================================================== */
+/* ========================================================================== */
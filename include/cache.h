@@ -0,0 +1,139 @@
+/**
+ * @file cache.h
+ * @author agent <agent@local>
+ * @standard C99
+ * @version 1.0
+ * @date 18th October 2026
+ *
+ * @brief Header file for the cache of the files already coded.
+ *
+ * The cache is a directory keeping the ".hfm" files coded by the batch and the
+ * archives, so that a file which has not changed is not coded again. An entry
+ * is named after the XXH64 hash of the content of the file, seeded with the
+ * parameters of the format (version, size of the blocks, checksums), and its
+ * size: the same content coded with other parameters has another entry.
+ *
+ * An entry starts with a header of HFM_CACHE_HEADER_SIZE bytes (little endian
+ * integers): the magic "HFMK" (4 bytes), the CRC32C of the ".hfm" file (4
+ * bytes), the hash (8 bytes) and the size of the original file (8 bytes). The
+ * ".hfm" file follows. An entry whose CRC32C or hash does not match is removed
+ * and the file is coded again.
+ *
+ * The entries are written in a temporary file renamed once complete, so that
+ * several processes can share a cache. The date of an entry is updated when it
+ * is used, and the entries not used for the longest time are removed when the
+ * cache is bigger than its maximal size.
+ *
+ * Overview about the cache structure functions:
+ *  - openCache
+ *  - closeCache
+ *  - getCacheHits
+ *  - getCacheMisses
+ *
+ * Overview about public functions of cache:
+ *  - encryptBufferCached
+ */
+
+/* ========================================================= */
+/* ================== CACHE_H FILE HEADER ================== */
+/* ========================================================================== */
+
+#ifndef CACHE_H
+#define CACHE_H
+
+/* ============ Includes =========== */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "huffman.h" /**< Contains the huffman coding of the files  */
+#include "xxhash64.h" /**< Contains the hash of the content of the files  */
+
+/* ============ Defines ============ */
+
+#define HFM_CACHE_MAGIC "HFMK" /**< First bytes of an entry */
+#define HFM_CACHE_HEADER_SIZE 24 /**< Size of the header of an entry */
+#define HFM_CACHE_DEFAULT_SIZE (1LL << 30) /**< Default maximal size of a cache */
+#define HFM_CACHE_MAX_ENTRY (64 << 20) /**< Bigger files are not kept in the cache */
+
+/* ============= Struct ============ */
+
+/**
+ * @typedef cch
+ * @brief Definition of cch, a pointer of the structure cache.
+ *
+ * The struct cache is said existing, but truly implemented in the file
+ * "cache.c". It is a cache directory opened, with the size of its entries. It
+ * can be used by several threads at the same time.
+ */
+typedef struct cache* cch;
+
+/* ======== Struct functions ======= */
+
+/**
+ * @function openCache
+ * @brief Opens a cache directory, created if it does not exist.
+ *
+ * @param{char*} directory: the directory.
+ * @param{long long} maxSize: maximal size of the entries, in bytes.
+ *
+ * @return{cch}: the cache, NULL if the directory can't be created or read.
+ */
+cch openCache(char *directory, long long maxSize);
+
+/**
+ * @function closeCache
+ * @brief Removes the oldest entries if the cache is too big, and frees it.
+ *
+ * @param{cch*} cache: pointer on the cache (can point on NULL).
+ *
+ * @return{void}
+ */
+void closeCache(cch *cache);
+
+/**
+ * @function getCacheHits
+ * @brief Getter of the number of files found in the cache.
+ *
+ * @param{cch} cache: the cache.
+ *
+ * @return{size_t}: the number of files.
+ */
+size_t getCacheHits(cch cache);
+
+/**
+ * @function getCacheMisses
+ * @brief Getter of the number of files coded and added to the cache.
+ *
+ * @param{cch} cache: the cache.
+ *
+ * @return{size_t}: the number of files.
+ */
+size_t getCacheMisses(cch cache);
+
+/* =========== Functions =========== */
+
+/**
+ * @function encryptBufferCached
+ * @brief Encrypts data in memory, or takes its ".hfm" file from the cache.
+ * @see @function encryptBufferInMemory
+ *
+ * The data coded is added to the cache if it has at most HFM_CACHE_MAX_ENTRY
+ * bytes.
+ *
+ * @param{cch} cache: the cache (NULL to always code the data).
+ * @param{unsigned char*} data: the data to encrypt.
+ * @param{size_t} size: size of the data.
+ * @param{unsigned int} checksums: checksums to write.
+ * @param{size_t*} outSize: receives the size of the ".hfm" file.
+ *
+ * @return{unsigned char*}: the ".hfm" file, to free, NULL if it can't be
+ *                          written.
+ */
+unsigned char* encryptBufferCached(cch cache, unsigned char *data, size_t size, unsigned int checksums, size_t *outSize);
+
+
+#endif
+
+/* ========================================================================== */
+/* ========================================================================== */
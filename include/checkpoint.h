@@ -0,0 +1,203 @@
+/**
+ * @file checkpoint.h
+ * @author agent <agent@local>
+ * @standard C99
+ * @version 1.0
+ * @date 18th October 2026
+ *
+ * @brief Header file for the checkpoints of the long encryptions and
+ * decryptions.
+ *
+ * While a large file is encrypted or decrypted, a checkpoint is written every
+ * HFM_CHECKPOINT_BLOCKS blocks in a file next to the output (its name followed
+ * by HFM_CHECKPOINT_EXTENSION), so that an interrupted job can be resumed from
+ * its last complete block instead of starting again. The checkpoint file is
+ * removed once the job is done.
+ *
+ * The checkpoint file is a journal: a header of HFM_CHECKPOINT_HEADER_SIZE
+ * bytes (HFM_CHECKPOINT_MAGIC, the kind of job, 3 reserved bytes and the size
+ * of the input file on 8 bytes), then one record per checkpoint, appended:
+ *  - the number of block index entries of the record (4 bytes), then the
+ *    entries of the blocks written since the previous record (size in the
+ *    file, original size and CRC32C, 4 bytes each). Only an encryption writes
+ *    entries, the index of its output being written at the end only.
+ *  - the number of blocks done, the offset in the input file and the offset in
+ *    the output file (8 bytes each)
+ *  - the CRC32C of the original data done (4 bytes), then the CRC32C of the
+ *    record (4 bytes)
+ * All the integers are little endian. The output file is synchronized on the
+ * disk before a record is written, so the data a record describes is complete.
+ * A record cut by an interruption does not match its CRC32C and is ignored.
+ *
+ * The code table is not in the checkpoint: it is in the header of the output
+ * file being encrypted, in the key file, or in the input file being decrypted.
+ *
+ * Overview about the checkpoint structure functions:
+ *  - createCheckpoint
+ *  - loadCheckpoint
+ *  - closeCheckpoint
+ *  - getCheckpointNbBlocks
+ *  - getCheckpointInputOffset
+ *  - getCheckpointOutputOffset
+ *  - getCheckpointChecksum
+ *
+ * Overview about public functions of checkpoint:
+ *  - commitCheckpoint
+ *  - restoreCheckpointBlocks
+ */
+
+/* ========================================================= */
+/* ================ CHECKPOINT_H FILE HEADER =============== */
+/* ========================================================================== */
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+/* ============ Includes =========== */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include "utils.h" /**< Contains useful tool functions  */
+#include "container.h" /**< Contains the header of the ".hfm" files  */
+
+/* ============ Defines ============ */
+
+#define HFM_CHECKPOINT_MAGIC "HFMR" /**< First bytes of a checkpoint file */
+#define HFM_CHECKPOINT_EXTENSION ".ckpt" /**< Added to the name of the output */
+#define HFM_CHECKPOINT_HEADER_SIZE 16 /**< Size of the header of a checkpoint file */
+#define HFM_CHECKPOINT_BLOCKS 1024 /**< Blocks between two checkpoints (64 MiB) */
+#define HFM_CHECKPOINT_ENCRYPTION 'E' /**< Kind of job: encryption */
+#define HFM_CHECKPOINT_DECRYPTION 'D' /**< Kind of job: decryption */
+
+/* ============= Struct ============ */
+
+/**
+ * @typedef ckp
+ * @brief Definition of ckp, a pointer of the structure checkpoint.
+ *
+ * The struct checkpoint is said existing, but truly implemented in the file
+ * "checkpoint.c". It is an opened checkpoint file and its last record.
+ */
+typedef struct checkpoint* ckp;
+
+/* ======== Struct functions ======= */
+
+/**
+ * @function createCheckpoint
+ * @brief Creates the checkpoint file of a job starting.
+ *
+ * @param{char*} fileOut: name of the output file of the job.
+ * @param{char} kind: HFM_CHECKPOINT_ENCRYPTION or HFM_CHECKPOINT_DECRYPTION.
+ * @param{long long} inputSize: size of the input file.
+ *
+ * @return{ckp}: the checkpoint, NULL if its file can't be written or memory
+ *               can't be allocated.
+ */
+ckp createCheckpoint(char *fileOut, char kind, long long inputSize);
+
+/**
+ * @function loadCheckpoint
+ * @brief Opens the checkpoint file of an interrupted job.
+ *
+ * The last complete record is read, and the records after it are removed.
+ * Without any record, the job is resumed from its start. If memory can't be
+ * allocated for a record, the job is resumed from the record before it.
+ *
+ * @param{char*} fileOut: name of the output file of the job.
+ * @param{char} kind: HFM_CHECKPOINT_ENCRYPTION or HFM_CHECKPOINT_DECRYPTION.
+ * @param{long long} inputSize: size of the input file, which must be the one
+ *                              of the interrupted job.
+ *
+ * @return{ckp}: the checkpoint, NULL if there is no checkpoint of such a job
+ *               or memory can't be allocated.
+ */
+ckp loadCheckpoint(char *fileOut, char kind, long long inputSize);
+
+/**
+ * @function closeCheckpoint
+ * @brief Closes a checkpoint file, and removes it if the job is done.
+ *
+ * @param{ckp*} checkpoint: pointer on the checkpoint (can be NULL).
+ * @param{int} done: 1 if the job is done, 0 to keep the file for a resume.
+ *
+ * @return{void}
+ */
+void closeCheckpoint(ckp *checkpoint, int done);
+
+/**
+ * @function getCheckpointNbBlocks
+ * @brief Getter of the number of blocks done.
+ *
+ * @param{ckp} checkpoint: the checkpoint.
+ *
+ * @return{size_t}: the number of blocks.
+ */
+size_t getCheckpointNbBlocks(ckp checkpoint);
+
+/**
+ * @function getCheckpointInputOffset
+ * @brief Getter of the offset where the input file is read again.
+ *
+ * @param{ckp} checkpoint: the checkpoint.
+ *
+ * @return{long long}: the offset.
+ */
+long long getCheckpointInputOffset(ckp checkpoint);
+
+/**
+ * @function getCheckpointOutputOffset
+ * @brief Getter of the offset where the output file is written again.
+ *
+ * @param{ckp} checkpoint: the checkpoint.
+ *
+ * @return{long long}: the offset.
+ */
+long long getCheckpointOutputOffset(ckp checkpoint);
+
+/**
+ * @function getCheckpointChecksum
+ * @brief Getter of the CRC32C of the original data done.
+ *
+ * @param{ckp} checkpoint: the checkpoint.
+ *
+ * @return{uint32_t}: the checksum.
+ */
+uint32_t getCheckpointChecksum(ckp checkpoint);
+
+/* =========== Functions =========== */
+
+/**
+ * @function commitCheckpoint
+ * @brief Synchronizes the output file and writes a record.
+ *
+ * @param{ckp} checkpoint: the checkpoint.
+ * @param{FILE*} fileOut: the output file, positioned after the data done.
+ * @param{ctn} container: for an encryption, the container of the output,
+ *                        whose new index entries are written (else NULL).
+ * @param{size_t} nbBlocks: number of blocks done.
+ * @param{long long} inputOffset: offset in the input file after the blocks.
+ * @param{uint32_t} checksum: CRC32C of the original data done.
+ *
+ * @return{int}: 0 if the record has been written, -1 otherwise.
+ */
+int commitCheckpoint(ckp checkpoint, FILE *fileOut, ctn container, size_t nbBlocks, long long inputOffset, uint32_t checksum);
+
+/**
+ * @function restoreCheckpointBlocks
+ * @brief Adds the blocks of an encryption resumed to the index of its output.
+ *
+ * @param{ckp} checkpoint: the checkpoint of an encryption.
+ * @param{ctn} container: the container read in the header of the output (@see
+ *                        @function readContainerHeader).
+ *
+ * @return{void}
+ */
+void restoreCheckpointBlocks(ckp checkpoint, ctn container);
+
+
+#endif
+
+/* ========================================================================== */
+/* ========================================================================== */
@@ -0,0 +1,565 @@
+/**
+ * @file codec.h
+ * @author agent <agent@local>
+ * @standard C99
+ * @version 1.0
+ * @date 18th October 2026
+ *
+ * @brief Header file for the reentrant core coding ".hfm" files in memory.
+ *
+ * The functions of this core never stop the program and never print: they
+ * return an error code (@see HFM_OK...), and only use the memory given to them
+ * (the data, the output and a scratch space). They can be called by any number
+ * of threads at the same time, each thread with its own scratch space.
+ *
+ * The tables are arrays instead of a tree of nodes: the prefixes of the 256
+ * byte values (up to 255 bits each) and the tree flattened in 255 nodes. They
+ * are built from the occurrences of the byte values exactly as the tree of
+ * "huffman.c", so the ".hfm" files written are the same as the ones of
+ * encryptBufferInMemory, and both decode the files of each other.
+ *
+ * A context keeps the tables of a key, built once, for the short messages
+ * coded with it: a message is the varint of its size (doubled, plus 1 if it is
+ * coded) followed by its prefixes, or by its bytes if the coding doesn't make
+ * it smaller. It has no header, no index and no table.
+ *
+ * A context is counted by its references, and shared by the streams coded
+ * with its tables: a stream only keeps the bits of its last byte not complete
+ * yet, and the node of the tree reached by its decoding, about 16 bytes. The
+ * prefixes of a stream follow each other with no size and no padding, up to a
+ * flush which completes its last byte.
+ *
+ * Overview about the scratch structure functions:
+ *  - createCodecScratch
+ *  - destroyCodecScratch
+ *
+ * Overview about the context structure functions:
+ *  - createCodecContext
+ *  - retainCodecContext
+ *  - destroyCodecContext
+ *
+ * Overview about the stream structure functions:
+ *  - createCodecStream
+ *  - destroyCodecStream
+ *
+ * Overview about public functions of codec:
+ *  - codecErrorMessage
+ *  - codecCompressBound
+ *  - codecCompress
+ *  - codecDecompressedSize
+ *  - codecDecompress
+ *  - codecCompressVector
+ *  - codecDecompressVector
+ *  - codecCompressParallel
+ *  - codecDecompressParallel
+ *  - codecMessageBound
+ *  - codecCompressMessage
+ *  - codecDecompressMessage
+ *  - codecStreamBound
+ *  - codecEncodeStream
+ *  - codecFlushStream
+ *  - codecDecodeStream
+ *  - codecAlignStream
+ *  - codecDecodeTree
+ *  - codecDecodeTreeBlock
+ */
+
+/* ========================================================= */
+/* ================== CODEC_H FILE HEADER ================== */
+/* ========================================================================== */
+
+#ifndef CODEC_H
+#define CODEC_H
+
+/* ============ Includes =========== */
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <sys/uio.h>
+#include "container.h" /**< Contains the format of the ".hfm" files  */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============ Defines ============ */
+
+#define HFM_OK 0 /**< Done */
+#define HFM_ERROR_KEY -1 /**< A block is coded with the key and no key is given */
+#define HFM_ERROR_CORRUPTED -2 /**< The file is not a valid ".hfm" file */
+#define HFM_ERROR_CHECKSUM -3 /**< The file does not match its checksums */
+#define HFM_ERROR_ARGUMENT -4 /**< An argument is not valid */
+#define HFM_ERROR_MEMORY -5 /**< Memory can't be allocated */
+#define HFM_ERROR_OVERFLOW -6 /**< The output is too small (its size needed is given) */
+
+/* ============= Struct ============ */
+
+struct scheduler; /**< The scheduler of the parallel coding (@see @file scheduler.h) */
+
+/**
+ * @typedef csc
+ * @brief Definition of csc, a pointer of the structure codecScratch.
+ *
+ * The struct codecScratch is said existing, but truly implemented in the file
+ * "codec.c". It holds the tables and the counters used while coding, about
+ * 24 KiB, so that a thread coding many buffers allocates nothing.
+ */
+typedef struct codecScratch* csc;
+
+/**
+ * @typedef cct
+ * @brief Definition of cct, a pointer of the structure codecContext.
+ *
+ * The struct codecContext is said existing, but truly implemented in the file
+ * "codec.c". It holds the tables of a key and the cost of each byte, about
+ * 14 KiB, never changed once created but for its count of references: it can
+ * be shared by any number of threads and streams, and coding a message with it
+ * allocates nothing.
+ */
+typedef struct codecContext* cct;
+
+/**
+ * @typedef cst
+ * @brief Definition of cst, a pointer of the structure codecStream.
+ *
+ * The struct codecStream is said existing, but truly implemented in the file
+ * "codec.c". It holds a reference on a context and the state of a stream
+ * between two calls, for one thread at a time.
+ */
+typedef struct codecStream* cst;
+
+/* ======== Struct functions ======= */
+
+/**
+ * @function createCodecScratch
+ * @brief Creates a scratch space, for one thread at a time.
+ *
+ * @return{csc}: the scratch space, NULL if memory can't be allocated.
+ */
+csc createCodecScratch(void);
+
+/**
+ * @function destroyCodecScratch
+ * @brief Frees a scratch space and sets its pointer to NULL.
+ *
+ * @param{csc*} scratch: pointer on the scratch space (can point on NULL).
+ *
+ * @return{void}
+ */
+void destroyCodecScratch(csc *scratch);
+
+/**
+ * @function createCodecContext
+ * @brief Creates a context from a key, its tables built once.
+ *
+ * @param{const size_t*} key: occurrences of the 256 byte values giving the
+ *                            codes (a byte with no occurrence has no prefix).
+ *
+ * @return{cct}: the context, NULL if the key is NULL or memory can't be
+ *               allocated.
+ */
+cct createCodecContext(const size_t *key);
+
+/**
+ * @function retainCodecContext
+ * @brief Adds a reference on a context, released by destroyCodecContext.
+ *
+ * @param{cct} context: the context.
+ *
+ * @return{cct}: the context.
+ */
+cct retainCodecContext(cct context);
+
+/**
+ * @function destroyCodecContext
+ * @brief Releases a reference on a context, freed with the last one, and sets
+ * its pointer to NULL.
+ *
+ * @param{cct*} context: pointer on the context (can point on NULL).
+ *
+ * @return{void}
+ */
+void destroyCodecContext(cct *context);
+
+/**
+ * @function createCodecStream
+ * @brief Creates a stream coded with the tables of a context, on which it
+ * takes a reference.
+ *
+ * @param{cct} context: the context.
+ *
+ * @return{cst}: the stream, NULL if the context is NULL or memory can't be
+ *               allocated.
+ */
+cst createCodecStream(cct context);
+
+/**
+ * @function destroyCodecStream
+ * @brief Frees a stream, releases its context and sets its pointer to NULL.
+ *
+ * The bits not flushed are lost.
+ *
+ * @param{cst*} stream: pointer on the stream (can point on NULL).
+ *
+ * @return{void}
+ */
+void destroyCodecStream(cst *stream);
+
+/* =========== Functions =========== */
+
+/**
+ * @function codecErrorMessage
+ * @brief Describes an error code.
+ *
+ * @param{int} error: the error code.
+ *
+ * @return{const char*}: the description, a constant string.
+ */
+const char* codecErrorMessage(int error);
+
+/**
+ * @function codecCompressBound
+ * @brief Gives the size of an output always big enough for codecCompress.
+ *
+ * @param{size_t} size: size of the data.
+ *
+ * @return{size_t}: the size in bytes.
+ */
+size_t codecCompressBound(size_t size);
+
+/**
+ * @function codecCompress
+ * @brief Writes the ".hfm" file of data in memory.
+ *
+ * Without key, the code table is made from the data and written in the
+ * header, and the blocks are stored if the coding doesn't make the data
+ * smaller (@see @function encryptBufferInMemory): the header then has no code
+ * table, and no key is needed. With a key, the header has no code table.
+ *
+ * @param{csc} scratch: scratch space (NULL to allocate one for the call).
+ * @param{const unsigned char*} data: the data.
+ * @param{size_t} size: size of the data.
+ * @param{const size_t*} key: occurrences of the 256 byte values giving the
+ *                            codes, NULL to make them from the data.
+ * @param{unsigned int} checksums: HFM_CONTAINER_BLOCK_CRC and/or
+ *                                 HFM_CONTAINER_STREAM_CRC, 0 for none.
+ * @param{unsigned char*} out: the output.
+ * @param{size_t} capacity: size of the output.
+ * @param{size_t*} outSize: receives the size of the ".hfm" file, even when
+ *                          the output is too small.
+ *
+ * @return{int}: HFM_OK, HFM_ERROR_OVERFLOW if the output is too small, or
+ *               another error code.
+ */
+int codecCompress(csc scratch, const unsigned char *data, size_t size, const size_t *key, unsigned int checksums, unsigned char *out, size_t capacity, size_t *outSize);
+
+/**
+ * @function codecDecompressedSize
+ * @brief Reads the size of the original data in the header of a ".hfm" file.
+ *
+ * @param{const unsigned char*} data: the ".hfm" file.
+ * @param{size_t} size: size of the ".hfm" file.
+ * @param{size_t*} originalSize: receives the size of the original data.
+ *
+ * @return{int}: HFM_OK, HFM_ERROR_CORRUPTED if the header is not valid.
+ */
+int codecDecompressedSize(const unsigned char *data, size_t size, size_t *originalSize);
+
+/**
+ * @function codecDecompress
+ * @brief Decodes a ".hfm" file kept in memory.
+ *
+ * The header and the block index are checked before the first byte is
+ * written, each block before it is decoded.
+ *
+ * @param{csc} scratch: scratch space (NULL to allocate one for the call).
+ * @param{const unsigned char*} data: the ".hfm" file.
+ * @param{size_t} size: size of the ".hfm" file.
+ * @param{const size_t*} key: occurrences of the 256 byte values, used if the
+ *                            file has no code table (can be NULL).
+ * @param{unsigned char*} out: the output.
+ * @param{size_t} capacity: size of the output.
+ * @param{size_t*} outSize: receives the size of the original data, even when
+ *                          the output is too small.
+ *
+ * @return{int}: HFM_OK, HFM_ERROR_OVERFLOW if the output is too small, or
+ *               another error code.
+ */
+int codecDecompress(csc scratch, const unsigned char *data, size_t size, const size_t *key, unsigned char *out, size_t capacity, size_t *outSize);
+
+/**
+ * @function codecCompressVector
+ * @brief Writes data held in fragments as a ".hfm" file in fragments (@see
+ * @function codecCompress).
+ *
+ * The fragments are read and written where they are, a block or its payload
+ * going on from a fragment to the next one: the ".hfm" file is the same as the
+ * one of their concatenation, and nothing is allocated with a scratch space.
+ *
+ * @param{csc} scratch: scratch space (NULL to allocate one for the call).
+ * @param{const struct iovec*} in: fragments of the data.
+ * @param{int} inCount: number of fragments of the data.
+ * @param{const size_t*} key: occurrences of the 256 byte values giving the
+ *                            codes, NULL to put the code table in the header.
+ * @param{unsigned int} checksums: HFM_CONTAINER_BLOCK_CRC and/or
+ *                                 HFM_CONTAINER_STREAM_CRC, 0 for none.
+ * @param{const struct iovec*} out: fragments of the output, filled in order.
+ * @param{int} outCount: number of fragments of the output.
+ * @param{size_t*} outSize: receives the size of the ".hfm" file, even when the
+ *                          output is too small.
+ *
+ * @return{int}: HFM_OK, HFM_ERROR_OVERFLOW if the output is too small, or
+ *               another error code.
+ */
+int codecCompressVector(csc scratch, const struct iovec *in, int inCount, const size_t *key, unsigned int checksums, const struct iovec *out, int outCount, size_t *outSize);
+
+/**
+ * @function codecDecompressVector
+ * @brief Decodes a ".hfm" file held in fragments into fragments (@see
+ * @function codecDecompress).
+ *
+ * @param{csc} scratch: scratch space (NULL to allocate one for the call).
+ * @param{const struct iovec*} in: fragments of the ".hfm" file.
+ * @param{int} inCount: number of fragments of the ".hfm" file.
+ * @param{const size_t*} key: occurrences of the 256 byte values, used if the
+ *                            file has no code table (can be NULL).
+ * @param{const struct iovec*} out: fragments of the output, filled in order.
+ * @param{int} outCount: number of fragments of the output.
+ * @param{size_t*} outSize: receives the size of the original data, even when
+ *                          the output is too small.
+ *
+ * @return{int}: HFM_OK, HFM_ERROR_OVERFLOW if the output is too small, or
+ *               another error code.
+ */
+int codecDecompressVector(csc scratch, const struct iovec *in, int inCount, const size_t *key, const struct iovec *out, int outCount, size_t *outSize);
+
+/**
+ * @function codecMessageBound
+ * @brief Gives the size of an output always big enough for
+ * codecCompressMessage.
+ *
+ * @param{size_t} size: size of the message.
+ *
+ * @return{size_t}: the size in bytes.
+ */
+size_t codecMessageBound(size_t size);
+
+/**
+ * @function codecCompressMessage
+ * @brief Codes a short message with the tables of a context.
+ *
+ * A message with a byte the key gives no prefix to is stored.
+ *
+ * @param{cct} context: the context.
+ * @param{const unsigned char*} data: the message.
+ * @param{size_t} size: size of the message.
+ * @param{unsigned char*} out: the output.
+ * @param{size_t} capacity: size of the output.
+ * @param{size_t*} outSize: receives the size of the coded message, even when
+ *                          the output is too small (nothing is written then).
+ *
+ * @return{int}: HFM_OK, HFM_ERROR_OVERFLOW if the output is too small, or
+ *               HFM_ERROR_ARGUMENT.
+ */
+int codecCompressMessage(cct context, const unsigned char *data, size_t size, unsigned char *out, size_t capacity, size_t *outSize);
+
+/**
+ * @function codecDecompressMessage
+ * @brief Decodes a message coded with the tables of a context.
+ *
+ * @param{cct} context: the context of the key the message was coded with.
+ * @param{const unsigned char*} data: the coded message.
+ * @param{size_t} size: size of the coded message.
+ * @param{unsigned char*} out: the output.
+ * @param{size_t} capacity: size of the output.
+ * @param{size_t*} outSize: receives the size of the message, even when the
+ *                          output is too small (nothing is written then).
+ *
+ * @return{int}: HFM_OK, HFM_ERROR_OVERFLOW if the output is too small,
+ *               HFM_ERROR_CORRUPTED or HFM_ERROR_ARGUMENT.
+ */
+int codecDecompressMessage(cct context, const unsigned char *data, size_t size, unsigned char *out, size_t capacity, size_t *outSize);
+
+/**
+ * @function codecStreamBound
+ * @brief Gives the size of an output always big enough for codecEncodeStream
+ * and codecFlushStream.
+ *
+ * @param{cst} stream: the stream.
+ * @param{size_t} size: size of the data.
+ *
+ * @return{size_t}: the size in bytes.
+ */
+size_t codecStreamBound(cst stream, size_t size);
+
+/**
+ * @function codecEncodeStream
+ * @brief Codes data at the end of a stream.
+ *
+ * The bytes completed are written, and the bits of the last one are kept by
+ * the stream.
+ *
+ * @param{cst} stream: the stream.
+ * @param{const unsigned char*} data: the data.
+ * @param{size_t} size: size of the data.
+ * @param{unsigned char*} out: the output.
+ * @param{size_t} capacity: size of the output.
+ * @param{size_t*} outSize: receives the number of bytes written, or needed if
+ *                          the output is too small (nothing is coded then).
+ *
+ * @return{int}: HFM_OK, HFM_ERROR_OVERFLOW if the output is too small, or
+ *               HFM_ERROR_ARGUMENT (a byte of the data has no prefix).
+ */
+int codecEncodeStream(cst stream, const unsigned char *data, size_t size, unsigned char *out, size_t capacity, size_t *outSize);
+
+/**
+ * @function codecFlushStream
+ * @brief Completes the last byte of a stream with bits 0, to end a message
+ * (@see @function codecAlignStream).
+ *
+ * @param{cst} stream: the stream.
+ * @param{unsigned char*} out: the output.
+ * @param{size_t} capacity: size of the output.
+ * @param{size_t*} outSize: receives the number of bytes written (0 or 1), or
+ *                          needed if the output is too small.
+ *
+ * @return{int}: HFM_OK, HFM_ERROR_OVERFLOW if the output is too small, or
+ *               HFM_ERROR_ARGUMENT.
+ */
+int codecFlushStream(cst stream, unsigned char *out, size_t capacity, size_t *outSize);
+
+/**
+ * @function codecDecodeStream
+ * @brief Decodes the next bytes of a stream.
+ *
+ * It stops when the coded data is consumed or the output is full: the stream
+ * keeps the node reached and the bits of a byte not decoded yet. The padding
+ * of a flush is decoded as other bytes: the caller has to stop at the end of
+ * the message, by the size of its output, then align the stream.
+ *
+ * @param{cst} stream: the stream.
+ * @param{const unsigned char*} data: the coded data.
+ * @param{size_t} size: size of the coded data.
+ * @param{size_t*} used: receives the number of bytes of coded data consumed.
+ * @param{unsigned char*} out: the output.
+ * @param{size_t} capacity: size of the output.
+ * @param{size_t*} outSize: receives the number of bytes decoded.
+ *
+ * @return{int}: HFM_OK, HFM_ERROR_CORRUPTED if the tables code nothing, or
+ *               HFM_ERROR_ARGUMENT.
+ */
+int codecDecodeStream(cst stream, const unsigned char *data, size_t size, size_t *used, unsigned char *out, size_t capacity, size_t *outSize);
+
+/**
+ * @function codecAlignStream
+ * @brief Skips the padding of a flush in a stream being decoded, once the
+ * whole message is decoded.
+ *
+ * @param{cst} stream: the stream.
+ *
+ * @return{void}
+ */
+void codecAlignStream(cst stream);
+
+/**
+ * @function codecDecodeTree
+ * @brief Decodes a piece of a payload with a flattened tree, going on from a
+ * node of the tree.
+ *
+ * In the tree, a child greater or equal to 0 is the index of another node, and
+ * a negative child c is the leaf of the byte -(c+1) (@see @function
+ * flattenTree). The tables of the codec, the embedded table and the
+ * dictionaries are decoded by this function.
+ *
+ * @param{const int16_t(*)[2]} nodes: the nodes of the tree.
+ * @param{int16_t} root: the root, a node and not a leaf.
+ * @param{const unsigned char*} payload: the piece, the first bit the highest.
+ * @param{size_t} size: size of the piece.
+ * @param{int16_t*} node: the node reached by the piece before (the root at the
+ *                        start), then the one reached by this one.
+ * @param{unsigned char*} out: the bytes decoded.
+ * @param{size_t} length: number of bytes to decode at most, at least 1.
+ *
+ * @return{size_t}: the number of bytes decoded, less than 'length' if the
+ *                  piece ends before.
+ */
+size_t codecDecodeTree(const int16_t (*nodes)[2], int16_t root, const unsigned char *payload, size_t size, int16_t *node, unsigned char *out, size_t length);
+
+/**
+ * @function codecDecodeTreeBlock
+ * @brief Decodes a whole block with a flattened tree (@see @function
+ * codecDecodeTree).
+ *
+ * @param{const int16_t(*)[2]} nodes: the nodes of the tree.
+ * @param{int16_t} root: the root, a leaf if the tree has a single byte (which
+ *                       has an empty prefix).
+ * @param{const unsigned char*} payload: the payload.
+ * @param{size_t} size: size of the payload.
+ * @param{unsigned char*} out: the block.
+ * @param{size_t} length: size of the block.
+ *
+ * @return{size_t}: 'length', SIZE_MAX if the payload is too short.
+ */
+size_t codecDecodeTreeBlock(const int16_t (*nodes)[2], int16_t root, const unsigned char *payload, size_t size, unsigned char *out, size_t length);
+
+/**
+ * @function codecCompressParallel
+ * @brief Writes data as a ".hfm" file, its blocks coded by the tasks of a
+ * scheduler (@see @function codecCompress).
+ *
+ * The ".hfm" file is the same as the one of codecCompress. It can be called by
+ * a task of the scheduler, which runs other tasks while it waits.
+ *
+ * @param{struct scheduler*} scheduler: the scheduler (NULL, or a few blocks,
+ *                                      to code the data alone).
+ * @param{csc} scratch: scratch space of the coding alone (can be NULL).
+ * @param{const unsigned char*} data: the data.
+ * @param{size_t} size: size of the data.
+ * @param{const size_t*} key: occurrences of the 256 byte values giving the
+ *                            codes, NULL to put the code table in the header.
+ * @param{unsigned int} checksums: HFM_CONTAINER_BLOCK_CRC and/or
+ *                                 HFM_CONTAINER_STREAM_CRC, 0 for none.
+ * @param{unsigned char*} out: the output.
+ * @param{size_t} capacity: size of the output.
+ * @param{size_t*} outSize: receives the size of the ".hfm" file, even when the
+ *                          output is too small.
+ *
+ * @return{int}: HFM_OK, HFM_ERROR_OVERFLOW if the output is too small, or
+ *               another error code.
+ */
+int codecCompressParallel(struct scheduler *scheduler, csc scratch, const unsigned char *data, size_t size, const size_t *key, unsigned int checksums, unsigned char *out, size_t capacity, size_t *outSize);
+
+/**
+ * @function codecDecompressParallel
+ * @brief Decodes a ".hfm" file kept in memory, its blocks decoded by the tasks
+ * of a scheduler (@see @function codecDecompress).
+ *
+ * The error returned is the one of the first block in error, as with
+ * codecDecompress, but the blocks after it may have been written. A file with
+ * table blocks is decoded alone, in order.
+ *
+ * @param{struct scheduler*} scheduler: the scheduler (NULL to decode alone).
+ * @param{csc} scratch: scratch space of the decoding alone (can be NULL).
+ * @param{const unsigned char*} data: the ".hfm" file.
+ * @param{size_t} size: size of the ".hfm" file.
+ * @param{const size_t*} key: occurrences of the 256 byte values, used if the
+ *                            file has no code table (can be NULL).
+ * @param{unsigned char*} out: the output.
+ * @param{size_t} capacity: size of the output.
+ * @param{size_t*} outSize: receives the size of the original data, even when
+ *                          the output is too small.
+ *
+ * @return{int}: HFM_OK, HFM_ERROR_OVERFLOW if the output is too small, or
+ *               another error code.
+ */
+int codecDecompressParallel(struct scheduler *scheduler, csc scratch, const unsigned char *data, size_t size, const size_t *key, unsigned char *out, size_t capacity, size_t *outSize);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+/* ========================================================================== */
+/* ========================================================================== */
@@ -0,0 +1,455 @@
+/**
+ * @file container.h
+ * @author agent <agent@local>
+ * @standard C99
+ * @version 1.0
+ * @date 18th October 2026
+ *
+ * @brief Header file for the container of the ".hfm" files.
+ *
+ * A ".hfm" file is self-contained: it starts with a header of
+ * HFM_CONTAINER_HEADER_SIZE bytes (little endian integers):
+ *  - the magic "HFMC" (4 bytes), the version (1 byte), the flags (1 byte) and
+ *    2 reserved bytes
+ *  - the size of the original file (8 bytes)
+ *  - the number of blocks (8 bytes)
+ *  - the offset of the block index from the start of the header (8 bytes),
+ *    the same as in the file unless the container is stored inside another
+ *    file (@see @file archive.h)
+ *
+ * If the flag HFM_CONTAINER_TABLE is set, the header is followed by the code
+ * table: the occurrences of the 256 byte values, written as in a histogram file
+ * (@see @file histogram.h). Otherwise the occurrences are in a separate key
+ * file. The blocks come next (@see HFM_BLOCK_SIZE), and the block index ends
+ * the file: for each block, its size in the file (block header included) and
+ * its original size (4 bytes each).
+ *
+ * The checksums are optional. With the flag HFM_CONTAINER_BLOCK_CRC, each entry
+ * of the index also has the CRC32C of the original block (4 bytes). With the
+ * flag HFM_CONTAINER_STREAM_CRC, the CRC32C of the whole original file follows
+ * the index (4 bytes). @see @file crc32c.h
+ *
+ * The index is written after the blocks, so that the file is written in one
+ * pass and blocks can be appended, and the header gives its offset.
+ *
+ * Since the version 2, a file can have table blocks (@see HFM_BLOCK_TABLE),
+ * which change the code table of the blocks following them, so that data
+ * appended or files joined keep their own tables. A table block has an
+ * original size of 0 and a payload of at least 1 byte, which tells it apart in
+ * the index. A file without table block is written with the version 1.
+ *
+ * Reading the header and the index is enough to describe a file without
+ * decoding it, and to find the block holding any byte of the original file.
+ *
+ * Overview about the container structure functions:
+ *  - createContainer
+ *  - destroyContainer
+ *  - getContainerVersion
+ *  - hasContainerTable
+ *  - getContainerHistogram
+ *  - getContainerOriginalSize
+ *  - getContainerNbBlocks
+ *  - getContainerBlockStoredSize
+ *  - getContainerBlockLength
+ *  - getContainerFirstBlockOffset
+ *  - getContainerIndexOffset
+ *  - getContainerChecksums
+ *  - getContainerBlockChecksum
+ *  - getContainerChecksum
+ *  - setContainerChecksum
+ *  - getContainerBlockOffset
+ *  - getContainerBlockStart
+ *  - findContainerBlock
+ *  - isContainerTableBlock
+ *
+ * Overview about public functions of container:
+ *  - writeContainerHeader
+ *  - addContainerBlock
+ *  - appendContainer
+ *  - restoreContainerBlock
+ *  - finishContainer
+ *  - readContainer
+ *  - readContainerHeader
+ */
+
+/* ========================================================= */
+/* ================ CONTAINER_H FILE HEADER ================ */
+/* ========================================================================== */
+
+#ifndef CONTAINER_H
+#define CONTAINER_H
+
+/* ============ Includes =========== */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include "utils.h" /**< Contains useful tool functions  */
+#include "histogram.h" /**< Contains the histograms of files  */
+#include "crc32c.h" /**< Contains the checksums  */
+
+/* ============ Defines ============ */
+
+/**
+ * Size of the blocks the input file is split into. Every block of a ".hfm"
+ * file starts with a header of HFM_BLOCK_HEADER_SIZE bytes: the block type,
+ * the size of its payload and the size of the original block (4 bytes each,
+ * little endian). The decoder reads exactly the original size, so no end
+ * character is coded and the 256 byte values can be encrypted.
+ */
+#define HFM_BLOCK_SIZE 65536
+#define HFM_BLOCK_HEADER_SIZE 9
+#define HFM_BLOCK_STORED 'S' /**< Payload is the raw block, copied as is */
+#define HFM_BLOCK_HUFFMAN 'H' /**< Payload is the huffman coded block */
+#define HFM_BLOCK_TABLE 'T' /**< Payload is a code table, original size 0 */
+#define HFM_TABLE_KEY 0 /**< Table block: back to the table of the header or the key */
+#define HFM_TABLE_HISTOGRAM 1 /**< Table block: a histogram follows */
+
+#define HFM_CONTAINER_MAGIC "HFMC" /**< First bytes of a ".hfm" file */
+#define HFM_CONTAINER_VERSION 2 /**< Last version of the ".hfm" files */
+#define HFM_CONTAINER_HEADER_SIZE 32 /**< Size of the fixed part of the header */
+#define HFM_CONTAINER_TABLE 0x01 /**< Flag: the code table is in the header */
+#define HFM_CONTAINER_BLOCK_CRC 0x02 /**< Flag: the index has the CRC32C of each block */
+#define HFM_CONTAINER_STREAM_CRC 0x04 /**< Flag: the CRC32C of the file follows the index */
+#define HFM_CONTAINER_CHECKSUMS (HFM_CONTAINER_BLOCK_CRC | HFM_CONTAINER_STREAM_CRC) /**< Both checksums */
+#define HFM_INDEX_ENTRY_SIZE 8 /**< Size of an entry of the block index */
+#define HFM_INDEX_CRC_SIZE 4 /**< Size of a checksum */
+
+/* ============= Struct ============ */
+
+/**
+ * @typedef ctn
+ * @brief Definition of ctn, a pointer of the structure container.
+ *
+ * The struct container is said existing, but truly implemented in the file
+ * "container.c". It describes the header and the block index of a ".hfm" file.
+ */
+typedef struct container* ctn;
+
+/* ======== Struct functions ======= */
+
+/**
+ * @function createContainer
+ * @brief Creates the description of a ".hfm" file to write.
+ *
+ * @param{size_t*} histogram: occurrences of the 256 byte values written as code
+ *                            table in the header, NULL for a separate key file.
+ * @param{unsigned int} checksums: HFM_CONTAINER_BLOCK_CRC and/or
+ *                                 HFM_CONTAINER_STREAM_CRC, 0 for none.
+ *
+ * @return{ctn}: the new container, without blocks, NULL if memory can't be
+ *               allocated.
+ */
+ctn createContainer(size_t *histogram, unsigned int checksums);
+
+/**
+ * @function destroyContainer
+ * @brief Frees a container and sets its pointer to NULL.
+ *
+ * @param{ctn*} container: pointer of the container.
+ *
+ * @return{void}
+ */
+void destroyContainer(ctn *container);
+
+/**
+ * @function getContainerVersion
+ * @brief Getter of the version of the format.
+ *
+ * @param{ctn} container: the container.
+ *
+ * @return{unsigned int}: the version.
+ */
+unsigned int getContainerVersion(ctn container);
+
+/**
+ * @function hasContainerTable
+ * @brief Tells if the code table is in the header.
+ *
+ * @param{ctn} container: the container.
+ *
+ * @return{int}: 1 if the table is in the header, 0 if a key file is needed.
+ */
+int hasContainerTable(ctn container);
+
+/**
+ * @function getContainerHistogram
+ * @brief Getter of the code table (occurrences of the 256 byte values).
+ *
+ * @param{ctn} container: the container.
+ *
+ * @return{size_t*}: the 256 occurrences, NULL if the table is not in the header.
+ */
+size_t* getContainerHistogram(ctn container);
+
+/**
+ * @function getContainerOriginalSize
+ * @brief Getter of the size of the original file.
+ *
+ * @param{ctn} container: the container.
+ *
+ * @return{long long}: the size in bytes.
+ */
+long long getContainerOriginalSize(ctn container);
+
+/**
+ * @function getContainerNbBlocks
+ * @brief Getter of the number of blocks.
+ *
+ * @param{ctn} container: the container.
+ *
+ * @return{size_t}: the number of blocks.
+ */
+size_t getContainerNbBlocks(ctn container);
+
+/**
+ * @function getContainerBlockStoredSize
+ * @brief Getter of the size of a block in the ".hfm" file.
+ *
+ * @param{ctn} container: the container.
+ * @param{size_t} index: index of the block.
+ *
+ * @return{size_t}: the size in bytes, block header included.
+ */
+size_t getContainerBlockStoredSize(ctn container, size_t index);
+
+/**
+ * @function getContainerBlockLength
+ * @brief Getter of the size of a block in the original file.
+ *
+ * @param{ctn} container: the container.
+ * @param{size_t} index: index of the block.
+ *
+ * @return{size_t}: the size in bytes.
+ */
+size_t getContainerBlockLength(ctn container, size_t index);
+
+/**
+ * @function getContainerFirstBlockOffset
+ * @brief Getter of the offset of the first block in the ".hfm" file.
+ *
+ * @param{ctn} container: the container.
+ *
+ * @return{long long}: the offset in bytes.
+ */
+long long getContainerFirstBlockOffset(ctn container);
+
+/**
+ * @function getContainerIndexOffset
+ * @brief Getter of the offset of the block index in the ".hfm" file.
+ *
+ * @param{ctn} container: the container.
+ *
+ * @return{long long}: the offset in bytes.
+ */
+long long getContainerIndexOffset(ctn container);
+
+/**
+ * @function getContainerChecksums
+ * @brief Getter of the checksums of the file.
+ *
+ * @param{ctn} container: the container.
+ *
+ * @return{unsigned int}: HFM_CONTAINER_BLOCK_CRC and/or HFM_CONTAINER_STREAM_CRC,
+ *                        0 if the file has no checksum.
+ */
+unsigned int getContainerChecksums(ctn container);
+
+/**
+ * @function getContainerBlockChecksum
+ * @brief Getter of the CRC32C of a block of the original file.
+ *
+ * @param{ctn} container: the container, with HFM_CONTAINER_BLOCK_CRC.
+ * @param{size_t} index: index of the block.
+ *
+ * @return{uint32_t}: the checksum.
+ */
+uint32_t getContainerBlockChecksum(ctn container, size_t index);
+
+/**
+ * @function getContainerChecksum
+ * @brief Getter of the CRC32C of the whole original file.
+ *
+ * While writing, it is the checksum of the blocks added so far.
+ *
+ * @param{ctn} container: the container, with HFM_CONTAINER_STREAM_CRC.
+ *
+ * @return{uint32_t}: the checksum.
+ */
+uint32_t getContainerChecksum(ctn container);
+
+/**
+ * @function setContainerChecksum
+ * @brief Setter of the CRC32C of the blocks added so far.
+ *
+ * @param{ctn} container: the container, with HFM_CONTAINER_STREAM_CRC.
+ * @param{uint32_t} checksum: the checksum.
+ *
+ * @return{void}
+ */
+void setContainerChecksum(ctn container, uint32_t checksum);
+
+/**
+ * @function getContainerBlockOffset
+ * @brief Getter of the offset of a block in the ".hfm" file.
+ *
+ * @param{ctn} container: the container.
+ * @param{size_t} index: index of the block.
+ *
+ * @return{long long}: the offset in bytes of the block header.
+ */
+long long getContainerBlockOffset(ctn container, size_t index);
+
+/**
+ * @function getContainerBlockStart
+ * @brief Getter of the offset of a block in the original file.
+ *
+ * @param{ctn} container: the container.
+ * @param{size_t} index: index of the block.
+ *
+ * @return{long long}: the offset in bytes of the first byte of the block.
+ */
+long long getContainerBlockStart(ctn container, size_t index);
+
+/**
+ * @function findContainerBlock
+ * @brief Finds the block holding a byte of the original file.
+ *
+ * @param{ctn} container: the container.
+ * @param{long long} position: offset of the byte in the original file.
+ *
+ * @return{size_t}: index of the block, SIZE_MAX if the position is out of the
+ *                  original file.
+ */
+size_t findContainerBlock(ctn container, long long position);
+
+/**
+ * @function isContainerTableBlock
+ * @brief Tells if a block is a table block.
+ *
+ * @param{ctn} container: the container.
+ * @param{size_t} index: index of the block.
+ *
+ * @return{int}: 1 if the block gives a code table, 0 if it holds data.
+ */
+int isContainerTableBlock(ctn container, size_t index);
+
+/* =========== Functions =========== */
+
+/**
+ * @function writeContainerHeader
+ * @brief Writes the header (and the code table) at the current position.
+ *
+ * The sizes and the offset of the index are written as 0, they are filled by
+ * finishContainer.
+ *
+ * @param{ctn} container: the container.
+ * @param{FILE*} file: the file already opened, in which it is possible to seek.
+ *
+ * @return{int}: 0 if the header has been written, -1 otherwise.
+ */
+int writeContainerHeader(ctn container, FILE *file);
+
+/**
+ * @function addContainerBlock
+ * @brief Adds a block written in the file to the index.
+ *
+ * The checksums of the container are computed from the original block, which
+ * is not read if the container has no checksum.
+ *
+ * @param{ctn} container: the container.
+ * @param{size_t} storedSize: size of the block in the file, header included.
+ * @param{unsigned char*} block: the original block.
+ * @param{size_t} length: size of the block in the original file.
+ *
+ * @return{int}: 0 if the block has been added, -1 if memory can't be allocated
+ *               (finishContainer then fails).
+ */
+int addContainerBlock(ctn container, size_t storedSize, unsigned char *block, size_t length);
+
+/**
+ * @function appendContainer
+ * @brief Adds the blocks of another file to the index.
+ *
+ * The blocks of the other file must have been copied (without change) just
+ * after the blocks of this one. The checksums of the other file are reused, the
+ * checksum of the whole file being combined without reading the data. If
+ * memory can't be allocated for the index, finishContainer fails.
+ *
+ * @param{ctn} container: the container, with no checksum the other one has
+ *                        not.
+ * @param{ctn} other: the container of the file whose blocks have been copied.
+ *
+ * @return{void}
+ */
+void appendContainer(ctn container, ctn other);
+
+/**
+ * @function restoreContainerBlock
+ * @brief Adds a block already written to the index, without reading it.
+ *
+ * Used to resume the writing of a file (@see @file checkpoint.h): the checksum
+ * of the whole file is not updated, @see @function setContainerChecksum. If
+ * memory can't be allocated for the index, finishContainer fails.
+ *
+ * @param{ctn} container: the container.
+ * @param{size_t} storedSize: size of the block in the file, header included.
+ * @param{size_t} length: size of the block in the original file.
+ * @param{uint32_t} checksum: CRC32C of the block (ignored without
+ *                            HFM_CONTAINER_BLOCK_CRC).
+ *
+ * @return{void}
+ */
+void restoreContainerBlock(ctn container, size_t storedSize, size_t length, uint32_t checksum);
+
+/**
+ * @function finishContainer
+ * @brief Writes the block index and completes the header.
+ *
+ * The index is written at the current position (just after the last block),
+ * then the header written by writeContainerHeader (or read by readContainer,
+ * to append blocks) is completed. The file is left positioned at its end.
+ *
+ * @param{ctn} container: the container.
+ * @param{FILE*} file: the file already opened.
+ *
+ * @return{int}: 0 if the index has been written, -1 otherwise (also when a
+ *               block couldn't be added to the index).
+ */
+int finishContainer(ctn container, FILE *file);
+
+/**
+ * @function readContainer
+ * @brief Reads the header and the block index of a ".hfm" file.
+ *
+ * The header is read at the current position of the file, and the file is
+ * left positioned at the first block. Nothing is decoded.
+ *
+ * @param{FILE*} file: the file already opened.
+ *
+ * @return{ctn}: the container, NULL if the file is not a valid ".hfm" file
+ *               or memory can't be allocated.
+ */
+ctn readContainer(FILE *file);
+
+/**
+ * @function readContainerHeader
+ * @brief Reads the header of a ".hfm" file whose block index is not written.
+ *
+ * Only the version, the flags and the code table are read: the sizes of the
+ * header are the ones of the last index written, if any. The file is left
+ * positioned at the first block.
+ *
+ * @param{FILE*} file: the file already opened.
+ *
+ * @return{ctn}: the container with no block, NULL if the header is not valid
+ *               or memory can't be allocated.
+ */
+ctn readContainerHeader(FILE *file);
+
+
+#endif
+
+/* ========================================================================== */
+/* ========================================================================== */
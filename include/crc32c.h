@@ -0,0 +1,68 @@
+/**
+ * @file crc32c.h
+ * @author agent <agent@local>
+ * @standard C99
+ * @version 1.0
+ * @date 18th October 2026
+ *
+ * @brief Header file for the CRC32C checksums.
+ *
+ * The CRC32C (Castagnoli polynomial, the one of iSCSI, ext4 and SSE4.2) is used
+ * to check the integrity of the ".hfm" files. It is computed with the crc32
+ * instructions of the processor when they are available (SSE4.2 on x86-64,
+ * CRC extension on ARMv8), and with a slicing-by-8 table otherwise.
+ *
+ * Overview about public functions of crc32c:
+ *  - crc32c
+ *  - crc32cCombine
+ */
+
+/* ========================================================= */
+/* ================= CRC32C_H FILE HEADER ================== */
+/* ========================================================================== */
+
+#ifndef CRC32C_H
+#define CRC32C_H
+
+/* ============ Includes =========== */
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+/* =========== Functions =========== */
+
+/**
+ * @function crc32c
+ * @brief Updates a CRC32C with some data.
+ *
+ * The checksum of data split in several parts is computed by giving to each
+ * call the checksum returned for the previous parts (0 for the first one).
+ *
+ * @param{uint32_t} crc: checksum of the previous data, 0 to start.
+ * @param{const unsigned char*} data: the data.
+ * @param{size_t} size: size of the data.
+ *
+ * @return{uint32_t}: the checksum of the previous data followed by 'data'.
+ */
+uint32_t crc32c(uint32_t crc, const unsigned char *data, size_t size);
+
+/**
+ * @function crc32cCombine
+ * @brief Gives the CRC32C of two data put end to end from their CRC32C.
+ *
+ * The data are not needed, so that files can be joined without reading them.
+ *
+ * @param{uint32_t} crc1: checksum of the first data.
+ * @param{uint32_t} crc2: checksum of the second data.
+ * @param{long long} size2: size of the second data.
+ *
+ * @return{uint32_t}: the checksum of the first data followed by the second.
+ */
+uint32_t crc32cCombine(uint32_t crc1, uint32_t crc2, long long size2);
+
+
+#endif
+
+/* ========================================================================== */
+/* ========================================================================== */
@@ -0,0 +1,276 @@
+/**
+ * @file dedup.h
+ * @author agent <agent@local>
+ * @standard C99
+ * @version 1.0
+ * @date 18th October 2026
+ *
+ * @brief Header file for the deduplication of the chunks of the archives.
+ *
+ * Near-identical files share most of their content, but not at the same
+ * offsets. The files are cut in chunks where their content says so, not every
+ * N bytes, with the rolling gear hash of FastCDC: a byte inserted only changes
+ * the chunk around it, the next chunks are the same. The chunks have between
+ * HFM_DEDUP_MIN_CHUNK and HFM_DEDUP_MAX_CHUNK bytes, HFM_DEDUP_AVG_CHUNK on
+ * average (a stricter mask before the average and a looser one after it keep
+ * the sizes close to it).
+ *
+ * A chunk is recognized by two XXH64 hashes of its content (128 bits) and its
+ * length. Each unique chunk is stored once: the unique chunks are appended to a
+ * pack, and each pack of HFM_DEDUP_PACK_SIZE bytes is coded in a ".hfm"
+ * container, big enough for its code table to be worth it. A file is then the
+ * list of the indexes of its chunks.
+ *
+ * The tables stored in the directory of an archive (little endian integers):
+ *  - the number of packs (8 bytes), then for each pack the offset of its
+ *    container in the archive (8 bytes) and its size (8 bytes)
+ *  - the number of chunks (8 bytes), then for each chunk its pack (4 bytes), its
+ *    offset in the original content of the pack (4 bytes) and its length (4
+ *    bytes)
+ *
+ * A chunk is decoded with a reader on its pack (@see @file reader.h), which
+ * decodes only the blocks of the pack holding it.
+ *
+ * Overview about the dedup structure functions:
+ *  - createDedup
+ *  - destroyDedup
+ *  - getDedupNbChunks
+ *  - getDedupUniqueSize
+ *  - getDedupStoredSize
+ *  - openDedupReader
+ *  - closeDedupReader
+ *
+ * Overview about public functions of dedup:
+ *  - findChunkLength
+ *  - addDedupData
+ *  - flushDedup
+ *  - getDedupTablesSize
+ *  - storeDedupTables
+ *  - loadDedupTables
+ *  - readDedupChunks
+ */
+
+/* ========================================================= */
+/* ================== DEDUP_H FILE HEADER ================== */
+/* ========================================================================== */
+
+#ifndef DEDUP_H
+#define DEDUP_H
+
+/* ============ Includes =========== */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include "huffman.h" /**< Contains the huffman coding of the files  */
+#include "reader.h" /**< Contains the random access to the packs  */
+#include "cache.h" /**< Contains the cache of the packs already coded  */
+
+/* ============ Defines ============ */
+
+#define HFM_DEDUP_MIN_CHUNK 2048 /**< Minimal size of a chunk (but the last one of a file) */
+#define HFM_DEDUP_AVG_CHUNK 8192 /**< Average size of a chunk */
+#define HFM_DEDUP_MAX_CHUNK 65536 /**< Maximal size of a chunk */
+#define HFM_DEDUP_PACK_SIZE (4 << 20) /**< Size of the unique chunks coded together */
+#define HFM_DEDUP_PACK_ENTRY_SIZE 16 /**< Size of a pack in the tables */
+#define HFM_DEDUP_CHUNK_ENTRY_SIZE 12 /**< Size of a chunk in the tables */
+#define HFM_DEDUP_OPEN_PACKS 4 /**< Packs opened at the same time by a reader */
+
+/* ============= Struct ============ */
+
+/**
+ * @typedef ddp
+ * @brief Definition of ddp, a pointer of the structure dedup.
+ *
+ * The struct dedup is said existing, but truly implemented in the file
+ * "dedup.c". It is the table of the unique chunks and their packs, filled by
+ * several threads at the same time when packing, or read from an archive.
+ */
+typedef struct dedup* ddp;
+
+/**
+ * @typedef ddr
+ * @brief Definition of ddr, a pointer of the structure dedupReader.
+ *
+ * The struct dedupReader is said existing, but truly implemented in the file
+ * "dedup.c". It decodes chunks for one thread, with its own readers on the
+ * last packs used.
+ */
+typedef struct dedupReader* ddr;
+
+/* ======== Struct functions ======= */
+
+/**
+ * @function createDedup
+ * @brief Creates an empty table of chunks, writing its packs in an archive.
+ *
+ * @param{FILE*} archive: the archive, where the packs are appended.
+ * @param{pthread_mutex_t*} archiveLock: lock of the writes in the archive.
+ * @param{unsigned int} checksums: checksums written in each pack.
+ * @param{cch} cache: the packs already coded (can be NULL).
+ *
+ * @return{ddp}: the table.
+ */
+ddp createDedup(FILE *archive, pthread_mutex_t *archiveLock, unsigned int checksums, cch cache);
+
+/**
+ * @function destroyDedup
+ * @brief Frees a table of chunks and sets its pointer to NULL.
+ *
+ * @param{ddp*} dedup: pointer on the table (can point on NULL).
+ *
+ * @return{void}
+ */
+void destroyDedup(ddp *dedup);
+
+/**
+ * @function getDedupNbChunks
+ * @brief Getter of the number of unique chunks.
+ *
+ * @param{ddp} dedup: the table.
+ *
+ * @return{size_t}: the number of chunks.
+ */
+size_t getDedupNbChunks(ddp dedup);
+
+/**
+ * @function getDedupUniqueSize
+ * @brief Getter of the size of the unique chunks.
+ *
+ * @param{ddp} dedup: the table.
+ *
+ * @return{long long}: the size in bytes.
+ */
+long long getDedupUniqueSize(ddp dedup);
+
+/**
+ * @function getDedupStoredSize
+ * @brief Getter of the size of the packs written.
+ *
+ * @param{ddp} dedup: the table.
+ *
+ * @return{long long}: the size in bytes.
+ */
+long long getDedupStoredSize(ddp dedup);
+
+/**
+ * @function openDedupReader
+ * @brief Creates a reader of the chunks of an archive, for one thread.
+ *
+ * @param{ddp} dedup: the table, read by loadDedupTables.
+ * @param{char*} fileArchive: name of the archive, opened for each pack read.
+ *
+ * @return{ddr}: the reader.
+ */
+ddr openDedupReader(ddp dedup, char *fileArchive);
+
+/**
+ * @function closeDedupReader
+ * @brief Closes the packs of a reader, frees it and sets its pointer to NULL.
+ *
+ * @param{ddr*} reader: pointer on the reader (can point on NULL).
+ *
+ * @return{void}
+ */
+void closeDedupReader(ddr *reader);
+
+/* =========== Functions =========== */
+
+/**
+ * @function findChunkLength
+ * @brief Finds the end of the first chunk of some data (FastCDC).
+ *
+ * @param{const unsigned char*} data: the data.
+ * @param{size_t} size: size of the data.
+ *
+ * @return{size_t}: the length of the chunk, size if the data is too short to
+ *                  be cut.
+ */
+size_t findChunkLength(const unsigned char *data, size_t size);
+
+/**
+ * @function addDedupData
+ * @brief Cuts data in chunks and adds the new ones to the table.
+ *
+ * The data is cut and hashed without the lock of the table. A pack filled is
+ * coded and written in the archive by the thread which filled it, without the
+ * lock of the table either.
+ *
+ * @param{ddp} dedup: the table.
+ * @param{unsigned char*} data: the data (a file).
+ * @param{size_t} size: size of the data.
+ * @param{uint32_t**} chunks: receives the indexes of the chunks of the data,
+ *                            to free.
+ * @param{size_t*} nbChunks: receives the number of chunks of the data.
+ *
+ * @return{int}: 0 if the chunks have been added, -1 if a pack can't be
+ *               written or the table is full.
+ */
+int addDedupData(ddp dedup, unsigned char *data, size_t size, uint32_t **chunks, size_t *nbChunks);
+
+/**
+ * @function flushDedup
+ * @brief Codes and writes the last pack, once all the data has been added.
+ *
+ * @param{ddp} dedup: the table.
+ *
+ * @return{int}: 0 if all the packs have been written, -1 otherwise.
+ */
+int flushDedup(ddp dedup);
+
+/**
+ * @function getDedupTablesSize
+ * @brief Gives the size of the tables of the packs and the chunks.
+ *
+ * @param{ddp} dedup: the table.
+ *
+ * @return{size_t}: the size in bytes.
+ */
+size_t getDedupTablesSize(ddp dedup);
+
+/**
+ * @function storeDedupTables
+ * @brief Writes the tables of the packs and the chunks in memory.
+ *
+ * @param{ddp} dedup: the table.
+ * @param{unsigned char*} out: the memory, of getDedupTablesSize bytes.
+ *
+ * @return{void}
+ */
+void storeDedupTables(ddp dedup, unsigned char *out);
+
+/**
+ * @function loadDedupTables
+ * @brief Reads and checks the tables of the packs and the chunks.
+ *
+ * @param{unsigned char*} tables: the tables.
+ * @param{size_t} size: number of bytes available.
+ * @param{long long} start: the packs can't start before this offset.
+ * @param{long long} end: the packs can't end after this offset.
+ * @param{size_t*} used: receives the size of the tables.
+ *
+ * @return{ddp}: the table, NULL if the tables are corrupted.
+ */
+ddp loadDedupTables(unsigned char *tables, size_t size, long long start, long long end, size_t *used);
+
+/**
+ * @function readDedupChunks
+ * @brief Decodes chunks and writes them in a file.
+ *
+ * @param{ddr} reader: the reader.
+ * @param{uint32_t*} chunks: indexes of the chunks.
+ * @param{size_t} nbChunks: number of chunks.
+ * @param{FILE*} fileOut: the file written.
+ *
+ * @return{long long}: the number of bytes written, -1 on an error of the
+ *                     files, -2 if a pack is corrupted, -3 if it does not
+ *                     match its checksums.
+ */
+long long readDedupChunks(ddr reader, uint32_t *chunks, size_t nbChunks, FILE *fileOut);
+
+
+#endif
+
+/* ========================================================================== */
+/* ========================================================================== */
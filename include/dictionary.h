@@ -0,0 +1,248 @@
+/**
+ * @file dictionary.h
+ * @author agent <agent@local>
+ * @standard C99
+ * @version 1.0
+ * @date 18th October 2026
+ *
+ * @brief Header file for the struct "dictionary".
+ *
+ * A dictionary is a huffman table trained once on a corpus of sample messages
+ * and saved in a file. Short messages are then encrypted and decrypted with it
+ * without building a tree for each message, and without any key or header in
+ * the encrypted message.
+ *
+ * The dictionary file contains the tables ready to be used: the prefix of each
+ * byte value for the encryption, and the tree flattened in an array for the
+ * decryption. Loading a dictionary maps the file in memory (read only and
+ * shared), so that the processes using the same dictionary share its pages.
+ *
+ * A message can contain any byte, \0 included: its size is not written in the
+ * encrypted message but given back to the decryption (as the size of a record
+ * or of a field is), so the decoding stops after exactly that many bytes and
+ * the bits padding the last byte are never read.
+ *
+ * Overview about public functions of dictionary:
+ *  - trainDictionary
+ *  - loadDictionary
+ *  - destroyDictionary
+ *  - getDictionaryCode
+ *  - getDictionaryLength
+ *  - getDictionaryNode
+ *  - getDictionaryNbNodes
+ *  - dictionaryEncryptBound
+ *  - dictionaryEncrypt
+ *  - dictionaryDecrypt
+ *  - flattenTree
+ */
+
+/* ========================================================= */
+/* =============== DICTIONARY_H FILE HEADER ================ */
+/* ========================================================================== */
+
+#ifndef DICTIONARY_H
+#define DICTIONARY_H
+
+/* ============ Includes =========== */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include "utils.h" /**< Contains useful tool functions  */
+#include "tuple.h" /**< Contains struct tuple and its functions  */
+#include "node.h" /**< Contains struct node and its functions  */
+
+/* ============ Defines ============ */
+
+#define HFM_DICTIONARY_MAGIC "HFMD" /**< First bytes of a dictionary file */
+#define HFM_DICTIONARY_VERSION 2 /**< Version of the dictionary files written */
+#define HFM_DICTIONARY_MAX_LENGTH 32 /**< Maximal size of a prefix */
+
+/* ============= Struct ============ */
+
+/**
+ * @typedef dct
+ * @brief Definition of dct, a pointer of the structure dictionary.
+ *
+ * The struct dictionary is said existing, but truly implemented in the file
+ * "dictionary.c". The idea is to make a structure with unknown members so that
+ * the structure is manipulated only by the functions detailed here.
+ */
+typedef struct dictionary* dct;
+
+/* ======== Struct functions ======= */
+
+/**
+ * @function trainDictionary
+ * @brief Trains a dictionary on a corpus and saves it in a file.
+ *
+ * Counts the occurrences of the bytes of the files of the corpus, and saves the
+ * tables of the corresponding huffman tree in a dictionary file. Every byte
+ * value gets a prefix, even if the corpus doesn't contain it, and the prefixes
+ * are limited to HFM_DICTIONARY_MAX_LENGTH bits.
+ *
+ * @param{char**} files: names of the files of the corpus.
+ * @param{int} nbFiles: number of files.
+ * @param{char*} fileDict: name of the dictionary file to write.
+ *
+ * @return{int}: 0 if the dictionary has been written, -1 otherwise.
+ */
+int trainDictionary(char **files, int nbFiles, char *fileDict);
+
+/**
+ * @function loadDictionary
+ * @brief Loads a dictionary file.
+ *
+ * Maps a dictionary file in memory. Nothing is built, the tables are used
+ * directly from the mapped file.
+ *
+ * @param{char*} fileDict: name of the dictionary file.
+ *
+ * @return{dct}: pointer of the dictionary, NULL if the file can't be mapped or
+ *               is not a dictionary.
+ */
+dct loadDictionary(char *fileDict);
+
+/**
+ * @function destroyDictionary
+ * @brief Destroys a dictionary.
+ *
+ * Unmaps the file of the dictionary and frees the struct.
+ *
+ * @param{dct*} dict: pointer of the pointer of the dictionary.
+ *
+ * @return{void}
+ */
+void destroyDictionary(dct *dict);
+
+/**
+ * @function getDictionaryCode
+ * @brief Getter of the prefix of a character, in the lowest bits.
+ *
+ * @param{dct} dict: the dictionary.
+ * @param{size_t} index: the character.
+ *
+ * @return{uint32_t}: the prefix.
+ */
+uint32_t getDictionaryCode(dct dict, size_t index);
+
+/**
+ * @function getDictionaryLength
+ * @brief Getter of the size of the prefix of a character.
+ *
+ * @param{dct} dict: the dictionary.
+ * @param{size_t} index: the character.
+ *
+ * @return{uint8_t}: the size of the prefix.
+ */
+uint8_t getDictionaryLength(dct dict, size_t index);
+
+/**
+ * @function getDictionaryNode
+ * @brief Getter of a child of a node of the flattened tree.
+ * @see @function flattenTree
+ *
+ * @param{dct} dict: the dictionary.
+ * @param{size_t} node: index of the node.
+ * @param{int} bit: 0 for the left child, 1 for the right one.
+ *
+ * @return{int16_t}: the child.
+ */
+int16_t getDictionaryNode(dct dict, size_t node, int bit);
+
+/**
+ * @function getDictionaryNbNodes
+ * @brief Getter of the number of nodes of the flattened tree.
+ *
+ * @param{dct} dict: the dictionary.
+ *
+ * @return{uint32_t}: the number of nodes.
+ */
+uint32_t getDictionaryNbNodes(dct dict);
+
+/* =========== Functions =========== */
+
+/**
+ * @function dictionaryEncryptBound
+ * @brief Returns the maximal size of the encryption of a message.
+ *
+ * @param{dct} dict: the dictionary.
+ * @param{size_t} size: size of the message.
+ *
+ * @return{size_t}: size of a buffer big enough to encrypt any message of 'size'
+ *                  bytes.
+ */
+size_t dictionaryEncryptBound(dct dict, size_t size);
+
+/**
+ * @function dictionaryEncrypt
+ * @brief Encrypts a message with a dictionary.
+ *
+ * Writes the prefixes of the bytes of the message in 'out'. If the encryption
+ * needs more than 'outSize' bytes, only the first 'outSize' bytes are written
+ * and the size needed is returned.
+ *
+ * @param{dct} dict: the dictionary.
+ * @param{unsigned char*} message: the message.
+ * @param{size_t} size: size of the message.
+ * @param{unsigned char*} out: buffer receiving the encrypted message.
+ * @param{size_t} outSize: size of the buffer.
+ *
+ * @return{size_t}: size of the encrypted message.
+ */
+size_t dictionaryEncrypt(dct dict,
+                         unsigned char *message,
+                         size_t size,
+                         unsigned char *out,
+                         size_t outSize
+                        );
+
+/**
+ * @function dictionaryDecrypt
+ * @brief Decrypts a message encrypted with a dictionary.
+ *
+ * Decodes the 'length' bytes of the message in 'out'. The encrypted message
+ * must end in its last byte, the bits after the last prefix being the padding.
+ *
+ * @param{dct} dict: the dictionary the message was encrypted with.
+ * @param{unsigned char*} in: the encrypted message.
+ * @param{size_t} size: size of the encrypted message.
+ * @param{unsigned char*} out: buffer of 'length' bytes receiving the message.
+ * @param{size_t} length: size of the original message.
+ *
+ * @return{size_t}: 'length', or SIZE_MAX if the encrypted message is corrupted
+ *                  or is not the one of a message of 'length' bytes.
+ */
+size_t dictionaryDecrypt(dct dict,
+                         unsigned char *in,
+                         size_t size,
+                         unsigned char *out,
+                         size_t length
+                        );
+
+/**
+ * @function flattenTree
+ * @brief Flattens a huffman tree in an array of nodes.
+ *
+ * Each node that is not a leaf gets an index in the array (the root being 0)
+ * and its two children are written at this index. A child greater or equal to 0
+ * is the index of another node, and a negative child c is a leaf of the
+ * character -(c+1).
+ *
+ * A tree of more than 256 leaves (read from a wrong key) does not fit in the
+ * array: its nodes after the 256th are only counted in nbNodes.
+ *
+ * @param{nd} node: a node of the tree.
+ * @param{int16_t(*)[2]} nodes: the array of at least 256 nodes.
+ * @param{uint32_t*} nbNodes: number of nodes already in the array, updated.
+ *
+ * @return{int16_t}: the index of the node in the array, or the negative value
+ *                   of the leaf.
+ */
+int16_t flattenTree(nd node, int16_t (*nodes)[2], uint32_t *nbNodes);
+
+
+#endif
+
+/* ========================================================================== */
+/* ========================================================================== */
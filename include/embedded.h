@@ -0,0 +1,141 @@
+/**
+ * @file embedded.h
+ * @author agent <agent@local>
+ * @standard C99
+ * @version 1.0
+ * @date 18th October 2026
+ *
+ * @brief Header file for the code tables embedded at compile time.
+ *
+ * When the same key is used for every file (for example a key built from the
+ * histogram of a whole dataset), its code table can be generated as a C header
+ * with "huffman_exec gen-table KEY > table.h" and compiled in the program with
+ * "make TABLE=table.h". The encoder and the decoder are then specialized for
+ * this table: the prefixes are integers of constant arrays, the tree is a
+ * constant array of nodes, and no key file has to be read or written.
+ *
+ * The files written with an embedded table are the same .hfm files as the ones
+ * written with its key, so each one can be decrypted by the other.
+ *
+ * A generated table defines:
+ *  - HFM_EMBEDDED_NB_NODES: number of nodes of the tree
+ *  - HFM_EMBEDDED_ROOT: 0 if the root is the node 0, the negative value of the
+ *    leaf if the tree is a single character (@see flattenTree)
+ *  - HFM_EMBEDDED_CODES[256]: prefix of each character in the lowest bits
+ *  - HFM_EMBEDDED_LENGTHS[256]: size of each prefix
+ *  - HFM_EMBEDDED_HAS_CODE[256]: 1 if the character has a prefix, 0 otherwise
+ *  - HFM_EMBEDDED_NODES[256][2]: the tree flattened by flattenTree
+ *
+ * Overview about public functions of embedded:
+ *  - generateEmbeddedTable
+ *  - hasEmbeddedTable
+ *  - embeddedEncodeBlock (only with HFM_EMBEDDED_TABLE)
+ *  - embeddedDecodeBlock (only with HFM_EMBEDDED_TABLE)
+ *  - huffmanEncryptFileEmbedded (only with HFM_EMBEDDED_TABLE)
+ *  - huffmanDecryptFileEmbedded (only with HFM_EMBEDDED_TABLE)
+ */
+
+/* ========================================================= */
+/* ================= EMBEDDED_H FILE HEADER ================ */
+/* ========================================================================== */
+
+#ifndef EMBEDDED_H
+#define EMBEDDED_H
+
+/* ============ Includes =========== */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include "huffman.h" /**< Contains the huffman coding of the files  */
+
+/* ============ Defines ============ */
+
+#define HFM_EMBEDDED_MAX_LENGTH 56 /**< Maximal size of an embedded prefix */
+
+/* =========== Functions =========== */
+
+/**
+ * @function generateEmbeddedTable
+ * @brief Writes the code table of a key or a dictionary as a C header.
+ *
+ * @param{char*} fileKey: name of the key file or of the dictionary file.
+ * @param{FILE*} fileOut: the file already opened where the header is written.
+ *
+ * @return{int}: 0 if the table has been written, -1 if the key can't be read,
+ *               has a prefix longer than HFM_EMBEDDED_MAX_LENGTH bits or memory
+ *               can't be allocated.
+ */
+int generateEmbeddedTable(char *fileKey, FILE *fileOut);
+
+/**
+ * @function hasEmbeddedTable
+ * @brief Tells if a code table has been compiled in the program.
+ *
+ * @return{int}: 1 if the program has been built with a table, 0 otherwise.
+ */
+int hasEmbeddedTable();
+
+#ifdef HFM_EMBEDDED_TABLE
+
+/**
+ * @function embeddedEncodeBlock
+ * @brief Codes a block with the embedded table, if it makes it smaller.
+ * @see @function encryptBlocksOfFile
+ *
+ * @param{unsigned char*} block: the block to code.
+ * @param{size_t} size: size of the block.
+ * @param{unsigned char*} out: buffer of HFM_BLOCK_SIZE bytes for the payload.
+ * @param{void*} context: unused.
+ *
+ * @return{size_t}: size of the payload, SIZE_MAX if the block has to be stored.
+ */
+size_t embeddedEncodeBlock(unsigned char *block, size_t size, unsigned char *out, void *context);
+
+/**
+ * @function embeddedDecodeBlock
+ * @brief Decodes a block with the embedded table.
+ * @see @function decryptBlocksOfFile
+ *
+ * @param{unsigned char*} payload: the payload of the block.
+ * @param{size_t} size: size of the payload.
+ * @param{unsigned char*} out: buffer of HFM_BLOCK_SIZE bytes for the block.
+ * @param{size_t} length: size of the block.
+ * @param{void*} context: unused.
+ *
+ * @return{size_t}: 'length', SIZE_MAX if the payload is corrupted.
+ */
+size_t embeddedDecodeBlock(unsigned char *payload, size_t size, unsigned char *out, size_t length, void *context);
+
+/**
+ * @function huffmanEncryptFileEmbedded
+ * @brief Encrypts a file with the embedded table.
+ *
+ * @param{char*} fileIn: name of the file we want to encrypt.
+ * @param{char*} fileOut: name of the file to write.
+ * @param{unsigned int} checksums: checksums to write (@see @function
+ *                                 encryptBlocksOfFile).
+ *
+ * @return{int}: 0 if the file has been encrypted, -1 otherwise.
+ */
+int huffmanEncryptFileEmbedded(char *fileIn, char *fileOut, unsigned int checksums);
+
+/**
+ * @function huffmanDecryptFileEmbedded
+ * @brief Decrypts a file with the embedded table.
+ *
+ * @param{char*} fileIn: name of the file we want to decrypt.
+ * @param{char*} fileOut: name of the file to write.
+ *
+ * @return{int}: 0 if the file has been decrypted, -1 if a file can't be opened,
+ *               -2 if the file is corrupted, -3 if a checksum does not match.
+ */
+int huffmanDecryptFileEmbedded(char *fileIn, char *fileOut);
+
+#endif
+
+
+#endif
+
+/* ========================================================================== */
+/* ========================================================================== */
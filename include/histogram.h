@@ -0,0 +1,142 @@
+/**
+ * @file histogram.h
+ * @author agent <agent@local>
+ * @standard C99
+ * @version 1.0
+ * @date 18th October 2026
+ *
+ * @brief Header file for the histograms of files.
+ *
+ * A histogram is an array of 256 counters, the occurrences of each byte value
+ * in some data. Histograms can be saved in a compact file, and the histograms
+ * of several files (for example the shards of a dataset encrypted on different
+ * machines) can be merged so that all the shards are encrypted with the same
+ * key.
+ *
+ * A histogram file is made of the magic "HFMH", a version byte, and the 256
+ * counters written as variable length integers (7 bits per byte, the high bit
+ * telling if another byte follows).
+ *
+ * Overview about public functions of histogram:
+ *  - histogramOfFile
+ *  - saveHistogramInFile
+ *  - loadHistogramFromFile
+ *  - mergeHistogramFiles
+ *  - writeHistogramInOpenedFile
+ *  - readHistogramFromOpenedFile
+ *  - histogramEncodedSize
+ */
+
+/* ========================================================= */
+/* ================ HISTOGRAM_H FILE HEADER ================ */
+/* ========================================================================== */
+
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+/* ============ Includes =========== */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "utils.h" /**< Contains useful tool functions  */
+
+/* ============ Defines ============ */
+
+#define HFM_HISTOGRAM_MAGIC "HFMH" /**< First bytes of a histogram file */
+#define HFM_HISTOGRAM_VERSION 1 /**< Version of the histogram files written */
+
+/* =========== Functions =========== */
+
+/**
+ * @function histogramOfFile
+ * @brief Adds the occurrences of the bytes of a file to a histogram.
+ *
+ * Reads a file and adds the occurrences of each byte value to the histogram.
+ * The histogram is not reset, so that several files can be counted in the same
+ * histogram.
+ *
+ * @param{char*} srcFile: name of the file.
+ * @param{size_t*} histogram: the 256 counters to increment.
+ *
+ * @return{int}: 0 if the file has been read, -1 otherwise.
+ */
+int histogramOfFile(char *srcFile, size_t *histogram);
+
+/**
+ * @function saveHistogramInFile
+ * @brief Saves a histogram in a file.
+ *
+ * @param{size_t*} histogram: the 256 counters to save.
+ * @param{char*} fileHist: name of the file to write.
+ *
+ * @return{int}: 0 if the file has been written, -1 otherwise.
+ */
+int saveHistogramInFile(size_t *histogram, char *fileHist);
+
+/**
+ * @function loadHistogramFromFile
+ * @brief Adds the counters saved in a histogram file to a histogram.
+ *
+ * The histogram is not reset, loading several files in the same histogram
+ * merges them.
+ *
+ * @param{char*} fileHist: name of the histogram file.
+ * @param{size_t*} histogram: the 256 counters to increment.
+ *
+ * @return{int}: 0 if the file has been read, -1 if it can't be read or is not
+ *               a histogram file.
+ */
+int loadHistogramFromFile(char *fileHist, size_t *histogram);
+
+/**
+ * @function mergeHistogramFiles
+ * @brief Merges histogram files in a new one.
+ *
+ * @param{char**} filesHist: names of the histogram files to merge.
+ * @param{int} nbFiles: number of files to merge.
+ * @param{char*} fileOut: name of the histogram file to write.
+ *
+ * @return{int}: 0 if the files have been merged, -1 otherwise.
+ */
+int mergeHistogramFiles(char **filesHist, int nbFiles, char *fileOut);
+
+/**
+ * @function writeHistogramInOpenedFile
+ * @brief Writes the 256 counters of a histogram, without magic nor version.
+ *
+ * @param{FILE*} file: the file already opened.
+ * @param{size_t*} histogram: the 256 counters to write.
+ *
+ * @return{void}
+ */
+void writeHistogramInOpenedFile(FILE *file, size_t *histogram);
+
+/**
+ * @function readHistogramFromOpenedFile
+ * @brief Reads the counters written by writeHistogramInOpenedFile.
+ *
+ * The counters read are added to the histogram.
+ *
+ * @param{FILE*} file: the file already opened.
+ * @param{size_t*} histogram: the 256 counters to increment.
+ *
+ * @return{int}: 0 if the counters have been read, -1 otherwise.
+ */
+int readHistogramFromOpenedFile(FILE *file, size_t *histogram);
+
+/**
+ * @function histogramEncodedSize
+ * @brief Returns the number of bytes written by writeHistogramInOpenedFile.
+ *
+ * @param{size_t*} histogram: the 256 counters.
+ *
+ * @return{size_t}: the size in bytes.
+ */
+size_t histogramEncodedSize(size_t *histogram);
+
+
+#endif
+
+/* ========================================================================== */
+/* ========================================================================== */
@@ -24,18 +24,42 @@
  * Overview about public functions of the file huffman:
  *    - huffmanEncrypt
  *    - huffmanEncryptFile
+ *    - huffmanEncryptFileSampled
+ *    - huffmanEncryptFileWithKey
+ *    - huffmanResumeEncryptFile
+ *    - huffmanKeyFromHistogramFile
  *    - huffmanDecrypt
  *    - huffmanDecryptStr
  *    - huffmanDecryptFile
+ *    - huffmanResumeDecryptFile
  *    - getEncryptionOf
  *    - makeCharactersFromBits
  *    - writeEncryptionInFile
+ *    - encryptBlocksOfFile
+ *    - resumeEncryptBlocksOfFile
+ *    - writeBlockOfOpenedFile
+ *    - encryptBufferInOpenedFile
+ *    - encryptBufferInMemory
+ *    - encryptBufferWithCodesInMemory
+ *    - decryptBufferInMemory
  *    - saveKeyInFile
  *    - getDecryptionOf
  *    - writeDecryptionInFile
+ *    - decryptBlocksOfFile
+ *    - resumeDecryptBlocksOfFile
+ *    - decryptBlocksOfOpenedFile
+ *    - readBlockOfOpenedFile
+ *    - writeTableBlockOfOpenedFile
+ *    - readTableBlockOfOpenedFile
  *    - getTreeFromKeyFile
+ *    - getHistogramFromKeyFile
+ *    - getTreeFromContainer
+ *    - getTreeFromHistogram
  *    - charOccurrencesOfStr
  *    - charOccurrencesOfFile
+ *    - charOccurrencesOfFileSampled
+ *    - occurrencesFromHistogram
+ *    - histogramOfOccurrences
  *    - contructBinaryTree
  *    - mergeTwoSmallerNodes
  *    - mergeNodes
@@ -44,6 +68,14 @@
  *    - getTupleInListByKey
  *    - weightNode
  *    - writeBitsInOpenedFile
+ *    - prefixesTable
+ *    - estimateCodedSize
+ *    - encodeBlock
+ *    - decodeBlock
+ *    - encodeBlockWithCodes
+ *    - decodeBlockWithTree
+ *    - copyStoredBlock
+ *    - estimateEncryptionOfFile
  */
 
 /* ========================================================= */
@@ -58,10 +90,24 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <stdint.h>
 #include "utils.h" /**< Contains useful tool functions  */
 #include "tuple.h" /**< Contains struct tuple and its functions  */
 #include "list.h" /**< Contains struct list and its functions  */
 #include "node.h" /**< Contains struct node and its functions  */
+#include "histogram.h" /**< Contains the histograms of files  */
+#include "dictionary.h" /**< Contains the trained dictionaries  */
+#include "container.h" /**< Contains the header of the ".hfm" files  */
+#include "checkpoint.h" /**< Contains the checkpoints of the long jobs  */
+#include "pipeline.h" /**< Contains the pipeline reading, coding and writing blocks  */
+#include "codec.h" /**< Contains the reentrant core coding in memory  */
+
+/* ============ Defines ============ */
+
+/**
+ * Size of the chunks read to build the occurrences from a sample of a file.
+ */
+#define HFM_SAMPLE_CHUNK 65536
 
 /* ============= Struct ============ */
 
@@ -84,7 +130,8 @@ typedef struct huffman* hfm;
  * This function creates a new struct huffman, sets its members to NULL and returns
  * a pointer on that struct.
  *
- * @return{hfm}: pointer of the new huffman structure.
+ * @return{hfm}: pointer of the new huffman structure, NULL if memory can't be
+ *               allocated.
  */
 hfm createHuffman();
 
@@ -98,7 +145,8 @@ hfm createHuffman();
  * @param{char*} str: the encrypted string.
  * @param{nd} tree: the tree.
  *
- * @return{hfm}: pointer of the new huffman structure.
+ * @return{hfm}: pointer of the new huffman structure, NULL if memory can't be
+ *               allocated.
  */
 hfm createDefinedHuffman(char *str, nd tree);
 
@@ -172,7 +220,8 @@ void destroyHuffman(hfm *huffman);
  *
  * @param{char*} str: string of characters to encrypt.
  *
- * @return{hfm}: encrypted string.
+ * @return{hfm}: encrypted string, NULL if str is NULL or memory can't be
+ *               allocated.
  */
 hfm huffmanEncrypt(char *str);
 
@@ -180,15 +229,101 @@ hfm huffmanEncrypt(char *str);
  * @function huffmanEncryptFile
  * @brief Encrypts a file.
  *
- * This function encrypts a file by using the huffman coding.
+ * This function encrypts a file by using the huffman coding. The code table is
+ * written in the header of the ".hfm" file, unless a key file is given.
  *
  * @param{char*} fileIn: name of the file we want to encrypt.
  * @param{char*} fileOut: name of the file to write.
- * @param{char*} fileKey: name of the file to write the key in.
+ * @param{char*} fileKey: name of the file to write the key in, NULL to write
+ *                        the code table in fileOut.
  *
- * @return{void}
+ * @return{int}: 0 if the file has been encrypted, -1 otherwise.
+ */
+int huffmanEncryptFile(char *fileIn, char *fileOut, char *fileKey);
+
+/**
+ * @function huffmanEncryptFileSampled
+ * @brief Encrypts a file with a tree built from a sample of it.
+ * @see @function charOccurrencesOfFileSampled
+ *
+ * This function encrypts a file like huffmanEncryptFile, but the occurrences
+ * used to build the tree are taken from a sample of the file, so that the file
+ * is not read entirely twice.
+ *
+ * If the coding doesn't make the file smaller, every block is stored: the
+ * header then has no code table, and the key file is empty.
+ *
+ * The encryption of a file of more than HFM_CHECKPOINT_BLOCKS blocks writes
+ * checkpoints, @see @function huffmanResumeEncryptFile.
+ *
+ * @param{char*} fileIn: name of the file we want to encrypt.
+ * @param{char*} fileOut: name of the file to write.
+ * @param{char*} fileKey: name of the file to write the key in, NULL to write
+ *                        the code table in fileOut.
+ * @param{double} samplingRate: part of the file read to build the tree (1 reads
+ *                              the whole file).
+ * @param{unsigned int} checksums: HFM_CONTAINER_BLOCK_CRC and/or
+ *                                 HFM_CONTAINER_STREAM_CRC to write checksums,
+ *                                 0 for none.
+ *
+ * @return{int}: 0 if the file has been encrypted, -1 otherwise.
+ */
+int huffmanEncryptFileSampled(char *fileIn,
+                              char *fileOut,
+                              char *fileKey,
+                              double samplingRate,
+                              unsigned int checksums
+                             );
+
+/**
+ * @function huffmanEncryptFileWithKey
+ * @brief Encrypts a file with an existing key.
+ *
+ * This function encrypts a file with the tree of a key file already made, for
+ * example from the merged histograms of all the shards of a dataset (@see
+ * @function huffmanKeyFromHistogramFile). The file is read only once, and the
+ * blocks containing characters the key has no prefix for are stored. The code
+ * table is not written in the ".hfm" file, the key is needed to decrypt it.
+ *
+ * @param{char*} fileIn: name of the file we want to encrypt.
+ * @param{char*} fileOut: name of the file to write.
+ * @param{char*} fileKey: name of the key file to use.
+ * @param{unsigned int} checksums: HFM_CONTAINER_BLOCK_CRC and/or
+ *                                 HFM_CONTAINER_STREAM_CRC to write checksums,
+ *                                 0 for none.
+ *
+ * @return{int}: 0 if the file has been encrypted, -1 otherwise.
+ */
+int huffmanEncryptFileWithKey(char *fileIn, char *fileOut, char *fileKey, unsigned int checksums);
+
+/**
+ * @function huffmanResumeEncryptFile
+ * @brief Resumes an interrupted encryption from its last checkpoint.
+ * @see @file checkpoint.h
+ *
+ * The code table is read in the header of fileOut, or in the key file if the
+ * header doesn't contain it, and the blocks written after the last checkpoint
+ * are written again. Without both, the next blocks are stored.
+ *
+ * @param{char*} fileIn: name of the file being encrypted.
+ * @param{char*} fileOut: name of the ".hfm" file being written.
+ * @param{char*} fileKey: name of the key file, only read if fileOut has no code
+ *                        table.
+ *
+ * @return{int}: 0 if the file has been encrypted, -1 otherwise.
+ */
+int huffmanResumeEncryptFile(char *fileIn, char *fileOut, char *fileKey);
+
+/**
+ * @function huffmanKeyFromHistogramFile
+ * @brief Writes the key file corresponding to a histogram file.
+ *
+ * @param{char*} fileHist: name of the histogram file (@see @file histogram.h).
+ * @param{char*} fileKey: name of the key file to write.
+ *
+ * @return{int}: 0 if the key has been written, -1 otherwise.
  */
-void huffmanEncryptFile(char *fileIn, char *fileOut, char *fileKey);
+int huffmanKeyFromHistogramFile(char *fileHist, char *fileKey);
 
 
 /**
@@ -200,7 +335,7 @@ void huffmanEncryptFile(char *fileIn, char *fileOut, char *fileKey);
  *
  * @param{hfm} huffmanEncr: A pointer on the huffman struct.
  *
- * @return{char*}: decrypted string.
+ * @return{char*}: decrypted string, NULL if memory can't be allocated.
  */
 char* huffmanDecrypt(hfm huffmanEncr);
 
@@ -214,7 +349,7 @@ char* huffmanDecrypt(hfm huffmanEncr);
  * @param{char*} str: string of characters to decrypt.
  * @param{nd} tree: the tree needed to decrypt.
  *
- * @return{char*}: decrypted string.
+ * @return{char*}: decrypted string, NULL if memory can't be allocated.
  */
 char* huffmanDecryptStr(char *str, nd tree);
 
@@ -222,29 +357,49 @@ char* huffmanDecryptStr(char *str, nd tree);
  * @function huffmanDecryptFile
  * @brief Decrypts a file.
  *
- * This function decrypts a file by using the huffman coding.
+ * This function decrypts a file by using the huffman coding. The code table is
+ * read in the header of the ".hfm" file, or in the key file if the header
+ * doesn't contain it. A file stored needs neither.
  *
  * @param{char*} fileIn: name of the file we want to decrypt.
  * @param{char*} fileOut: name of the file to write.
- * @param{char*} fileKey: name of the file to write the key in.
+ * @param{char*} fileKey: name of the key file, only read if fileIn has no code
+ *                        table.
+ *
+ * @return{int}: same as decryptBlocksOfFile, -1 if a block is coded with the
+ *               key and it can't be read.
+ */
+int huffmanDecryptFile(char *fileIn, char *fileOut, char *fileKey);
+
+/**
+ * @function huffmanResumeDecryptFile
+ * @brief Resumes an interrupted decryption from its last checkpoint.
+ * @see @file checkpoint.h
+ *
+ * @param{char*} fileIn: name of the file being decrypted.
+ * @param{char*} fileOut: name of the file being written.
+ * @param{char*} fileKey: name of the key file, only read if fileIn has no code
+ *                        table.
  *
- * @return{void}.
+ * @return{int}: same as decryptBlocksOfFile.
  */
-void huffmanDecryptFile(char *fileIn, char *fileOut, char *fileKey);
+int huffmanResumeDecryptFile(char *fileIn, char *fileOut, char *fileKey);
 
 /**
  * @function getEncryptionOf
  * @brief Returns the encryption in its bit form.
  *
  * Returns the encryption in its bit form, that is the sequence of prefixes
- * corresponding for each character of the string passed as parameter.
+ * corresponding for each character of the string passed as parameter. The
+ * result is allocated with its exact size, computed from the prefixes.
  *
  * @param{char*} str: string of characters to encrypt (bits form).
  * @param{lst} prefixes: list of prefixes that give the bit sequence associated
  *                       for each character in fileIn.
- * @param{int} maxPrefixLength: maximal size of a prefix.
+ * @param{int} maxPrefixLength: maximal size of a prefix (not needed anymore).
  *
- * @return{char*}: Encryption in its bits form.
+ * @return{char*}: Encryption in its bits form, NULL if memory can't be
+ *                 allocated.
  */
 char* getEncryptionOf(char *str, lst prefixes, int maxPrefixLength);
 
@@ -254,37 +409,196 @@ char* getEncryptionOf(char *str, lst prefixes, int maxPrefixLength);
  * @see @function getEncryptionOf
  *
  * Returns an encrypted string. The string is the compressed form of the
- * encryption returned by getEncryptionOf, with some modifications to handle
- * the problems with the potential generation of the EOF and \0.
+ * encryption returned by getEncryptionOf: 7 bits per character, the lowest bit
+ * being always 1 so that no \0 is generated in the string.
  *
- * @param{char*} bits: the sequence of bits to compress.
- * @param{char*} endChar: the prefix of the end character.
+ * @param{char*} bits: the sequence of bits to compress (freed).
  *
- * @return{char*}: Encrypted characters (compressed form).
+ * @return{char*}: Encrypted characters (compressed form), NULL if bits is NULL
+ *                 or memory can't be allocated.
  */
-char* makeCharactersFromBits(char *bits, char *endChar);
+char* makeCharactersFromBits(char *bits);
 
 /**
  * @function writeEncryptionInFile
  * @brief Writes the encryption in a file.
  *
  * Encrypts a file with a list of prefixes for each character obtained by using
- * an huffman tree, and writes it in another file. Handles problems with the
- * potential generation of the EOF and \0.
+ * an huffman tree, and writes it in another file. The file is cut in blocks of
+ * HFM_BLOCK_SIZE bytes, and each block is written huffman coded only if its
+ * estimated coded size is smaller than the block itself, else it is stored raw.
+ * If the prefixes are NULL every block is stored.
  *
  * @param{char*} fileIn: name of the file we want to encrypt.
  * @param{char*} fileOut: name of the file to write.
  * @param{lst} prefixes: list of prefixes that give the bit sequence associated
- *                       for each character in fileIn.
+ *                       for each character in fileIn (can be NULL).
  * @param{int} maxPrefixLength: maximal size of a prefix.
  *
+ * @return{int}: 0 if the file has been encrypted, -1 otherwise.
+ */
+int writeEncryptionInFile(char *fileIn,
+                          char *fileOut,
+                          lst prefixes,
+                          int maxPrefixLength
+                         );
+
+/**
+ * @function encryptBlocksOfFile
+ * @brief Writes the blocks of a file, coded by a given function.
+ *
+ * Cuts a file in blocks of HFM_BLOCK_SIZE bytes and writes them in another
+ * file, between the header and the block index (@see @file container.h). Each
+ * block is given to 'encode', and is written as a huffman block if the payload
+ * returned is smaller than the block, else the block is stored.
+ *
+ * When the file has more than HFM_CHECKPOINT_BLOCKS blocks, a checkpoint is
+ * written every HFM_CHECKPOINT_BLOCKS blocks (@see @file checkpoint.h).
+ *
+ * The blocks are read, coded and written at the same time (@see @file
+ * pipeline.h): 'encode' is only called by the coder thread.
+ *
+ * @param{char*} fileIn: name of the file we want to encrypt.
+ * @param{char*} fileOut: name of the file to write.
+ * @param{size_t*} histogram: code table written in the header, NULL if it is
+ *                            in a separate key file.
+ * @param{unsigned int} checksums: HFM_CONTAINER_BLOCK_CRC and/or
+ *                                 HFM_CONTAINER_STREAM_CRC to write checksums,
+ *                                 0 for none.
+ * @param{size_t()} encode(unsigned char *block, size_t size, unsigned char *out,
+ *                         void *context): function coding a block in 'out'
+ *                         (HFM_BLOCK_SIZE bytes) and returning the size of the
+ *                         payload, or SIZE_MAX to store the block.
+ * @param{void*} context: context given to 'encode'.
+ *
+ * @return{int}: 0 if the file has been written, -1 if a file can't be opened or
+ *               written or memory can't be allocated.
+ */
+int encryptBlocksOfFile(char *fileIn,
+                        char *fileOut,
+                        size_t *histogram,
+                        unsigned int checksums,
+                        size_t(*encode)(unsigned char *block, size_t size, unsigned char *out, void *context),
+                        void *context
+                       );
+
+/**
+ * @function resumeEncryptBlocksOfFile
+ * @brief Resumes an encryption of encryptBlocksOfFile from its last checkpoint.
+ *
+ * The header of fileOut is kept, and the blocks are written again from the
+ * last checkpoint on.
+ *
+ * @param{char*} fileIn: name of the file being encrypted.
+ * @param{char*} fileOut: name of the ".hfm" file being written.
+ * @param{size_t()} encode: function coding the blocks, the same as the one of
+ *                          the interrupted encryption.
+ * @param{void*} context: context given to 'encode'.
+ *
+ * @return{int}: 0 if the file has been written, -1 if there is no checkpoint or
+ *               a file can't be opened or written.
+ */
+int resumeEncryptBlocksOfFile(char *fileIn,
+                              char *fileOut,
+                              size_t(*encode)(unsigned char *block, size_t size, unsigned char *out, void *context),
+                              void *context
+                             );
+
+/**
+ * @function writeBlockOfOpenedFile
+ * @brief Codes a block and writes it in a ".hfm" file already opened.
+ * @see @function encryptBlocksOfFile
+ *
+ * The block is written at the current position of the file, as a huffman
+ * block if the payload returned by 'encode' is smaller than the block, else
+ * stored, and is added to the block index of the container.
+ *
+ * @param{FILE*} fileOut: the ".hfm" file, after the header or the last block.
+ * @param{ctn} container: the header and the index of fileOut.
+ * @param{unsigned char*} block: the block (at most HFM_BLOCK_SIZE bytes).
+ * @param{size_t} size: size of the block.
+ * @param{unsigned char*} payload: buffer of HFM_BLOCK_SIZE bytes.
+ * @param{size_t()} encode: function coding the block.
+ * @param{void*} context: context given to 'encode'.
+ *
  * @return{void}
  */
-void writeEncryptionInFile(char *fileIn,
-                           char *fileOut,
-                           lst prefixes,
-                           int maxPrefixLength
-                          );
+void writeBlockOfOpenedFile(FILE *fileOut,
+                            ctn container,
+                            unsigned char *block,
+                            size_t size,
+                            unsigned char *payload,
+                            size_t(*encode)(unsigned char *block, size_t size, unsigned char *out, void *context),
+                            void *context
+                           );
+
+/**
+ * @function encryptBufferInOpenedFile
+ * @brief Encrypts data in memory, with the code table in the header.
+ *
+ * The whole ".hfm" file is written at the current position of fileOut (@see
+ * @function encryptBufferInMemory). The data is stored if the coding doesn't
+ * make it smaller, as by huffmanEncryptFile, and the header has no table.
+ *
+ * @param{unsigned char*} data: the data to encrypt.
+ * @param{size_t} size: size of the data.
+ * @param{FILE*} fileOut: the file to write, already opened.
+ * @param{unsigned int} checksums: checksums to write (@see @function
+ *                                 encryptBlocksOfFile).
+ *
+ * @return{int}: 0 if the data has been written, -1 otherwise.
+ */
+int encryptBufferInOpenedFile(unsigned char *data, size_t size, FILE *fileOut, unsigned int checksums);
+
+/**
+ * @function encryptBufferInMemory
+ * @brief Encrypts data in memory in a ".hfm" file kept in memory.
+ * @see @function encryptBufferInOpenedFile
+ *
+ * @param{unsigned char*} data: the data to encrypt.
+ * @param{size_t} size: size of the data.
+ * @param{unsigned int} checksums: checksums to write.
+ * @param{size_t*} outSize: receives the size of the ".hfm" file.
+ *
+ * @return{unsigned char*}: the ".hfm" file, to free, NULL if it can't be
+ *                          written.
+ */
+unsigned char* encryptBufferInMemory(unsigned char *data, size_t size, unsigned int checksums, size_t *outSize);
+
+/**
+ * @function encryptBufferWithCodesInMemory
+ * @brief Encrypts data in memory with the codes of a key, in a ".hfm" file
+ * kept in memory without code table (the key is needed to decrypt it).
+ * @see @function encryptBufferInMemory
+ *
+ * @param{unsigned char*} data: the data to encrypt.
+ * @param{size_t} size: size of the data.
+ * @param{char**} codes: code of each character (@see @function prefixesTable).
+ * @param{unsigned int} checksums: checksums to write.
+ * @param{size_t*} outSize: receives the size of the ".hfm" file.
+ *
+ * @return{unsigned char*}: the ".hfm" file, to free, NULL if it can't be
+ *                          written.
+ */
+unsigned char* encryptBufferWithCodesInMemory(unsigned char *data, size_t size, char **codes, unsigned int checksums, size_t *outSize);
+
+/**
+ * @function decryptBufferInMemory
+ * @brief Decrypts a ".hfm" file kept in memory, in memory.
+ *
+ * @param{unsigned char*} data: the ".hfm" file.
+ * @param{size_t} size: size of the ".hfm" file.
+ * @param{nd} tree: tree of the key, used if the code table is not in the
+ *                  header (can be NULL).
+ * @param{size_t} maxSize: maximal size of the original data accepted.
+ * @param{unsigned char**} out: receives the original data, to free.
+ * @param{size_t*} outSize: receives the size of the original data.
+ *
+ * @return{int}: 0 if the data has been decrypted, -1 if the key is needed or
+ *               memory can't be allocated, -2 if the file is corrupted or too
+ *               big, -3 if a checksum does not match.
+ */
+int decryptBufferInMemory(unsigned char *data, size_t size, nd tree, size_t maxSize, unsigned char **out, size_t *outSize);
 
 /**
  * @function saveKeyInFile
@@ -296,21 +610,22 @@ void writeEncryptionInFile(char *fileIn,
  * @param{lst} occurrences: occurrences to save in the file.
  * @param{char*} fileKey: file to write in.
  *
- * @return{void}
+ * @return{int}: 0 if the key has been written, -1 otherwise.
  */
-void saveKeyInFile(lst occurrences, char *fileKey);
+int saveKeyInFile(lst occurrences, char *fileKey);
 
 /**
  * @function getDecryptionOf
  * @brief Returns the decryption of the string given.
  *
  * Returns the decryption of the string of characters given in parameters by
- * using the tree used for the encryption.
+ * using the tree used for the encryption. The result is allocated with the number
+ * of characters the tree was built from.
  *
  * @param{char*} str: string of characters to decrypt.
  * @param{nd} tree: the tree used to decrypt.
  *
- * @return{char*}: Encryption in its bits form.
+ * @return{char*}: Decrypted string, NULL if memory can't be allocated.
  */
 char* getDecryptionOf(char *str, nd tree);
 
@@ -319,15 +634,158 @@ char* getDecryptionOf(char *str, nd tree);
  * @brief Writes the decryption in a file.
  *
  * Decrypts a file with the tree used to generate it, and writes the decryption
- * in another file.
+ * in another file. Huffman blocks are decoded with the tree, stored blocks are
+ * copied straight through.
  *
  * @param{char*} fileIn: name of the file we want to decrypt.
  * @param{char*} fileOut: name of the file to write.
  * @param{lst} tree: the huffman tree.
  *
+ * @return{int}: same as decryptBlocksOfFile.
+ */
+int writeDecryptionInFile(char *fileIn, char *fileOut, nd tree);
+
+/**
+ * @function decryptBlocksOfFile
+ * @brief Writes the blocks of an encrypted file, decoded by a given function.
+ *
+ * Reads the blocks of a ".hfm" file and writes the decrypted blocks in another
+ * file. The payloads of the huffman blocks are given to 'decode', the stored
+ * blocks are copied. If the file has checksums, each decrypted block (and the
+ * whole file) is checked against them.
+ *
+ * When the file has more than HFM_CHECKPOINT_BLOCKS blocks, a checkpoint is
+ * written every HFM_CHECKPOINT_BLOCKS blocks (@see @file checkpoint.h).
+ *
+ * The blocks are read, decoded and written at the same time (@see @file
+ * pipeline.h): 'decode' is only called by the coder thread.
+ *
+ * If fileIn is corrupted or a checksum does not match, fileOut and its
+ * checkpoint are removed: no part of a wrong decryption is left.
+ *
+ * @param{char*} fileIn: name of the file we want to decrypt.
+ * @param{char*} fileOut: name of the file to write.
+ * @param{size_t()} decode(unsigned char *payload, size_t size,
+ *                         unsigned char *out, size_t length, void *context):
+ *                         function decoding the 'length' bytes of a block in
+ *                         'out' (HFM_BLOCK_SIZE bytes) and returning 'length',
+ *                         or SIZE_MAX if the payload is corrupted.
+ * @param{void*} context: context given to 'decode'.
+ *
+ * @return{int}: 0 if the file has been decrypted, -1 if a file can't be
+ *               opened or memory can't be allocated, -2 if fileIn is
+ *               corrupted, -3 if a checksum does not match.
+ */
+int decryptBlocksOfFile(char *fileIn,
+                        char *fileOut,
+                        size_t(*decode)(unsigned char *payload, size_t size, unsigned char *out, size_t length, void *context),
+                        void *context
+                       );
+
+/**
+ * @function resumeDecryptBlocksOfFile
+ * @brief Resumes a decryption of decryptBlocksOfFile from its last checkpoint.
+ *
+ * The data of fileOut written after the last checkpoint is written again.
+ * Unlike decryptBlocksOfFile, fileOut and its checkpoint are kept when the
+ * decryption fails.
+ *
+ * @param{char*} fileIn: name of the file being decrypted.
+ * @param{char*} fileOut: name of the file being written.
+ * @param{size_t()} decode: function decoding the huffman blocks.
+ * @param{void*} context: context given to 'decode'.
+ *
+ * @return{int}: same as decryptBlocksOfFile, -1 if there is no checkpoint.
+ */
+int resumeDecryptBlocksOfFile(char *fileIn,
+                              char *fileOut,
+                              size_t(*decode)(unsigned char *payload, size_t size, unsigned char *out, size_t length, void *context),
+                              void *context
+                             );
+
+/**
+ * @function decryptBlocksOfOpenedFile
+ * @brief Writes the blocks of an encrypted file already opened.
+ * @see @function decryptBlocksOfFile
+ *
+ * The blocks following a table block (@see HFM_BLOCK_TABLE) holding a
+ * histogram are decoded with its tree, the ones following a table block
+ * holding HFM_TABLE_KEY with 'decode'.
+ *
+ * @param{FILE*} fileIn: the ".hfm" file, positioned at its first block.
+ * @param{FILE*} fileOut: the file to write.
+ * @param{ctn} container: the header and the index of fileIn (@see @function
+ *                        readContainer).
+ * @param{size_t()} decode: function decoding the huffman blocks.
+ * @param{void*} context: context given to 'decode'.
+ *
+ * @return{int}: 0 if the file has been decrypted, -1 if fileOut can't be
+ *               written or memory can't be allocated, -2 if fileIn is
+ *               corrupted, -3 if a checksum does not match.
+ */
+int decryptBlocksOfOpenedFile(FILE *fileIn,
+                              FILE *fileOut,
+                              ctn container,
+                              size_t(*decode)(unsigned char *payload, size_t size, unsigned char *out, size_t length, void *context),
+                              void *context
+                             );
+
+/**
+ * @function readBlockOfOpenedFile
+ * @brief Reads and decodes one block of an encrypted file already opened.
+ *
+ * The block header is checked against the block index, and the decoded block
+ * against its checksum if the file has one.
+ *
+ * @param{FILE*} fileIn: the ".hfm" file, positioned at the block (@see
+ *                       @function getContainerBlockOffset).
+ * @param{ctn} container: the header and the index of fileIn.
+ * @param{size_t} index: index of the block.
+ * @param{unsigned char*} payload: buffer of HFM_BLOCK_SIZE bytes.
+ * @param{unsigned char*} block: buffer of HFM_BLOCK_SIZE bytes receiving the
+ *                               decoded block.
+ * @param{size_t()} decode: function decoding the huffman blocks (@see
+ *                          @function decryptBlocksOfFile).
+ * @param{void*} context: context given to 'decode'.
+ *
+ * @return{int}: 0 if the block has been decoded, -2 if it is corrupted, -3 if
+ *               it does not match its checksum.
+ */
+int readBlockOfOpenedFile(FILE *fileIn,
+                          ctn container,
+                          size_t index,
+                          unsigned char *payload,
+                          unsigned char *block,
+                          size_t(*decode)(unsigned char *payload, size_t size, unsigned char *out, size_t length, void *context),
+                          void *context
+                         );
+
+/**
+ * @function writeTableBlockOfOpenedFile
+ * @brief Writes a table block and adds it to the index of a container.
+ *
+ * @param{FILE*} fileOut: the file already opened, positioned after the blocks.
+ * @param{ctn} container: the container being written.
+ * @param{size_t*} histogram: the 256 counters of the table coding the next
+ *                            blocks, NULL if they are coded with the key.
+ *
  * @return{void}
  */
-void writeDecryptionInFile(char *fileIn, char *fileOut, nd tree);
+void writeTableBlockOfOpenedFile(FILE *fileOut, ctn container, size_t *histogram);
+
+/**
+ * @function readTableBlockOfOpenedFile
+ * @brief Reads a table block of an encrypted file already opened.
+ *
+ * @param{FILE*} fileIn: the ".hfm" file, positioned at the block.
+ * @param{ctn} container: the header and the index of fileIn.
+ * @param{size_t} index: index of the table block.
+ * @param{size_t*} histogram: receives the 256 counters of the table.
+ *
+ * @return{int}: 1 if a histogram has been read, 0 if the next blocks are coded
+ *               with the key, -2 if the block is corrupted.
+ */
+int readTableBlockOfOpenedFile(FILE *fileIn, ctn container, size_t index, size_t *histogram);
 
 /**
  * @function getTreeFromKeyFile
@@ -338,20 +796,56 @@ void writeDecryptionInFile(char *fileIn, char *fileOut, nd tree);
  * @param{char*} fileKey: name of the file containing the key (list of
  * occurrences of characters).
  *
- * @return{nd}: the tree generated contained in 'fileKey'.
+ * @return{nd}: the tree generated contained in 'fileKey', NULL if the key can't
+ *              be read, is empty or memory can't be allocated.
  */
 nd getTreeFromKeyFile(char *fileKey);
 
+/**
+ * @function getHistogramFromKeyFile
+ * @brief Reads the occurrences of a key file in a histogram.
+ *
+ * @param{char*} fileKey: name of the key file.
+ * @param{size_t*} histogram: receives the 256 counters.
+ *
+ * @return{int}: 0 if the key has been read, -1 if it can't be opened.
+ */
+int getHistogramFromKeyFile(char *fileKey, size_t *histogram);
+
+/**
+ * @function getTreeFromContainer
+ * @brief Gets the tree needed to decrypt a ".hfm" file.
+ *
+ * @param{ctn} container: the header of the ".hfm" file.
+ * @param{char*} fileKey: name of the key file, only read if the code table is
+ *                        not in the header (can be NULL).
+ *
+ * @return{nd}: the tree, NULL if the table is empty, the key can't be read or
+ *              memory can't be allocated.
+ */
+nd getTreeFromContainer(ctn container, char *fileKey);
+
+/**
+ * @function getTreeFromHistogram
+ * @brief Builds the tree of a histogram.
+ *
+ * @param{size_t*} histogram: the 256 counters.
+ *
+ * @return{nd}: the tree, NULL if the histogram is empty or memory can't be
+ *              allocated.
+ */
+nd getTreeFromHistogram(size_t *histogram);
+
 /**
  * @function charOccurrencesOfStr
  * @brief Creates a list of occurrences from a given string of characters.
  *
  * Creates a list of occurrences from the string of characters 'str' given in
- * parameter. The character \0 is added to dedicate a prefix for it.
+ * parameter.
  *
  * @param{char*} str: the string of characters.
  *
- * @return{lst}: the occurrences.
+ * @return{lst}: the occurrences, NULL if memory can't be allocated.
  */
 lst charOccurrencesOfStr(char *str);
 
@@ -359,15 +853,58 @@ lst charOccurrencesOfStr(char *str);
  * @function charOccurrencesOfFile
  * @brief Creates a list of occurrences from a file.
  *
- * Creates a list of occurrences from a file given in parameter. The
- * character \0 is added to dedicate a prefix for it.
+ * Creates a list of occurrences from a file given in parameter.
  *
  * @param{char*} srcFile: name of the file.
  *
- * @return{lst}: the occurrences.
+ * @return{lst}: the occurrences, NULL if the file can't be read or memory
+ *               can't be allocated.
  */
 lst charOccurrencesOfFile(char *srcFile);
 
+/**
+ * @function charOccurrencesOfFileSampled
+ * @brief Creates a list of occurrences from a sample of a file.
+ *
+ * Creates a list of occurrences by reading only chunks of HFM_SAMPLE_CHUNK bytes
+ * evenly spread over the file, so that about 'samplingRate' of the file is
+ * read. The sample is always the same for a given file and rate. The counts are
+ * scaled to the size of the file, and every character gets an occurrence of at
+ * least 1 so that a byte missed by the sample still has a prefix.
+ *
+ * @param{char*} srcFile: name of the file.
+ * @param{double} samplingRate: part of the file to read, between 0 and 1.
+ *
+ * @return{lst}: the occurrences, NULL if the file can't be read or memory
+ *               can't be allocated.
+ */
+lst charOccurrencesOfFileSampled(char *srcFile, double samplingRate);
+
+/**
+ * @function occurrencesFromHistogram
+ * @brief Creates a list of occurrences from a histogram.
+ *
+ * The characters that occur are added in the order of their values.
+ *
+ * @param{size_t*} histogram: occurrences of the 256 byte values (@see @file
+ *                            histogram.h).
+ *
+ * @return{lst}: the occurrences, NULL if memory can't be allocated.
+ */
+lst occurrencesFromHistogram(size_t *histogram);
+
+/**
+ * @function histogramOfOccurrences
+ * @brief Fills a histogram from a list of occurrences.
+ * @see @function occurrencesFromHistogram
+ *
+ * @param{lst} occurrences: the occurrences.
+ * @param{size_t*} histogram: the 256 counters to fill.
+ *
+ * @return{void}
+ */
+void histogramOfOccurrences(lst occurrences, size_t *histogram);
+
 /**
  * @function contructBinaryTree
  * @brief Constructs the binary tree used for huffman coding.
@@ -376,7 +913,8 @@ lst charOccurrencesOfFile(char *srcFile);
  *
  * @param{lst} occurrences: list of occurrences.
  *
- * @return{nd}: the tree generated.
+ * @return{nd}: the tree generated, NULL if there is no occurrence or memory
+ *              can't be allocated.
  */
 nd contructBinaryTree(lst occurrences);
 
@@ -389,11 +927,12 @@ nd contructBinaryTree(lst occurrences);
  * in the list.
  *
  * @param{lst} list: list of occurrences.
- * @param{int()} weight(void *elem): function to get the weight of a node.
+ * @param{size_t()} weight(void *elem): function to get the weight of a node.
  *
- * @return{void}
+ * @return{int}: 0 if the nodes are merged, -1 if memory can't be allocated (the
+ *               two nodes are then destroyed).
  */
-void mergeTwoSmallerNodes(lst list, int(*weight)(void *elem));
+int mergeTwoSmallerNodes(lst list, size_t(*weight)(void *elem));
 
 /**
  * @function mergeNodes
@@ -404,11 +943,12 @@ void mergeTwoSmallerNodes(lst list, int(*weight)(void *elem));
  *
  * @param{nd} node1: first node.
  * @param{nd} node2: second node.
- * @param{int()} weight(void *elem): function to get the weight of a node.
+ * @param{size_t()} weight(void *elem): function to get the weight of a node.
  *
- * @return{nd}: the new node.
+ * @return{nd}: the new node, NULL if memory can't be allocated (the two nodes
+ *              are then left to the caller).
  */
-nd mergeNodes(nd node1, nd node2, int(*weight)(void *elem));
+nd mergeNodes(nd node1, nd node2, size_t(*weight)(void *elem));
 
 /**
  * @function prefixesList
@@ -419,7 +959,7 @@ nd mergeNodes(nd node1, nd node2, int(*weight)(void *elem));
  * @param{nd} tree: the tree.
  * @param{int} maxPrefixLength: maximal size of a prefix.
  *
- * @return{lst}: the prefixes.
+ * @return{lst}: the prefixes, NULL if memory can't be allocated.
  */
 lst prefixesList(nd tree, int *maxPrefixLength);
 
@@ -434,9 +974,10 @@ lst prefixesList(nd tree, int *maxPrefixLength);
  * @param{lst} prefixes: list of prefixes to modify.
  * @param{char*} prefix: maximal size of a prefix.
  *
- * @return{void}
+ * @return{int}: 0 if the prefixes are calculated, -1 if a pointer is NULL or
+ *               memory can't be allocated.
  */
-void calculatePrefixes(nd node, lst prefixes, char *prefix);
+int calculatePrefixes(nd node, lst prefixes, char *prefix);
 
 
 /**
@@ -456,9 +997,9 @@ tpl getTupleInListByKey(lst list, char key);
  *
  * @param{void*} elem: the node.
  *
- * @return{int}: the node weight.
+ * @return{size_t}: the node weight.
  */
-int weightNode(void *elem);
+size_t weightNode(void *elem);
 
 /**
  * @function writeBitsInOpenedFile
@@ -475,6 +1016,156 @@ int weightNode(void *elem);
  */
 void writeBitsInOpenedFile(FILE *fileW, char *bits);
 
+/**
+ * @function prefixesTable
+ * @brief Fills a table giving the prefix of each byte value.
+ *
+ * Fills 'codes' so that codes[c] is the prefix of the character c taken in the
+ * list of prefixes, or NULL if the character has no prefix. This avoids a
+ * search in the list for every character to encrypt.
+ *
+ * @param{lst} prefixes: list of prefixes.
+ * @param{char**} codes: table of 256 prefixes to fill.
+ *
+ * @return{void}
+ */
+void prefixesTable(lst prefixes, char **codes);
+
+/**
+ * @function estimateCodedSize
+ * @brief Returns the size of a huffman block payload.
+ *
+ * Computes, from the occurrences of each byte value in a block and the length
+ * of their prefixes, the number of bytes the block takes once huffman coded
+ * (padding included), without coding it.
+ *
+ * @param{size_t*} histogram: occurrences of the 256 byte values in the block.
+ * @param{char**} codes: table of prefixes (@see @function prefixesTable).
+ *
+ * @return{size_t}: size of the payload, or SIZE_MAX if a byte of the block has
+ *                  no prefix.
+ */
+size_t estimateCodedSize(size_t *histogram, char **codes);
+
+/**
+ * @function encodeBlock
+ * @brief Huffman codes a block.
+ *
+ * Writes in 'out' the prefixes of the bytes of the block, 8 bits per byte and
+ * padded with 0s. Every byte of the block must have a prefix and 'out' must be
+ * big enough to hold the size given by estimateCodedSize.
+ *
+ * @param{unsigned char*} block: the block to code.
+ * @param{size_t} size: size of the block.
+ * @param{char**} codes: table of prefixes (@see @function prefixesTable).
+ * @param{unsigned char*} out: buffer receiving the payload.
+ *
+ * @return{size_t}: size of the payload written.
+ */
+size_t encodeBlock(unsigned char *block,
+                   size_t size,
+                   char **codes,
+                   unsigned char *out
+                  );
+
+/**
+ * @function decodeBlock
+ * @brief Decodes a huffman block.
+ *
+ * Decodes exactly 'length' bytes from the payload of a huffman block with the
+ * tree. A tree made of a single character decodes it 'length' times from an
+ * empty payload.
+ *
+ * The tree is flattened in an array (@see @function flattenTree) and the bits
+ * are decoded with it (@see @function codecDecodeTreeBlock).
+ *
+ * @param{unsigned char*} payload: the coded block.
+ * @param{size_t} size: size of the payload.
+ * @param{nd} tree: the huffman tree.
+ * @param{unsigned char*} out: buffer of HFM_BLOCK_SIZE bytes receiving the
+ *                             decoded block.
+ * @param{size_t} length: size of the original block (at most HFM_BLOCK_SIZE).
+ *
+ * @return{size_t}: 'length', or SIZE_MAX if the payload is corrupted.
+ */
+size_t decodeBlock(unsigned char *payload,
+                   size_t size,
+                   nd tree,
+                   unsigned char *out,
+                   size_t length
+                  );
+
+/**
+ * @function encodeBlockWithCodes
+ * @brief Codes a block with a table of prefixes, if it makes it smaller.
+ * @see @function encryptBlocksOfFile
+ *
+ * @param{unsigned char*} block: the block to code.
+ * @param{size_t} size: size of the block.
+ * @param{unsigned char*} out: buffer of HFM_BLOCK_SIZE bytes for the payload.
+ * @param{void*} context: the table of 256 prefixes (char**, @see @function
+ *                        prefixesTable).
+ *
+ * @return{size_t}: size of the payload, SIZE_MAX if the block has to be stored.
+ */
+size_t encodeBlockWithCodes(unsigned char *block, size_t size, unsigned char *out, void *context);
+
+/**
+ * @function decodeBlockWithTree
+ * @brief Decodes a block with a huffman tree.
+ * @see @function decryptBlocksOfFile
+ *
+ * @param{unsigned char*} payload: the payload of the block.
+ * @param{size_t} size: size of the payload.
+ * @param{unsigned char*} out: buffer of HFM_BLOCK_SIZE bytes for the block.
+ * @param{size_t} length: size of the block.
+ * @param{void*} context: the tree (nd).
+ *
+ * @return{size_t}: 'length', SIZE_MAX if the payload is corrupted.
+ */
+size_t decodeBlockWithTree(unsigned char *payload, size_t size, unsigned char *out, size_t length, void *context);
+
+/**
+ * @function copyStoredBlock
+ * @brief Copies a stored block from a file to another.
+ *
+ * Copies 'size' bytes from the current position of fileIn to the current
+ * position of fileOut. On Linux the copy is done by the kernel with
+ * copy_file_range, otherwise (or if it is not supported for these files) the
+ * bytes go through 'buffer'.
+ *
+ * @param{FILE*} fileIn: file to read.
+ * @param{FILE*} fileOut: file to write.
+ * @param{size_t} size: number of bytes to copy.
+ * @param{unsigned char*} buffer: buffer of at least 'size' bytes.
+ *
+ * @return{int}: 0 if the copy is done, -1 otherwise.
+ */
+int copyStoredBlock(FILE *fileIn, FILE *fileOut, size_t size, unsigned char *buffer);
+
+/**
+ * @function estimateEncryptionOfFile
+ * @brief Returns the size of the encryption of a file, without encrypting it.
+ *
+ * Computes the exact size of the ".hfm" file written by
+ * huffmanEncryptFileSampled (blocks headers and padding included) from the occurrences of each block and the length of the prefixes.
+ * The file is read, but nothing is written.
+ *
+ * @param{char*} fileIn: name of the file.
+ * @param{double} samplingRate: sampling rate the file would be encrypted with
+ *                              (1 for huffmanEncryptFile).
+ * @param{long long*} keySize: NULL if the code table is written in the header
+ *                             (and counted in the size returned), else receives
+ *                             the size of the separate key file.
+ * @param{unsigned int} checksums: HFM_CONTAINER_BLOCK_CRC and/or
+ *                                 HFM_CONTAINER_STREAM_CRC to write checksums,
+ *                                 0 for none.
+ *
+ * @return{long long}: size of the ".hfm" file, -1 if fileIn can't be read or
+ *                     memory can't be allocated.
+ */
+long long estimateEncryptionOfFile(char *fileIn, double samplingRate, long long *keySize, unsigned int checksums);
+
 
 #endif
 
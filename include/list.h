@@ -66,7 +66,7 @@ typedef struct list* lst;
  * blocks in memory to 0. The pointer of the list of elements is set NULL, like
  * the destroyer and the printer for the elements of the list.
  *
- * @return{lst}: pointer of the new list.
+ * @return{lst}: pointer of the new list, NULL if memory can't be allocated.
  */
 lst createList();
 
@@ -85,7 +85,7 @@ lst createList();
  * @param{void()} printElem(void *elem): function that print the type of element
  *                                       currently used in the list.
  *
- * @return{lst}: pointer of the new list.
+ * @return{lst}: pointer of the new list, NULL if memory can't be allocated.
  */
 lst createDefinedList(void(*destroyElem)(void **elem),
                       void(*printElem)(void *elem)
@@ -191,9 +191,10 @@ void printList(lst l);
  * @param{lst} l: pointer of the list.
  * @param{void*} elem: pointer of the element.
  *
- * @return{void}
+ * @return{int}: 0 if the element is added, -1 if the list is NULL or memory
+ *               can't be allocated (the element is then left to the caller).
  */
-void addInList(lst l, void *elem);
+int addInList(lst l, void *elem);
 
 /**
  * @function popList
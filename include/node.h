@@ -64,7 +64,7 @@ typedef struct node* nd;
  *
  * @param{void*} tag: pointer on the tag of the node.
  *
- * @return{nd}: The pointer of the new node.
+ * @return{nd}: The pointer of the new node, NULL if memory can't be allocated.
  */
 nd createNode(void *tag);
 
@@ -79,7 +79,8 @@ nd createNode(void *tag);
  * @param{void* ()} printTag(void *elem): function used to print the key (because
  *                                       we don't know the real type of the key).
  *
- * @return{nd}: The pointer of the new node.
+ * @return{nd}: The pointer of the new node, NULL if memory can't be allocated
+ *              (the tag is then left to the caller).
  */
 nd createDefinedNode(void *tag,
                      void(*destroyTag)(void **elem),
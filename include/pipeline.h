@@ -0,0 +1,201 @@
+/**
+ * @file pipeline.h
+ * @author agent <agent@local>
+ * @standard C99
+ * @version 1.0
+ * @date 18th October 2026
+ *
+ * @brief Header file for the pipeline reading, coding and writing blocks at
+ * the same time.
+ *
+ * A pipeline runs three stages on a sequence of blocks: a reader thread, a
+ * coder thread, and the calling thread which writes the blocks. The stages are
+ * connected by a ring of HFM_PIPELINE_SLOTS blocks allocated once and recycled:
+ * the reader fills a block, the coder codes it, the writer writes it and gives
+ * it back to the reader. Each stage handles the blocks in order, so the reading
+ * of a block, the coding of the previous one and the writing of the one before
+ * are done at the same time, and the time taken is close to the one of the
+ * slowest stage instead of the sum of the three.
+ *
+ * The blocks are handed over through atomic counters, the ring between two
+ * stages being a single producer and single consumer ring: a stage only takes
+ * a lock to sleep when its ring is empty or full, or to wake a stage sleeping.
+ * Only the coder uses the coding function, and only the writer writes the
+ * output, so neither of them has to be reentrant.
+ *
+ * If a stage fails, the pipeline stops: the blocks still in the ring are not
+ * coded nor written, and the error is returned.
+ *
+ * Overview about the pipeline block structure functions:
+ *  - getPipelineBlockNumber
+ *  - getPipelineBlockData
+ *  - getPipelineBlockSize
+ *  - setPipelineBlockSize
+ *  - getPipelineBlockOut
+ *  - getPipelineBlockOutSize
+ *  - setPipelineBlockOutSize
+ *  - getPipelineBlockKind
+ *  - setPipelineBlockKind
+ *
+ * Overview about public functions of pipeline:
+ *  - runPipeline
+ */
+
+/* ========================================================= */
+/* ================= PIPELINE_H FILE HEADER ================ */
+/* ========================================================================== */
+
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+/* ============ Includes =========== */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "utils.h" /**< Contains useful tool functions  */
+
+/* ============ Defines ============ */
+
+#define HFM_PIPELINE_SLOTS 8 /**< Number of blocks in the ring of a pipeline */
+
+/* ============= Struct ============ */
+
+/**
+ * @typedef pbk
+ * @brief Definition of pbk, a pointer of the structure pipelineBlock.
+ *
+ * The struct pipelineBlock is said existing, but truly implemented in the file
+ * "pipeline.c". It is a block of the ring of a pipeline: the data read, the
+ * data coded, and a kind free for the stages.
+ */
+typedef struct pipelineBlock* pbk;
+
+/* ======== Struct functions ======= */
+
+/**
+ * @function getPipelineBlockNumber
+ * @brief Getter of the number of the block in the sequence, from 0.
+ *
+ * @param{pbk} block: the block.
+ *
+ * @return{size_t}: the number.
+ */
+size_t getPipelineBlockNumber(pbk block);
+
+/**
+ * @function getPipelineBlockData
+ * @brief Getter of the buffer of the data read.
+ *
+ * @param{pbk} block: the block.
+ *
+ * @return{unsigned char*}: the buffer, of the size given to runPipeline.
+ */
+unsigned char* getPipelineBlockData(pbk block);
+
+/**
+ * @function getPipelineBlockSize
+ * @brief Getter of the size of the data read.
+ *
+ * @param{pbk} block: the block.
+ *
+ * @return{size_t}: the size.
+ */
+size_t getPipelineBlockSize(pbk block);
+
+/**
+ * @function setPipelineBlockSize
+ * @brief Setter of the size of the data read.
+ *
+ * @param{pbk} block: the block.
+ * @param{size_t} size: the size.
+ *
+ * @return{void}
+ */
+void setPipelineBlockSize(pbk block, size_t size);
+
+/**
+ * @function getPipelineBlockOut
+ * @brief Getter of the buffer of the data coded.
+ *
+ * @param{pbk} block: the block.
+ *
+ * @return{unsigned char*}: the buffer, of the size given to runPipeline.
+ */
+unsigned char* getPipelineBlockOut(pbk block);
+
+/**
+ * @function getPipelineBlockOutSize
+ * @brief Getter of the size of the data coded.
+ *
+ * @param{pbk} block: the block.
+ *
+ * @return{size_t}: the size.
+ */
+size_t getPipelineBlockOutSize(pbk block);
+
+/**
+ * @function setPipelineBlockOutSize
+ * @brief Setter of the size of the data coded.
+ *
+ * @param{pbk} block: the block.
+ * @param{size_t} size: the size.
+ *
+ * @return{void}
+ */
+void setPipelineBlockOutSize(pbk block, size_t size);
+
+/**
+ * @function getPipelineBlockKind
+ * @brief Getter of the kind of the block, given by a stage to the next ones.
+ *
+ * @param{pbk} block: the block.
+ *
+ * @return{int}: the kind, 0 when the block is given to the reader.
+ */
+int getPipelineBlockKind(pbk block);
+
+/**
+ * @function setPipelineBlockKind
+ * @brief Setter of the kind of the block.
+ *
+ * @param{pbk} block: the block.
+ * @param{int} kind: the kind.
+ *
+ * @return{void}
+ */
+void setPipelineBlockKind(pbk block, int kind);
+
+/* =========== Functions =========== */
+
+/**
+ * @function runPipeline
+ * @brief Reads, codes and writes blocks until the end of the input.
+ *
+ * The functions of the stages return 0 when the block is done and a negative
+ * code on error. The reader returns 1 when there is no block left to read (the
+ * block given is then not used). If the threads can't be created, the stages
+ * are run one after the other in the calling thread.
+ *
+ * @param{size_t} bufferSize: size of the buffers of each block.
+ * @param{int()} readBlock: reader stage, run in its own thread.
+ * @param{int()} codeBlock: coder stage, run in its own thread.
+ * @param{int()} writeBlock: writer stage, run in the calling thread.
+ * @param{void*} context: context given to the stages.
+ *
+ * @return{int}: 0 if all the blocks have been written, -1 if memory can't be
+ *               allocated for the buffers, else the first error returned by a
+ *               stage.
+ */
+int runPipeline(size_t bufferSize,
+                int(*readBlock)(pbk block, void *context),
+                int(*codeBlock)(pbk block, void *context),
+                int(*writeBlock)(pbk block, void *context),
+                void *context
+               );
+
+
+#endif
+
+/* ========================================================================== */
+/* ========================================================================== */
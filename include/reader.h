@@ -0,0 +1,165 @@
+/**
+ * @file reader.h
+ * @author agent <agent@local>
+ * @standard C99
+ * @version 1.0
+ * @date 18th October 2026
+ *
+ * @brief Header file for the random access to the ".hfm" files.
+ *
+ * A reader decodes any range of bytes of the original file by reading only the
+ * blocks covering it: the block index of the container gives the offset of each
+ * block in the ".hfm" file and in the original file (@see @file container.h).
+ * The last blocks decoded are kept in a cache (least recently used ones
+ * evicted first), so that repeated reads of the same area (previews, tails) cost
+ * at most the decoding of one block.
+ *
+ * Overview about the reader structure functions:
+ *  - openReader
+ *  - openReaderOfOpenedFile
+ *  - closeReader
+ *  - getReaderSize
+ *  - getReaderContainer
+ *
+ * Overview about public functions of reader:
+ *  - readRange
+ *  - huffmanDecryptRange
+ */
+
+/* ========================================================= */
+/* ================== READER_H FILE HEADER ================= */
+/* ========================================================================== */
+
+#ifndef READER_H
+#define READER_H
+
+/* ============ Includes =========== */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "huffman.h" /**< Contains the huffman coding of the files  */
+
+/* ============ Defines ============ */
+
+#define HFM_READER_CACHE_BLOCKS 8 /**< Default number of blocks kept decoded */
+
+/* ============= Struct ============ */
+
+/**
+ * @typedef rdr
+ * @brief Definition of rdr, a pointer of the structure reader.
+ *
+ * The struct reader is said existing, but truly implemented in the file
+ * "reader.c". It holds an opened ".hfm" file, its trees and its cache.
+ */
+typedef struct reader* rdr;
+
+/* ======== Struct functions ======= */
+
+/**
+ * @function openReader
+ * @brief Opens a ".hfm" file for random access.
+ *
+ * Only the header and the block index are read.
+ *
+ * @param{char*} fileIn: name of the ".hfm" file.
+ * @param{char*} fileKey: name of the key file, only read if the code table is
+ *                        not in the header (can be NULL).
+ * @param{size_t} cacheSize: number of decoded blocks kept in memory (at least
+ *                           1, @see HFM_READER_CACHE_BLOCKS).
+ *
+ * @return{rdr}: the reader, NULL if the file can't be opened, is not a valid
+ *               ".hfm" file or memory can't be allocated.
+ */
+rdr openReader(char *fileIn, char *fileKey, size_t cacheSize);
+
+/**
+ * @function openReaderOfOpenedFile
+ * @brief Opens for random access a ".hfm" container in an opened file, as the
+ * containers packed in an archive.
+ * @see @function openReader
+ *
+ * @param{FILE*} file: the file, positioned at the header of the container. It
+ *                     is closed with the reader, but not if NULL is returned.
+ * @param{char*} fileKey: name of the key file (can be NULL).
+ * @param{size_t} cacheSize: number of decoded blocks kept in memory.
+ *
+ * @return{rdr}: the reader, NULL if the container is not valid or memory
+ *               can't be allocated.
+ */
+rdr openReaderOfOpenedFile(FILE *file, char *fileKey, size_t cacheSize);
+
+/**
+ * @function closeReader
+ * @brief Closes the file of a reader, frees it and sets its pointer to NULL.
+ *
+ * @param{rdr*} reader: pointer of the reader.
+ *
+ * @return{void}
+ */
+void closeReader(rdr *reader);
+
+/**
+ * @function getReaderSize
+ * @brief Getter of the size of the original file.
+ *
+ * @param{rdr} reader: the reader.
+ *
+ * @return{long long}: the size in bytes.
+ */
+long long getReaderSize(rdr reader);
+
+/**
+ * @function getReaderContainer
+ * @brief Getter of the header and the block index of the file.
+ *
+ * @param{rdr} reader: the reader.
+ *
+ * @return{ctn}: the container, owned by the reader.
+ */
+ctn getReaderContainer(rdr reader);
+
+/* =========== Functions =========== */
+
+/**
+ * @function readRange
+ * @brief Decodes a range of bytes of the original file.
+ *
+ * Only the blocks covering the range are decoded, or taken from the cache.
+ *
+ * @param{rdr} reader: the reader.
+ * @param{long long} offset: offset of the first byte in the original file.
+ * @param{size_t} length: number of bytes to read.
+ * @param{unsigned char*} out: buffer of 'length' bytes.
+ *
+ * @return{long long}: number of bytes read (less than 'length' at the end of
+ *                     the file), -1 if memory can't be allocated, -2 if a block
+ *                     is corrupted, -3 if a block does not match its checksum.
+ */
+long long readRange(rdr reader, long long offset, size_t length, unsigned char *out);
+
+/**
+ * @function huffmanDecryptRange
+ * @brief Decrypts a range of bytes of a file.
+ *
+ * @param{char*} fileIn: name of the ".hfm" file.
+ * @param{char*} fileOut: name of the file to write.
+ * @param{char*} fileKey: name of the key file, only read if the code table is
+ *                        not in the header (can be NULL).
+ * @param{long long} offset: offset of the first byte in the original file, or
+ *                           if negative, from the end of the original file.
+ * @param{long long} length: number of bytes to decrypt, negative to decrypt up
+ *                           to the end.
+ *
+ * @return{int}: 0 if the range has been decrypted, -1 if a file can't be
+ *               opened or memory can't be allocated, -2 if fileIn is
+ *               corrupted, -3 if a checksum does not match.
+ */
+int huffmanDecryptRange(char *fileIn, char *fileOut, char *fileKey, long long offset, long long length);
+
+
+#endif
+
+/* ========================================================================== */
+/* ========================================================================== */
@@ -0,0 +1,228 @@
+/**
+ * @file scheduler.h
+ * @author agent <agent@local>
+ * @standard C99
+ * @version 1.0
+ * @date 18th October 2026
+ *
+ * @brief Header file for the work-stealing scheduler of the coding tasks.
+ *
+ * A task is a function and its argument, of any size: the histogram of a part
+ * of a buffer, the coding of some blocks, the whole coding of a file. Each
+ * worker of the scheduler has its own queue: a task submitted by a worker (a
+ * task splitting its work) goes at the end of the queue of this worker, which
+ * takes its last task first, and a task submitted from outside goes to the
+ * queues in turn. A worker with an empty queue steals the first task of the
+ * queue of another worker, so a worker stuck on a big file doesn't keep the
+ * small ones waiting.
+ *
+ * The tasks can be put in a group, to wait for all of them. A worker waiting
+ * for a group runs the tasks of the queues meanwhile, so a task can split its
+ * work in tasks and wait for them.
+ *
+ * Each worker has its own scratch space (@see @file codec.h), given to its
+ * tasks. The workers can be pinned each on a processor, and be placed on the
+ * NUMA nodes in turn: the queue and the scratch space of a worker are then
+ * allocated by itself, in the memory of its node.
+ *
+ * The scheduler counts for each worker the tasks run, the tasks stolen and the
+ * time spent in the tasks, to tune the size of the tasks and the number of
+ * workers.
+ *
+ * Overview about the scheduler structure functions:
+ *  - createScheduler
+ *  - destroyScheduler
+ *  - getSchedulerSize
+ *  - getSchedulerWorker
+ *  - getSchedulerCounters
+ *  - printSchedulerStats
+ *
+ * Overview about the task functions:
+ *  - createSchedulerGroup
+ *  - destroySchedulerGroup
+ *  - submitSchedulerTask
+ *  - waitSchedulerGroup
+ */
+
+/* ========================================================= */
+/* ================ SCHEDULER_H FILE HEADER ================ */
+/* ========================================================================== */
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+/* ============ Includes =========== */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include "codec.h" /**< Contains the scratch spaces of the coding  */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============ Defines ============ */
+
+#define HFM_SCHEDULER_MAX_WORKERS 256 /**< Maximal number of workers */
+#define HFM_SCHEDULER_PIN 0x01 /**< Option: each worker is pinned on a processor */
+#define HFM_SCHEDULER_NUMA 0x02 /**< Option: the workers are spread over the NUMA nodes */
+
+/* ============= Struct ============ */
+
+/**
+ * @typedef sch
+ * @brief Definition of sch, a pointer of the structure scheduler.
+ *
+ * The struct scheduler is said existing, but truly implemented in the file
+ * "scheduler.c".
+ */
+typedef struct scheduler* sch;
+
+/**
+ * @typedef sgp
+ * @brief Definition of sgp, a pointer of the structure schedulerGroup.
+ *
+ * The struct schedulerGroup is said existing, but truly implemented in the
+ * file "scheduler.c".
+ */
+typedef struct schedulerGroup* sgp;
+
+/**
+ * @typedef schedulerFunction
+ * @brief Function of a task, given its argument and the scratch space of the
+ * worker running it.
+ */
+typedef void (*schedulerFunction)(void *arg, csc scratch);
+
+/* ======== Struct functions ======= */
+
+/**
+ * @function createScheduler
+ * @brief Creates a scheduler and starts its workers.
+ *
+ * @param{int} nbWorkers: number of workers (at most HFM_SCHEDULER_MAX_WORKERS),
+ *                        0 for one per processor.
+ * @param{unsigned int} options: HFM_SCHEDULER_PIN and/or HFM_SCHEDULER_NUMA, 0
+ *                               to let the system place the workers.
+ *
+ * @return{sch}: the scheduler, NULL if it can't be created.
+ */
+sch createScheduler(int nbWorkers, unsigned int options);
+
+/**
+ * @function destroyScheduler
+ * @brief Stops a scheduler and sets its pointer to NULL.
+ *
+ * The tasks already submitted are run before the workers stop, with the tasks
+ * they submit; the new tasks submitted from outside are refused.
+ *
+ * @param{sch*} scheduler: pointer on the scheduler (can point on NULL).
+ *
+ * @return{void}
+ */
+void destroyScheduler(sch *scheduler);
+
+/**
+ * @function getSchedulerSize
+ * @brief Gives the number of workers of a scheduler.
+ *
+ * @param{sch} scheduler: the scheduler.
+ *
+ * @return{int}: the number of workers.
+ */
+int getSchedulerSize(sch scheduler);
+
+/**
+ * @function getSchedulerWorker
+ * @brief Gives the index of the worker calling, in a scheduler.
+ *
+ * @param{sch} scheduler: the scheduler.
+ *
+ * @return{int}: the index of the worker, -1 if the caller is not one of its
+ *               workers.
+ */
+int getSchedulerWorker(sch scheduler);
+
+/**
+ * @function getSchedulerCounters
+ * @brief Gives the counters of a worker.
+ *
+ * @param{sch} scheduler: the scheduler.
+ * @param{int} worker: index of the worker.
+ * @param{unsigned long long*} tasks: receives the number of tasks run.
+ * @param{unsigned long long*} steals: receives the number of tasks stolen from
+ *                                     another worker.
+ * @param{double*} utilization: receives the part of the time spent in the
+ *                              tasks since the scheduler has been created.
+ *
+ * @return{void}
+ */
+void getSchedulerCounters(sch scheduler, int worker, unsigned long long *tasks, unsigned long long *steals, double *utilization);
+
+/**
+ * @function printSchedulerStats
+ * @brief Prints the counters of each worker, and their sums.
+ *
+ * @param{sch} scheduler: the scheduler.
+ * @param{FILE*} stream: where to print.
+ *
+ * @return{void}
+ */
+void printSchedulerStats(sch scheduler, FILE *stream);
+
+/* =========== Functions =========== */
+
+/**
+ * @function createSchedulerGroup
+ * @brief Creates a group of tasks, to wait for them.
+ *
+ * @return{sgp}: the group, NULL if memory can't be allocated.
+ */
+sgp createSchedulerGroup(void);
+
+/**
+ * @function destroySchedulerGroup
+ * @brief Frees a group with no task left and sets its pointer to NULL.
+ *
+ * @param{sgp*} group: pointer on the group (can point on NULL).
+ *
+ * @return{void}
+ */
+void destroySchedulerGroup(sgp *group);
+
+/**
+ * @function submitSchedulerTask
+ * @brief Submits a task.
+ *
+ * @param{sch} scheduler: the scheduler.
+ * @param{sgp} group: group of the task (can be NULL).
+ * @param{schedulerFunction} function: function of the task.
+ * @param{void*} arg: argument of the function, kept until the task is run.
+ *
+ * @return{int}: 0 if the task has been submitted, -1 if memory can't be
+ *               allocated or the scheduler is stopping.
+ */
+int submitSchedulerTask(sch scheduler, sgp group, schedulerFunction function, void *arg);
+
+/**
+ * @function waitSchedulerGroup
+ * @brief Waits until all the tasks of a group are done.
+ *
+ * A worker of the scheduler runs the tasks of the queues while it waits.
+ *
+ * @param{sch} scheduler: the scheduler.
+ * @param{sgp} group: the group.
+ *
+ * @return{void}
+ */
+void waitSchedulerGroup(sch scheduler, sgp group);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+/* ========================================================================== */
+/* ========================================================================== */
@@ -0,0 +1,118 @@
+/**
+ * @file server.h
+ * @author agent <agent@local>
+ * @standard C99
+ * @version 1.0
+ * @date 18th October 2026
+ *
+ * @brief Header file for the compression daemon on a Unix domain socket.
+ *
+ * A process started for each file pays its startup, and reads its key file and
+ * builds its tree again at each call. The daemon does it once: it listens on a
+ * Unix domain socket, keeps the trees and the codes of the last key files used
+ * (built again when a key file changes), and serves its clients with a pool of
+ * threads, a connection per thread at a time. A connection can send many
+ * requests, one after the other. A connection that sends nothing, or reads
+ * nothing of its response, for HFM_SERVER_IDLE_TIMEOUT seconds is closed, so
+ * that the idle clients don't keep the threads from the others.
+ *
+ * A request starts with a header of HFM_SERVER_HEADER_SIZE bytes (little endian
+ * integers):
+ *  - the magic "HFMQ" (4 bytes)
+ *  - the operation (1 byte, @see HFM_SERVER_COMPRESS...)
+ *  - the flags (1 byte, HFM_SERVER_CHECKSUMS to write the checksums)
+ *  - the length of the path of the key file (2 bytes, 0 for none)
+ *  - the length of the payload (8 bytes, at most HFM_SERVER_MAX_SIZE)
+ * The path of the key file follows (without '\0'), then the payload: the data
+ * to compress or the ".hfm" file to decompress, or for the operations on files
+ * the path of the input, a '\0' and the path of the output (paths of the
+ * machine of the daemon).
+ *
+ * A response starts with a header of HFM_SERVER_HEADER_SIZE bytes: the magic
+ * "HFMR" (4 bytes), the status (1 byte, signed: 0 if done, -1 on an error of
+ * the files or the key, -2 if the data is corrupted, -3 if it does not match
+ * its checksums, -4 if the request is not valid), 3 reserved bytes and the
+ * length of the payload (8 bytes). The payload is the result (empty for the
+ * operations on files), or a message when the status is not 0.
+ *
+ * The daemon measures the time of each request, from its header read to its
+ * response written, in a histogram per operation (buckets of powers of 2 of
+ * microseconds), given by the operation HFM_SERVER_STATS and printed when the
+ * daemon stops (SIGINT or SIGTERM).
+ *
+ * Overview about public functions of server:
+ *  - huffmanServe
+ *  - huffmanServerRequest
+ */
+
+/* ========================================================= */
+/* ================== SERVER_H FILE HEADER ================= */
+/* ========================================================================== */
+
+#ifndef SERVER_H
+#define SERVER_H
+
+/* ============ Includes =========== */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "huffman.h" /**< Contains the huffman coding of the files  */
+
+/* ============ Defines ============ */
+
+#define HFM_SERVER_REQUEST_MAGIC "HFMQ" /**< First bytes of a request */
+#define HFM_SERVER_RESPONSE_MAGIC "HFMR" /**< First bytes of a response */
+#define HFM_SERVER_HEADER_SIZE 16 /**< Size of the header of a request and a response */
+#define HFM_SERVER_COMPRESS 1 /**< Operation: compresses the payload */
+#define HFM_SERVER_DECOMPRESS 2 /**< Operation: decompresses the payload */
+#define HFM_SERVER_COMPRESS_FILE 3 /**< Operation: compresses a file in another */
+#define HFM_SERVER_DECOMPRESS_FILE 4 /**< Operation: decompresses a file in another */
+#define HFM_SERVER_STATS 5 /**< Operation: gives the histograms of the latencies */
+#define HFM_SERVER_NB_OPERATIONS 6 /**< Number of operations, plus 1 */
+#define HFM_SERVER_CHECKSUMS 0x01 /**< Flag: the compression writes the checksums */
+#define HFM_SERVER_MAX_SIZE (1LL << 30) /**< Maximal size of a payload and of its result */
+#define HFM_SERVER_MAX_KEYS 16 /**< Key files kept with their tree and their codes */
+#define HFM_SERVER_MAX_THREADS 256 /**< Maximal number of threads of the pool */
+#define HFM_SERVER_BUCKETS 40 /**< Buckets of the histograms, up to 2^39 microseconds */
+#define HFM_SERVER_IDLE_TIMEOUT 10 /**< Seconds a connection can stay idle */
+
+/* =========== Functions =========== */
+
+/**
+ * @function huffmanServe
+ * @brief Serves the requests of a Unix domain socket until SIGINT or SIGTERM.
+ *
+ * A file already at the path of the socket is replaced if it is a socket.
+ *
+ * @param{char*} socketPath: path of the socket.
+ * @param{int} nbThreads: number of threads of the pool (at most
+ *                        HFM_SERVER_MAX_THREADS), 0 for 4 per processor.
+ *
+ * @return{int}: 0 once stopped, -1 if the socket can't be created.
+ */
+int huffmanServe(char *socketPath, int nbThreads);
+
+/**
+ * @function huffmanServerRequest
+ * @brief Sends a request to a daemon and writes its result.
+ *
+ * @param{char*} socketPath: path of the socket of the daemon.
+ * @param{int} operation: HFM_SERVER_COMPRESS, HFM_SERVER_DECOMPRESS or
+ *                        HFM_SERVER_STATS.
+ * @param{char*} fileKey: key file used by the daemon (can be NULL).
+ * @param{unsigned int} checksums: HFM_CONTAINER_CHECKSUMS to write the
+ *                                 checksums, 0 otherwise.
+ * @param{char*} fileIn: file sent (NULL for HFM_SERVER_STATS).
+ * @param{char*} fileOut: file receiving the result (NULL for the standard
+ *                        output).
+ *
+ * @return{int}: the status of the response, -1 if the daemon can't be reached.
+ */
+int huffmanServerRequest(char *socketPath, int operation, char *fileKey, unsigned int checksums, char *fileIn, char *fileOut);
+
+
+#endif
+
+/* ========================================================================== */
+/* ========================================================================== */
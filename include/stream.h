@@ -0,0 +1,170 @@
+/**
+ * @file stream.h
+ * @author agent <agent@local>
+ * @standard C99
+ * @version 1.0
+ * @date 18th October 2026
+ *
+ * @brief Header file for the file handles on ".hfm" files.
+ *
+ * A stream reads or writes a ".hfm" file like a regular file, without staging
+ * the original data in a temporary file:
+ *  - in reading, whole blocks are decoded ahead of the position and kept by a
+ *    reader (@see @file reader.h), so that the following reads are copies, and
+ *    the position can be moved anywhere with hfmSeek
+ *  - in writing, the data is gathered in blocks of HFM_BLOCK_SIZE bytes, coded
+ *    and written one after the other, and the block index is written by
+ *    hfmClose. The position can't be moved.
+ *
+ * When no key is given for writing, the code table is built from the first
+ * block written (every byte value keeping a prefix, as with a sampling) and is
+ * written in the header.
+ *
+ * On glibc, hfmFopen gives a stream as a FILE*, so that the functions of
+ * stdio.h read and write ".hfm" files directly.
+ *
+ * Overview about the stream structure functions:
+ *  - hfmOpen
+ *  - hfmClose
+ *
+ * Overview about public functions of stream:
+ *  - hfmRead
+ *  - hfmWrite
+ *  - hfmSeek
+ *  - hfmTell
+ *  - hfmFopen (only with glibc)
+ */
+
+/* ========================================================= */
+/* ================== STREAM_H FILE HEADER ================= */
+/* ========================================================================== */
+
+#ifndef STREAM_H
+#define STREAM_H
+
+/* ============ Includes =========== */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "reader.h" /**< Contains the random access to the ".hfm" files  */
+
+/* ============= Struct ============ */
+
+/**
+ * @typedef stm
+ * @brief Definition of stm, a pointer of the structure stream.
+ *
+ * The struct stream is said existing, but truly implemented in the file
+ * "stream.c". It is a ".hfm" file opened for reading or for writing.
+ */
+typedef struct stream* stm;
+
+/* ======== Struct functions ======= */
+
+/**
+ * @function hfmOpen
+ * @brief Opens a ".hfm" file for reading or for writing.
+ *
+ * @param{char*} file: name of the ".hfm" file.
+ * @param{char*} mode: "r" to read, "w" to write ("wc" to also write the
+ *                     checksums, @see HFM_CONTAINER_CHECKSUMS).
+ * @param{char*} fileKey: name of a key file, NULL if the code table is in the
+ *                        header. In writing, the key is used to code the
+ *                        blocks and is not written in the file.
+ *
+ * @return{stm}: the stream, NULL if the file can't be opened, is not a valid
+ *               ".hfm" file, the mode is unknown or memory can't be allocated.
+ */
+stm hfmOpen(char *file, char *mode, char *fileKey);
+
+/**
+ * @function hfmClose
+ * @brief Closes a stream, frees it and sets its pointer to NULL.
+ *
+ * In writing, the last block, the block index and the header are written.
+ *
+ * @param{stm*} stream: pointer of the stream.
+ *
+ * @return{int}: 0 if the file has been closed, -1 if it could not be written.
+ */
+int hfmClose(stm *stream);
+
+/* =========== Functions =========== */
+
+/**
+ * @function hfmRead
+ * @brief Reads data from a stream opened for reading.
+ *
+ * @param{stm} stream: the stream.
+ * @param{void*} buffer: buffer of 'size' bytes.
+ * @param{size_t} size: number of bytes to read.
+ *
+ * @return{long long}: number of bytes read (0 at the end of the file), -1 if
+ *                     the stream is opened for writing, -2 if the file is
+ *                     corrupted, -3 if a block does not match its checksum.
+ */
+long long hfmRead(stm stream, void *buffer, size_t size);
+
+/**
+ * @function hfmWrite
+ * @brief Writes data in a stream opened for writing.
+ *
+ * @param{stm} stream: the stream.
+ * @param{const void*} buffer: the data.
+ * @param{size_t} size: size of the data.
+ *
+ * @return{long long}: 'size', -1 if the stream is opened for reading or the
+ *                     file can't be written.
+ */
+long long hfmWrite(stm stream, const void *buffer, size_t size);
+
+/**
+ * @function hfmSeek
+ * @brief Moves the position of a stream opened for reading.
+ *
+ * @param{stm} stream: the stream.
+ * @param{long long} offset: offset in the original file.
+ * @param{int} whence: SEEK_SET, SEEK_CUR or SEEK_END, as for fseek.
+ *
+ * @return{long long}: the new position, -1 if it is negative or if the stream
+ *                     is opened for writing (unless the position is not
+ *                     changed).
+ */
+long long hfmSeek(stm stream, long long offset, int whence);
+
+/**
+ * @function hfmTell
+ * @brief Gives the position of a stream.
+ *
+ * @param{stm} stream: the stream.
+ *
+ * @return{long long}: the position in the original file.
+ */
+long long hfmTell(stm stream);
+
+#if defined(__GLIBC__)
+
+/**
+ * @function hfmFopen
+ * @brief Opens a ".hfm" file as a FILE*.
+ * @see @function hfmOpen
+ *
+ * The FILE* is closed with fclose.
+ *
+ * @param{char*} file: name of the ".hfm" file.
+ * @param{char*} mode: "r", "w" or "wc".
+ * @param{char*} fileKey: name of a key file, NULL if the code table is in the
+ *                        header.
+ *
+ * @return{FILE*}: the file, NULL if it can't be opened.
+ */
+FILE* hfmFopen(char *file, char *mode, char *fileKey);
+
+#endif
+
+
+#endif
+
+/* ========================================================================== */
+/* ========================================================================== */
@@ -69,7 +69,8 @@ typedef struct tuple* tpl;
  * @param{void()} printValue(void *val): function used to print the key (because
  *                                       we don't know the real type of the key).
  *
- * @return{tpl}: The pointer of the new tuple.
+ * @return{tpl}: The pointer of the new tuple, NULL if memory can't be
+ *               allocated (the key and the value are then left to the caller).
  */
 tpl createTuple(void *key,
                 void *val,
@@ -104,7 +105,8 @@ tpl createTuple(void *key,
  * @param{void()} printValue(void *val): function used to print the key (because
  *                                       we don't know the real type of the key).
  *
- * @return{tpl}: The pointer of the new tuple.
+ * @return{tpl}: The pointer of the new tuple, NULL if memory can't be
+ *               allocated or a copy fails.
  */
 tpl createTupleByCopy(void *key,
                       void *val,
@@ -126,7 +128,8 @@ tpl createTupleByCopy(void *key,
  * @param{void*()} copyValue(void *val): function used to create a new pointer
  *                                       with the copy of the key value.
  *
- * @return{tpl}: The pointer of the new tuple.
+ * @return{tpl}: The pointer of the new tuple, NULL if memory can't be
+ *               allocated or a copy fails.
  */
 tpl makeCopyTuple(tpl tuple,
                   void*(*copyKey)(void *key),
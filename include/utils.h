@@ -14,16 +14,22 @@
  * Overview about public functions of utils:
  *  - equalsInt
  *  - printInt
+ *  - printSize
  *  - printChar
  *  - printString
  *  - copyInt
+ *  - copySize
  *  - copyChar
  *  - copyString
+ *  - withExtension
  *  - charBitsToChar
  *  - strToInt
  *  - decimalToBinary
  *  - pointerAllocError
  *  - pointerNullError
+ *  - getFileSize
+ *  - storeLittleEndian
+ *  - loadLittleEndian
  */
 
 /* ========================================================= */
@@ -38,6 +44,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h> /**< used for strlen, strcpy and strcat function */
+#include <stdint.h> /**< used for uint64_t */
 #include <math.h> /**< used for pow function */
 
 /* =========== Functions =========== */
@@ -70,6 +77,16 @@ int equalsInt(void *val1, void *val2);
  */
 void printInt(void *elem);
 
+/**
+ * @function printSize
+ * @brief Prints a size (or a count).
+ *
+ * @param{void*} elem: pointer on the size_t (the pointer is generic).
+ *
+ * @return{void}
+ */
+void printSize(void *elem);
+
 /**
  * @function printChar
  * @brief Prints a character.
@@ -105,10 +122,22 @@ void printString(void *elem);
  *
  * @param{void*} elem: pointer on the integer to copy (the pointer is generic).
  *
- * @return{void*}: The generic pointer of the new integer.
+ * @return{void*}: The generic pointer of the new integer, NULL if memory can't
+ *                 be allocated.
  */
 void* copyInt(void *elem);
 
+/**
+ * @function copySize
+ * @brief Returns the pointer of the copy of the given size (or count).
+ *
+ * @param{void*} elem: pointer on the size_t to copy (the pointer is generic).
+ *
+ * @return{void*}: The generic pointer of the new size_t, NULL if memory can't
+ *                 be allocated.
+ */
+void* copySize(void *elem);
+
 /**
  * @function copyChar
  * @brief Returns the pointer of the copy of the given character.
@@ -118,7 +147,8 @@ void* copyInt(void *elem);
  *
  * @param{void*} elem: pointer on the character to copy (the pointer is generic).
  *
- * @return{void*}: The generic pointer of the new character.
+ * @return{void*}: The generic pointer of the new character, NULL if memory
+ *                 can't be allocated.
  */
 void* copyChar(void *elem);
 
@@ -131,10 +161,22 @@ void* copyChar(void *elem);
  *
  * @param{void*} elem: pointer on the string to copy (the pointer is generic).
  *
- * @return{void*}: The generic pointer of the new string.
+ * @return{void*}: The generic pointer of the new string, NULL if memory can't
+ *                 be allocated.
  */
 void* copyString(void *elem);
 
+/**
+ * @function withExtension
+ * @brief Makes a file name from another and an extension.
+ *
+ * @param{char*} name: name of the file.
+ * @param{char*} extension: extension to add (ex: ".key").
+ *
+ * @return{char*}: the new name, to free, NULL if memory can't be allocated.
+ */
+char* withExtension(char *name, char *extension);
+
 /**
  * @function charBitsToChar
  * @brief Returns the character corresponding to a sequence of bits.
@@ -197,6 +239,39 @@ void pointerAllocError();
  */
 void pointerNullError();
 
+/**
+ * @function getFileSize
+ * @brief Returns the size of a file.
+ *
+ * @param{char*} fileName: name of the file.
+ *
+ * @return{long long}: size of the file in bytes, -1 if it can't be opened.
+ */
+long long getFileSize(char *fileName);
+
+/**
+ * @function storeLittleEndian
+ * @brief Writes an integer in little endian in a buffer.
+ *
+ * @param{unsigned char*} buffer: the buffer, of at least 'nbBytes' bytes.
+ * @param{uint64_t} value: the integer.
+ * @param{size_t} nbBytes: number of bytes to write.
+ *
+ * @return{void}
+ */
+void storeLittleEndian(unsigned char *buffer, uint64_t value, size_t nbBytes);
+
+/**
+ * @function loadLittleEndian
+ * @brief Reads an integer written by storeLittleEndian.
+ *
+ * @param{unsigned char*} buffer: the buffer.
+ * @param{size_t} nbBytes: number of bytes to read.
+ *
+ * @return{uint64_t}: the integer.
+ */
+uint64_t loadLittleEndian(unsigned char *buffer, size_t nbBytes);
+
 
 #endif
 
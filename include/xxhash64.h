@@ -0,0 +1,50 @@
+/**
+ * @file xxhash64.h
+ * @author agent <agent@local>
+ * @standard C99
+ * @version 1.0
+ * @date 18th October 2026
+ *
+ * @brief Header file for the XXH64 hash.
+ *
+ * XXH64 is a fast non-cryptographic hash of 64 bits (the one of the xxHash
+ * library, of which it gives the same values), several GB/s on one core. It is
+ * used to recognize the files already coded (@see @file cache.h), where the
+ * CRC32C would be too short to tell many files apart.
+ *
+ * Overview about public functions of xxhash64:
+ *  - xxHash64
+ */
+
+/* ========================================================= */
+/* ================ XXHASH64_H FILE HEADER ================= */
+/* ========================================================================== */
+
+#ifndef XXHASH64_H
+#define XXHASH64_H
+
+/* ============ Includes =========== */
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+/* =========== Functions =========== */
+
+/**
+ * @function xxHash64
+ * @brief Computes the XXH64 hash of some data.
+ *
+ * @param{const unsigned char*} data: the data.
+ * @param{size_t} size: size of the data.
+ * @param{uint64_t} seed: seed of the hash, giving another hash for each value.
+ *
+ * @return{uint64_t}: the hash.
+ */
+uint64_t xxHash64(const unsigned char *data, size_t size, uint64_t seed);
+
+
+#endif
+
+/* ========================================================================== */
+/* ========================================================================== */
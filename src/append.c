@@ -0,0 +1,345 @@
+/**
+ * @file append.c
+ * @author agent <agent@local>
+ * @standard C99
+ * @version 1.0
+ * @date 18th October 2026
+ *
+ * @brief Implementation file for "append.h"
+ *
+ * This file implements the append of a file to a ".hfm" file and the
+ * concatenation of ".hfm" files, both without decoding the blocks already
+ * encrypted.
+ *
+ * Overview about private functions of append:
+ *  - getLastTree
+ *  - getDefaultTableUses
+ *  - copyBlocksOfFile
+ *
+ * Overview about public functions of append:
+ *  - huffmanAppendFile
+ *  - concatenateFiles
+ */
+
+#define _GNU_SOURCE
+#include "append.h"
+
+
+/* ================================================== */
+/* ============== DEF PRIVATE FUNCTIONS ============= */
+/* ========================================================================== */
+
+
+/**
+ * @function getLastTree
+ * @brief Gets the tree decoding the last blocks of a ".hfm" file.
+ *
+ * @param{FILE*} file: the ".hfm" file.
+ * @param{ctn} container: its header and its block index.
+ * @param{char*} fileKey: name of its key file, only read if the last blocks are
+ *                        coded with it (can be NULL).
+ * @param{nd*} tree: receives the tree, NULL if it is empty or the key is not
+ *                   known.
+ *
+ * @return{int}: 0 if the tree is given, -1 if memory can't be allocated, -2 if
+ *               the last table block is corrupted.
+ */
+int getLastTree(FILE *file, ctn container, char *fileKey, nd *tree);
+
+/**
+ * @function getDefaultTableUses
+ * @brief Tells which blocks of a ".hfm" file are coded with the table of its
+ * header or of its key.
+ *
+ * @param{FILE*} file: the ".hfm" file.
+ * @param{ctn} container: its header and its block index.
+ * @param{int*} uses: receives 1 if a block is coded with it.
+ * @param{int*} usesAgain: receives 1 if a block following a table block going
+ *                         back to it (@see HFM_TABLE_KEY) is coded with it.
+ *
+ * @return{int}: 0 if the blocks have been read, -2 if one is corrupted.
+ */
+int getDefaultTableUses(FILE *file, ctn container, int *uses, int *usesAgain);
+
+/**
+ * @function copyBlocksOfFile
+ * @brief Copies all the blocks of a ".hfm" file, without reading them.
+ *
+ * @param{FILE*} fileIn: the ".hfm" file, positioned at its first block.
+ * @param{FILE*} fileOut: the file written, positioned after its blocks.
+ * @param{ctn} container: the header and the block index of fileIn.
+ * @param{unsigned char*} buffer: buffer of HFM_BLOCK_SIZE bytes.
+ *
+ * @return{int}: 0 if the blocks have been copied, -1 otherwise.
+ */
+int copyBlocksOfFile(FILE *fileIn, FILE *fileOut, ctn container, unsigned char *buffer);
+
+
+/* ================================================== */
+/* ===================== PUBLIC ===================== */
+/* ========================================================================== */
+
+
+/**
+ * @see @file append.h / @function huffmanAppendFile
+ */
+int huffmanAppendFile(char *fileIn, char *fileArchive, char *fileKey, double samplingRate) {
+  long long fileSize = getFileSize(fileIn);
+  FILE *fileToRead = fopen(fileIn, "rb");
+  if(fileToRead == NULL) {
+    perror(fileIn);
+    return -1;
+  }
+  FILE *archive = fopen(fileArchive, "r+b");
+  if(archive == NULL) {
+    perror(fileArchive);
+    fclose(fileToRead);
+    return -1;
+  }
+  nd lastTree = NULL;
+  ctn container = readContainer(archive);
+  int result = (container != NULL) ? getLastTree(archive, container, fileKey, &lastTree) : -2;
+  if(result != 0) {
+    if(result == -2) printf("'%s' is not a .hfm file\n", fileArchive);
+    destroyContainer(&container);
+    fclose(archive);
+    fclose(fileToRead);
+    return result;
+  }
+  // The table of the new data, and the estimated size of each way to code it
+  lst charOccurrences = charOccurrencesOfFileSampled(fileIn, samplingRate);
+  if(charOccurrences == NULL) {
+    destroyNode(&lastTree);
+    destroyContainer(&container);
+    fclose(archive);
+    fclose(fileToRead);
+    return -1;
+  }
+  size_t histogram[256];
+  histogramOfOccurrences(charOccurrences, histogram);
+  nd newTree = contructBinaryTree(charOccurrences);
+  int isTreeMissing = (newTree == NULL && getListSize(charOccurrences) > 0);
+  destroyList(&charOccurrences);
+  int maxPrefixLength = 0;
+  lst lastPrefixes = (lastTree != NULL) ? prefixesList(lastTree, &maxPrefixLength) : createList();
+  lst newPrefixes = (newTree != NULL) ? prefixesList(newTree, &maxPrefixLength) : createList();
+  destroyNode(&lastTree);
+  destroyNode(&newTree);
+  if(isTreeMissing || lastPrefixes == NULL || newPrefixes == NULL) {
+    destroyList(&lastPrefixes);
+    destroyList(&newPrefixes);
+    destroyContainer(&container);
+    fclose(archive);
+    fclose(fileToRead);
+    return -1;
+  }
+  char *lastCodes[256], *newCodes[256];
+  prefixesTable(lastPrefixes, lastCodes);
+  prefixesTable(newPrefixes, newCodes);
+  size_t sampleSize = 0;
+  for (size_t c = 0; c < 256; c++) sampleSize += histogram[c];
+  double scale = (sampleSize > 0) ? (double)fileSize / (double)sampleSize : 0;
+  size_t lastSize = estimateCodedSize(histogram, lastCodes);
+  size_t newSize = estimateCodedSize(histogram, newCodes);
+  double lastCost = (lastSize != SIZE_MAX) ? scale * (double)lastSize : (double)fileSize + 1;
+  double newCost = (newSize != SIZE_MAX) ? scale * (double)newSize : (double)fileSize + 1;
+  newCost += HFM_BLOCK_HEADER_SIZE + 1 + histogramEncodedSize(histogram);
+  char **codes = lastCodes; // Blocks not smaller once coded are stored anyway
+  if(newCost < lastCost && newCost < (double)fileSize) codes = newCodes;
+  else if(lastCost >= (double)fileSize) for (size_t c = 0; c < 256; c++) lastCodes[c] = NULL;
+  // The new blocks overwrite the index, written again after them
+  unsigned char *block = (unsigned char*)malloc(HFM_BLOCK_SIZE);
+  unsigned char *payload = (unsigned char*)malloc(HFM_BLOCK_SIZE);
+  result = (block != NULL && payload != NULL && fseeko(archive, (off_t)getContainerIndexOffset(container), SEEK_SET) == 0) ? 0 : -1;
+  if(result == 0 && codes == newCodes) writeTableBlockOfOpenedFile(archive, container, histogram);
+  size_t blockSize;
+  while(result == 0 && (blockSize = fread(block, 1, HFM_BLOCK_SIZE, fileToRead)) > 0)
+    writeBlockOfOpenedFile(archive, container, block, blockSize, payload, encodeBlockWithCodes, codes);
+  if(result == 0 && (ferror(fileToRead) || finishContainer(container, archive) != 0)) result = -1;
+  if(fclose(archive) != 0) result = -1;
+  if(result != 0) perror(fileArchive);
+  free(block);
+  free(payload);
+  destroyList(&lastPrefixes);
+  destroyList(&newPrefixes);
+  destroyContainer(&container);
+  fclose(fileToRead);
+  return result;
+}
+
+/**
+ * @see @file append.h / @function concatenateFiles
+ */
+int concatenateFiles(char **filesIn, int nbFiles, char *fileOut) {
+  FILE **files = (FILE**)calloc((size_t)nbFiles, sizeof(FILE*));
+  ctn *containers = (ctn*)calloc((size_t)nbFiles, sizeof(ctn));
+  size_t (*tables)[256] = (size_t(*)[256])calloc((size_t)nbFiles, sizeof(*tables));
+  int *usesTable = (int*)calloc((size_t)nbFiles, sizeof(int));
+  if(files == NULL || containers == NULL || tables == NULL || usesTable == NULL) {
+    free(usesTable);
+    free(tables);
+    free(containers);
+    free(files);
+    return -1;
+  }
+  int result = 0;
+  int allTables = 1; // 1 if every file has its table in its header
+  int keyOfFile = -1; // File giving the key of the result, -1 if none is needed
+  unsigned int checksums = HFM_CONTAINER_CHECKSUMS;
+  for (int i = 0; i < nbFiles && result == 0; i++) {
+    int usesAgain = 0;
+    files[i] = fopen(filesIn[i], "rb");
+    if(files[i] == NULL) {
+      perror(filesIn[i]);
+      result = -1;
+    } else if((containers[i] = readContainer(files[i])) == NULL
+              || getDefaultTableUses(files[i], containers[i], &usesTable[i], &usesAgain) != 0) {
+      printf("'%s' is not a .hfm file\n", filesIn[i]);
+      result = -2;
+    } else {
+      allTables = allTables && hasContainerTable(containers[i]);
+      checksums &= getContainerChecksums(containers[i]);
+    }
+    // The table of a file coded with a key is the key "<file>.key"
+    if(result == 0 && hasContainerTable(containers[i]))
+      memcpy(tables[i], getContainerHistogram(containers[i]), sizeof(tables[i]));
+    else if(result == 0 && usesTable[i]) {
+      char *fileKey = withExtension(filesIn[i], ".key");
+      if(fileKey == NULL) result = -1;
+      else if(getHistogramFromKeyFile(fileKey, tables[i]) != 0) {
+        perror(fileKey);
+        result = -1;
+      } else if(keyOfFile < 0) keyOfFile = i;
+      free(fileKey);
+    }
+    // A table block going back to the table of the file would go back to the one of the result
+    int isTableOfResult = (allTables && i == 0)
+                          || (!hasContainerTable(containers[i]) && keyOfFile >= 0
+                              && !memcmp(tables[i], tables[keyOfFile], sizeof(tables[i])));
+    if(result == 0 && usesAgain && !isTableOfResult) {
+      printf("'%s' can't be joined: its blocks go back to its own table\n", filesIn[i]);
+      result = -2;
+    }
+  }
+  FILE *fileToWrite = NULL;
+  if(result == 0 && !allTables && keyOfFile >= 0) {
+    // The result is coded with the key of its first file coded with a key
+    lst occurrences = occurrencesFromHistogram(tables[keyOfFile]);
+    char *fileKey = withExtension(fileOut, ".key");
+    result = saveKeyInFile(occurrences, fileKey);
+    free(fileKey);
+    destroyList(&occurrences);
+  }
+  if(result == 0 && (fileToWrite = fopen(fileOut, "wb")) == NULL) {
+    perror(fileOut);
+    result = -1;
+  }
+  if(result == 0) {
+    ctn container = createContainer((allTables && nbFiles > 0) ? getContainerHistogram(containers[0]) : NULL, checksums);
+    unsigned char *buffer = (unsigned char*)malloc(HFM_BLOCK_SIZE);
+    result = (container != NULL && buffer != NULL) ? writeContainerHeader(container, fileToWrite) : -1;
+    int isDefault = 1; // 1 if the last blocks written use the table of the header or the key
+    for (int i = 0; i < nbFiles && result == 0; i++) {
+      int isTableOfResult = (allTables && i == 0)
+                            || (!hasContainerTable(containers[i]) && keyOfFile >= 0
+                                && !memcmp(tables[i], tables[keyOfFile], sizeof(tables[i])));
+      if(usesTable[i] && !isTableOfResult) {
+        writeTableBlockOfOpenedFile(fileToWrite, container, tables[i]);
+        isDefault = 0;
+      } else if(usesTable[i] && !isDefault) {
+        writeTableBlockOfOpenedFile(fileToWrite, container, NULL);
+        isDefault = 1;
+      }
+      result = copyBlocksOfFile(files[i], fileToWrite, containers[i], buffer);
+      appendContainer(container, containers[i]);
+      for (size_t j = 0; j < getContainerNbBlocks(containers[i]); j++)
+        if(isContainerTableBlock(containers[i], j)) isDefault = 0;
+    }
+    if(result == 0) result = finishContainer(container, fileToWrite);
+    if(fclose(fileToWrite) != 0) result = -1;
+    if(result != 0) perror(fileOut);
+    free(buffer);
+    destroyContainer(&container);
+  }
+  for (int i = 0; i < nbFiles; i++) {
+    destroyContainer(&containers[i]);
+    if(files[i] != NULL) fclose(files[i]);
+  }
+  free(usesTable);
+  free(tables);
+  free(containers);
+  free(files);
+  return result;
+}
+
+
+/* ================================================== */
+/* ===================== PRIVATE ==================== */
+/* ========================================================================== */
+
+
+/**
+ * @see @file append.c / @function getLastTree
+ */
+int getLastTree(FILE *file, ctn container, char *fileKey, nd *tree) {
+  *tree = NULL;
+  for (size_t i = getContainerNbBlocks(container); i > 0; i--) {
+    if(isContainerTableBlock(container, i - 1)) {
+      size_t histogram[256];
+      if(fseeko(file, (off_t)getContainerBlockOffset(container, i - 1), SEEK_SET) != 0) return -2;
+      int result = readTableBlockOfOpenedFile(file, container, i - 1, histogram);
+      if(result < 0) return -2;
+      if(result == 1) {
+        *tree = getTreeFromHistogram(histogram);
+        return (*tree != NULL) ? 0 : -1;
+      }
+      break; // Back to the table of the header or the key
+    }
+  }
+  *tree = getTreeFromContainer(container, fileKey);
+  return (*tree == NULL && hasContainerTable(container)) ? -1 : 0;
+}
+
+/**
+ * @see @file append.c / @function getDefaultTableUses
+ */
+int getDefaultTableUses(FILE *file, ctn container, int *uses, int *usesAgain) {
+  int isDefault = 1;
+  int isBack = 0; // 1 after a table block going back to the default table
+  *uses = 0;
+  *usesAgain = 0;
+  for (size_t i = 0; i < getContainerNbBlocks(container); i++) {
+    // The type of a block is the first byte of its header, the kind of a table the first byte of its payload
+    long long offset = getContainerBlockOffset(container, i);
+    int isTable = isContainerTableBlock(container, i);
+    if(isTable) offset += HFM_BLOCK_HEADER_SIZE;
+    if(fseeko(file, (off_t)offset, SEEK_SET) != 0) return -2;
+    int c = fgetc(file);
+    if(c == EOF) return -2;
+    if(isTable) {
+      isDefault = (c == HFM_TABLE_KEY);
+      isBack = isBack || isDefault;
+    } else if(c == HFM_BLOCK_HUFFMAN && isDefault) {
+      *uses = 1;
+      *usesAgain = *usesAgain || isBack;
+    }
+  }
+  return 0;
+}
+
+/**
+ * @see @file append.c / @function copyBlocksOfFile
+ */
+int copyBlocksOfFile(FILE *fileIn, FILE *fileOut, ctn container, unsigned char *buffer) {
+  long long size = getContainerIndexOffset(container) - getContainerFirstBlockOffset(container);
+  if(fseeko(fileIn, (off_t)getContainerFirstBlockOffset(container), SEEK_SET) != 0) return -1;
+  while(size > 0) { // copyStoredBlock reads at most HFM_BLOCK_SIZE bytes at once
+    size_t part = (size < HFM_BLOCK_SIZE) ? (size_t)size : HFM_BLOCK_SIZE;
+    if(copyStoredBlock(fileIn, fileOut, part, buffer) != 0) return -1;
+    size -= (long long)part;
+  }
+  return 0;
+}
+
+/* ========================================================================== */
+/* ========================================================================== */
@@ -0,0 +1,874 @@
+/**
+ * @file archive.c
+ * @author agent <agent@local>
+ * @standard C99
+ * @version 1.0
+ * @date 18th October 2026
+ *
+ * @brief Implementation file for "archive.h"
+ *
+ * This file implements the packing of files in an archive and their
+ * extraction, both by a task per member run by the workers of a scheduler
+ * (@see @file scheduler.h). With the deduplication, a task cuts its member in
+ * chunks and only adds the new ones to the packs (@see @file dedup.h), and a
+ * task extracting decodes the chunks of its member from their packs.
+ *
+ * Overview about private functions of archive:
+ *  - addArchivePath
+ *  - compareNames
+ *  - memberName
+ *  - isSafeMemberName
+ *  - runArchiveTasks
+ *  - setArchiveResult
+ *  - packerTask
+ *  - packMember
+ *  - unpackerTask
+ *  - unpackMember
+ *  - createParentDirectories
+ *  - writeArchiveDirectory
+ *  - readArchiveDirectory
+ *  - destroyArchiveEntries
+ *
+ * Overview about public functions of archive:
+ *  - huffmanArchiveFiles
+ *  - huffmanExtractFiles
+ *  - listArchiveMembers
+ */
+
+#define _GNU_SOURCE /**< fseeko, ftello, fileno and the pthreads */
+#include "archive.h"
+
+#include <pthread.h>
+#include <errno.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+
+
+/**
+ * @struct archiveEntry
+ * @brief A member of an archive, as in the directory.
+ */
+struct archiveEntry {
+  char *name; /**< Name of the member */
+  char *path; /**< File packed, NULL when extracting */
+  unsigned int mode; /**< Permissions of the file */
+  long long originalSize; /**< Size of the file */
+  long long offset; /**< Offset of the container in the archive (index of its first chunk with deduplication) */
+  long long storedSize; /**< Size of the container (number of chunks with deduplication) */
+  struct archiveJobs *jobs; /**< The members, for the task of the member */
+  uint32_t *chunks; /**< Indexes of its chunks, when packing with deduplication */
+  size_t nbChunks; /**< Number of chunks, when packing with deduplication */
+  int selected; /**< 1 if the member is packed or extracted */
+};
+
+/**
+ * @struct archiveJobs
+ * @brief The members shared by the tasks.
+ */
+struct archiveJobs {
+  struct archiveEntry *entries; /**< The members */
+  size_t nbEntries; /**< Number of members */
+  sch scheduler; /**< Workers running the tasks, NULL to run them in the calling thread */
+  FILE **archives; /**< Archive opened by each worker, when extracting */
+  ddr *readers; /**< Reader of the chunks of each worker, when extracting with deduplication */
+  size_t nbReaders; /**< Workers, and the calling thread last */
+  char *fileArchive; /**< Name of the archive */
+  FILE *archive; /**< Archive written, when packing */
+  char *directory; /**< Directory receiving the members, when extracting */
+  unsigned int checksums; /**< Checksums written in each member */
+  cch cache; /**< Files already coded, NULL if none */
+  ddp dedup; /**< Unique chunks, NULL without deduplication */
+  uint32_t *chunks; /**< Chunks of the members in the directory, when extracting */
+  size_t nbChunks; /**< Number of chunks in the directory */
+  int result; /**< First error of the tasks, 0 if none */
+  pthread_mutex_t lock; /**< Lock of the archive written and of 'result' */
+};
+
+
+/* ================================================== */
+/* ============== DEF PRIVATE FUNCTIONS ============= */
+/* ========================================================================== */
+
+
+/**
+ * @function addArchivePath
+ * @brief Adds a file, or the files of a directory and its sub-directories, to
+ * the members to pack.
+ *
+ * The files of a directory are added in the order of their names, so that the
+ * same tree gives the same directory. The symbolic links to directories are not
+ * followed.
+ *
+ * @param{char*} path: the file or the directory.
+ * @param{struct archiveEntry**} entries: the members, reallocated.
+ * @param{size_t*} nbEntries: number of members, updated.
+ * @param{size_t*} capacity: number of members allocated, updated.
+ * @param{struct stat*} archiveStat: the archive written, which is not added.
+ *
+ * @return{int}: 0 if the path has been added, -1 if it can't be read.
+ */
+int addArchivePath(char *path, struct archiveEntry **entries, size_t *nbEntries, size_t *capacity, struct stat *archiveStat);
+
+/**
+ * @function compareNames
+ * @brief Compares two names, for qsort.
+ *
+ * @param{const void*} name1: pointer on the first name.
+ * @param{const void*} name2: pointer on the second name.
+ *
+ * @return{int}: as strcmp.
+ */
+int compareNames(const void *name1, const void *name2);
+
+/**
+ * @function memberName
+ * @brief Returns the name of the member of a path: the path without its
+ * leading '/' and "./".
+ *
+ * @param{char*} path: the path.
+ *
+ * @return{char*}: the name, to free.
+ */
+char* memberName(char *path);
+
+/**
+ * @function isSafeMemberName
+ * @brief Tells if a member can be extracted without writing outside of the
+ * directory given.
+ *
+ * @param{char*} name: name of the member.
+ *
+ * @return{int}: 1 if the name is relative and has no "..", 0 otherwise.
+ */
+int isSafeMemberName(char *name);
+
+/**
+ * @function runArchiveTasks
+ * @brief Runs a task per member on the workers of a scheduler, or in the
+ * calling thread if the scheduler can't be created.
+ *
+ * @param{struct archiveJobs*} jobs: the members.
+ * @param{int} nbThreads: number of workers, 0 for one per processor.
+ * @param{schedulerFunction} function: function of the task of a member.
+ *
+ * @return{void}
+ */
+void runArchiveTasks(struct archiveJobs *jobs, int nbThreads, schedulerFunction function);
+
+/**
+ * @function setArchiveResult
+ * @brief Keeps the first error of the tasks.
+ *
+ * @param{struct archiveJobs*} jobs: the members.
+ * @param{int} result: result of a member.
+ *
+ * @return{void}
+ */
+void setArchiveResult(struct archiveJobs *jobs, int result);
+
+/**
+ * @function packerTask
+ * @brief Task packing a member.
+ *
+ * @param{void*} entry: the struct archiveEntry.
+ * @param{csc} scratch: scratch space of the worker.
+ *
+ * @return{void}
+ */
+void packerTask(void *entry, csc scratch);
+
+/**
+ * @function packMember
+ * @brief Codes a file and writes it at the end of the archive, or adds its
+ * chunks to the packs with deduplication.
+ *
+ * The blocks of a file of more than HFM_ARCHIVE_MAX_MEMORY bytes are coded by
+ * the tasks of all the workers, so the workers having no member left help
+ * with the big ones.
+ *
+ * @param{struct archiveJobs*} jobs: the members.
+ * @param{struct archiveEntry*} entry: the member, receiving its offset and
+ *                                     its size.
+ * @param{csc} scratch: scratch space of the worker (can be NULL).
+ *
+ * @return{int}: 0 if the member has been written, -1 otherwise.
+ */
+int packMember(struct archiveJobs *jobs, struct archiveEntry *entry, csc scratch);
+
+/**
+ * @function unpackerTask
+ * @brief Task extracting a member, if it is selected.
+ *
+ * Each worker opens the archive once, to seek in it without the other
+ * workers.
+ *
+ * @param{void*} entry: the struct archiveEntry.
+ * @param{csc} scratch: scratch space of the worker.
+ *
+ * @return{void}
+ */
+void unpackerTask(void *entry, csc scratch);
+
+/**
+ * @function unpackMember
+ * @brief Decodes a member in its file.
+ *
+ * @param{struct archiveJobs*} jobs: the members.
+ * @param{struct archiveEntry*} entry: the member.
+ * @param{FILE*} archive: the archive, opened by the worker (NULL with
+ *                        deduplication).
+ * @param{ddr} packs: reader of the chunks of the worker, with deduplication
+ *                    (NULL otherwise).
+ *
+ * @return{int}: 0 if the member has been extracted, -1 on an error of the
+ *               files, -2 if it is corrupted, -3 if it does not match its
+ *               checksums.
+ */
+int unpackMember(struct archiveJobs *jobs, struct archiveEntry *entry, FILE *archive, ddr packs);
+
+/**
+ * @function createParentDirectories
+ * @brief Creates the directories of a path, except its last component.
+ *
+ * @param{char*} path: the path.
+ *
+ * @return{int}: 0 if the directories exist, -1 otherwise.
+ */
+int createParentDirectories(char *path);
+
+/**
+ * @function writeArchiveDirectory
+ * @brief Writes the directory of the members packed and the header of an
+ * archive.
+ *
+ * @param{FILE*} archive: the archive, positioned after its members.
+ * @param{struct archiveEntry*} entries: the members, only the ones selected
+ *                                       are written.
+ * @param{size_t} nbEntries: number of members.
+ * @param{ddp} dedup: the unique chunks, NULL without deduplication.
+ *
+ * @return{int}: 0 if the directory has been written, -1 otherwise.
+ */
+int writeArchiveDirectory(FILE *archive, struct archiveEntry *entries, size_t nbEntries, ddp dedup);
+
+/**
+ * @function readArchiveDirectory
+ * @brief Reads and checks the directory of an archive.
+ *
+ * @param{FILE*} archive: the archive.
+ * @param{struct archiveJobs*} jobs: receives the members, and the chunks with
+ *                                   deduplication.
+ *
+ * @return{int}: 0 if the directory has been read, -2 if the archive is
+ *               corrupted.
+ */
+int readArchiveDirectory(FILE *archive, struct archiveJobs *jobs);
+
+/**
+ * @function destroyArchiveEntries
+ * @brief Frees the members.
+ *
+ * @param{struct archiveEntry*} entries: the members.
+ * @param{size_t} nbEntries: number of members.
+ *
+ * @return{void}
+ */
+void destroyArchiveEntries(struct archiveEntry *entries, size_t nbEntries);
+
+
+/* ================================================== */
+/* ===================== PUBLIC ===================== */
+/* ========================================================================== */
+
+
+/**
+ * @see @file archive.h / @function huffmanArchiveFiles
+ */
+int huffmanArchiveFiles(char **paths, int nbPaths, char *fileArchive, unsigned int checksums, int nbThreads, cch cache, int dedup) {
+  FILE *archive = fopen(fileArchive, "wb");
+  struct stat archiveStat;
+  if(archive == NULL || fstat(fileno(archive), &archiveStat) != 0) {
+    perror(fileArchive);
+    if(archive != NULL) fclose(archive);
+    return -1;
+  }
+  struct archiveJobs jobs;
+  jobs.entries = NULL;
+  jobs.nbEntries = 0;
+  jobs.fileArchive = fileArchive;
+  jobs.archive = archive;
+  jobs.directory = NULL;
+  jobs.checksums = checksums;
+  jobs.cache = cache;
+  jobs.dedup = dedup ? createDedup(archive, &jobs.lock, checksums, cache) : NULL;
+  jobs.chunks = NULL;
+  jobs.nbChunks = 0;
+  jobs.result = 0;
+  pthread_mutex_init(&jobs.lock, NULL);
+  size_t capacity = 0;
+  for (int i = 0; i < nbPaths; i++)
+    if(addArchivePath(paths[i], &jobs.entries, &jobs.nbEntries, &capacity, &archiveStat) != 0) jobs.result = -1;
+  unsigned char header[HFM_ARCHIVE_HEADER_SIZE];
+  memset(header, 0, HFM_ARCHIVE_HEADER_SIZE); // Written again after the directory
+  if(fwrite(header, 1, HFM_ARCHIVE_HEADER_SIZE, archive) != HFM_ARCHIVE_HEADER_SIZE) jobs.result = -1;
+  runArchiveTasks(&jobs, nbThreads, packerTask);
+  if(jobs.dedup != NULL && flushDedup(jobs.dedup) != 0) jobs.result = -1;
+  int result = writeArchiveDirectory(archive, jobs.entries, jobs.nbEntries, jobs.dedup);
+  if(fclose(archive) != 0) result = -1;
+  if(result != 0) perror(fileArchive);
+  if(jobs.result != 0) result = jobs.result;
+  pthread_mutex_destroy(&jobs.lock);
+  destroyArchiveEntries(jobs.entries, jobs.nbEntries);
+  destroyDedup(&jobs.dedup);
+  return result;
+}
+
+/**
+ * @see @file archive.h / @function huffmanExtractFiles
+ */
+int huffmanExtractFiles(char *fileArchive, char *directory, char **members, int nbMembers, int nbThreads) {
+  FILE *archive = fopen(fileArchive, "rb");
+  if(archive == NULL) {
+    perror(fileArchive);
+    return -1;
+  }
+  struct archiveJobs jobs;
+  int valid = readArchiveDirectory(archive, &jobs);
+  fclose(archive);
+  if(valid != 0) {
+    printf("'%s' is not a .hfa file\n", fileArchive);
+    return -2;
+  }
+  jobs.fileArchive = fileArchive;
+  jobs.archive = NULL;
+  jobs.directory = directory;
+  jobs.checksums = 0;
+  jobs.cache = NULL;
+  jobs.result = 0;
+  pthread_mutex_init(&jobs.lock, NULL);
+  for (size_t i = 0; i < jobs.nbEntries; i++) jobs.entries[i].selected = (nbMembers == 0);
+  for (int m = 0; m < nbMembers; m++) {
+    size_t length = strlen(members[m]);
+    while(length > 1 && members[m][length - 1] == '/') length--; // "dir/" selects the members of "dir"
+    int found = 0;
+    for (size_t i = 0; i < jobs.nbEntries; i++) {
+      char *name = jobs.entries[i].name;
+      if(!strncmp(name, members[m], length) && (name[length] == '\0' || name[length] == '/')) {
+        jobs.entries[i].selected = 1;
+        found = 1;
+      }
+    }
+    if(!found) {
+      printf("'%s' is not in '%s'\n", members[m], fileArchive);
+      jobs.result = -1;
+    }
+  }
+  runArchiveTasks(&jobs, nbThreads, unpackerTask);
+  pthread_mutex_destroy(&jobs.lock);
+  destroyArchiveEntries(jobs.entries, jobs.nbEntries);
+  destroyDedup(&jobs.dedup);
+  free(jobs.chunks);
+  return jobs.result;
+}
+
+/**
+ * @see @file archive.h / @function listArchiveMembers
+ */
+int listArchiveMembers(char *fileArchive) {
+  FILE *archive = fopen(fileArchive, "rb");
+  if(archive == NULL) {
+    perror(fileArchive);
+    return -1;
+  }
+  struct archiveJobs jobs;
+  int valid = readArchiveDirectory(archive, &jobs);
+  fclose(archive);
+  if(valid != 0) {
+    printf("'%s' is not a .hfa file\n", fileArchive);
+    return -2;
+  }
+  struct archiveEntry *entries = jobs.entries;
+  long long originalSize = 0, storedSize = 0;
+  for (size_t i = 0; i < jobs.nbEntries; i++) {
+    if(jobs.dedup != NULL) printf("%04o %12lld %7lld chunks  %s\n", entries[i].mode, entries[i].originalSize, entries[i].storedSize, entries[i].name);
+    else printf("%04o %12lld %12lld  %s\n", entries[i].mode, entries[i].originalSize, entries[i].storedSize, entries[i].name);
+    originalSize += entries[i].originalSize;
+    storedSize += entries[i].storedSize;
+  }
+  printf("%zu members. Original size: %lld bytes", jobs.nbEntries, originalSize);
+  if(jobs.dedup != NULL) {
+    storedSize = getDedupStoredSize(jobs.dedup);
+    printf(". Unique chunks: %zu (%lld bytes)", getDedupNbChunks(jobs.dedup), getDedupUniqueSize(jobs.dedup));
+  }
+  printf(". Encrypted: %lld bytes", storedSize);
+  if(originalSize > 0) printf(" (%.2f%%)", 100.0 * storedSize / originalSize);
+  printf("\n");
+  destroyArchiveEntries(jobs.entries, jobs.nbEntries);
+  destroyDedup(&jobs.dedup);
+  free(jobs.chunks);
+  return 0;
+}
+
+
+/* ================================================== */
+/* ===================== PRIVATE ==================== */
+/* ========================================================================== */
+
+
+/**
+ * @see @file archive.c / @function addArchivePath
+ */
+int addArchivePath(char *path, struct archiveEntry **entries, size_t *nbEntries, size_t *capacity, struct stat *archiveStat) {
+  struct stat pathStat;
+  if(lstat(path, &pathStat) != 0 || (S_ISLNK(pathStat.st_mode) && stat(path, &pathStat) != 0)) {
+    perror(path);
+    return -1;
+  }
+  if(pathStat.st_dev == archiveStat->st_dev && pathStat.st_ino == archiveStat->st_ino) return 0;
+  if(S_ISREG(pathStat.st_mode)) {
+    char *name = memberName(path);
+    if(strlen(name) > HFM_ARCHIVE_MAX_NAME || name[0] == '\0') {
+      fprintf(stderr, "%s: name not valid in an archive\n", path);
+      free(name);
+      return -1;
+    }
+    if(*nbEntries == *capacity) {
+      *capacity = (*capacity > 0) ? 2 * *capacity : 64;
+      struct archiveEntry *ptr = (struct archiveEntry*)realloc(*entries, *capacity * sizeof(struct archiveEntry));
+      if(ptr == NULL) pointerAllocError();
+      *entries = ptr;
+    }
+    struct archiveEntry *entry = &(*entries)[(*nbEntries)++];
+    entry->name = name;
+    entry->path = (char*)copyString(path);
+    if(entry->path == NULL) pointerAllocError();
+    entry->mode = (unsigned int)(pathStat.st_mode & 07777);
+    entry->originalSize = (long long)pathStat.st_size;
+    entry->offset = entry->storedSize = 0;
+    entry->chunks = NULL;
+    entry->nbChunks = 0;
+    entry->selected = 0; // Until it is written
+    return 0;
+  }
+  if(!S_ISDIR(pathStat.st_mode) || lstat(path, &pathStat) != 0 || !S_ISDIR(pathStat.st_mode)) return 0;
+  DIR *dir = opendir(path);
+  if(dir == NULL) {
+    perror(path);
+    return -1;
+  }
+  size_t nbNames = 0, allocated = 16;
+  char **names = (char**)malloc(allocated * sizeof(char*));
+  if(names == NULL) pointerAllocError();
+  struct dirent *dirEntry;
+  while((dirEntry = readdir(dir)) != NULL) {
+    if(!strcmp(dirEntry->d_name, ".") || !strcmp(dirEntry->d_name, "..")) continue;
+    if(nbNames == allocated) {
+      allocated *= 2;
+      char **ptr = (char**)realloc(names, allocated * sizeof(char*));
+      if(ptr == NULL) pointerAllocError();
+      names = ptr;
+    }
+    names[nbNames] = (char*)copyString(dirEntry->d_name);
+    if(names[nbNames++] == NULL) pointerAllocError();
+  }
+  closedir(dir);
+  qsort(names, nbNames, sizeof(char*), compareNames);
+  size_t pathLength = strlen(path);
+  int result = 0;
+  for (size_t i = 0; i < nbNames; i++) {
+    char *child = (char*)malloc(pathLength + strlen(names[i]) + 2);
+    if(child == NULL) pointerAllocError();
+    sprintf(child, (pathLength > 0 && path[pathLength - 1] == '/') ? "%s%s" : "%s/%s", path, names[i]);
+    if(addArchivePath(child, entries, nbEntries, capacity, archiveStat) != 0) result = -1;
+    free(child);
+    free(names[i]);
+  }
+  free(names);
+  return result;
+}
+
+/**
+ * @see @file archive.c / @function compareNames
+ */
+int compareNames(const void *name1, const void *name2) {
+  return strcmp(*(char* const*)name1, *(char* const*)name2);
+}
+
+/**
+ * @see @file archive.c / @function memberName
+ */
+char* memberName(char *path) {
+  while(path[0] == '/' || (path[0] == '.' && path[1] == '/')) path += (path[0] == '/') ? 1 : 2;
+  char *name = (char*)copyString(path);
+  if(name == NULL) pointerAllocError();
+  size_t j = 0; // "a//b" is "a/b"
+  for (size_t i = 0; name[i] != '\0'; i++)
+    if(name[i] != '/' || j == 0 || name[j - 1] != '/') name[j++] = name[i];
+  name[j] = '\0';
+  return name;
+}
+
+/**
+ * @see @file archive.c / @function isSafeMemberName
+ */
+int isSafeMemberName(char *name) {
+  if(name[0] == '\0' || name[0] == '/') return 0;
+  for (char *part = name; part != NULL; part = strchr(part, '/')) {
+    if(*part == '/') part++;
+    if(part[0] == '.' && part[1] == '.' && (part[2] == '/' || part[2] == '\0')) return 0;
+  }
+  return 1;
+}
+
+/**
+ * @see @file archive.c / @function runArchiveTasks
+ */
+void runArchiveTasks(struct archiveJobs *jobs, int nbThreads, schedulerFunction function) {
+  if(nbThreads < 1) nbThreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+  if(nbThreads < 1) nbThreads = 1;
+  if(nbThreads > HFM_ARCHIVE_MAX_THREADS) nbThreads = HFM_ARCHIVE_MAX_THREADS;
+  jobs->scheduler = createScheduler(nbThreads, 0);
+  jobs->nbReaders = ((jobs->scheduler != NULL) ? (size_t)getSchedulerSize(jobs->scheduler) : 0) + 1;
+  jobs->archives = (FILE**)calloc(jobs->nbReaders, sizeof(FILE*));
+  jobs->readers = (ddr*)calloc(jobs->nbReaders, sizeof(ddr));
+  if(jobs->archives == NULL || jobs->readers == NULL) pointerAllocError();
+  sgp group = (jobs->scheduler != NULL) ? createSchedulerGroup() : NULL;
+  for (size_t i = 0; i < jobs->nbEntries; i++) {
+    jobs->entries[i].jobs = jobs;
+    if(group == NULL || submitSchedulerTask(jobs->scheduler, group, function, &jobs->entries[i]) != 0)
+      function(&jobs->entries[i], NULL);
+  }
+  if(group != NULL) waitSchedulerGroup(jobs->scheduler, group);
+  destroySchedulerGroup(&group);
+  destroyScheduler(&jobs->scheduler);
+  for (size_t i = 0; i < jobs->nbReaders; i++) {
+    if(jobs->archives[i] != NULL) fclose(jobs->archives[i]);
+    closeDedupReader(&jobs->readers[i]);
+  }
+  free(jobs->archives);
+  free(jobs->readers);
+}
+
+/**
+ * @see @file archive.c / @function setArchiveResult
+ */
+void setArchiveResult(struct archiveJobs *jobs, int result) {
+  pthread_mutex_lock(&jobs->lock);
+  if(jobs->result == 0) jobs->result = result;
+  pthread_mutex_unlock(&jobs->lock);
+}
+
+/**
+ * @see @file archive.c / @function packerTask
+ */
+void packerTask(void *entry, csc scratch) {
+  struct archiveEntry *e = (struct archiveEntry*)entry;
+  if(packMember(e->jobs, e, scratch) != 0) setArchiveResult(e->jobs, -1);
+  else e->selected = 1;
+}
+
+/**
+ * @see @file archive.c / @function packMember
+ */
+int packMember(struct archiveJobs *jobs, struct archiveEntry *entry, csc scratch) {
+  int fd = open(entry->path, O_RDONLY | O_CLOEXEC);
+  struct stat fileStat;
+  if(fd < 0 || fstat(fd, &fileStat) != 0) {
+    perror(entry->path);
+    if(fd >= 0) close(fd);
+    return -1;
+  }
+  size_t size = (size_t)fileStat.st_size;
+  entry->originalSize = (long long)size; // The file may have changed since it was listed
+  unsigned char *data = NULL;
+  if(size > 0 && (data = (unsigned char*)mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0)) == MAP_FAILED) {
+    perror(entry->path);
+    close(fd);
+    return -1;
+  }
+  close(fd);
+  int result = 0;
+  if(jobs->dedup != NULL) { // Only its new chunks are kept, to be coded with the next ones
+    result = addDedupData(jobs->dedup, data, size, &entry->chunks, &entry->nbChunks);
+  } else { // Coded without the lock, written at once
+    size_t outSize = 0;
+    unsigned char *out = NULL;
+    if(size <= HFM_ARCHIVE_MAX_MEMORY) {
+      out = encryptBufferCached(jobs->cache, data, size, jobs->checksums, &outSize);
+    } else { // Its blocks are coded by the tasks of all the workers
+      size_t capacity = codecCompressBound(size);
+      out = (unsigned char*)malloc(capacity);
+      if(out != NULL && codecCompressParallel(jobs->scheduler, scratch, data, size, NULL, jobs->checksums, out, capacity, &outSize) != HFM_OK) {
+        free(out);
+        out = NULL;
+      }
+    }
+    if(out == NULL) result = -1;
+    pthread_mutex_lock(&jobs->lock);
+    entry->offset = (long long)ftello(jobs->archive);
+    if(result == 0 && (entry->offset < 0 || fwrite(out, 1, outSize, jobs->archive) != outSize)) result = -1;
+    pthread_mutex_unlock(&jobs->lock);
+    entry->storedSize = (long long)outSize;
+    free(out);
+  }
+  if(data != NULL) munmap(data, size);
+  if(result != 0) fprintf(stderr, "%s: can't be written in '%s'\n", entry->path, jobs->fileArchive);
+  return result;
+}
+
+/**
+ * @see @file archive.c / @function unpackerTask
+ */
+void unpackerTask(void *entry, csc scratch) {
+  (void)scratch;
+  struct archiveEntry *e = (struct archiveEntry*)entry;
+  struct archiveJobs *j = e->jobs;
+  if(!e->selected) return;
+  int worker = (j->scheduler != NULL) ? getSchedulerWorker(j->scheduler) : -1;
+  size_t slot = (worker >= 0) ? (size_t)worker : j->nbReaders - 1;
+  if(j->dedup != NULL && j->readers[slot] == NULL) j->readers[slot] = openDedupReader(j->dedup, j->fileArchive);
+  if(j->readers[slot] == NULL && j->archives[slot] == NULL && (j->archives[slot] = fopen(j->fileArchive, "rb")) == NULL) {
+    perror(j->fileArchive);
+    setArchiveResult(j, -1);
+    return;
+  }
+  int result = unpackMember(j, e, j->archives[slot], j->readers[slot]);
+  if(result != 0) setArchiveResult(j, result);
+}
+
+/**
+ * @see @file archive.c / @function unpackMember
+ */
+int unpackMember(struct archiveJobs *jobs, struct archiveEntry *entry, FILE *archive, ddr packs) {
+  if(!isSafeMemberName(entry->name)) {
+    fprintf(stderr, "%s: not extracted, outside of '%s'\n", entry->name, jobs->directory);
+    return -1;
+  }
+  ctn container = NULL;
+  if(packs == NULL) {
+    if(fseeko(archive, (off_t)entry->offset, SEEK_SET) != 0) return -2;
+    container = readContainer(archive);
+    if(container == NULL || getContainerOriginalSize(container) != entry->originalSize
+       || getContainerIndexOffset(container) > entry->offset + entry->storedSize) {
+      fprintf(stderr, "%s: corrupted in '%s'\n", entry->name, jobs->fileArchive);
+      destroyContainer(&container);
+      return -2;
+    }
+  }
+  char *path = (char*)malloc(strlen(jobs->directory) + strlen(entry->name) + 2);
+  if(path == NULL) pointerAllocError();
+  sprintf(path, "%s/%s", jobs->directory, entry->name);
+  FILE *fileOut = NULL;
+  int result = 0;
+  if(createParentDirectories(path) != 0 || (fileOut = fopen(path, "wb")) == NULL) {
+    perror(path);
+    result = -1;
+  }
+  if(result == 0 && packs != NULL) {
+    long long written = readDedupChunks(packs, jobs->chunks + entry->offset, (size_t)entry->storedSize, fileOut);
+    result = (written < 0) ? (int)written : (written != entry->originalSize) ? -2 : 0;
+  } else if(result == 0) {
+    nd tree = getTreeFromContainer(container, NULL);
+    if(tree == NULL && hasContainerTable(container)) result = -1;
+    else result = decryptBlocksOfOpenedFile(archive, fileOut, container, decodeBlockWithTree, tree);
+    destroyNode(&tree);
+  }
+  if(fileOut != NULL) {
+    if(fclose(fileOut) != 0 && result == 0) result = -1;
+    if(result == 0) chmod(path, (mode_t)entry->mode);
+    if(result == -1) perror(path);
+    else if(result == -2) fprintf(stderr, "%s: corrupted in '%s'\n", entry->name, jobs->fileArchive);
+    else if(result == -3) fprintf(stderr, "%s: does not match its checksums\n", entry->name);
+  }
+  free(path);
+  destroyContainer(&container);
+  return result;
+}
+
+/**
+ * @see @file archive.c / @function createParentDirectories
+ */
+int createParentDirectories(char *path) {
+  for (char *slash = strchr(path + 1, '/'); slash != NULL; slash = strchr(slash + 1, '/')) {
+    *slash = '\0';
+    int result = mkdir(path, 0777);
+    int error = errno;
+    *slash = '/';
+    if(result != 0 && error != EEXIST) return -1; // Made by another thread or already there
+  }
+  return 0;
+}
+
+/**
+ * @see @file archive.c / @function writeArchiveDirectory
+ */
+int writeArchiveDirectory(FILE *archive, struct archiveEntry *entries, size_t nbEntries, ddp dedup) {
+  size_t size = 0, nbMembers = 0, nbChunks = 0;
+  for (size_t i = 0; i < nbEntries; i++) {
+    if(entries[i].selected) {
+      size += HFM_ARCHIVE_ENTRY_SIZE + strlen(entries[i].name);
+      nbMembers++;
+      nbChunks += entries[i].nbChunks;
+    }
+  }
+  if(dedup != NULL) size += getDedupTablesSize(dedup) + 8 + 4 * nbChunks;
+  unsigned char *directory = (unsigned char*)malloc(size + 4);
+  if(directory == NULL) pointerAllocError();
+  unsigned char *entry = directory;
+  size_t firstChunk = 0;
+  for (size_t i = 0; i < nbEntries; i++) {
+    if(!entries[i].selected) continue;
+    if(dedup != NULL) { // The member is the list of its chunks
+      entries[i].offset = (long long)firstChunk;
+      entries[i].storedSize = (long long)entries[i].nbChunks;
+      firstChunk += entries[i].nbChunks;
+    }
+    size_t length = strlen(entries[i].name);
+    storeLittleEndian(entry, length, 2);
+    memcpy(entry + 2, entries[i].name, length);
+    entry += 2 + length;
+    storeLittleEndian(entry, entries[i].mode, 4);
+    storeLittleEndian(entry + 4, (uint64_t)entries[i].originalSize, 8);
+    storeLittleEndian(entry + 12, (uint64_t)entries[i].offset, 8);
+    storeLittleEndian(entry + 20, (uint64_t)entries[i].storedSize, 8);
+    entry += HFM_ARCHIVE_ENTRY_SIZE - 2;
+  }
+  if(dedup != NULL) {
+    storeDedupTables(dedup, entry);
+    entry += getDedupTablesSize(dedup);
+    storeLittleEndian(entry, nbChunks, 8);
+    entry += 8;
+    for (size_t i = 0; i < nbEntries; i++) {
+      if(!entries[i].selected) continue;
+      for (size_t c = 0; c < entries[i].nbChunks; c++, entry += 4) storeLittleEndian(entry, entries[i].chunks[c], 4);
+    }
+  }
+  storeLittleEndian(entry, crc32c(0, directory, size), 4);
+  long long offset = (long long)ftello(archive);
+  int result = (offset >= 0 && fwrite(directory, 1, size + 4, archive) == size + 4) ? 0 : -1;
+  free(directory);
+  unsigned char header[HFM_ARCHIVE_HEADER_SIZE];
+  memset(header, 0, HFM_ARCHIVE_HEADER_SIZE);
+  memcpy(header, HFM_ARCHIVE_MAGIC, 4);
+  header[4] = (dedup != NULL) ? HFM_ARCHIVE_VERSION : 1; // Still readable by the first version without chunks
+  header[5] = (dedup != NULL) ? HFM_ARCHIVE_DEDUP : 0;
+  storeLittleEndian(header + 8, nbMembers, 8);
+  storeLittleEndian(header + 16, (uint64_t)offset, 8);
+  storeLittleEndian(header + 24, size, 8);
+  if(result == 0 && (fseeko(archive, 0, SEEK_SET) != 0 || fwrite(header, 1, HFM_ARCHIVE_HEADER_SIZE, archive) != HFM_ARCHIVE_HEADER_SIZE))
+    result = -1;
+  return result;
+}
+
+/**
+ * @see @file archive.c / @function readArchiveDirectory
+ */
+int readArchiveDirectory(FILE *archive, struct archiveJobs *jobs) {
+  unsigned char header[HFM_ARCHIVE_HEADER_SIZE];
+  jobs->entries = NULL;
+  jobs->nbEntries = 0;
+  jobs->dedup = NULL;
+  jobs->chunks = NULL;
+  jobs->nbChunks = 0;
+  if(fread(header, 1, HFM_ARCHIVE_HEADER_SIZE, archive) != HFM_ARCHIVE_HEADER_SIZE
+     || memcmp(header, HFM_ARCHIVE_MAGIC, 4) || header[4] < 1 || header[4] > HFM_ARCHIVE_VERSION
+     || fseeko(archive, 0, SEEK_END) != 0)
+    return -2;
+  int dedup = header[4] >= 2 && (header[5] & HFM_ARCHIVE_DEDUP);
+  uint64_t nbMembers = loadLittleEndian(header + 8, 8);
+  uint64_t offset = loadLittleEndian(header + 16, 8);
+  uint64_t size = loadLittleEndian(header + 24, 8);
+  long long fileSize = (long long)ftello(archive);
+  // The directory must be in the file (this also bounds its allocation)
+  if(fileSize < 0 || offset < HFM_ARCHIVE_HEADER_SIZE || offset > (uint64_t)fileSize || size > (uint64_t)fileSize - offset
+     || (uint64_t)fileSize - offset - size < 4 || nbMembers > size / HFM_ARCHIVE_ENTRY_SIZE
+     || fseeko(archive, (off_t)offset, SEEK_SET) != 0)
+    return -2;
+  unsigned char *directory = (unsigned char*)malloc((size_t)size + 4);
+  if(directory == NULL) pointerAllocError();
+  if(fread(directory, 1, (size_t)size + 4, archive) != (size_t)size + 4
+     || crc32c(0, directory, (size_t)size) != (uint32_t)loadLittleEndian(directory + size, 4)) {
+    free(directory);
+    return -2;
+  }
+  struct archiveEntry *entries = (struct archiveEntry*)calloc((size_t)nbMembers + 1, sizeof(struct archiveEntry));
+  if(entries == NULL) pointerAllocError();
+  jobs->entries = entries;
+  unsigned char *entry = directory;
+  int valid = 1;
+  for (size_t i = 0; valid && i < nbMembers; i++) {
+    size_t left = (size_t)size - (size_t)(entry - directory);
+    size_t length = (left >= 2) ? (size_t)loadLittleEndian(entry, 2) : 0;
+    valid = left >= HFM_ARCHIVE_ENTRY_SIZE + length && length > 0 && memchr(entry + 2, '\0', length) == NULL;
+    if(!valid) break;
+    entries[i].name = (char*)malloc(length + 1);
+    if(entries[i].name == NULL) pointerAllocError();
+    memcpy(entries[i].name, entry + 2, length);
+    entries[i].name[length] = '\0';
+    entry += 2 + length;
+    entries[i].mode = (unsigned int)loadLittleEndian(entry, 4) & 07777;
+    entries[i].originalSize = (long long)loadLittleEndian(entry + 4, 8);
+    entries[i].offset = (long long)loadLittleEndian(entry + 12, 8);
+    entries[i].storedSize = (long long)loadLittleEndian(entry + 20, 8);
+    entry += HFM_ARCHIVE_ENTRY_SIZE - 2;
+    jobs->nbEntries = i + 1;
+    valid = entries[i].originalSize >= 0
+            && (dedup || (entries[i].offset >= HFM_ARCHIVE_HEADER_SIZE && entries[i].storedSize >= HFM_CONTAINER_HEADER_SIZE
+                          && (uint64_t)entries[i].offset <= offset && (uint64_t)entries[i].storedSize <= offset - (uint64_t)entries[i].offset));
+  }
+  if(valid && dedup) { // The tables of the chunks follow the members
+    size_t left = (size_t)size - (size_t)(entry - directory), used = 0;
+    jobs->dedup = loadDedupTables(entry, left, HFM_ARCHIVE_HEADER_SIZE, (long long)offset, &used);
+    valid = jobs->dedup != NULL && left - used >= 8;
+    if(valid) {
+      entry += used;
+      uint64_t nbChunks = loadLittleEndian(entry, 8);
+      entry += 8;
+      valid = nbChunks <= (left - used - 8) / 4;
+      if(valid) {
+        jobs->nbChunks = (size_t)nbChunks;
+        jobs->chunks = (uint32_t*)malloc((jobs->nbChunks > 0 ? jobs->nbChunks : 1) * sizeof(uint32_t));
+        if(jobs->chunks == NULL) pointerAllocError();
+      }
+      for (size_t i = 0; valid && i < jobs->nbChunks; i++, entry += 4) {
+        jobs->chunks[i] = (uint32_t)loadLittleEndian(entry, 4);
+        valid = jobs->chunks[i] < getDedupNbChunks(jobs->dedup);
+      }
+    }
+    for (size_t i = 0; valid && i < jobs->nbEntries; i++)
+      valid = entries[i].offset >= 0 && entries[i].storedSize >= 0 && (size_t)entries[i].offset <= jobs->nbChunks
+              && (size_t)entries[i].storedSize <= jobs->nbChunks - (size_t)entries[i].offset;
+  }
+  valid = valid && entry == directory + size; // No byte left after the last member
+  free(directory);
+  if(!valid) {
+    destroyArchiveEntries(jobs->entries, jobs->nbEntries);
+    destroyDedup(&jobs->dedup);
+    free(jobs->chunks);
+    jobs->entries = NULL;
+    jobs->nbEntries = 0;
+    jobs->chunks = NULL;
+    jobs->nbChunks = 0;
+    return -2;
+  }
+  return 0;
+}
+
+/**
+ * @see @file archive.c / @function destroyArchiveEntries
+ */
+void destroyArchiveEntries(struct archiveEntry *entries, size_t nbEntries) {
+  if(entries == NULL) return;
+  for (size_t i = 0; i < nbEntries; i++) {
+    free(entries[i].name);
+    free(entries[i].path);
+    free(entries[i].chunks);
+  }
+  free(entries);
+}
+
+/* ========================================================================== */
+/* ========================================================================== */
@@ -0,0 +1,342 @@
+/**
+ * @file async.c
+ * @author agent <agent@local>
+ * @standard C99
+ * @version 1.0
+ * @date 18th October 2026
+ *
+ * @brief Implementation file for "async.h"
+ *
+ * This file implements the requests, run as tasks of a scheduler, and their
+ * completion.
+ *
+ * The completion of the requests without callback is guarded by the lock of the
+ * pool, and signaled to all the threads waiting for one. The pool counts its
+ * requests not done, to wait for them when it is destroyed: a request is
+ * counted done under the lock of the pool, after its callback has returned, so
+ * the pool is alive until then.
+ *
+ * Overview about private functions of async:
+ *  - submitAsyncRequest
+ *  - runAsyncRequest
+ *  - completeAsyncRequest
+ *
+ * Overview about the pool structure functions:
+ *  - createAsyncPool
+ *  - createAsyncPoolOnScheduler
+ *  - destroyAsyncPool
+ *  - getAsyncPoolFd
+ *
+ * Overview about the request structure functions:
+ *  - submitAsyncCompress
+ *  - submitAsyncDecompress
+ *  - isAsyncRequestDone
+ *  - waitAsyncRequest
+ *  - getAsyncRequestStatus
+ *  - takeAsyncRequestResult
+ *  - getAsyncRequestUserData
+ *  - releaseAsyncRequest
+ */
+
+#define _GNU_SOURCE /**< eventfd */
+#include "async.h"
+
+#include <pthread.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+
+#define HFM_ASYNC_COMPRESS 1 /**< Operation: writes a ".hfm" file */
+#define HFM_ASYNC_DECOMPRESS 2 /**< Operation: decodes a ".hfm" file */
+
+
+/**
+ * @struct asyncRequest
+ * @brief A buffer to code, and its result.
+ */
+struct asyncRequest {
+  asp pool; /**< The pool */
+  int operation; /**< HFM_ASYNC_COMPRESS or HFM_ASYNC_DECOMPRESS */
+  const unsigned char *data; /**< The buffer to code */
+  size_t size; /**< Size of the buffer */
+  size_t key[256]; /**< Copy of the key */
+  int hasKey; /**< 1 if a key has been given */
+  unsigned int checksums; /**< Checksums to write */
+  size_t maxSize; /**< Maximal size of the decoded data */
+  asyncCallback callback; /**< Called once done, NULL if none */
+  void *userData; /**< Given to the callback */
+  int status; /**< HFM_OK or an error code */
+  unsigned char *result; /**< The result, NULL if none or taken */
+  size_t resultSize; /**< Size of the result, or size needed */
+  int done; /**< 1 once done */
+};
+
+/**
+ * @struct asyncPool
+ * @brief The scheduler and the completions of the requests.
+ */
+struct asyncPool {
+  sch scheduler; /**< The scheduler */
+  int ownsScheduler; /**< 1 if the scheduler is destroyed with the pool */
+  size_t pending; /**< Requests submitted and not done */
+  int closed; /**< 1 once the pool stops */
+  int eventFd; /**< Counter of the requests done without callback, -1 if none */
+  pthread_mutex_t lock; /**< Lock of the completions */
+  pthread_cond_t done; /**< Signaled when a request is done */
+};
+
+
+/* ================================================== */
+/* ============== DEF PRIVATE FUNCTIONS ============= */
+/* ========================================================================== */
+
+
+/**
+ * @function submitAsyncRequest
+ * @brief Creates a request and adds it to a queue.
+ *
+ * @param{asp} pool: the pool.
+ * @param{int} operation: HFM_ASYNC_COMPRESS or HFM_ASYNC_DECOMPRESS.
+ * @param{const unsigned char*} data: the buffer to code.
+ * @param{size_t} size: size of the buffer.
+ * @param{const size_t*} key: the key (can be NULL).
+ * @param{unsigned int} checksums: checksums to write (compression).
+ * @param{size_t} maxSize: maximal size of the decoded data (decompression).
+ * @param{asyncCallback} callback: function called once done (can be NULL).
+ * @param{void*} userData: given to the callback.
+ *
+ * @return{asr}: the request, NULL if it can't be created or the pool is
+ *               stopping.
+ */
+asr submitAsyncRequest(asp pool, int operation, const unsigned char *data, size_t size, const size_t *key, unsigned int checksums, size_t maxSize, asyncCallback callback, void *userData);
+
+/**
+ * @function runAsyncRequest
+ * @brief Task of a request: codes its buffer, then completes it.
+ *
+ * @param{void*} arg: the request.
+ * @param{csc} scratch: scratch space of the worker.
+ *
+ * @return{void}
+ */
+void runAsyncRequest(void *arg, csc scratch);
+
+/**
+ * @function completeAsyncRequest
+ * @brief Gives a request done to its callback, or to its waiters.
+ *
+ * @param{asr} request: the request.
+ *
+ * @return{void}
+ */
+void completeAsyncRequest(asr request);
+
+/* ================================================== */
+/* ================ STRUCT FUNCTIONS ================ */
+/* ========================================================================== */
+
+
+/**
+ * @see @file async.h / @function createAsyncPool
+ */
+asp createAsyncPool(int nbThreads) {
+  sch scheduler = createScheduler(nbThreads, 0);
+  if(scheduler == NULL) return NULL;
+  asp pool = createAsyncPoolOnScheduler(scheduler);
+  if(pool == NULL) destroyScheduler(&scheduler);
+  else pool->ownsScheduler = 1;
+  return pool;
+}
+
+/**
+ * @see @file async.h / @function createAsyncPoolOnScheduler
+ */
+asp createAsyncPoolOnScheduler(sch scheduler) {
+  asp pool = (asp)calloc(1, sizeof(struct asyncPool));
+  if(pool == NULL) return NULL;
+  pool->scheduler = scheduler;
+  pool->eventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  pthread_mutex_init(&pool->lock, NULL);
+  pthread_cond_init(&pool->done, NULL);
+  return pool;
+}
+
+/**
+ * @see @file async.h / @function destroyAsyncPool
+ */
+void destroyAsyncPool(asp *pool) {
+  if(*pool == NULL) return;
+  asp p = *pool;
+  pthread_mutex_lock(&p->lock);
+  p->closed = 1;
+  while(p->pending > 0) pthread_cond_wait(&p->done, &p->lock);
+  pthread_mutex_unlock(&p->lock);
+  if(p->ownsScheduler) destroyScheduler(&p->scheduler);
+  if(p->eventFd >= 0) close(p->eventFd);
+  pthread_cond_destroy(&p->done);
+  pthread_mutex_destroy(&p->lock);
+  free(p);
+  *pool = NULL;
+}
+
+/**
+ * @see @file async.h / @function getAsyncPoolFd
+ */
+int getAsyncPoolFd(asp pool) {
+  return pool->eventFd;
+}
+
+/**
+ * @see @file async.h / @function submitAsyncCompress
+ */
+asr submitAsyncCompress(asp pool, const unsigned char *data, size_t size, const size_t *key, unsigned int checksums, asyncCallback callback, void *userData) {
+  return submitAsyncRequest(pool, HFM_ASYNC_COMPRESS, data, size, key, checksums, 0, callback, userData);
+}
+
+/**
+ * @see @file async.h / @function submitAsyncDecompress
+ */
+asr submitAsyncDecompress(asp pool, const unsigned char *data, size_t size, const size_t *key, size_t maxSize, asyncCallback callback, void *userData) {
+  return submitAsyncRequest(pool, HFM_ASYNC_DECOMPRESS, data, size, key, 0, maxSize, callback, userData);
+}
+
+/**
+ * @see @file async.h / @function isAsyncRequestDone
+ */
+int isAsyncRequestDone(asr request) {
+  return __atomic_load_n(&request->done, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * @see @file async.h / @function waitAsyncRequest
+ */
+int waitAsyncRequest(asr request) {
+  asp pool = request->pool;
+  pthread_mutex_lock(&pool->lock);
+  while(!request->done) pthread_cond_wait(&pool->done, &pool->lock);
+  pthread_mutex_unlock(&pool->lock);
+  return request->status;
+}
+
+/**
+ * @see @file async.h / @function getAsyncRequestStatus
+ */
+int getAsyncRequestStatus(asr request) {
+  return request->status;
+}
+
+/**
+ * @see @file async.h / @function takeAsyncRequestResult
+ */
+unsigned char* takeAsyncRequestResult(asr request, size_t *size) {
+  unsigned char *result = request->result;
+  request->result = NULL;
+  if(size != NULL) *size = request->resultSize;
+  return result;
+}
+
+/**
+ * @see @file async.h / @function getAsyncRequestUserData
+ */
+void* getAsyncRequestUserData(asr request) {
+  return request->userData;
+}
+
+/**
+ * @see @file async.h / @function releaseAsyncRequest
+ */
+void releaseAsyncRequest(asr *request) {
+  if(*request == NULL) return;
+  if((*request)->callback == NULL) waitAsyncRequest(*request);
+  free((*request)->result);
+  free(*request);
+  *request = NULL;
+}
+
+
+/* ================================================== */
+/* ===================== PRIVATE ==================== */
+/* ========================================================================== */
+
+
+/**
+ * @see @file async.c / @function submitAsyncRequest
+ */
+asr submitAsyncRequest(asp pool, int operation, const unsigned char *data, size_t size, const size_t *key, unsigned int checksums, size_t maxSize, asyncCallback callback, void *userData) {
+  if(pool == NULL || (data == NULL && size > 0)) return NULL;
+  asr request = (asr)calloc(1, sizeof(struct asyncRequest));
+  if(request == NULL) return NULL;
+  request->pool = pool;
+  request->operation = operation;
+  request->data = data;
+  request->size = size;
+  request->hasKey = key != NULL;
+  if(key != NULL) memcpy(request->key, key, sizeof(request->key));
+  request->checksums = checksums;
+  request->maxSize = maxSize;
+  request->callback = callback;
+  request->userData = userData;
+  // The pool is closed under its lock: a request is refused or surely done
+  pthread_mutex_lock(&pool->lock);
+  int accepted = !pool->closed && submitSchedulerTask(pool->scheduler, NULL, runAsyncRequest, request) == 0;
+  if(accepted) pool->pending++;
+  pthread_mutex_unlock(&pool->lock);
+  if(!accepted) free(request);
+  return accepted ? request : NULL;
+}
+
+/**
+ * @see @file async.c / @function runAsyncRequest
+ */
+void runAsyncRequest(void *arg, csc scratch) {
+  asr request = (asr)arg;
+  const size_t *key = request->hasKey ? request->key : NULL;
+  size_t capacity = 0;
+  if(request->operation == HFM_ASYNC_COMPRESS) {
+    capacity = codecCompressBound(request->size);
+  } else {
+    request->status = codecDecompressedSize(request->data, request->size, &capacity);
+    request->resultSize = capacity;
+    if(request->status == HFM_OK && capacity > request->maxSize) request->status = HFM_ERROR_OVERFLOW;
+  }
+  // One more byte: an empty result is not NULL
+  if(request->status == HFM_OK && (request->result = (unsigned char*)malloc(capacity + 1)) == NULL)
+    request->status = HFM_ERROR_MEMORY;
+  if(request->status == HFM_OK && request->operation == HFM_ASYNC_COMPRESS)
+    request->status = codecCompressParallel(request->pool->scheduler, scratch, request->data, request->size, key,
+                                            request->checksums, request->result, capacity, &request->resultSize);
+  else if(request->status == HFM_OK)
+    request->status = codecDecompressParallel(request->pool->scheduler, scratch, request->data, request->size, key,
+                                              request->result, capacity, &request->resultSize);
+  if(request->status != HFM_OK) {
+    free(request->result);
+    request->result = NULL;
+  }
+  completeAsyncRequest(request);
+}
+
+/**
+ * @see @file async.c / @function completeAsyncRequest
+ */
+void completeAsyncRequest(asr request) {
+  asp pool = request->pool;
+  int hasCallback = request->callback != NULL;
+  if(hasCallback) {
+    __atomic_store_n(&request->done, 1, __ATOMIC_RELEASE);
+    request->callback(request, request->userData);
+  }
+  // The request may be released once done: only the pool is used after
+  pthread_mutex_lock(&pool->lock);
+  if(!hasCallback) {
+    // Done before the counter: a poller reading the counter then sees the request done
+    uint64_t one = 1;
+    __atomic_store_n(&request->done, 1, __ATOMIC_RELEASE);
+    if(pool->eventFd >= 0 && write(pool->eventFd, &one, sizeof(one)) != sizeof(one)) one = 0;
+  }
+  pool->pending--;
+  pthread_cond_broadcast(&pool->done);
+  pthread_mutex_unlock(&pool->lock);
+}
+
+/* ========================================================================== */
+/* ========================================================================== */
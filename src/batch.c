@@ -0,0 +1,925 @@
+/**
+ * @file batch.c
+ * @author agent <agent@local>
+ * @standard C99
+ * @version 1.0
+ * @date 18th October 2026
+ *
+ * @brief Implementation file for "batch.h"
+ *
+ * This file implements the encryption of many files: the io_uring ring driven
+ * by the calling thread, the tasks coding the files, and the tasks doing
+ * everything with blocking calls when io_uring is missing. The tasks are run
+ * by the workers of a scheduler (@see @file scheduler.h).
+ *
+ * With io_uring, a file goes through these steps:
+ *  - its size and the file itself are asked together (statx and openat)
+ *  - it is read in memory, then closed without waiting
+ *  - a task codes it in memory, and wakes the ring up through an eventfd read
+ *    by the ring
+ *  - the output is opened, written and closed
+ *
+ * Overview about private functions of batch:
+ *  - batchOutputName
+ *  - encryptFileOfBatch
+ *  - encryptMappedFile
+ *  - encryptJobInMemory
+ *  - pushJob
+ *  - popJob
+ *  - encryptFileTask
+ *  - codeJobTask
+ *  - submitJob
+ *  - createRing (only with io_uring)
+ *  - destroyRing (only with io_uring)
+ *  - enterRing (only with io_uring)
+ *  - prepareRingOperation (only with io_uring)
+ *  - runRingBatch (only with io_uring)
+ *  - startJob (only with io_uring)
+ *  - handleCompletion (only with io_uring)
+ *  - inputOpened (only with io_uring)
+ *  - closeInput (only with io_uring)
+ *  - finishJob (only with io_uring)
+ *
+ * Overview about public functions of batch:
+ *  - listBatchFiles
+ *  - destroyBatchFiles
+ *  - huffmanEncryptBatch
+ */
+
+#define _GNU_SOURCE /**< statx and eventfd */
+#include "batch.h"
+
+#include <pthread.h>
+#include <errno.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <sys/eventfd.h>
+#include <linux/io_uring.h>
+#if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter)
+#define HFM_BATCH_IO_URING /**< The files are read and written with io_uring */
+#endif
+#endif
+
+#define HFM_BATCH_TAG_STEP 0 /**< Completion of the current step of a job */
+#define HFM_BATCH_TAG_STATX 1 /**< Completion of the statx of a job */
+#define HFM_BATCH_TAG_CLOSE 2 /**< Completion of the close of an input */
+#define HFM_BATCH_TAG_EVENT 3 /**< Completion of the read of the eventfd */
+
+#define HFM_BATCH_OPEN_INPUT 0 /**< Step: opening the input */
+#define HFM_BATCH_READ 1 /**< Step: reading the input */
+#define HFM_BATCH_OPEN_OUTPUT 2 /**< Step: opening the output */
+#define HFM_BATCH_WRITE 3 /**< Step: writing the output */
+#define HFM_BATCH_CLOSE_OUTPUT 4 /**< Step: closing the output */
+
+
+/**
+ * @struct batchJob
+ * @brief A file being encrypted.
+ */
+struct batchJob {
+  struct batch *batch; /**< Batch of the file */
+  char *fileIn; /**< Name of the file */
+  char *fileOut; /**< Name of the ".hfm" file */
+  int fd; /**< File opened by the ring, -1 if none */
+  int step; /**< Current step (HFM_BATCH_OPEN_INPUT...) */
+  int pending; /**< Operations of the step not completed */
+  int error; /**< errno of the first operation failed, 0 if none */
+  int result; /**< 0, -1 if the coding has failed */
+  int written; /**< 1 if the output has been written by its task */
+  long long size; /**< Size of the file */
+  unsigned char *data; /**< Content of the file */
+  size_t done; /**< Bytes read or written */
+  char *out; /**< Content of the ".hfm" file */
+  size_t outSize; /**< Size of 'out' */
+#ifdef HFM_BATCH_IO_URING
+  struct statx stat; /**< Result of the statx */
+#endif
+  struct batchJob *next; /**< Next job of a queue */
+};
+
+/**
+ * @struct batchQueue
+ * @brief A queue of jobs shared by threads.
+ */
+struct batchQueue {
+  struct batchJob *head; /**< First job, NULL if the queue is empty */
+  struct batchJob *tail; /**< Last job */
+  pthread_mutex_t lock; /**< Lock of the queue */
+};
+
+/**
+ * @struct batch
+ * @brief The files of a batch and the state shared by its tasks.
+ */
+struct batch {
+  char **filesIn; /**< Names of the files */
+  size_t nbFiles; /**< Number of files */
+  unsigned int checksums; /**< Checksums to write */
+  cch cache; /**< Files already coded, NULL if none */
+  sch scheduler; /**< Workers running the tasks, NULL to run them in the calling thread */
+  size_t nbFailed; /**< Number of files which can't be encrypted */
+  struct batchQueue done; /**< Jobs coded, to write */
+  int eventFd; /**< Written by a task when its job is coded */
+};
+
+#ifdef HFM_BATCH_IO_URING
+/**
+ * @struct batchRing
+ * @brief An io_uring ring mapped in memory.
+ */
+struct batchRing {
+  int fd; /**< File descriptor of the ring */
+  unsigned int entries; /**< Number of entries of the submission queue */
+  unsigned int *sqHead; /**< Head of the submission queue, moved by the kernel */
+  unsigned int *sqTail; /**< Tail of the submission queue */
+  unsigned int *sqMask; /**< Mask of the indexes of the submission queue */
+  unsigned int *sqArray; /**< Indexes of the entries submitted */
+  unsigned int sqLocalTail; /**< Tail with the entries not submitted yet */
+  struct io_uring_sqe *sqes; /**< Entries of the submission queue */
+  unsigned int *cqHead; /**< Head of the completion queue */
+  unsigned int *cqTail; /**< Tail of the completion queue, moved by the kernel */
+  unsigned int *cqMask; /**< Mask of the indexes of the completion queue */
+  struct io_uring_cqe *cqes; /**< Entries of the completion queue */
+  void *sqMap; /**< Mapping of the submission queue */
+  size_t sqMapSize; /**< Size of sqMap */
+  void *cqMap; /**< Mapping of the completion queue, sqMap if single */
+  size_t cqMapSize; /**< Size of cqMap */
+  size_t sqesSize; /**< Size of the mapping of sqes */
+  size_t nbRunning; /**< Jobs started and not finished */
+  size_t nbStarted; /**< Jobs started */
+  size_t nbFinished; /**< Jobs finished */
+  size_t nbCloses; /**< Closes of inputs not completed */
+  uint64_t eventValue; /**< Buffer of the read of the eventfd */
+};
+#endif
+
+
+/* ================================================== */
+/* ============== DEF PRIVATE FUNCTIONS ============= */
+/* ========================================================================== */
+
+
+/**
+ * @function batchOutputName
+ * @brief Returns the name of the ".hfm" file of a file.
+ *
+ * @param{char*} fileIn: name of the file.
+ *
+ * @return{char*}: the name, to free.
+ */
+char* batchOutputName(char *fileIn);
+
+/**
+ * @function encryptFileOfBatch
+ * @brief Encrypts a file with blocking calls.
+ *
+ * The file is read in memory if it has at most HFM_BATCH_MAX_SIZE bytes, else
+ * it is mapped (@see @function encryptMappedFile). It is looked for in the
+ * cache if it has at most HFM_CACHE_MAX_ENTRY bytes.
+ *
+ * @param{struct batch*} batch: the batch.
+ * @param{char*} fileIn: name of the file.
+ * @param{char*} fileOut: name of the ".hfm" file.
+ * @param{csc} scratch: scratch space of the worker (can be NULL).
+ *
+ * @return{int}: 0 if the file has been encrypted, -1 otherwise.
+ */
+int encryptFileOfBatch(struct batch *batch, char *fileIn, char *fileOut, csc scratch);
+
+/**
+ * @function encryptMappedFile
+ * @brief Codes a file mapped in its ".hfm" file, mapped too.
+ *
+ * Its blocks are coded by the tasks of all the workers, so the workers having
+ * no file left help with the big ones.
+ *
+ * @param{struct batch*} batch: the batch.
+ * @param{unsigned char*} data: content of the file.
+ * @param{size_t} size: size of the file.
+ * @param{int} fd: the ".hfm" file, opened to read and write.
+ * @param{csc} scratch: scratch space of the worker (can be NULL).
+ *
+ * @return{int}: 0 if the file has been coded, -1 otherwise.
+ */
+int encryptMappedFile(struct batch *batch, unsigned char *data, size_t size, int fd, csc scratch);
+
+/**
+ * @function encryptJobInMemory
+ * @brief Codes the content of a job in the content of its ".hfm" file.
+ *
+ * @param{struct batchJob*} job: the job, its content is freed.
+ * @param{unsigned int} checksums: checksums to write.
+ * @param{cch} cache: the files already coded, NULL if none.
+ *
+ * @return{int}: 0 if the job has been coded, -1 otherwise.
+ */
+int encryptJobInMemory(struct batchJob *job, unsigned int checksums, cch cache);
+
+/**
+ * @function pushJob
+ * @brief Adds a job at the end of a queue.
+ *
+ * @param{struct batchQueue*} queue: the queue.
+ * @param{struct batchJob*} job: the job.
+ *
+ * @return{void}
+ */
+void pushJob(struct batchQueue *queue, struct batchJob *job);
+
+/**
+ * @function popJob
+ * @brief Removes the first job of a queue, without waiting.
+ *
+ * @param{struct batchQueue*} queue: the queue.
+ *
+ * @return{struct batchJob*}: the job, NULL if there is none.
+ */
+struct batchJob* popJob(struct batchQueue *queue);
+
+/**
+ * @function encryptFileTask
+ * @brief Task encrypting a file with blocking calls.
+ *
+ * @param{void*} job: the struct batchJob, only its names are used.
+ * @param{csc} scratch: scratch space of the worker.
+ *
+ * @return{void}
+ */
+void encryptFileTask(void *job, csc scratch);
+
+/**
+ * @function codeJobTask
+ * @brief Task coding a job read by the ring, and waking the ring up.
+ *
+ * The files too big to be read in memory are encrypted here, with blocking
+ * calls.
+ *
+ * @param{void*} job: the struct batchJob.
+ * @param{csc} scratch: scratch space of the worker.
+ *
+ * @return{void}
+ */
+void codeJobTask(void *job, csc scratch);
+
+/**
+ * @function submitJob
+ * @brief Submits the coding of a job read by the ring, or codes it at once if
+ * it can't be submitted.
+ *
+ * @param{struct batch*} batch: the batch.
+ * @param{struct batchJob*} job: the job.
+ *
+ * @return{void}
+ */
+void submitJob(struct batch *batch, struct batchJob *job);
+
+#ifdef HFM_BATCH_IO_URING
+/**
+ * @function createRing
+ * @brief Creates an io_uring ring and maps its queues.
+ *
+ * @param{struct batchRing*} ring: the ring to fill.
+ * @param{unsigned int} entries: number of entries of the submission queue.
+ *
+ * @return{int}: 0 if the ring has been created, -1 otherwise.
+ */
+int createRing(struct batchRing *ring, unsigned int entries);
+
+/**
+ * @function destroyRing
+ * @brief Unmaps the queues of a ring and closes it.
+ *
+ * @param{struct batchRing*} ring: the ring.
+ *
+ * @return{void}
+ */
+void destroyRing(struct batchRing *ring);
+
+/**
+ * @function enterRing
+ * @brief Submits the entries prepared and waits for completions.
+ *
+ * @param{struct batchRing*} ring: the ring.
+ * @param{unsigned int} minComplete: number of completions to wait for.
+ *
+ * @return{int}: 0, -1 if the ring can't be used anymore.
+ */
+int enterRing(struct batchRing *ring, unsigned int minComplete);
+
+/**
+ * @function prepareRingOperation
+ * @brief Prepares an entry of the submission queue.
+ *
+ * @param{struct batchRing*} ring: the ring.
+ * @param{int} opcode: the operation (IORING_OP_READ...).
+ * @param{int} fd: file descriptor of the operation.
+ * @param{void*} addr: buffer or path of the operation.
+ * @param{unsigned int} len: length, mode or mask of the operation.
+ * @param{uint64_t} offset: offset of the operation.
+ * @param{struct batchJob*} job: job of the operation (can be NULL).
+ * @param{int} tag: HFM_BATCH_TAG_STEP...
+ *
+ * @return{struct io_uring_sqe*}: the entry, for the other fields.
+ */
+struct io_uring_sqe* prepareRingOperation(struct batchRing *ring, int opcode, int fd, void *addr, unsigned int len, uint64_t offset, struct batchJob *job, int tag);
+
+/**
+ * @function runRingBatch
+ * @brief Reads and writes all the files of a batch through a ring.
+ *
+ * @param{struct batch*} batch: the batch.
+ * @param{struct batchRing*} ring: the ring.
+ *
+ * @return{void}
+ */
+void runRingBatch(struct batch *batch, struct batchRing *ring);
+
+/**
+ * @function startJob
+ * @brief Starts the encryption of the next file: asks its size and opens it.
+ *
+ * @param{struct batch*} batch: the batch.
+ * @param{struct batchRing*} ring: the ring.
+ *
+ * @return{void}
+ */
+void startJob(struct batch *batch, struct batchRing *ring);
+
+/**
+ * @function handleCompletion
+ * @brief Goes on with the job of a completion.
+ *
+ * @param{struct batch*} batch: the batch.
+ * @param{struct batchRing*} ring: the ring.
+ * @param{uint64_t} userData: the job and the tag of the operation completed.
+ * @param{int} res: result of the operation.
+ *
+ * @return{void}
+ */
+void handleCompletion(struct batch *batch, struct batchRing *ring, uint64_t userData, int res);
+
+/**
+ * @function inputOpened
+ * @brief Reads a file once it is opened and its size known.
+ *
+ * @param{struct batch*} batch: the batch.
+ * @param{struct batchRing*} ring: the ring.
+ * @param{struct batchJob*} job: the job.
+ *
+ * @return{void}
+ */
+void inputOpened(struct batch *batch, struct batchRing *ring, struct batchJob *job);
+
+/**
+ * @function closeInput
+ * @brief Closes the input of a job, without waiting.
+ *
+ * @param{struct batchRing*} ring: the ring.
+ * @param{struct batchJob*} job: the job.
+ *
+ * @return{void}
+ */
+void closeInput(struct batchRing *ring, struct batchJob *job);
+
+/**
+ * @function finishJob
+ * @brief Frees a job, and starts the next file.
+ *
+ * @param{struct batch*} batch: the batch.
+ * @param{struct batchRing*} ring: the ring.
+ * @param{struct batchJob*} job: the job.
+ *
+ * @return{void}
+ */
+void finishJob(struct batch *batch, struct batchRing *ring, struct batchJob *job);
+#endif
+
+
+/* ================================================== */
+/* ===================== PUBLIC ===================== */
+/* ========================================================================== */
+
+
+/**
+ * @see @file batch.h / @function listBatchFiles
+ */
+char** listBatchFiles(char *path, size_t *nbFiles) {
+  *nbFiles = 0;
+  struct stat pathStat;
+  if(stat(path, &pathStat) != 0) {
+    perror(path);
+    return NULL;
+  }
+  size_t allocated = 16;
+  char **files = (char**)malloc(allocated * sizeof(char*));
+  if(files == NULL) pointerAllocError();
+  char *name = NULL;
+  size_t nameSize = 0;
+  DIR *dir = NULL;
+  FILE *list = NULL;
+  if(S_ISDIR(pathStat.st_mode) && (dir = opendir(path)) == NULL) perror(path);
+  if(!S_ISDIR(pathStat.st_mode) && (list = fopen(path, "r")) == NULL) perror(path);
+  if(dir == NULL && list == NULL) {
+    free(files);
+    return NULL;
+  }
+  while(1) {
+    char *file = NULL;
+    if(dir != NULL) {
+      struct dirent *entry = readdir(dir);
+      if(entry == NULL) break;
+      size_t length = strlen(entry->d_name);
+      if(length >= 4 && !strcmp(entry->d_name + length - 4, ".hfm")) continue;
+      file = (char*)malloc(strlen(path) + length + 2);
+      if(file == NULL) pointerAllocError();
+      sprintf(file, "%s/%s", path, entry->d_name);
+      struct stat fileStat;
+      if(stat(file, &fileStat) != 0 || !S_ISREG(fileStat.st_mode)) {
+        free(file);
+        continue;
+      }
+    } else {
+      ssize_t length = getline(&name, &nameSize, list);
+      if(length < 0) break;
+      while(length > 0 && (name[length - 1] == '\n' || name[length - 1] == '\r')) name[--length] = '\0';
+      if(length == 0) continue;
+      file = (char*)copyString(name);
+      if(file == NULL) pointerAllocError();
+    }
+    if(*nbFiles == allocated) {
+      allocated *= 2;
+      char **ptr = (char**)realloc(files, allocated * sizeof(char*));
+      if(ptr == NULL) pointerAllocError();
+      files = ptr;
+    }
+    files[(*nbFiles)++] = file;
+  }
+  if(dir != NULL) closedir(dir);
+  if(list != NULL) fclose(list);
+  free(name);
+  return files;
+}
+
+/**
+ * @see @file batch.h / @function destroyBatchFiles
+ */
+void destroyBatchFiles(char ***files, size_t nbFiles) {
+  if(*files == NULL) return;
+  for (size_t i = 0; i < nbFiles; i++) free((*files)[i]);
+  free(*files);
+  *files = NULL;
+}
+
+/**
+ * @see @file batch.h / @function huffmanEncryptBatch
+ */
+size_t huffmanEncryptBatch(char **filesIn, size_t nbFiles, unsigned int checksums, int nbThreads, cch cache) {
+  struct batch batch;
+  batch.filesIn = filesIn;
+  batch.nbFiles = nbFiles;
+  batch.checksums = checksums;
+  batch.cache = cache;
+  batch.nbFailed = 0;
+  batch.eventFd = -1;
+  batch.done.head = batch.done.tail = NULL;
+  pthread_mutex_init(&batch.done.lock, NULL);
+  if(nbThreads < 1) nbThreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+  if(nbThreads < 1) nbThreads = 1;
+  if(nbThreads > HFM_BATCH_MAX_THREADS) nbThreads = HFM_BATCH_MAX_THREADS;
+  batch.scheduler = createScheduler(nbThreads, 0); // NULL: the tasks are run by this thread
+  int useRing = 0;
+#ifdef HFM_BATCH_IO_URING
+  struct batchRing ring;
+  if(createRing(&ring, 4 * HFM_BATCH_DEPTH) == 0) {
+    if((batch.eventFd = eventfd(0, EFD_CLOEXEC)) >= 0) useRing = 1;
+    else destroyRing(&ring);
+  }
+  if(useRing) {
+    runRingBatch(&batch, &ring);
+    destroyRing(&ring);
+  }
+#endif
+  struct batchJob *jobs = NULL;
+  if(!useRing) {
+    jobs = (struct batchJob*)calloc(nbFiles, sizeof(struct batchJob));
+    if(jobs == NULL && nbFiles > 0) pointerAllocError();
+  }
+  sgp group = (!useRing && batch.scheduler != NULL) ? createSchedulerGroup() : NULL;
+  for (size_t i = 0; !useRing && i < nbFiles; i++) {
+    jobs[i].batch = &batch;
+    jobs[i].fileIn = filesIn[i];
+    if(group == NULL || submitSchedulerTask(batch.scheduler, group, encryptFileTask, &jobs[i]) != 0)
+      encryptFileTask(&jobs[i], NULL);
+  }
+  if(group != NULL) waitSchedulerGroup(batch.scheduler, group);
+  destroySchedulerGroup(&group);
+  destroyScheduler(&batch.scheduler); // Its tasks write the eventfd until they end
+  if(useRing) close(batch.eventFd);
+  pthread_mutex_destroy(&batch.done.lock);
+  free(jobs);
+  return batch.nbFailed;
+}
+
+
+/* ================================================== */
+/* ===================== PRIVATE ==================== */
+/* ========================================================================== */
+
+
+/**
+ * @see @file batch.c / @function batchOutputName
+ */
+char* batchOutputName(char *fileIn) {
+  char *fileOut = (char*)malloc(strlen(fileIn) + 5);
+  if(fileOut == NULL) pointerAllocError();
+  sprintf(fileOut, "%s.hfm", fileIn);
+  return fileOut;
+}
+
+/**
+ * @see @file batch.c / @function encryptFileOfBatch
+ */
+int encryptFileOfBatch(struct batch *batch, char *fileIn, char *fileOut, csc scratch) {
+  int fd = open(fileIn, O_RDONLY | O_CLOEXEC);
+  struct stat fileStat;
+  if(fd < 0 || fstat(fd, &fileStat) != 0) {
+    perror(fileIn);
+    if(fd >= 0) close(fd);
+    return -1;
+  }
+  size_t size = (size_t)fileStat.st_size;
+  unsigned char *data = NULL;
+  int mapped = size > HFM_BATCH_MAX_SIZE;
+  int result = 0;
+  if(mapped) {
+    data = (unsigned char*)mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if(data == MAP_FAILED) {
+      data = NULL;
+      result = -1;
+    }
+  } else {
+    data = (unsigned char*)malloc(size + 1);
+    if(data == NULL) pointerAllocError();
+    size_t done = 0;
+    ssize_t length = 1;
+    while(done < size && (length = read(fd, data + done, size - done)) > 0) done += (size_t)length;
+    if(length < 0) result = -1;
+    size = done;
+  }
+  if(result != 0) perror(fileIn);
+  close(fd);
+  FILE *file = NULL;
+  if(result == 0 && (file = fopen(fileOut, mapped ? "w+b" : "wb")) == NULL) result = -1;
+  if(result == 0 && batch->cache != NULL && size <= HFM_CACHE_MAX_ENTRY) {
+    size_t outSize;
+    unsigned char *out = encryptBufferCached(batch->cache, data, size, batch->checksums, &outSize);
+    result = (out != NULL && fwrite(out, 1, outSize, file) == outSize) ? 0 : -1;
+    free(out);
+  } else if(result == 0 && mapped) {
+    result = encryptMappedFile(batch, data, size, fileno(file), scratch);
+  } else if(result == 0) {
+    result = encryptBufferInOpenedFile(data, size, file, batch->checksums);
+  }
+  if(file != NULL && fclose(file) != 0) result = -1;
+  if(result != 0 && (file != NULL || data != NULL)) perror(fileOut);
+  if(mapped && data != NULL) munmap(data, size);
+  else if(!mapped) free(data);
+  return result;
+}
+
+/**
+ * @see @file batch.c / @function encryptMappedFile
+ */
+int encryptMappedFile(struct batch *batch, unsigned char *data, size_t size, int fd, csc scratch) {
+  size_t capacity = codecCompressBound(size);
+  if(ftruncate(fd, (off_t)capacity) != 0) return -1;
+  unsigned char *out = (unsigned char*)mmap(NULL, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if(out == MAP_FAILED) return -1;
+  size_t outSize = 0;
+  int result = codecCompressParallel(batch->scheduler, scratch, data, size, NULL, batch->checksums, out, capacity, &outSize);
+  munmap(out, capacity);
+  // The file is cut to the size of the ".hfm" file
+  return (result == HFM_OK && ftruncate(fd, (off_t)outSize) == 0) ? 0 : -1;
+}
+
+/**
+ * @see @file batch.c / @function encryptJobInMemory
+ */
+int encryptJobInMemory(struct batchJob *job, unsigned int checksums, cch cache) {
+  job->out = (char*)encryptBufferCached(cache, job->data, (size_t)job->size, checksums, &job->outSize);
+  if(job->out == NULL) fprintf(stderr, "%s: can't be coded in memory\n", job->fileIn);
+  free(job->data);
+  job->data = NULL;
+  return (job->out != NULL) ? 0 : -1;
+}
+
+/**
+ * @see @file batch.c / @function pushJob
+ */
+void pushJob(struct batchQueue *queue, struct batchJob *job) {
+  job->next = NULL;
+  pthread_mutex_lock(&queue->lock);
+  if(queue->tail != NULL) queue->tail->next = job;
+  else queue->head = job;
+  queue->tail = job;
+  pthread_mutex_unlock(&queue->lock);
+}
+
+/**
+ * @see @file batch.c / @function popJob
+ */
+struct batchJob* popJob(struct batchQueue *queue) {
+  pthread_mutex_lock(&queue->lock);
+  struct batchJob *job = queue->head;
+  if(job != NULL) {
+    queue->head = job->next;
+    if(queue->head == NULL) queue->tail = NULL;
+  }
+  pthread_mutex_unlock(&queue->lock);
+  return job;
+}
+
+/**
+ * @see @file batch.c / @function encryptFileTask
+ */
+void encryptFileTask(void *job, csc scratch) {
+  struct batchJob *j = (struct batchJob*)job;
+  char *fileOut = batchOutputName(j->fileIn);
+  if(encryptFileOfBatch(j->batch, j->fileIn, fileOut, scratch) != 0)
+    __atomic_fetch_add(&j->batch->nbFailed, 1, __ATOMIC_RELAXED);
+  free(fileOut);
+}
+
+/**
+ * @see @file batch.c / @function codeJobTask
+ */
+void codeJobTask(void *job, csc scratch) {
+  struct batchJob *j = (struct batchJob*)job;
+  struct batch *b = j->batch;
+  if(j->size > HFM_BATCH_MAX_SIZE) {
+    j->result = encryptFileOfBatch(b, j->fileIn, j->fileOut, scratch);
+    j->written = 1;
+  } else {
+    j->result = encryptJobInMemory(j, b->checksums, b->cache);
+  }
+  pushJob(&b->done, j);
+  uint64_t one = 1;
+  while(write(b->eventFd, &one, sizeof(one)) < 0 && errno == EINTR);
+}
+
+/**
+ * @see @file batch.c / @function submitJob
+ */
+void submitJob(struct batch *batch, struct batchJob *job) {
+  if(batch->scheduler == NULL || submitSchedulerTask(batch->scheduler, NULL, codeJobTask, job) != 0)
+    codeJobTask(job, NULL);
+}
+
+#ifdef HFM_BATCH_IO_URING
+/**
+ * @see @file batch.c / @function createRing
+ */
+int createRing(struct batchRing *ring, unsigned int entries) {
+  struct io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  ring->fd = (int)syscall(__NR_io_uring_setup, entries, &params);
+  if(ring->fd < 0) return -1;
+  ring->entries = params.sq_entries;
+  ring->sqMapSize = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+  ring->cqMapSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+  int single = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+  if(single && ring->cqMapSize > ring->sqMapSize) ring->sqMapSize = ring->cqMapSize;
+  ring->sqMap = mmap(NULL, ring->sqMapSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+  ring->cqMap = single ? ring->sqMap
+                       : mmap(NULL, ring->cqMapSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_CQ_RING);
+  ring->sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+  ring->sqes = (struct io_uring_sqe*)mmap(NULL, ring->sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+  if(ring->sqMap == MAP_FAILED || ring->cqMap == MAP_FAILED || ring->sqes == MAP_FAILED) {
+    if(ring->sqMap != MAP_FAILED) munmap(ring->sqMap, ring->sqMapSize);
+    if(!single && ring->cqMap != MAP_FAILED) munmap(ring->cqMap, ring->cqMapSize);
+    if(ring->sqes != MAP_FAILED) munmap(ring->sqes, ring->sqesSize);
+    close(ring->fd);
+    return -1;
+  }
+  unsigned char *sq = (unsigned char*)ring->sqMap;
+  unsigned char *cq = (unsigned char*)ring->cqMap;
+  ring->sqHead = (unsigned int*)(sq + params.sq_off.head);
+  ring->sqTail = (unsigned int*)(sq + params.sq_off.tail);
+  ring->sqMask = (unsigned int*)(sq + params.sq_off.ring_mask);
+  ring->sqArray = (unsigned int*)(sq + params.sq_off.array);
+  ring->sqLocalTail = *ring->sqTail;
+  ring->cqHead = (unsigned int*)(cq + params.cq_off.head);
+  ring->cqTail = (unsigned int*)(cq + params.cq_off.tail);
+  ring->cqMask = (unsigned int*)(cq + params.cq_off.ring_mask);
+  ring->cqes = (struct io_uring_cqe*)(cq + params.cq_off.cqes);
+  ring->nbRunning = ring->nbStarted = ring->nbFinished = ring->nbCloses = 0;
+  return 0;
+}
+
+/**
+ * @see @file batch.c / @function destroyRing
+ */
+void destroyRing(struct batchRing *ring) {
+  munmap(ring->sqes, ring->sqesSize);
+  if(ring->cqMap != ring->sqMap) munmap(ring->cqMap, ring->cqMapSize);
+  munmap(ring->sqMap, ring->sqMapSize);
+  close(ring->fd);
+}
+
+/**
+ * @see @file batch.c / @function enterRing
+ */
+int enterRing(struct batchRing *ring, unsigned int minComplete) {
+  unsigned int toSubmit = ring->sqLocalTail - *ring->sqTail;
+  __atomic_store_n(ring->sqTail, ring->sqLocalTail, __ATOMIC_RELEASE);
+  while(toSubmit > 0 || minComplete > 0) {
+    long submitted = syscall(__NR_io_uring_enter, ring->fd, toSubmit, minComplete, minComplete > 0 ? IORING_ENTER_GETEVENTS : 0, NULL, 0);
+    if(submitted < 0) {
+      if(errno == EINTR || errno == EAGAIN || errno == EBUSY) continue;
+      return -1;
+    }
+    toSubmit -= (unsigned int)submitted;
+    minComplete = 0;
+  }
+  return 0;
+}
+
+/**
+ * @see @file batch.c / @function prepareRingOperation
+ */
+struct io_uring_sqe* prepareRingOperation(struct batchRing *ring, int opcode, int fd, void *addr, unsigned int len, uint64_t offset, struct batchJob *job, int tag) {
+  // The entries are submitted when the queue is full
+  if(ring->sqLocalTail - __atomic_load_n(ring->sqHead, __ATOMIC_ACQUIRE) >= ring->entries) enterRing(ring, 0);
+  unsigned int index = ring->sqLocalTail & *ring->sqMask;
+  struct io_uring_sqe *sqe = &ring->sqes[index];
+  memset(sqe, 0, sizeof(struct io_uring_sqe));
+  sqe->opcode = (uint8_t)opcode;
+  sqe->fd = fd;
+  sqe->addr = (uint64_t)(uintptr_t)addr;
+  sqe->len = len;
+  sqe->off = offset;
+  sqe->user_data = (uint64_t)(uintptr_t)job | (uint64_t)tag; // The jobs are aligned on 4 bytes at least
+  ring->sqArray[index] = index;
+  ring->sqLocalTail++;
+  return sqe;
+}
+
+/**
+ * @see @file batch.c / @function runRingBatch
+ */
+void runRingBatch(struct batch *batch, struct batchRing *ring) {
+  while(ring->nbStarted < batch->nbFiles && ring->nbRunning < HFM_BATCH_DEPTH) startJob(batch, ring);
+  prepareRingOperation(ring, IORING_OP_READ, batch->eventFd, &ring->eventValue, sizeof(uint64_t), 0, NULL, HFM_BATCH_TAG_EVENT);
+  while(ring->nbFinished < batch->nbFiles || ring->nbCloses > 0) {
+    if(enterRing(ring, 1) != 0) {
+      perror("io_uring");
+      batch->nbFailed += batch->nbFiles - ring->nbFinished; // The jobs running are lost
+      return;
+    }
+    unsigned int head = *ring->cqHead;
+    while(head != __atomic_load_n(ring->cqTail, __ATOMIC_ACQUIRE)) {
+      struct io_uring_cqe *cqe = &ring->cqes[head & *ring->cqMask];
+      uint64_t userData = cqe->user_data;
+      int res = cqe->res;
+      __atomic_store_n(ring->cqHead, ++head, __ATOMIC_RELEASE);
+      handleCompletion(batch, ring, userData, res);
+    }
+  }
+}
+
+/**
+ * @see @file batch.c / @function startJob
+ */
+void startJob(struct batch *batch, struct batchRing *ring) {
+  struct batchJob *job = (struct batchJob*)calloc(1, sizeof(struct batchJob));
+  if(job == NULL) pointerAllocError();
+  job->batch = batch;
+  job->fileIn = batch->filesIn[ring->nbStarted++];
+  job->fileOut = batchOutputName(job->fileIn);
+  job->fd = -1;
+  job->step = HFM_BATCH_OPEN_INPUT;
+  job->pending = 2;
+  ring->nbRunning++;
+  struct io_uring_sqe *sqe = prepareRingOperation(ring, IORING_OP_STATX, AT_FDCWD, job->fileIn, STATX_SIZE, (uint64_t)(uintptr_t)&job->stat, job, HFM_BATCH_TAG_STATX);
+  sqe->statx_flags = 0;
+  sqe = prepareRingOperation(ring, IORING_OP_OPENAT, AT_FDCWD, job->fileIn, 0, 0, job, HFM_BATCH_TAG_STEP);
+  sqe->open_flags = O_RDONLY | O_CLOEXEC;
+}
+
+/**
+ * @see @file batch.c / @function handleCompletion
+ */
+void handleCompletion(struct batch *batch, struct batchRing *ring, uint64_t userData, int res) {
+  int tag = (int)(userData & 3);
+  struct batchJob *job = (struct batchJob*)(uintptr_t)(userData & ~(uint64_t)3);
+  if(tag == HFM_BATCH_TAG_CLOSE) {
+    ring->nbCloses--;
+  } else if(tag == HFM_BATCH_TAG_EVENT) { // Jobs coded by the tasks
+    while((job = popJob(&batch->done)) != NULL) {
+      if(job->written || job->result != 0) {
+        finishJob(batch, ring, job);
+      } else {
+        job->step = HFM_BATCH_OPEN_OUTPUT;
+        struct io_uring_sqe *sqe = prepareRingOperation(ring, IORING_OP_OPENAT, AT_FDCWD, job->fileOut, 0644, 0, job, HFM_BATCH_TAG_STEP);
+        sqe->open_flags = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
+      }
+    }
+    prepareRingOperation(ring, IORING_OP_READ, batch->eventFd, &ring->eventValue, sizeof(uint64_t), 0, NULL, HFM_BATCH_TAG_EVENT);
+  } else if(tag == HFM_BATCH_TAG_STATX || job->step == HFM_BATCH_OPEN_INPUT) {
+    if(res < 0 && job->error == 0) job->error = -res;
+    if(res >= 0 && tag == HFM_BATCH_TAG_STEP) job->fd = res;
+    if(--job->pending == 0) inputOpened(batch, ring, job);
+  } else if(job->step == HFM_BATCH_READ) {
+    if(res < 0) {
+      job->error = -res;
+      closeInput(ring, job);
+      finishJob(batch, ring, job);
+      return;
+    }
+    job->done += (size_t)res;
+    if(res > 0 && job->done < (size_t)job->size) {
+      prepareRingOperation(ring, IORING_OP_READ, job->fd, job->data + job->done, (unsigned int)((size_t)job->size - job->done), job->done, job, HFM_BATCH_TAG_STEP);
+    } else {
+      job->size = (long long)job->done; // The file may have been shortened
+      closeInput(ring, job);
+      submitJob(batch, job);
+    }
+  } else if(job->step == HFM_BATCH_OPEN_OUTPUT) {
+    if(res < 0) {
+      job->error = -res;
+      finishJob(batch, ring, job);
+      return;
+    }
+    job->fd = res;
+    job->step = HFM_BATCH_WRITE;
+    job->done = 0;
+    prepareRingOperation(ring, IORING_OP_WRITE, job->fd, job->out, (unsigned int)job->outSize, 0, job, HFM_BATCH_TAG_STEP);
+  } else if(job->step == HFM_BATCH_WRITE) {
+    if(res <= 0 && job->error == 0) job->error = (res < 0) ? -res : EIO;
+    if(res > 0) job->done += (size_t)res;
+    if(res > 0 && job->done < job->outSize) {
+      prepareRingOperation(ring, IORING_OP_WRITE, job->fd, job->out + job->done, (unsigned int)(job->outSize - job->done), job->done, job, HFM_BATCH_TAG_STEP);
+    } else {
+      job->step = HFM_BATCH_CLOSE_OUTPUT;
+      prepareRingOperation(ring, IORING_OP_CLOSE, job->fd, NULL, 0, 0, job, HFM_BATCH_TAG_STEP);
+    }
+  } else if(job->step == HFM_BATCH_CLOSE_OUTPUT) {
+    if(res < 0 && job->error == 0) job->error = -res;
+    finishJob(batch, ring, job);
+  }
+}
+
+/**
+ * @see @file batch.c / @function inputOpened
+ */
+void inputOpened(struct batch *batch, struct batchRing *ring, struct batchJob *job) {
+  if(job->error != 0) {
+    if(job->fd >= 0) closeInput(ring, job);
+    finishJob(batch, ring, job);
+    return;
+  }
+  job->size = (long long)job->stat.stx_size;
+  if(job->size > HFM_BATCH_MAX_SIZE || job->size == 0) { // Mapped by its task, or nothing to read
+    closeInput(ring, job);
+    submitJob(batch, job);
+    return;
+  }
+  job->data = (unsigned char*)malloc((size_t)job->size);
+  if(job->data == NULL) pointerAllocError();
+  job->step = HFM_BATCH_READ;
+  job->done = 0;
+  prepareRingOperation(ring, IORING_OP_READ, job->fd, job->data, (unsigned int)job->size, 0, job, HFM_BATCH_TAG_STEP);
+}
+
+/**
+ * @see @file batch.c / @function closeInput
+ */
+void closeInput(struct batchRing *ring, struct batchJob *job) {
+  prepareRingOperation(ring, IORING_OP_CLOSE, job->fd, NULL, 0, 0, NULL, HFM_BATCH_TAG_CLOSE);
+  ring->nbCloses++;
+  job->fd = -1;
+}
+
+/**
+ * @see @file batch.c / @function finishJob
+ */
+void finishJob(struct batch *batch, struct batchRing *ring, struct batchJob *job) {
+  if(job->error != 0) fprintf(stderr, "%s: %s\n", (job->step <= HFM_BATCH_READ) ? job->fileIn : job->fileOut, strerror(job->error));
+  if(job->error != 0 || job->result != 0) batch->nbFailed++;
+  free(job->fileOut);
+  free(job->data);
+  free(job->out);
+  free(job);
+  ring->nbRunning--;
+  ring->nbFinished++;
+  if(ring->nbStarted < batch->nbFiles) startJob(batch, ring);
+}
+#endif
+
+/* ========================================================================== */
+/* ========================================================================== */
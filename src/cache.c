@@ -0,0 +1,396 @@
+/**
+ * @file cache.c
+ * @author agent <agent@local>
+ * @standard C99
+ * @version 1.0
+ * @date 18th October 2026
+ *
+ * @brief Implementation file for "cache.h"
+ *
+ * This file implements the reading, the writing and the eviction of the
+ * entries of a cache directory.
+ *
+ * The cache only keeps the total size of its entries. The directory is read
+ * again to find the oldest entries when they must be removed, which is rare:
+ * the entries are removed until the cache is at 90% of its maximal size.
+ *
+ * Overview about private functions of cache:
+ *  - cacheEntryName
+ *  - readCacheEntry
+ *  - writeCacheEntry
+ *  - evictCacheEntries
+ *  - isCacheEntryName
+ *  - compareCacheEntries
+ *
+ * Overview about the cache structure functions:
+ *  - openCache
+ *  - closeCache
+ *  - getCacheHits
+ *  - getCacheMisses
+ *
+ * Overview about public functions of cache:
+ *  - encryptBufferCached
+ */
+
+#define _GNU_SOURCE /**< fileno, fdopen, futimens and the pthreads */
+#include "cache.h"
+
+#include <pthread.h>
+#include <errno.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#define HFM_CACHE_EXTENSION ".hfmk" /**< Extension of the entries */
+
+
+/**
+ * @struct cache
+ * @brief A cache directory opened.
+ */
+struct cache {
+  char *directory; /**< The directory */
+  long long maxSize; /**< Maximal size of the entries */
+  long long totalSize; /**< Size of the entries */
+  size_t hits; /**< Files found in the cache */
+  size_t misses; /**< Files coded */
+  unsigned int nbTemporaries; /**< Temporary files written, to name them */
+  pthread_mutex_t lock; /**< Lock of the sizes and the counters */
+};
+
+/**
+ * @struct cacheEntry
+ * @brief An entry of the cache directory, when looking for the oldest ones.
+ */
+struct cacheEntry {
+  char *name; /**< Name of the file */
+  long long size; /**< Size of the file */
+  long long used; /**< Date of the last use */
+};
+
+
+/* ================================================== */
+/* ============== DEF PRIVATE FUNCTIONS ============= */
+/* ========================================================================== */
+
+
+/**
+ * @function cacheEntryName
+ * @brief Returns the path of an entry.
+ *
+ * @param{cch} cache: the cache.
+ * @param{uint64_t} hash: hash of the content.
+ * @param{size_t} size: size of the content.
+ *
+ * @return{char*}: the path, to free.
+ */
+char* cacheEntryName(cch cache, uint64_t hash, size_t size);
+
+/**
+ * @function readCacheEntry
+ * @brief Reads the ".hfm" file of an entry, and marks the entry as used.
+ *
+ * An entry corrupted is removed.
+ *
+ * @param{cch} cache: the cache.
+ * @param{char*} path: path of the entry.
+ * @param{uint64_t} hash: hash of the content.
+ * @param{size_t} size: size of the content.
+ * @param{size_t*} outSize: receives the size of the ".hfm" file.
+ *
+ * @return{unsigned char*}: the ".hfm" file, to free, NULL if the entry does
+ *                          not exist or is corrupted.
+ */
+unsigned char* readCacheEntry(cch cache, char *path, uint64_t hash, size_t size, size_t *outSize);
+
+/**
+ * @function writeCacheEntry
+ * @brief Adds an entry, and removes the oldest ones if the cache is too big.
+ *
+ * @param{cch} cache: the cache.
+ * @param{char*} path: path of the entry.
+ * @param{uint64_t} hash: hash of the content.
+ * @param{size_t} size: size of the content.
+ * @param{unsigned char*} out: the ".hfm" file.
+ * @param{size_t} outSize: size of the ".hfm" file.
+ *
+ * @return{void}
+ */
+void writeCacheEntry(cch cache, char *path, uint64_t hash, size_t size, unsigned char *out, size_t outSize);
+
+/**
+ * @function evictCacheEntries
+ * @brief Removes the entries not used for the longest time, until the cache
+ * is not bigger than a size. The lock must be held.
+ *
+ * @param{cch} cache: the cache, its total size is updated.
+ * @param{long long} limit: the size.
+ *
+ * @return{void}
+ */
+void evictCacheEntries(cch cache, long long limit);
+
+/**
+ * @function isCacheEntryName
+ * @brief Tells if a file of the directory is an entry.
+ *
+ * @param{char*} name: name of the file.
+ *
+ * @return{int}: 1 if the name ends with HFM_CACHE_EXTENSION, 0 otherwise.
+ */
+int isCacheEntryName(char *name);
+
+/**
+ * @function compareCacheEntries
+ * @brief Compares the dates of two entries, for qsort.
+ *
+ * @param{const void*} entry1: the first struct cacheEntry.
+ * @param{const void*} entry2: the second struct cacheEntry.
+ *
+ * @return{int}: < 0 if the first one is older, > 0 if it is newer, 0 otherwise.
+ */
+int compareCacheEntries(const void *entry1, const void *entry2);
+
+
+/* ================================================== */
+/* ================ STRUCT FUNCTIONS ================ */
+/* ========================================================================== */
+
+
+/**
+ * @see @file cache.h / @function openCache
+ */
+cch openCache(char *directory, long long maxSize) {
+  if(mkdir(directory, 0777) != 0 && errno != EEXIST) {
+    perror(directory);
+    return NULL;
+  }
+  DIR *dir = opendir(directory);
+  if(dir == NULL) {
+    perror(directory);
+    return NULL;
+  }
+  cch cache = (cch)calloc(1, sizeof(struct cache));
+  if(cache == NULL) pointerAllocError();
+  cache->directory = (char*)copyString(directory);
+  if(cache->directory == NULL) pointerAllocError();
+  cache->maxSize = maxSize;
+  pthread_mutex_init(&cache->lock, NULL);
+  size_t directoryLength = strlen(directory);
+  struct dirent *dirEntry;
+  while((dirEntry = readdir(dir)) != NULL) {
+    if(!isCacheEntryName(dirEntry->d_name)) continue;
+    char *path = (char*)malloc(directoryLength + strlen(dirEntry->d_name) + 2);
+    if(path == NULL) pointerAllocError();
+    sprintf(path, "%s/%s", directory, dirEntry->d_name);
+    struct stat entryStat;
+    if(stat(path, &entryStat) == 0) cache->totalSize += (long long)entryStat.st_size;
+    free(path);
+  }
+  closedir(dir);
+  return cache;
+}
+
+/**
+ * @see @file cache.h / @function closeCache
+ */
+void closeCache(cch *cache) {
+  if(*cache == NULL) return;
+  if((*cache)->totalSize > (*cache)->maxSize) evictCacheEntries(*cache, (*cache)->maxSize - (*cache)->maxSize / 10);
+  pthread_mutex_destroy(&(*cache)->lock);
+  free((*cache)->directory);
+  free(*cache);
+  *cache = NULL;
+}
+
+/**
+ * @see @file cache.h / @function getCacheHits
+ */
+size_t getCacheHits(cch cache) {
+  return cache->hits;
+}
+
+/**
+ * @see @file cache.h / @function getCacheMisses
+ */
+size_t getCacheMisses(cch cache) {
+  return cache->misses;
+}
+
+
+/* ================================================== */
+/* ===================== PUBLIC ===================== */
+/* ========================================================================== */
+
+
+/**
+ * @see @file cache.h / @function encryptBufferCached
+ */
+unsigned char* encryptBufferCached(cch cache, unsigned char *data, size_t size, unsigned int checksums, size_t *outSize) {
+  if(cache == NULL || size > HFM_CACHE_MAX_ENTRY) return encryptBufferInMemory(data, size, checksums, outSize);
+  // The parameters of the format are in the seed: other parameters give other entries
+  uint64_t seed = ((uint64_t)HFM_CONTAINER_VERSION << 40) | ((uint64_t)HFM_BLOCK_SIZE << 8) | (checksums & HFM_CONTAINER_CHECKSUMS);
+  uint64_t hash = xxHash64(data, size, seed);
+  char *path = cacheEntryName(cache, hash, size);
+  unsigned char *out = readCacheEntry(cache, path, hash, size, outSize);
+  if(out != NULL) {
+    __atomic_fetch_add(&cache->hits, 1, __ATOMIC_RELAXED);
+  } else if((out = encryptBufferInMemory(data, size, checksums, outSize)) != NULL) {
+    __atomic_fetch_add(&cache->misses, 1, __ATOMIC_RELAXED);
+    writeCacheEntry(cache, path, hash, size, out, *outSize);
+  }
+  free(path);
+  return out;
+}
+
+
+/* ================================================== */
+/* ===================== PRIVATE ==================== */
+/* ========================================================================== */
+
+
+/**
+ * @see @file cache.c / @function cacheEntryName
+ */
+char* cacheEntryName(cch cache, uint64_t hash, size_t size) {
+  char *path = (char*)malloc(strlen(cache->directory) + 64);
+  if(path == NULL) pointerAllocError();
+  sprintf(path, "%s/%016llx-%llx%s", cache->directory, (unsigned long long)hash, (unsigned long long)size, HFM_CACHE_EXTENSION);
+  return path;
+}
+
+/**
+ * @see @file cache.c / @function readCacheEntry
+ */
+unsigned char* readCacheEntry(cch cache, char *path, uint64_t hash, size_t size, size_t *outSize) {
+  FILE *file = fopen(path, "rb");
+  if(file == NULL) return NULL;
+  unsigned char header[HFM_CACHE_HEADER_SIZE];
+  struct stat entryStat;
+  unsigned char *out = NULL;
+  int valid = fstat(fileno(file), &entryStat) == 0 && entryStat.st_size >= HFM_CACHE_HEADER_SIZE
+              && fread(header, 1, HFM_CACHE_HEADER_SIZE, file) == HFM_CACHE_HEADER_SIZE
+              && !memcmp(header, HFM_CACHE_MAGIC, 4) && loadLittleEndian(header + 8, 8) == hash
+              && loadLittleEndian(header + 16, 8) == (uint64_t)size;
+  if(valid) {
+    *outSize = (size_t)entryStat.st_size - HFM_CACHE_HEADER_SIZE;
+    out = (unsigned char*)malloc(*outSize + 1);
+    if(out == NULL) pointerAllocError();
+    valid = fread(out, 1, *outSize, file) == *outSize && crc32c(0, out, *outSize) == (uint32_t)loadLittleEndian(header + 4, 4);
+  }
+  if(valid) futimens(fileno(file), NULL); // Used now: removed last
+  fclose(file);
+  if(!valid) {
+    fprintf(stderr, "%s: corrupted, removed from the cache\n", path);
+    if(unlink(path) == 0) {
+      pthread_mutex_lock(&cache->lock);
+      cache->totalSize -= (long long)entryStat.st_size;
+      pthread_mutex_unlock(&cache->lock);
+    }
+    free(out);
+    out = NULL;
+  }
+  return out;
+}
+
+/**
+ * @see @file cache.c / @function writeCacheEntry
+ */
+void writeCacheEntry(cch cache, char *path, uint64_t hash, size_t size, unsigned char *out, size_t outSize) {
+  long long entrySize = HFM_CACHE_HEADER_SIZE + (long long)outSize;
+  if(entrySize > cache->maxSize) return;
+  char *temporary = (char*)malloc(strlen(cache->directory) + 64);
+  if(temporary == NULL) pointerAllocError();
+  unsigned int number = __atomic_fetch_add(&cache->nbTemporaries, 1, __ATOMIC_RELAXED);
+  sprintf(temporary, "%s/.tmp-%ld-%u", cache->directory, (long)getpid(), number);
+  int fd = open(temporary, O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+  FILE *file = (fd >= 0) ? fdopen(fd, "wb") : NULL;
+  if(file == NULL) {
+    if(fd >= 0) close(fd);
+    free(temporary);
+    return; // Coded again next time
+  }
+  unsigned char header[HFM_CACHE_HEADER_SIZE];
+  memcpy(header, HFM_CACHE_MAGIC, 4);
+  storeLittleEndian(header + 4, crc32c(0, out, outSize), 4);
+  storeLittleEndian(header + 8, hash, 8);
+  storeLittleEndian(header + 16, (uint64_t)size, 8);
+  int result = (fwrite(header, 1, HFM_CACHE_HEADER_SIZE, file) == HFM_CACHE_HEADER_SIZE && fwrite(out, 1, outSize, file) == outSize) ? 0 : -1;
+  if(fclose(file) != 0) result = -1;
+  // Seen complete or not at all by the other processes
+  if(result != 0 || rename(temporary, path) != 0) {
+    unlink(temporary);
+    free(temporary);
+    return;
+  }
+  free(temporary);
+  pthread_mutex_lock(&cache->lock);
+  cache->totalSize += entrySize;
+  if(cache->totalSize > cache->maxSize) evictCacheEntries(cache, cache->maxSize - cache->maxSize / 10);
+  pthread_mutex_unlock(&cache->lock);
+}
+
+/**
+ * @see @file cache.c / @function evictCacheEntries
+ */
+void evictCacheEntries(cch cache, long long limit) {
+  DIR *dir = opendir(cache->directory);
+  if(dir == NULL) return;
+  size_t nbEntries = 0, allocated = 64;
+  struct cacheEntry *entries = (struct cacheEntry*)malloc(allocated * sizeof(struct cacheEntry));
+  if(entries == NULL) pointerAllocError();
+  size_t directoryLength = strlen(cache->directory);
+  long long totalSize = 0;
+  struct dirent *dirEntry;
+  while((dirEntry = readdir(dir)) != NULL) {
+    if(!isCacheEntryName(dirEntry->d_name)) continue;
+    char *path = (char*)malloc(directoryLength + strlen(dirEntry->d_name) + 2);
+    if(path == NULL) pointerAllocError();
+    sprintf(path, "%s/%s", cache->directory, dirEntry->d_name);
+    struct stat entryStat;
+    if(stat(path, &entryStat) != 0) {
+      free(path);
+      continue;
+    }
+    if(nbEntries == allocated) {
+      allocated *= 2;
+      struct cacheEntry *ptr = (struct cacheEntry*)realloc(entries, allocated * sizeof(struct cacheEntry));
+      if(ptr == NULL) pointerAllocError();
+      entries = ptr;
+    }
+    entries[nbEntries].name = path;
+    entries[nbEntries].size = (long long)entryStat.st_size;
+    entries[nbEntries].used = (long long)entryStat.st_mtime;
+    totalSize += entries[nbEntries++].size;
+  }
+  closedir(dir);
+  qsort(entries, nbEntries, sizeof(struct cacheEntry), compareCacheEntries);
+  for (size_t i = 0; i < nbEntries; i++) {
+    if(totalSize > limit && unlink(entries[i].name) == 0) totalSize -= entries[i].size;
+    free(entries[i].name);
+  }
+  free(entries);
+  cache->totalSize = totalSize;
+}
+
+/**
+ * @see @file cache.c / @function isCacheEntryName
+ */
+int isCacheEntryName(char *name) {
+  size_t length = strlen(name);
+  size_t extensionLength = strlen(HFM_CACHE_EXTENSION);
+  return name[0] != '.' && length > extensionLength && !strcmp(name + length - extensionLength, HFM_CACHE_EXTENSION);
+}
+
+/**
+ * @see @file cache.c / @function compareCacheEntries
+ */
+int compareCacheEntries(const void *entry1, const void *entry2) {
+  long long used1 = ((const struct cacheEntry*)entry1)->used;
+  long long used2 = ((const struct cacheEntry*)entry2)->used;
+  return (used1 > used2) - (used1 < used2);
+}
+
+/* ========================================================================== */
+/* ========================================================================== */
@@ -0,0 +1,276 @@
+/**
+ * @file checkpoint.c
+ * @author agent <agent@local>
+ * @standard C99
+ * @version 1.0
+ * @date 18th October 2026
+ *
+ * @brief Implementation file for "checkpoint.h"
+ *
+ * This file implements the journal of the checkpoints written during the long
+ * encryptions and decryptions.
+ *
+ * Overview about private functions of checkpoint:
+ *  - checkpointFileName
+ *
+ * Overview about the checkpoint structure functions:
+ *  - createCheckpoint
+ *  - loadCheckpoint
+ *  - closeCheckpoint
+ *  - getCheckpointNbBlocks
+ *  - getCheckpointInputOffset
+ *  - getCheckpointOutputOffset
+ *  - getCheckpointChecksum
+ *
+ * Overview about public functions of checkpoint:
+ *  - commitCheckpoint
+ *  - restoreCheckpointBlocks
+ */
+
+#define _GNU_SOURCE /**< fseeko, ftello, fsync and ftruncate */
+#include "checkpoint.h"
+
+#include <unistd.h> /**< used for fsync and ftruncate */
+
+#define HFM_CHECKPOINT_ENTRY_SIZE 12 /**< Size of a block index entry of a record */
+#define HFM_CHECKPOINT_STATE_SIZE 32 /**< Size of the end of a record */
+
+
+/**
+ * @struct checkpoint
+ * @brief An opened checkpoint file and its last record.
+ */
+struct checkpoint {
+  FILE *file; /**< The checkpoint file, positioned after the last record */
+  char *name; /**< Its name */
+  size_t nbBlocks; /**< Number of blocks done */
+  long long inputOffset; /**< Offset in the input file after the blocks done */
+  long long outputOffset; /**< Offset in the output file after the blocks done */
+  uint32_t checksum; /**< CRC32C of the original data done */
+  size_t nbEntries; /**< Number of index entries in the file */
+  uint32_t *entries; /**< The index entries read (3 integers each), for a resume */
+};
+
+
+/* ================================================== */
+/* ============== DEF PRIVATE FUNCTIONS ============= */
+/* ========================================================================== */
+
+
+/**
+ * @function checkpointFileName
+ * @brief Returns the name of the checkpoint file of an output file.
+ *
+ * @param{char*} fileOut: name of the output file.
+ *
+ * @return{char*}: the name, to free, NULL if memory can't be allocated.
+ */
+char* checkpointFileName(char *fileOut);
+
+
+/* ================================================== */
+/* ================ STRUCT FUNCTIONS ================ */
+/* ========================================================================== */
+
+
+/**
+ * @see @file checkpoint.h / @function createCheckpoint
+ */
+ckp createCheckpoint(char *fileOut, char kind, long long inputSize) {
+  ckp checkpoint = (ckp)calloc(1, sizeof(struct checkpoint));
+  if(checkpoint == NULL) return NULL;
+  checkpoint->name = checkpointFileName(fileOut);
+  checkpoint->file = (checkpoint->name != NULL) ? fopen(checkpoint->name, "wb") : NULL;
+  if(checkpoint->file == NULL) {
+    if(checkpoint->name != NULL) perror(checkpoint->name);
+    free(checkpoint->name);
+    free(checkpoint);
+    return NULL;
+  }
+  unsigned char header[HFM_CHECKPOINT_HEADER_SIZE] = {0};
+  memcpy(header, HFM_CHECKPOINT_MAGIC, 4);
+  header[4] = (unsigned char)kind;
+  storeLittleEndian(header + 8, (uint64_t)inputSize, 8);
+  fwrite(header, 1, HFM_CHECKPOINT_HEADER_SIZE, checkpoint->file);
+  if(fflush(checkpoint->file) != 0) {
+    perror(checkpoint->name);
+    closeCheckpoint(&checkpoint, 1);
+  }
+  return checkpoint;
+}
+
+/**
+ * @see @file checkpoint.h / @function loadCheckpoint
+ */
+ckp loadCheckpoint(char *fileOut, char kind, long long inputSize) {
+  char *name = checkpointFileName(fileOut);
+  if(name == NULL) return NULL;
+  FILE *file = fopen(name, "r+b");
+  unsigned char header[HFM_CHECKPOINT_HEADER_SIZE];
+  if(file == NULL || fread(header, 1, HFM_CHECKPOINT_HEADER_SIZE, file) != HFM_CHECKPOINT_HEADER_SIZE
+     || memcmp(header, HFM_CHECKPOINT_MAGIC, 4) != 0 || header[4] != (unsigned char)kind
+     || loadLittleEndian(header + 8, 8) != (uint64_t)inputSize) {
+    printf("No checkpoint of this job to resume: '%s'\n", name);
+    if(file != NULL) fclose(file);
+    free(name);
+    return NULL;
+  }
+  ckp checkpoint = (ckp)calloc(1, sizeof(struct checkpoint));
+  if(checkpoint == NULL) {
+    fclose(file);
+    free(name);
+    return NULL;
+  }
+  checkpoint->file = file;
+  checkpoint->name = name;
+  long long fileSize = getFileSize(name);
+  long long end = HFM_CHECKPOINT_HEADER_SIZE; // End of the last complete record
+  unsigned char count[4];
+  while(fread(count, 1, 4, file) == 4) {
+    uint64_t nbEntries = loadLittleEndian(count, 4);
+    if(nbEntries > (uint64_t)(fileSize - end) / HFM_CHECKPOINT_ENTRY_SIZE) break;
+    size_t recordSize = 4 + (size_t)nbEntries * HFM_CHECKPOINT_ENTRY_SIZE + HFM_CHECKPOINT_STATE_SIZE;
+    unsigned char *record = (unsigned char*)malloc(recordSize);
+    if(record == NULL) break; // The job is resumed from the last record loaded
+    memcpy(record, count, 4);
+    int valid = fread(record + 4, 1, recordSize - 4, file) == recordSize - 4
+                && crc32c(0, record, recordSize - 4) == (uint32_t)loadLittleEndian(record + recordSize - 4, 4);
+    uint32_t *entries = valid ? (uint32_t*)realloc(checkpoint->entries, 3 * (checkpoint->nbEntries + (size_t)nbEntries + 1) * sizeof(uint32_t)) : NULL;
+    valid = valid && entries != NULL;
+    if(valid) {
+      checkpoint->entries = entries;
+      for (size_t i = 0; i < 3 * (size_t)nbEntries; i++)
+        checkpoint->entries[3 * checkpoint->nbEntries + i] = (uint32_t)loadLittleEndian(record + 4 + 4 * i, 4);
+      checkpoint->nbEntries += (size_t)nbEntries;
+      unsigned char *state = record + recordSize - HFM_CHECKPOINT_STATE_SIZE;
+      checkpoint->nbBlocks = (size_t)loadLittleEndian(state, 8);
+      checkpoint->inputOffset = (long long)loadLittleEndian(state + 8, 8);
+      checkpoint->outputOffset = (long long)loadLittleEndian(state + 16, 8);
+      checkpoint->checksum = (uint32_t)loadLittleEndian(state + 24, 4);
+      end += (long long)recordSize;
+    }
+    free(record);
+    if(!valid) break;
+  }
+  // A record cut by the interruption is removed before writing the next ones
+  if(fflush(file) != 0 || ftruncate(fileno(file), (off_t)end) != 0 || fseeko(file, (off_t)end, SEEK_SET) != 0) {
+    perror(name);
+    closeCheckpoint(&checkpoint, 0);
+  }
+  return checkpoint;
+}
+
+/**
+ * @see @file checkpoint.h / @function closeCheckpoint
+ */
+void closeCheckpoint(ckp *checkpoint, int done) {
+  if(checkpoint != NULL && *checkpoint != NULL) {
+    fclose((*checkpoint)->file);
+    if(done) remove((*checkpoint)->name);
+    free((*checkpoint)->entries);
+    free((*checkpoint)->name);
+    free(*checkpoint);
+    *checkpoint = NULL;
+  }
+}
+
+/**
+ * @see @file checkpoint.h / @function getCheckpointNbBlocks
+ */
+size_t getCheckpointNbBlocks(ckp checkpoint) {
+  return checkpoint->nbBlocks;
+}
+
+/**
+ * @see @file checkpoint.h / @function getCheckpointInputOffset
+ */
+long long getCheckpointInputOffset(ckp checkpoint) {
+  return checkpoint->inputOffset;
+}
+
+/**
+ * @see @file checkpoint.h / @function getCheckpointOutputOffset
+ */
+long long getCheckpointOutputOffset(ckp checkpoint) {
+  return checkpoint->outputOffset;
+}
+
+/**
+ * @see @file checkpoint.h / @function getCheckpointChecksum
+ */
+uint32_t getCheckpointChecksum(ckp checkpoint) {
+  return checkpoint->checksum;
+}
+
+
+/* ================================================== */
+/* ===================== PUBLIC ===================== */
+/* ========================================================================== */
+
+
+/**
+ * @see @file checkpoint.h / @function commitCheckpoint
+ */
+int commitCheckpoint(ckp checkpoint, FILE *fileOut, ctn container, size_t nbBlocks, long long inputOffset, uint32_t checksum) {
+  // The data must be on the disk before the record describing it
+  if(fflush(fileOut) != 0 || fsync(fileno(fileOut)) != 0) return -1;
+  long long outputOffset = (long long)ftello(fileOut);
+  size_t nbEntries = (container != NULL) ? getContainerNbBlocks(container) - checkpoint->nbEntries : 0;
+  size_t recordSize = 4 + nbEntries * HFM_CHECKPOINT_ENTRY_SIZE + HFM_CHECKPOINT_STATE_SIZE;
+  unsigned char *record = (unsigned char*)malloc(recordSize);
+  if(record == NULL) return -1;
+  storeLittleEndian(record, nbEntries, 4);
+  for (size_t i = 0; i < nbEntries; i++) {
+    size_t index = checkpoint->nbEntries + i;
+    storeLittleEndian(record + 4 + HFM_CHECKPOINT_ENTRY_SIZE * i, getContainerBlockStoredSize(container, index), 4);
+    storeLittleEndian(record + 8 + HFM_CHECKPOINT_ENTRY_SIZE * i, getContainerBlockLength(container, index), 4);
+    uint32_t blockChecksum = (getContainerChecksums(container) & HFM_CONTAINER_BLOCK_CRC) ? getContainerBlockChecksum(container, index) : 0;
+    storeLittleEndian(record + 12 + HFM_CHECKPOINT_ENTRY_SIZE * i, blockChecksum, 4);
+  }
+  unsigned char *state = record + recordSize - HFM_CHECKPOINT_STATE_SIZE;
+  storeLittleEndian(state, nbBlocks, 8);
+  storeLittleEndian(state + 8, (uint64_t)inputOffset, 8);
+  storeLittleEndian(state + 16, (uint64_t)outputOffset, 8);
+  storeLittleEndian(state + 24, checksum, 4);
+  storeLittleEndian(state + 28, crc32c(0, record, recordSize - 4), 4);
+  int result = (outputOffset >= 0 && fwrite(record, 1, recordSize, checkpoint->file) == recordSize
+                && fflush(checkpoint->file) == 0 && fsync(fileno(checkpoint->file)) == 0) ? 0 : -1;
+  free(record);
+  if(result == 0) {
+    checkpoint->nbEntries += nbEntries;
+    checkpoint->nbBlocks = nbBlocks;
+    checkpoint->inputOffset = inputOffset;
+    checkpoint->outputOffset = outputOffset;
+    checkpoint->checksum = checksum;
+  }
+  return result;
+}
+
+/**
+ * @see @file checkpoint.h / @function restoreCheckpointBlocks
+ */
+void restoreCheckpointBlocks(ckp checkpoint, ctn container) {
+  for (size_t i = 0; i < checkpoint->nbEntries; i++)
+    restoreContainerBlock(container, checkpoint->entries[3 * i], checkpoint->entries[3 * i + 1], checkpoint->entries[3 * i + 2]);
+  setContainerChecksum(container, checkpoint->checksum);
+}
+
+
+/* ================================================== */
+/* ===================== PRIVATE ==================== */
+/* ========================================================================== */
+
+
+/**
+ * @see @file checkpoint.c / @function checkpointFileName
+ */
+char* checkpointFileName(char *fileOut) {
+  char *name = (char*)malloc(strlen(fileOut) + strlen(HFM_CHECKPOINT_EXTENSION) + 1);
+  if(name == NULL) return NULL;
+  strcpy(name, fileOut);
+  strcat(name, HFM_CHECKPOINT_EXTENSION);
+  return name;
+}
+
+/* ========================================================================== */
+/* ========================================================================== */
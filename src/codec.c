@@ -0,0 +1,1929 @@
+/**
+ * @file codec.c
+ * @author agent <agent@local>
+ * @standard C99
+ * @version 1.0
+ * @date 18th October 2026
+ *
+ * @brief Implementation file for "codec.h"
+ *
+ * This file implements the tables built from occurrences, the coding and the
+ * decoding of the blocks with them, and the ".hfm" container written and read
+ * in memory.
+ *
+ * The tree is built as by contructBinaryTree: the leaves are taken in the order
+ * of the byte values, the two nodes merged are chosen by the same scan of the
+ * list (@see @function mergeTwoSmallerNodes) and the merged node is appended at
+ * its end. Any other choice between equal weights would give other prefixes.
+ *
+ * The block index is only known once the blocks are written, and its size is
+ * known from the start: it is written at the end of the output while the
+ * blocks are written from its start, then moved after the last block. The
+ * output is bounded by the space left before the index, and once it is too
+ * small the blocks are only measured, to give the size needed.
+ *
+ * The buffers are fragments (struct iovec), a contiguous buffer being a single
+ * one. A cursor walks through them: a block and its payload are coded in place
+ * when each is in a single fragment, and through a small buffer on the stack
+ * otherwise, the coding of the bits going on from a piece to the next one.
+ * Nothing is allocated when a scratch space is given.
+ *
+ * The parallel functions cut the blocks in ranges, a task of the scheduler for
+ * each, in three passes for the compression: the occurrences, the size of each
+ * block (its offset follows), then the blocks written at their offset. The
+ * checksum of the file is made of the checksums of the blocks. The tables
+ * shared by the tasks are in a scratch space of their own: a worker waiting
+ * for them may run other tasks with its scratch space meanwhile.
+ *
+ * Overview about private functions of codec:
+ *  - buildCodecTables
+ *  - assignCodecPrefixes
+ *  - chooseCodecTables
+ *  - codecCodedSize
+ *  - encodeCodecBits
+ *  - encodeCodecBlock
+ *  - encodeCodecCursor
+ *  - decodeCodecBlock
+ *  - decodeCodecCursor
+ *  - planCodecBlock
+ *  - writeCodecBlock
+ *  - checkCodecBlock
+ *  - decodeCodecDataBlock
+ *  - initCodecCursor
+ *  - spanCodecCursor
+ *  - skipCodecCursor
+ *  - getCodecCursor
+ *  - putCodecCursor
+ *  - copyCodecCursor
+ *  - codecVectorSize
+ *  - codecCostOf
+ *  - putCodecBytes
+ *  - putCodecVarint
+ *  - putCodecHeader
+ *  - readCodecVarint
+ *  - readCodecHeader
+ *  - openCodecFile
+ *  - recordCodecError
+ *  - runCodecTasks
+ *  - countCodecTask
+ *  - planCodecTask
+ *  - encodeCodecTask
+ *  - decodeCodecTask
+ *
+ * Overview about the scratch structure functions:
+ *  - createCodecScratch
+ *  - destroyCodecScratch
+ *
+ * Overview about the context structure functions:
+ *  - createCodecContext
+ *  - retainCodecContext
+ *  - destroyCodecContext
+ *
+ * Overview about the stream structure functions:
+ *  - createCodecStream
+ *  - destroyCodecStream
+ *
+ * Overview about public functions of codec:
+ *  - codecErrorMessage
+ *  - codecCompressBound
+ *  - codecCompress
+ *  - codecDecompressedSize
+ *  - codecDecompress
+ *  - codecCompressVector
+ *  - codecDecompressVector
+ *  - codecCompressParallel
+ *  - codecDecompressParallel
+ *  - codecMessageBound
+ *  - codecCompressMessage
+ *  - codecDecompressMessage
+ *  - codecStreamBound
+ *  - codecEncodeStream
+ *  - codecFlushStream
+ *  - codecDecodeStream
+ *  - codecAlignStream
+ *  - codecDecodeTree
+ *  - codecDecodeTreeBlock
+ */
+
+#include "codec.h"
+#include "scheduler.h"
+
+#define HFM_CODEC_MAX_VARINT 10 /**< Maximal size of an occurrence in a table */
+#define HFM_CODEC_HEAD_SIZE (HFM_CONTAINER_HEADER_SIZE + 256 * HFM_CODEC_MAX_VARINT) /**< Maximal header and table */
+#define HFM_CODEC_CHUNK 128 /**< Bytes coded at a time through the stack (32 bytes of payload each at most) */
+#define HFM_CODEC_NO_PREFIX ((uint64_t)1 << 40) /**< Cost of a byte with no prefix: the message is stored */
+#define HFM_CODEC_PARALLEL_BLOCKS 4 /**< Fewer blocks are coded by the caller alone */
+#define HFM_CODEC_TASKS_PER_WORKER 4 /**< Ranges of blocks per worker, for the balance */
+
+
+/**
+ * @struct codecTables
+ * @brief The prefixes and the flattened tree of a code table.
+ *
+ * In the tree, a child greater or equal to 0 is the index of another node, and
+ * a negative child c is the leaf of the byte -(c+1).
+ */
+struct codecTables {
+  uint64_t prefixes[256][4]; /**< Prefix of each byte, its first bit the highest one */
+  uint16_t lengths[256]; /**< Size of each prefix, in bits */
+  uint8_t hasCode[256]; /**< 1 if the byte has a prefix */
+  int16_t nodes[255][2]; /**< The tree, its nodes in the order of their merge */
+  int16_t root; /**< The root, a leaf if the table has a single byte */
+  unsigned int nbLeaves; /**< Number of bytes of the table, 0 if it codes nothing */
+};
+
+/**
+ * @struct codecScratch
+ * @brief The memory used while coding.
+ */
+struct codecScratch {
+  struct codecTables base; /**< Table of the header or of the key */
+  struct codecTables block; /**< Table of the last table block */
+  size_t histogram[256]; /**< Occurrences of the data, or of a block */
+  size_t blockHistogram[256]; /**< Occurrences of a table block */
+};
+
+/**
+ * @struct codecHeader
+ * @brief The fields of the header of a ".hfm" file.
+ */
+struct codecHeader {
+  unsigned int version; /**< Version of the format */
+  unsigned int flags; /**< HFM_CONTAINER_TABLE and the checksums */
+  uint64_t originalSize; /**< Size of the original data */
+  uint64_t nbBlocks; /**< Number of blocks */
+  uint64_t indexOffset; /**< Offset of the block index */
+  size_t firstBlockOffset; /**< Offset of the first block, after the code table */
+};
+
+/**
+ * @struct codecContext
+ * @brief The tables of a key, for the messages coded with it.
+ */
+struct codecContext {
+  struct codecTables tables; /**< The tables of the key */
+  uint64_t costs[256]; /**< Size of the prefix of each byte, HFM_CODEC_NO_PREFIX if it has none */
+  unsigned int maxLength; /**< Size of the longest prefix */
+  unsigned long references; /**< Number of references (atomic) */
+};
+
+/**
+ * @struct codecStream
+ * @brief The state of a stream between two calls.
+ */
+struct codecStream {
+  cct context; /**< The context, a reference taken */
+  int16_t node; /**< Node of the tree reached by the decoding */
+  uint8_t pending; /**< Bits of the last byte coded, in the lowest bits */
+  uint8_t nbPending; /**< Number of these bits, less than 8 */
+  uint8_t byte; /**< Byte being decoded */
+  uint8_t nbBits; /**< Bits of this byte not decoded yet, in its lowest bits */
+};
+
+/**
+ * @struct codecBits
+ * @brief The bits of a payload not written yet, between two pieces of a block.
+ */
+struct codecBits {
+  uint64_t bits; /**< The bits, in the lowest bits */
+  unsigned int nbPending; /**< Number of bits, less than 8 between two pieces */
+};
+
+/**
+ * @struct codecCursor
+ * @brief A position in fragments.
+ */
+struct codecCursor {
+  const struct iovec *vector; /**< The fragments */
+  int count; /**< Number of fragments */
+  int index; /**< The fragment of the position */
+  size_t offset; /**< The position in this fragment */
+};
+
+/**
+ * @struct codecJob
+ * @brief The state shared by the tasks coding a buffer.
+ */
+struct codecJob {
+  const struct codecTables *tables; /**< The tables */
+  const unsigned char *data; /**< The data, or the ".hfm" file */
+  size_t size; /**< Size of the data */
+  unsigned char *out; /**< The output */
+  size_t *histogram; /**< Occurrences of the data (atomic) */
+  size_t *offsets; /**< Offset of each block in the ".hfm" file */
+  size_t *positions; /**< Offset of each block in the data (decompression) */
+  uint32_t *checksums; /**< Checksum of each block */
+  unsigned int flags; /**< Flags of the header */
+  size_t entrySize; /**< Size of an entry of the index */
+  unsigned char *index; /**< The index (written or read) */
+  uint64_t error; /**< First error: its block, then its code on 8 bits (atomic) */
+};
+
+/**
+ * @struct codecTask
+ * @brief A range of blocks of a job.
+ */
+struct codecTask {
+  struct codecJob *job; /**< The job */
+  size_t first; /**< First block */
+  size_t last; /**< Block after the last one */
+};
+
+
+/* ================================================== */
+/* ============== DEF PRIVATE FUNCTIONS ============= */
+/* ========================================================================== */
+
+
+/**
+ * @function buildCodecTables
+ * @brief Builds the tables of occurrences, as the tree of "huffman.c".
+ *
+ * @param{const size_t*} histogram: occurrences of the 256 byte values.
+ * @param{struct codecTables*} tables: the tables to fill.
+ *
+ * @return{void}
+ */
+void buildCodecTables(const size_t *histogram, struct codecTables *tables);
+
+/**
+ * @function assignCodecPrefixes
+ * @brief Gives its prefix to each leaf under a node (recursively).
+ *
+ * @param{struct codecTables*} tables: the tables, with their tree.
+ * @param{int16_t} node: the node.
+ * @param{unsigned int} depth: depth of the node.
+ * @param{uint64_t*} prefix: prefix of the node (4 words).
+ *
+ * @return{void}
+ */
+void assignCodecPrefixes(struct codecTables *tables, int16_t node, unsigned int depth, uint64_t *prefix);
+
+/**
+ * @function chooseCodecTables
+ * @brief Builds the tables of a compression, empty if the coding doesn't make
+ * the data smaller (@see @function isCodingWorthIt).
+ *
+ * @param{struct codecTables*} tables: the tables to fill.
+ * @param{size_t*} histogram: occurrences of the data, set to 0 if the tables
+ *                            are empty (ignored with a key).
+ * @param{size_t} size: size of the data.
+ * @param{const size_t*} key: occurrences of the key (can be NULL).
+ *
+ * @return{void}
+ */
+void chooseCodecTables(struct codecTables *tables, size_t *histogram, size_t size, const size_t *key);
+
+/**
+ * @function codecCodedSize
+ * @brief Gives the size of the payload of a block coded with a table.
+ *
+ * @param{const struct codecTables*} tables: the tables.
+ * @param{const size_t*} histogram: occurrences of the block.
+ *
+ * @return{size_t}: the size in bytes, SIZE_MAX if a byte has no prefix.
+ */
+size_t codecCodedSize(const struct codecTables *tables, const size_t *histogram);
+
+/**
+ * @function encodeCodecBits
+ * @brief Codes a piece of a block with a table, keeping the last bits which
+ * don't make a byte.
+ *
+ * @param{const struct codecTables*} tables: the tables, with a prefix for each
+ *                                           byte of the piece.
+ * @param{const unsigned char*} data: the piece.
+ * @param{size_t} size: size of the piece.
+ * @param{struct codecBits*} state: the bits left by the piece before, then the
+ *                                  ones left by this one.
+ * @param{unsigned char*} out: the payload.
+ *
+ * @return{size_t}: the number of bytes written.
+ */
+size_t encodeCodecBits(const struct codecTables *tables, const unsigned char *data, size_t size, struct codecBits *state, unsigned char *out);
+
+/**
+ * @function encodeCodecBlock
+ * @brief Codes a block with a table.
+ *
+ * @param{const struct codecTables*} tables: the tables, with a prefix for each
+ *                                           byte of the block.
+ * @param{const unsigned char*} block: the block.
+ * @param{size_t} size: size of the block.
+ * @param{unsigned char*} out: the payload, of codecCodedSize bytes.
+ *
+ * @return{size_t}: the size of the payload.
+ */
+size_t encodeCodecBlock(const struct codecTables *tables, const unsigned char *block, size_t size, unsigned char *out);
+
+/**
+ * @function encodeCodecCursor
+ * @brief Codes a block of fragments in fragments, and moves both cursors.
+ *
+ * @param{const struct codecTables*} tables: the tables.
+ * @param{struct codecCursor*} in: the block.
+ * @param{size_t} length: size of the block.
+ * @param{struct codecCursor*} out: the payload.
+ * @param{size_t} payloadSize: size of the payload (@see @function
+ *                             codecCodedSize).
+ *
+ * @return{void}
+ */
+void encodeCodecCursor(const struct codecTables *tables, struct codecCursor *in, size_t length, struct codecCursor *out, size_t payloadSize);
+
+/**
+ * @function decodeCodecBlock
+ * @brief Decodes a block with a table.
+ *
+ * @param{const struct codecTables*} tables: the tables.
+ * @param{const unsigned char*} payload: the payload.
+ * @param{size_t} size: size of the payload.
+ * @param{unsigned char*} out: the block.
+ * @param{size_t} length: size of the block.
+ *
+ * @return{int}: HFM_OK, HFM_ERROR_CORRUPTED if the payload is too short or the
+ *               table codes nothing.
+ */
+int decodeCodecBlock(const struct codecTables *tables, const unsigned char *payload, size_t size, unsigned char *out, size_t length);
+
+/**
+ * @function decodeCodecCursor
+ * @brief Decodes a block checked from fragments in fragments, and moves the
+ * cursor of the output (@see @function decodeCodecDataBlock).
+ *
+ * @param{const struct codecTables*} tables: the tables.
+ * @param{unsigned char} type: type of the block.
+ * @param{struct codecCursor*} payload: the payload, moved.
+ * @param{size_t} payloadSize: size of the payload.
+ * @param{struct codecCursor*} out: the original block.
+ * @param{size_t} length: size of the original block.
+ *
+ * @return{int}: HFM_OK, HFM_ERROR_CORRUPTED if the block is not valid.
+ */
+int decodeCodecCursor(const struct codecTables *tables, unsigned char type, struct codecCursor *payload, size_t payloadSize, struct codecCursor *out, size_t length);
+
+/**
+ * @function planCodecBlock
+ * @brief Gives the size of the payload of a block: coded, or stored if the
+ * coding doesn't make it smaller.
+ *
+ * @param{const struct codecTables*} tables: the tables.
+ * @param{size_t*} histogram: receives the occurrences of the block.
+ * @param{const unsigned char*} block: the block.
+ * @param{size_t} length: size of the block.
+ *
+ * @return{size_t}: the size of the payload, 'length' if the block is stored.
+ */
+size_t planCodecBlock(const struct codecTables *tables, size_t *histogram, const unsigned char *block, size_t length);
+
+/**
+ * @function writeCodecBlock
+ * @brief Writes a block, its header and its payload.
+ *
+ * @param{const struct codecTables*} tables: the tables.
+ * @param{const unsigned char*} block: the block.
+ * @param{size_t} length: size of the block.
+ * @param{size_t} payloadSize: size given by planCodecBlock.
+ * @param{unsigned char*} out: the output.
+ *
+ * @return{void}
+ */
+void writeCodecBlock(const struct codecTables *tables, const unsigned char *block, size_t length, size_t payloadSize, unsigned char *out);
+
+/**
+ * @function checkCodecBlock
+ * @brief Checks the header of a block against its entry of the index (@see
+ * @function readBlockHeaderInOpenedFile).
+ *
+ * @param{const unsigned char*} block: the block.
+ * @param{size_t} storedSize: size of the block in the index.
+ * @param{size_t} length: size of the original block in the index.
+ *
+ * @return{int}: HFM_OK, HFM_ERROR_CORRUPTED if they don't match.
+ */
+int checkCodecBlock(const unsigned char *block, size_t storedSize, size_t length);
+
+/**
+ * @function decodeCodecDataBlock
+ * @brief Decodes a block checked, stored or coded.
+ *
+ * @param{const struct codecTables*} tables: the tables.
+ * @param{unsigned char} type: type of the block.
+ * @param{const unsigned char*} payload: the payload.
+ * @param{size_t} payloadSize: size of the payload.
+ * @param{unsigned char*} out: the original block.
+ * @param{size_t} length: size of the original block.
+ *
+ * @return{int}: HFM_OK, HFM_ERROR_CORRUPTED if the block is not valid.
+ */
+int decodeCodecDataBlock(const struct codecTables *tables, unsigned char type, const unsigned char *payload, size_t payloadSize, unsigned char *out, size_t length);
+
+/**
+ * @function initCodecCursor
+ * @brief Sets a cursor at a position of fragments.
+ *
+ * @param{struct codecCursor*} cursor: the cursor.
+ * @param{const struct iovec*} vector: the fragments.
+ * @param{int} count: number of fragments.
+ * @param{size_t} position: the position, from the start of the first one.
+ *
+ * @return{void}
+ */
+void initCodecCursor(struct codecCursor *cursor, const struct iovec *vector, int count, size_t position);
+
+/**
+ * @function spanCodecCursor
+ * @brief Gives the bytes of the fragment of a cursor from its position.
+ *
+ * @param{struct codecCursor*} cursor: the cursor, moved to the next fragment
+ *                                     not empty if its fragment is done.
+ * @param{size_t*} available: receives the number of bytes, 0 at the end.
+ *
+ * @return{unsigned char*}: the bytes.
+ */
+unsigned char* spanCodecCursor(struct codecCursor *cursor, size_t *available);
+
+/**
+ * @function skipCodecCursor
+ * @brief Moves a cursor.
+ *
+ * @param{struct codecCursor*} cursor: the cursor.
+ * @param{size_t} size: number of bytes.
+ *
+ * @return{void}
+ */
+void skipCodecCursor(struct codecCursor *cursor, size_t size);
+
+/**
+ * @function getCodecCursor
+ * @brief Reads bytes at a cursor, and moves it.
+ *
+ * @param{struct codecCursor*} cursor: the cursor.
+ * @param{void*} bytes: receives the bytes.
+ * @param{size_t} size: number of bytes, in the fragments.
+ *
+ * @return{void}
+ */
+void getCodecCursor(struct codecCursor *cursor, void *bytes, size_t size);
+
+/**
+ * @function putCodecCursor
+ * @brief Writes bytes at a cursor, and moves it.
+ *
+ * @param{struct codecCursor*} cursor: the cursor.
+ * @param{const void*} bytes: the bytes.
+ * @param{size_t} size: number of bytes, in the fragments.
+ *
+ * @return{void}
+ */
+void putCodecCursor(struct codecCursor *cursor, const void *bytes, size_t size);
+
+/**
+ * @function copyCodecCursor
+ * @brief Copies bytes from a cursor to another one, and moves both. The
+ * destination can overlap the source if it is before.
+ *
+ * @param{struct codecCursor*} to: the destination.
+ * @param{struct codecCursor*} from: the source.
+ * @param{size_t} size: number of bytes, in the fragments.
+ *
+ * @return{void}
+ */
+void copyCodecCursor(struct codecCursor *to, struct codecCursor *from, size_t size);
+
+/**
+ * @function codecVectorSize
+ * @brief Gives the size of fragments.
+ *
+ * @param{const struct iovec*} vector: the fragments.
+ * @param{int} count: number of fragments.
+ *
+ * @return{size_t}: the sum of their sizes, SIZE_MAX if they are not valid.
+ */
+size_t codecVectorSize(const struct iovec *vector, int count);
+
+/**
+ * @function codecCostOf
+ * @brief Gives the size of the prefixes of data with the tables of a context.
+ *
+ * @param{cct} context: the context.
+ * @param{const unsigned char*} data: the data.
+ * @param{size_t} size: size of the data.
+ *
+ * @return{uint64_t}: the size in bits, HFM_CODEC_NO_PREFIX or more if a byte
+ *                    has no prefix.
+ */
+uint64_t codecCostOf(cct context, const unsigned char *data, size_t size);
+
+/**
+ * @function putCodecBytes
+ * @brief Writes bytes in the output if they fit, and moves the position.
+ *
+ * @param{unsigned char*} out: the output.
+ * @param{size_t} limit: bytes of the output that can be written.
+ * @param{size_t*} position: position of the bytes, moved after them.
+ * @param{const void*} bytes: the bytes (NULL to only move the position).
+ * @param{size_t} size: number of bytes.
+ *
+ * @return{int}: 1 if the bytes have been written, 0 otherwise.
+ */
+int putCodecBytes(unsigned char *out, size_t limit, size_t *position, const void *bytes, size_t size);
+
+/**
+ * @function putCodecVarint
+ * @brief Writes an occurrence as in a histogram file (@see @file histogram.h).
+ *
+ * @param{unsigned char*} out: the output.
+ * @param{size_t} limit: bytes of the output that can be written.
+ * @param{size_t*} position: position of the integer, moved after it.
+ * @param{size_t} value: the integer.
+ *
+ * @return{void}
+ */
+void putCodecVarint(unsigned char *out, size_t limit, size_t *position, size_t value);
+
+/**
+ * @function putCodecHeader
+ * @brief Writes the header of a ".hfm" file (its index offset 0) and its code
+ * table.
+ *
+ * @param{unsigned char*} out: the output.
+ * @param{size_t} limit: bytes of the output that can be written.
+ * @param{size_t*} position: position of the header, moved after the table.
+ * @param{size_t} size: size of the data.
+ * @param{size_t} nbBlocks: number of blocks.
+ * @param{unsigned int} flags: flags of the header.
+ * @param{const size_t*} histogram: the code table, written with
+ *                                  HFM_CONTAINER_TABLE.
+ *
+ * @return{int}: 1 if the header and the table have been written, 0 otherwise.
+ */
+int putCodecHeader(unsigned char *out, size_t limit, size_t *position, size_t size, size_t nbBlocks, unsigned int flags, const size_t *histogram);
+
+/**
+ * @function readCodecVarint
+ * @brief Reads an occurrence written by putCodecVarint.
+ *
+ * @param{const unsigned char*} data: the data.
+ * @param{size_t} end: the integer can't go past this offset.
+ * @param{size_t*} position: position of the integer, moved after it.
+ * @param{size_t*} value: receives the integer.
+ *
+ * @return{int}: 0 if the integer has been read, -1 otherwise.
+ */
+int readCodecVarint(const unsigned char *data, size_t end, size_t *position, size_t *value);
+
+/**
+ * @function readCodecHeader
+ * @brief Reads the header of a ".hfm" file and its code table.
+ *
+ * @param{const unsigned char*} data: the ".hfm" file.
+ * @param{size_t} size: size of the ".hfm" file.
+ * @param{struct codecHeader*} header: receives the fields of the header.
+ * @param{size_t*} histogram: receives the code table (can be NULL).
+ *
+ * @return{int}: HFM_OK, HFM_ERROR_CORRUPTED if the header is not valid.
+ */
+int readCodecHeader(const unsigned char *data, size_t size, struct codecHeader *header, size_t *histogram);
+
+/**
+ * @function openCodecFile
+ * @brief Reads and checks the header and the index of a ".hfm" file before its
+ * decoding (@see @function readContainer).
+ *
+ * @param{const struct iovec*} data: fragments of the ".hfm" file.
+ * @param{int} count: number of fragments.
+ * @param{size_t} size: size of the ".hfm" file.
+ * @param{const size_t*} key: the key (can be NULL).
+ * @param{size_t} capacity: size of the output.
+ * @param{size_t*} outSize: receives the size of the original data.
+ * @param{struct codecHeader*} header: receives the fields of the header.
+ * @param{size_t*} histogram: receives the code table, set to 0 first.
+ *
+ * @return{int}: HFM_OK or the error code of codecDecompress.
+ */
+int openCodecFile(const struct iovec *data, int count, size_t size, const size_t *key, size_t capacity, size_t *outSize, struct codecHeader *header, size_t *histogram);
+
+/**
+ * @function recordCodecError
+ * @brief Keeps the error of a block, if no block before has one.
+ *
+ * @param{struct codecJob*} job: the job.
+ * @param{size_t} block: index of the block.
+ * @param{int} error: the error code.
+ *
+ * @return{void}
+ */
+void recordCodecError(struct codecJob *job, size_t block, int error);
+
+/**
+ * @function runCodecTasks
+ * @brief Runs a function on the ranges of blocks of a job, and waits for them.
+ *
+ * A range which can't be submitted is run by the caller.
+ *
+ * @param{sch} scheduler: the scheduler.
+ * @param{schedulerFunction} function: the function of the tasks.
+ * @param{struct codecTask*} tasks: the ranges.
+ * @param{size_t} nbTasks: number of ranges.
+ * @param{csc} scratch: scratch space of the ranges run by the caller.
+ *
+ * @return{void}
+ */
+void runCodecTasks(sch scheduler, schedulerFunction function, struct codecTask *tasks, size_t nbTasks, csc scratch);
+
+/**
+ * @function countCodecTask
+ * @brief Task adding the occurrences of a range of blocks to the histogram of
+ * its job.
+ *
+ * @param{void*} arg: the struct codecTask.
+ * @param{csc} scratch: scratch space of the worker.
+ *
+ * @return{void}
+ */
+void countCodecTask(void *arg, csc scratch);
+
+/**
+ * @function planCodecTask
+ * @brief Task giving the stored size of each block of a range.
+ *
+ * @param{void*} arg: the struct codecTask.
+ * @param{csc} scratch: scratch space of the worker.
+ *
+ * @return{void}
+ */
+void planCodecTask(void *arg, csc scratch);
+
+/**
+ * @function encodeCodecTask
+ * @brief Task writing the blocks of a range and their entries of the index.
+ *
+ * @param{void*} arg: the struct codecTask.
+ * @param{csc} scratch: scratch space of the worker.
+ *
+ * @return{void}
+ */
+void encodeCodecTask(void *arg, csc scratch);
+
+/**
+ * @function decodeCodecTask
+ * @brief Task checking and decoding the blocks of a range.
+ *
+ * @param{void*} arg: the struct codecTask.
+ * @param{csc} scratch: scratch space of the worker.
+ *
+ * @return{void}
+ */
+void decodeCodecTask(void *arg, csc scratch);
+
+
+/* ================================================== */
+/* ================ STRUCT FUNCTIONS ================ */
+/* ========================================================================== */
+
+
+/**
+ * @see @file codec.h / @function createCodecScratch
+ */
+csc createCodecScratch(void) {
+  return (csc)malloc(sizeof(struct codecScratch));
+}
+
+/**
+ * @see @file codec.h / @function destroyCodecScratch
+ */
+void destroyCodecScratch(csc *scratch) {
+  if(*scratch != NULL) {
+    free(*scratch);
+    *scratch = NULL;
+  }
+}
+
+
+/**
+ * @see @file codec.h / @function createCodecContext
+ */
+cct createCodecContext(const size_t *key) {
+  if(key == NULL) return NULL;
+  cct context = (cct)malloc(sizeof(struct codecContext));
+  if(context == NULL) return NULL;
+  buildCodecTables(key, &context->tables);
+  context->maxLength = 0;
+  for (size_t c = 0; c < 256; c++) {
+    context->costs[c] = context->tables.hasCode[c] ? context->tables.lengths[c] : HFM_CODEC_NO_PREFIX;
+    if(context->tables.hasCode[c] && context->tables.lengths[c] > context->maxLength) context->maxLength = context->tables.lengths[c];
+  }
+  context->references = 1;
+  return context;
+}
+
+/**
+ * @see @file codec.h / @function retainCodecContext
+ */
+cct retainCodecContext(cct context) {
+  __atomic_add_fetch(&context->references, 1, __ATOMIC_RELAXED);
+  return context;
+}
+
+/**
+ * @see @file codec.h / @function destroyCodecContext
+ */
+void destroyCodecContext(cct *context) {
+  if(*context != NULL) {
+    // The last reference frees it, once the others are done with its tables
+    if(__atomic_sub_fetch(&(*context)->references, 1, __ATOMIC_ACQ_REL) == 0) free(*context);
+    *context = NULL;
+  }
+}
+
+/**
+ * @see @file codec.h / @function createCodecStream
+ */
+cst createCodecStream(cct context) {
+  if(context == NULL) return NULL;
+  cst stream = (cst)calloc(1, sizeof(struct codecStream));
+  if(stream == NULL) return NULL;
+  stream->context = retainCodecContext(context);
+  stream->node = context->tables.root;
+  return stream;
+}
+
+/**
+ * @see @file codec.h / @function destroyCodecStream
+ */
+void destroyCodecStream(cst *stream) {
+  if(*stream != NULL) {
+    destroyCodecContext(&(*stream)->context);
+    free(*stream);
+    *stream = NULL;
+  }
+}
+
+
+/* ================================================== */
+/* ===================== PUBLIC ===================== */
+/* ========================================================================== */
+
+
+/**
+ * @see @file codec.h / @function codecErrorMessage
+ */
+const char* codecErrorMessage(int error) {
+  switch(error) {
+    case HFM_OK: return "done";
+    case HFM_ERROR_KEY: return "the key of the file is needed";
+    case HFM_ERROR_CORRUPTED: return "the file is corrupted";
+    case HFM_ERROR_CHECKSUM: return "the file does not match its checksums";
+    case HFM_ERROR_ARGUMENT: return "an argument is not valid";
+    case HFM_ERROR_MEMORY: return "memory can't be allocated";
+    case HFM_ERROR_OVERFLOW: return "the output is too small";
+    default: return "unknown error";
+  }
+}
+
+/**
+ * @see @file codec.h / @function codecCompressBound
+ */
+size_t codecCompressBound(size_t size) {
+  size_t nbBlocks = size / HFM_BLOCK_SIZE + 1;
+  return HFM_CONTAINER_HEADER_SIZE + 256 * HFM_CODEC_MAX_VARINT + HFM_INDEX_CRC_SIZE + size
+         + nbBlocks * (HFM_BLOCK_HEADER_SIZE + HFM_INDEX_ENTRY_SIZE + HFM_INDEX_CRC_SIZE);
+}
+
+/**
+ * @see @file codec.h / @function codecCompress
+ */
+int codecCompress(csc scratch, const unsigned char *data, size_t size, const size_t *key, unsigned int checksums, unsigned char *out, size_t capacity, size_t *outSize) {
+  if((data == NULL && size > 0) || (out == NULL && capacity > 0)) return HFM_ERROR_ARGUMENT;
+  struct iovec in = { (void*)data, size };
+  struct iovec output = { out, capacity };
+  return codecCompressVector(scratch, &in, 1, key, checksums, &output, 1, outSize);
+}
+
+/**
+ * @see @file codec.h / @function codecDecompressedSize
+ */
+int codecDecompressedSize(const unsigned char *data, size_t size, size_t *originalSize) {
+  struct codecHeader header;
+  if(data == NULL || originalSize == NULL) return HFM_ERROR_ARGUMENT;
+  int result = readCodecHeader(data, size, &header, NULL);
+  if(result == HFM_OK) *originalSize = (size_t)header.originalSize;
+  return result;
+}
+
+/**
+ * @see @file codec.h / @function codecDecompress
+ */
+int codecDecompress(csc scratch, const unsigned char *data, size_t size, const size_t *key, unsigned char *out, size_t capacity, size_t *outSize) {
+  if(data == NULL || (out == NULL && capacity > 0)) return HFM_ERROR_ARGUMENT;
+  struct iovec in = { (void*)data, size };
+  struct iovec output = { out, capacity };
+  return codecDecompressVector(scratch, &in, 1, key, &output, 1, outSize);
+}
+
+/**
+ * @see @file codec.h / @function codecCompressVector
+ */
+int codecCompressVector(csc scratch, const struct iovec *in, int inCount, const size_t *key, unsigned int checksums, const struct iovec *out, int outCount, size_t *outSize) {
+  size_t size = codecVectorSize(in, inCount), capacity = codecVectorSize(out, outCount);
+  if(size == SIZE_MAX || capacity == SIZE_MAX || outSize == NULL) return HFM_ERROR_ARGUMENT;
+  csc owned = NULL;
+  if(scratch == NULL && (scratch = owned = createCodecScratch()) == NULL) return HFM_ERROR_MEMORY;
+  checksums &= HFM_CONTAINER_CHECKSUMS;
+  struct codecTables *tables = &scratch->base;
+  size_t *histogram = scratch->histogram;
+  size_t nbBlocks = (size + HFM_BLOCK_SIZE - 1) / HFM_BLOCK_SIZE;
+  if(key == NULL) {
+    for (size_t c = 0; c < 256; c++) histogram[c] = 0;
+    for (int f = 0; f < inCount; f++) {
+      const unsigned char *fragment = (const unsigned char*)in[f].iov_base;
+      for (size_t i = 0; i < in[f].iov_len; i++) histogram[fragment[i]]++;
+    }
+  }
+  chooseCodecTables(tables, histogram, size, key);
+
+  size_t entrySize = HFM_INDEX_ENTRY_SIZE + ((checksums & HFM_CONTAINER_BLOCK_CRC) ? HFM_INDEX_CRC_SIZE : 0);
+  size_t indexSize = nbBlocks * entrySize + ((checksums & HFM_CONTAINER_STREAM_CRC) ? HFM_INDEX_CRC_SIZE : 0);
+  // The index waits at the end of the output: the blocks can't reach it
+  size_t limit = (capacity >= indexSize) ? capacity - indexSize : 0;
+  unsigned char head[HFM_CODEC_HEAD_SIZE];
+  size_t position = 0;
+  // A file stored has no table: it needs no key either
+  unsigned int flags = checksums | ((key == NULL && tables->nbLeaves > 0) ? HFM_CONTAINER_TABLE : 0);
+  putCodecHeader(head, HFM_CODEC_HEAD_SIZE, &position, size, nbBlocks, flags, histogram);
+  int fits = capacity >= indexSize && position <= limit;
+  struct codecCursor reader, writer, index;
+  initCodecCursor(&reader, in, inCount, 0);
+  initCodecCursor(&writer, out, outCount, 0);
+  initCodecCursor(&index, out, outCount, fits ? limit : 0);
+  if(fits) putCodecCursor(&writer, head, position);
+  uint32_t checksum = 0;
+  for (size_t i = 0; i < nbBlocks; i++) {
+    size_t length = (size - i * HFM_BLOCK_SIZE < HFM_BLOCK_SIZE) ? size - i * HFM_BLOCK_SIZE : HFM_BLOCK_SIZE;
+    // The occurrences and the checksum of the block, then its coding from its start
+    struct codecCursor block = reader;
+    uint32_t blockChecksum = 0;
+    for (size_t c = 0; c < 256; c++) histogram[c] = 0;
+    for (size_t left = length; left > 0; ) {
+      size_t available;
+      const unsigned char *piece = spanCodecCursor(&reader, &available);
+      if(available > left) available = left;
+      for (size_t j = 0; j < available; j++) histogram[piece[j]]++;
+      if(checksums & HFM_CONTAINER_BLOCK_CRC) blockChecksum = crc32c(blockChecksum, piece, available);
+      if(checksums & HFM_CONTAINER_STREAM_CRC) checksum = crc32c(checksum, piece, available);
+      skipCodecCursor(&reader, available);
+      left -= available;
+    }
+    size_t payloadSize = codecCodedSize(tables, histogram);
+    if(payloadSize >= length) payloadSize = length;
+    fits = fits && position + HFM_BLOCK_HEADER_SIZE + payloadSize <= limit;
+    if(fits) {
+      unsigned char blockHeader[HFM_BLOCK_HEADER_SIZE];
+      blockHeader[0] = (payloadSize == length) ? HFM_BLOCK_STORED : HFM_BLOCK_HUFFMAN;
+      storeLittleEndian(blockHeader + 1, payloadSize, 4);
+      storeLittleEndian(blockHeader + 5, length, 4);
+      putCodecCursor(&writer, blockHeader, HFM_BLOCK_HEADER_SIZE);
+      if(payloadSize == length) copyCodecCursor(&writer, &block, length);
+      else encodeCodecCursor(tables, &block, length, &writer, payloadSize);
+      unsigned char entry[HFM_INDEX_ENTRY_SIZE + HFM_INDEX_CRC_SIZE];
+      storeLittleEndian(entry, HFM_BLOCK_HEADER_SIZE + payloadSize, 4);
+      storeLittleEndian(entry + 4, length, 4);
+      storeLittleEndian(entry + 8, blockChecksum, 4);
+      putCodecCursor(&index, entry, entrySize);
+    }
+    position += HFM_BLOCK_HEADER_SIZE + payloadSize;
+  }
+  *outSize = position + indexSize;
+  if(fits) {
+    unsigned char word[8];
+    storeLittleEndian(word, checksum, 4);
+    if(checksums & HFM_CONTAINER_STREAM_CRC) putCodecCursor(&index, word, HFM_INDEX_CRC_SIZE);
+    initCodecCursor(&index, out, outCount, limit);
+    copyCodecCursor(&writer, &index, indexSize);
+    storeLittleEndian(word, position, 8);
+    initCodecCursor(&writer, out, outCount, 24);
+    putCodecCursor(&writer, word, 8);
+  }
+  destroyCodecScratch(&owned);
+  return fits ? HFM_OK : HFM_ERROR_OVERFLOW;
+}
+
+/**
+ * @see @file codec.h / @function codecDecompressVector
+ */
+int codecDecompressVector(csc scratch, const struct iovec *in, int inCount, const size_t *key, const struct iovec *out, int outCount, size_t *outSize) {
+  size_t size = codecVectorSize(in, inCount), capacity = codecVectorSize(out, outCount);
+  if(size == SIZE_MAX || capacity == SIZE_MAX || outSize == NULL) return HFM_ERROR_ARGUMENT;
+  csc owned = NULL;
+  if(scratch == NULL && (scratch = owned = createCodecScratch()) == NULL) return HFM_ERROR_MEMORY;
+  struct codecHeader header;
+  int result = openCodecFile(in, inCount, size, key, capacity, outSize, &header, scratch->histogram);
+  if(result != HFM_OK) {
+    destroyCodecScratch(&owned);
+    return result;
+  }
+
+  buildCodecTables((header.flags & HFM_CONTAINER_TABLE || key == NULL) ? scratch->histogram : key, &scratch->base);
+  const struct codecTables *tables = &scratch->base;
+  size_t entrySize = HFM_INDEX_ENTRY_SIZE + ((header.flags & HFM_CONTAINER_BLOCK_CRC) ? HFM_INDEX_CRC_SIZE : 0);
+  struct codecCursor index, reader, writer;
+  initCodecCursor(&index, in, inCount, (size_t)header.indexOffset);
+  initCodecCursor(&reader, in, inCount, header.firstBlockOffset);
+  initCodecCursor(&writer, out, outCount, 0);
+  uint32_t checksum = 0;
+  for (uint64_t i = 0; result == HFM_OK && i < header.nbBlocks; i++) {
+    unsigned char entry[HFM_INDEX_ENTRY_SIZE + HFM_INDEX_CRC_SIZE];
+    getCodecCursor(&index, entry, entrySize);
+    size_t storedSize = (size_t)loadLittleEndian(entry, 4);
+    size_t length = (size_t)loadLittleEndian(entry + 4, 4);
+    unsigned char blockHeader[HFM_BLOCK_HEADER_SIZE];
+    getCodecCursor(&reader, blockHeader, HFM_BLOCK_HEADER_SIZE);
+    if((result = checkCodecBlock(blockHeader, storedSize, length)) != HFM_OK) break;
+    size_t payloadSize = storedSize - HFM_BLOCK_HEADER_SIZE;
+    struct codecCursor payload = reader;
+    skipCodecCursor(&reader, payloadSize);
+    if(length == 0 && payloadSize > 0) { // Table block
+      unsigned char table[HFM_CODEC_HEAD_SIZE];
+      if(payloadSize > HFM_CODEC_HEAD_SIZE) {
+        result = HFM_ERROR_CORRUPTED;
+        continue;
+      }
+      getCodecCursor(&payload, table, payloadSize);
+      if(table[0] == HFM_TABLE_KEY) {
+        tables = &scratch->base;
+        if(payloadSize != 1) result = HFM_ERROR_CORRUPTED;
+      } else if(table[0] == HFM_TABLE_HISTOGRAM) {
+        size_t position = 1;
+        for (size_t c = 0; result == HFM_OK && c < 256; c++)
+          if(readCodecVarint(table, payloadSize, &position, &scratch->blockHistogram[c]) != 0) result = HFM_ERROR_CORRUPTED;
+        if(result == HFM_OK && position != payloadSize) result = HFM_ERROR_CORRUPTED;
+        if(result == HFM_OK) {
+          buildCodecTables(scratch->blockHistogram, &scratch->block);
+          // An empty table gives the table of the header back, as with a tree NULL
+          tables = (scratch->block.nbLeaves > 0) ? &scratch->block : &scratch->base;
+        }
+      } else {
+        result = HFM_ERROR_CORRUPTED;
+      }
+      continue;
+    }
+    struct codecCursor written = writer;
+    result = decodeCodecCursor(tables, blockHeader[0], &payload, payloadSize, &writer, length);
+    uint32_t blockChecksum = 0;
+    for (size_t left = (header.flags & HFM_CONTAINER_CHECKSUMS) ? length : 0; left > 0; ) {
+      size_t available;
+      const unsigned char *piece = spanCodecCursor(&written, &available);
+      if(available > left) available = left;
+      if(header.flags & HFM_CONTAINER_BLOCK_CRC) blockChecksum = crc32c(blockChecksum, piece, available);
+      if(header.flags & HFM_CONTAINER_STREAM_CRC) checksum = crc32c(checksum, piece, available);
+      skipCodecCursor(&written, available);
+      left -= available;
+    }
+    if(result == HFM_OK && (header.flags & HFM_CONTAINER_BLOCK_CRC) && blockChecksum != (uint32_t)loadLittleEndian(entry + 8, 4))
+      result = HFM_ERROR_CHECKSUM;
+  }
+  if(result == HFM_OK && (header.flags & HFM_CONTAINER_STREAM_CRC)) {
+    unsigned char word[HFM_INDEX_CRC_SIZE];
+    getCodecCursor(&index, word, HFM_INDEX_CRC_SIZE);
+    if(checksum != (uint32_t)loadLittleEndian(word, 4)) result = HFM_ERROR_CHECKSUM;
+  }
+  destroyCodecScratch(&owned);
+  return result;
+}
+
+/**
+ * @see @file codec.h / @function codecCompressParallel
+ */
+int codecCompressParallel(struct scheduler *scheduler, csc scratch, const unsigned char *data, size_t size, const size_t *key, unsigned int checksums, unsigned char *out, size_t capacity, size_t *outSize) {
+  size_t nbBlocks = (size + HFM_BLOCK_SIZE - 1) / HFM_BLOCK_SIZE;
+  if(scheduler == NULL || nbBlocks < HFM_CODEC_PARALLEL_BLOCKS)
+    return codecCompress(scratch, data, size, key, checksums, out, capacity, outSize);
+  if(data == NULL || (out == NULL && capacity > 0) || outSize == NULL) return HFM_ERROR_ARGUMENT;
+  checksums &= HFM_CONTAINER_CHECKSUMS;
+  size_t nbTasks = (size_t)getSchedulerSize(scheduler) * HFM_CODEC_TASKS_PER_WORKER;
+  if(nbTasks > nbBlocks) nbTasks = nbBlocks;
+  csc shared = createCodecScratch();
+  size_t *offsets = (size_t*)malloc((nbBlocks + 1) * sizeof(size_t));
+  uint32_t *blockChecksums = (uint32_t*)malloc(nbBlocks * sizeof(uint32_t));
+  struct codecTask *tasks = (struct codecTask*)malloc(nbTasks * sizeof(struct codecTask));
+  int result = (shared != NULL && offsets != NULL && blockChecksums != NULL && tasks != NULL) ? HFM_OK : HFM_ERROR_MEMORY;
+  struct codecJob job;
+  memset(&job, 0, sizeof(struct codecJob));
+  if(result == HFM_OK) {
+    job.tables = &shared->base;
+    job.data = data;
+    job.size = size;
+    job.out = out;
+    job.histogram = shared->histogram;
+    job.offsets = offsets;
+    job.checksums = blockChecksums;
+    job.entrySize = HFM_INDEX_ENTRY_SIZE + ((checksums & HFM_CONTAINER_BLOCK_CRC) ? HFM_INDEX_CRC_SIZE : 0);
+    size_t perTask = (nbBlocks + nbTasks - 1) / nbTasks;
+    for (size_t i = 0; i < nbTasks; i++) {
+      tasks[i].job = &job;
+      tasks[i].first = (i * perTask < nbBlocks) ? i * perTask : nbBlocks;
+      tasks[i].last = ((i + 1) * perTask < nbBlocks) ? (i + 1) * perTask : nbBlocks;
+    }
+    for (size_t c = 0; c < 256; c++) shared->histogram[c] = 0;
+    if(key == NULL) runCodecTasks(scheduler, countCodecTask, tasks, nbTasks, shared);
+    chooseCodecTables(&shared->base, shared->histogram, size, key);
+    job.flags = checksums | ((key == NULL && shared->base.nbLeaves > 0) ? HFM_CONTAINER_TABLE : 0);
+    runCodecTasks(scheduler, planCodecTask, tasks, nbTasks, shared);
+    // Each block follows the one before: the sizes give the offsets
+    offsets[0] = 0;
+    putCodecHeader(NULL, 0, &offsets[0], size, nbBlocks, job.flags, shared->histogram);
+    for (size_t i = 0; i < nbBlocks; i++) offsets[i + 1] += offsets[i];
+    size_t indexSize = nbBlocks * job.entrySize + ((checksums & HFM_CONTAINER_STREAM_CRC) ? HFM_INDEX_CRC_SIZE : 0);
+    *outSize = offsets[nbBlocks] + indexSize;
+    if(*outSize > capacity) result = HFM_ERROR_OVERFLOW;
+  }
+  if(result == HFM_OK) {
+    size_t position = 0;
+    putCodecHeader(out, capacity, &position, size, nbBlocks, job.flags, shared->histogram);
+    storeLittleEndian(out + 24, offsets[nbBlocks], 8);
+    job.index = out + offsets[nbBlocks];
+    runCodecTasks(scheduler, encodeCodecTask, tasks, nbTasks, shared);
+    if(checksums & HFM_CONTAINER_STREAM_CRC) {
+      uint32_t checksum = 0;
+      for (size_t i = 0; i < nbBlocks; i++)
+        checksum = crc32cCombine(checksum, blockChecksums[i], (i + 1 < nbBlocks) ? HFM_BLOCK_SIZE : (long long)(size - i * HFM_BLOCK_SIZE));
+      storeLittleEndian(job.index + nbBlocks * job.entrySize, checksum, 4);
+    }
+  }
+  destroyCodecScratch(&shared);
+  free(offsets);
+  free(blockChecksums);
+  free(tasks);
+  return result;
+}
+
+/**
+ * @see @file codec.h / @function codecDecompressParallel
+ */
+int codecDecompressParallel(struct scheduler *scheduler, csc scratch, const unsigned char *data, size_t size, const size_t *key, unsigned char *out, size_t capacity, size_t *outSize) {
+  if(scheduler == NULL) return codecDecompress(scratch, data, size, key, out, capacity, outSize);
+  if(data == NULL || (out == NULL && capacity > 0) || outSize == NULL) return HFM_ERROR_ARGUMENT;
+  csc shared = createCodecScratch();
+  if(shared == NULL) return HFM_ERROR_MEMORY;
+  struct codecHeader header;
+  struct iovec in = { (void*)data, size };
+  int result = openCodecFile(&in, 1, size, key, capacity, outSize, &header, shared->histogram);
+  size_t nbBlocks = (size_t)header.nbBlocks;
+  size_t entrySize = HFM_INDEX_ENTRY_SIZE + ((header.flags & HFM_CONTAINER_BLOCK_CRC) ? HFM_INDEX_CRC_SIZE : 0);
+  // The table blocks change the tables of the blocks after them: such a file is decoded in order
+  int sequential = result != HFM_OK || nbBlocks < HFM_CODEC_PARALLEL_BLOCKS;
+  for (size_t i = 0; !sequential && i < nbBlocks; i++) {
+    unsigned char *entry = (unsigned char*)data + header.indexOffset + i * entrySize;
+    sequential = loadLittleEndian(entry + 4, 4) == 0 && loadLittleEndian(entry, 4) > HFM_BLOCK_HEADER_SIZE;
+  }
+  if(sequential) {
+    destroyCodecScratch(&shared);
+    return (result == HFM_OK) ? codecDecompress(scratch, data, size, key, out, capacity, outSize) : result;
+  }
+  size_t nbTasks = (size_t)getSchedulerSize(scheduler) * HFM_CODEC_TASKS_PER_WORKER;
+  if(nbTasks > nbBlocks) nbTasks = nbBlocks;
+  size_t *offsets = (size_t*)malloc(2 * nbBlocks * sizeof(size_t));
+  uint32_t *blockChecksums = (uint32_t*)malloc(nbBlocks * sizeof(uint32_t));
+  struct codecTask *tasks = (struct codecTask*)malloc(nbTasks * sizeof(struct codecTask));
+  if(offsets == NULL || blockChecksums == NULL || tasks == NULL) result = HFM_ERROR_MEMORY;
+  if(result == HFM_OK) {
+    buildCodecTables((header.flags & HFM_CONTAINER_TABLE || key == NULL) ? shared->histogram : key, &shared->base);
+    struct codecJob job;
+    memset(&job, 0, sizeof(struct codecJob));
+    job.tables = &shared->base;
+    job.data = data;
+    job.size = size;
+    job.out = out;
+    job.offsets = offsets;
+    job.positions = offsets + nbBlocks;
+    job.checksums = blockChecksums;
+    job.flags = header.flags;
+    job.entrySize = entrySize;
+    job.index = (unsigned char*)data + header.indexOffset;
+    job.error = UINT64_MAX;
+    size_t offset = header.firstBlockOffset, position = 0;
+    for (size_t i = 0; i < nbBlocks; i++) {
+      job.offsets[i] = offset;
+      job.positions[i] = position;
+      offset += (size_t)loadLittleEndian(job.index + i * entrySize, 4);
+      position += (size_t)loadLittleEndian(job.index + i * entrySize + 4, 4);
+    }
+    size_t perTask = (nbBlocks + nbTasks - 1) / nbTasks;
+    for (size_t i = 0; i < nbTasks; i++) {
+      tasks[i].job = &job;
+      tasks[i].first = (i * perTask < nbBlocks) ? i * perTask : nbBlocks;
+      tasks[i].last = ((i + 1) * perTask < nbBlocks) ? (i + 1) * perTask : nbBlocks;
+    }
+    runCodecTasks(scheduler, decodeCodecTask, tasks, nbTasks, shared);
+    if(job.error != UINT64_MAX) result = -(int)(job.error & 0xFF);
+    if(result == HFM_OK && (header.flags & HFM_CONTAINER_STREAM_CRC)) {
+      uint32_t checksum = 0;
+      for (size_t i = 0; i < nbBlocks; i++)
+        checksum = crc32cCombine(checksum, blockChecksums[i], (long long)loadLittleEndian(job.index + i * entrySize + 4, 4));
+      if(checksum != (uint32_t)loadLittleEndian(job.index + nbBlocks * entrySize, 4)) result = HFM_ERROR_CHECKSUM;
+    }
+  }
+  destroyCodecScratch(&shared);
+  free(offsets);
+  free(blockChecksums);
+  free(tasks);
+  return result;
+}
+
+
+/**
+ * @see @file codec.h / @function codecMessageBound
+ */
+size_t codecMessageBound(size_t size) {
+  return HFM_CODEC_MAX_VARINT + size;
+}
+
+/**
+ * @see @file codec.h / @function codecCompressMessage
+ */
+int codecCompressMessage(cct context, const unsigned char *data, size_t size, unsigned char *out, size_t capacity, size_t *outSize) {
+  if(context == NULL || (data == NULL && size > 0) || (out == NULL && capacity > 0) || outSize == NULL || size > SIZE_MAX / 8)
+    return HFM_ERROR_ARGUMENT;
+  // The exact size first, from the costs: nothing is written if it doesn't fit
+  uint64_t bits = codecCostOf(context, data, size);
+  int coded = bits < HFM_CODEC_NO_PREFIX && (bits + 7) / 8 < size;
+  size_t payloadSize = coded ? (size_t)((bits + 7) / 8) : size;
+  size_t position = 0;
+  putCodecVarint(NULL, 0, &position, size * 2 + (size_t)coded);
+  *outSize = position + payloadSize;
+  if(*outSize > capacity) return HFM_ERROR_OVERFLOW;
+  position = 0;
+  putCodecVarint(out, capacity, &position, size * 2 + (size_t)coded);
+  if(coded) encodeCodecBlock(&context->tables, data, size, out + position);
+  else if(size > 0) memcpy(out + position, data, size);
+  return HFM_OK;
+}
+
+/**
+ * @see @file codec.h / @function codecDecompressMessage
+ */
+int codecDecompressMessage(cct context, const unsigned char *data, size_t size, unsigned char *out, size_t capacity, size_t *outSize) {
+  if(context == NULL || data == NULL || (out == NULL && capacity > 0) || outSize == NULL) return HFM_ERROR_ARGUMENT;
+  size_t position = 0, value;
+  if(readCodecVarint(data, size, &position, &value) != 0) return HFM_ERROR_CORRUPTED;
+  size_t length = value / 2, payloadSize = size - position;
+  if(!(value & 1) && payloadSize != length) return HFM_ERROR_CORRUPTED;
+  *outSize = length;
+  if(length > capacity) return HFM_ERROR_OVERFLOW;
+  if(value & 1) return decodeCodecBlock(&context->tables, data + position, payloadSize, out, length);
+  if(length > 0) memcpy(out, data + position, length);
+  return HFM_OK;
+}
+
+/**
+ * @see @file codec.h / @function codecStreamBound
+ */
+size_t codecStreamBound(cst stream, size_t size) {
+  if(size > SIZE_MAX / 256) return SIZE_MAX;
+  return (stream->nbPending + size * stream->context->maxLength) / 8 + 1;
+}
+
+/**
+ * @see @file codec.h / @function codecEncodeStream
+ */
+int codecEncodeStream(cst stream, const unsigned char *data, size_t size, unsigned char *out, size_t capacity, size_t *outSize) {
+  if(stream == NULL || (data == NULL && size > 0) || (out == NULL && capacity > 0) || outSize == NULL) return HFM_ERROR_ARGUMENT;
+  uint64_t bits = codecCostOf(stream->context, data, size);
+  if(bits >= HFM_CODEC_NO_PREFIX) return HFM_ERROR_ARGUMENT;
+  *outSize = (size_t)((stream->nbPending + bits) / 8);
+  if(*outSize > capacity) return HFM_ERROR_OVERFLOW;
+  struct codecBits state = { stream->pending, stream->nbPending };
+  encodeCodecBits(&stream->context->tables, data, size, &state, out);
+  stream->pending = (uint8_t)(state.bits & ((1u << state.nbPending) - 1));
+  stream->nbPending = (uint8_t)state.nbPending;
+  return HFM_OK;
+}
+
+/**
+ * @see @file codec.h / @function codecFlushStream
+ */
+int codecFlushStream(cst stream, unsigned char *out, size_t capacity, size_t *outSize) {
+  if(stream == NULL || (out == NULL && capacity > 0) || outSize == NULL) return HFM_ERROR_ARGUMENT;
+  *outSize = (stream->nbPending > 0) ? 1 : 0;
+  if(*outSize > capacity) return HFM_ERROR_OVERFLOW;
+  if(stream->nbPending > 0) out[0] = (unsigned char)(stream->pending << (8 - stream->nbPending));
+  stream->pending = 0;
+  stream->nbPending = 0;
+  return HFM_OK;
+}
+
+/**
+ * @see @file codec.h / @function codecDecodeStream
+ */
+int codecDecodeStream(cst stream, const unsigned char *data, size_t size, size_t *used, unsigned char *out, size_t capacity, size_t *outSize) {
+  if(stream == NULL || (data == NULL && size > 0) || used == NULL || (out == NULL && capacity > 0) || outSize == NULL)
+    return HFM_ERROR_ARGUMENT;
+  const struct codecTables *tables = &stream->context->tables;
+  *used = 0;
+  *outSize = 0;
+  if(capacity == 0) return HFM_OK;
+  if(tables->nbLeaves == 0) return HFM_ERROR_CORRUPTED;
+  if(tables->root < 0) { // A single byte has an empty prefix: no bit is consumed
+    memset(out, -tables->root - 1, capacity);
+    *outSize = capacity;
+    return HFM_OK;
+  }
+  int16_t node = stream->node;
+  size_t written = 0, consumed = 0;
+  while(written < capacity && (stream->nbBits > 0 || consumed < size)) {
+    // The whole bytes go at once while they can't fill the output
+    size_t nbBytes = (size - consumed < (capacity - written) / 8) ? size - consumed : (capacity - written) / 8;
+    if(stream->nbBits == 0 && nbBytes > 0) {
+      written += codecDecodeTree(tables->nodes, tables->root, data + consumed, nbBytes, &node, out + written, capacity - written);
+      consumed += nbBytes;
+      continue;
+    }
+    // One bit at a time otherwise, the byte kept by the stream
+    if(stream->nbBits == 0) {
+      stream->byte = data[consumed++];
+      stream->nbBits = 8;
+    }
+    stream->nbBits--;
+    node = tables->nodes[node][(stream->byte >> stream->nbBits) & 1];
+    if(node < 0) {
+      out[written++] = (unsigned char)(-node - 1);
+      node = tables->root;
+    }
+  }
+  stream->node = node;
+  *used = consumed;
+  *outSize = written;
+  return HFM_OK;
+}
+
+/**
+ * @see @file codec.h / @function codecAlignStream
+ */
+void codecAlignStream(cst stream) {
+  stream->node = stream->context->tables.root;
+  stream->nbBits = 0;
+}
+
+/**
+ * @see @file codec.h / @function codecDecodeTree
+ */
+size_t codecDecodeTree(const int16_t (*nodes)[2], int16_t root, const unsigned char *payload, size_t size, int16_t *node, unsigned char *out, size_t length) {
+  int16_t current = *node;
+  size_t outIndex = 0;
+  for (size_t i = 0; i < size; i++) {
+    unsigned int byte = payload[i];
+    // The 8 bits of a byte, unrolled by the compiler
+    for (int j = 7; j >= 0; j--) {
+      current = nodes[current][(byte >> j) & 1];
+      if(current < 0) {
+        out[outIndex++] = (unsigned char)(-current - 1);
+        current = root;
+        if(outIndex == length) {
+          *node = current;
+          return outIndex;
+        }
+      }
+    }
+  }
+  *node = current;
+  return outIndex;
+}
+
+/**
+ * @see @file codec.h / @function codecDecodeTreeBlock
+ */
+size_t codecDecodeTreeBlock(const int16_t (*nodes)[2], int16_t root, const unsigned char *payload, size_t size, unsigned char *out, size_t length) {
+  if(length == 0) return 0;
+  if(root < 0) { // A single byte has an empty prefix
+    memset(out, -root - 1, length);
+    return length;
+  }
+  int16_t node = root;
+  // A payload too short leaves bytes not decoded
+  return (codecDecodeTree(nodes, root, payload, size, &node, out, length) == length) ? length : SIZE_MAX;
+}
+
+
+/* ================================================== */
+/* ===================== PRIVATE ==================== */
+/* ========================================================================== */
+
+
+/**
+ * @see @file codec.c / @function buildCodecTables
+ */
+void buildCodecTables(const size_t *histogram, struct codecTables *tables) {
+  int16_t items[256];
+  size_t weights[256];
+  size_t nbItems = 0;
+  for (size_t c = 0; c < 256; c++) {
+    tables->hasCode[c] = 0;
+    tables->lengths[c] = 0;
+    if(histogram[c] > 0) {
+      items[nbItems] = (int16_t)(-(int)c - 1);
+      weights[nbItems++] = histogram[c];
+    }
+  }
+  tables->nbLeaves = (unsigned int)nbItems;
+  tables->root = 0;
+  if(nbItems == 0) return;
+  int16_t nbNodes = 0;
+  while(nbItems > 1) { // As mergeTwoSmallerNodes
+    size_t j = 0, k = 1;
+    size_t valueJ = weights[0], valueK = weights[1];
+    for (size_t i = 2; i < nbItems; i++) {
+      if(k < j) {
+        if(weights[i] < valueK) {
+          k = i;
+          valueK = weights[i];
+        }
+      } else if(weights[i] < valueJ) {
+        j = i;
+        valueJ = weights[i];
+      }
+    }
+    if(j < k) k--;
+    int16_t child1 = items[j], child2;
+    size_t weight1 = weights[j], weight2;
+    memmove(items + j, items + j + 1, (nbItems - j - 1) * sizeof(int16_t));
+    memmove(weights + j, weights + j + 1, (nbItems - j - 1) * sizeof(size_t));
+    nbItems--;
+    child2 = items[k];
+    weight2 = weights[k];
+    memmove(items + k, items + k + 1, (nbItems - k - 1) * sizeof(int16_t));
+    memmove(weights + k, weights + k + 1, (nbItems - k - 1) * sizeof(size_t));
+    nbItems--;
+    // As mergeNodes: the lighter child on the left
+    tables->nodes[nbNodes][0] = (weight1 <= weight2) ? child1 : child2;
+    tables->nodes[nbNodes][1] = (weight1 <= weight2) ? child2 : child1;
+    items[nbItems] = nbNodes++;
+    weights[nbItems++] = weight1 + weight2;
+  }
+  tables->root = items[0];
+  uint64_t prefix[4] = { 0, 0, 0, 0 };
+  assignCodecPrefixes(tables, tables->root, 0, prefix);
+}
+
+/**
+ * @see @file codec.c / @function assignCodecPrefixes
+ */
+void assignCodecPrefixes(struct codecTables *tables, int16_t node, unsigned int depth, uint64_t *prefix) {
+  if(node < 0) {
+    unsigned char c = (unsigned char)(-node - 1);
+    tables->hasCode[c] = 1;
+    tables->lengths[c] = (uint16_t)depth;
+    memcpy(tables->prefixes[c], prefix, 4 * sizeof(uint64_t));
+    return;
+  }
+  uint64_t bit = (uint64_t)1 << (63 - depth % 64);
+  assignCodecPrefixes(tables, tables->nodes[node][0], depth + 1, prefix);
+  prefix[depth / 64] |= bit;
+  assignCodecPrefixes(tables, tables->nodes[node][1], depth + 1, prefix);
+  prefix[depth / 64] &= ~bit;
+}
+
+/**
+ * @see @file codec.c / @function chooseCodecTables
+ */
+void chooseCodecTables(struct codecTables *tables, size_t *histogram, size_t size, const size_t *key) {
+  if(key != NULL) {
+    buildCodecTables(key, tables);
+    return;
+  }
+  buildCodecTables(histogram, tables);
+  // As isCodingWorthIt: each block may lose a byte to the padding
+  size_t tableSize = 0;
+  for (size_t c = 0; c < 256; c++) {
+    size_t value = histogram[c];
+    do {
+      tableSize++;
+      value >>= 7;
+    } while(value > 0);
+  }
+  size_t codedSize = (size > 0 && tables->nbLeaves > 0) ? codecCodedSize(tables, histogram) : SIZE_MAX;
+  if(codedSize == SIZE_MAX || codedSize + size / HFM_BLOCK_SIZE + 1 + tableSize >= size) {
+    for (size_t c = 0; c < 256; c++) histogram[c] = 0; // Every block is stored: the table is empty
+    buildCodecTables(histogram, tables);
+  }
+}
+
+/**
+ * @see @file codec.c / @function codecCodedSize
+ */
+size_t codecCodedSize(const struct codecTables *tables, const size_t *histogram) {
+  size_t bits = 0;
+  for (size_t c = 0; c < 256; c++) {
+    if(histogram[c] > 0) {
+      if(!tables->hasCode[c]) return SIZE_MAX;
+      bits += histogram[c] * tables->lengths[c];
+    }
+  }
+  return (bits + 7) / 8;
+}
+
+/**
+ * @see @file codec.c / @function encodeCodecBits
+ */
+size_t encodeCodecBits(const struct codecTables *tables, const unsigned char *data, size_t size, struct codecBits *state, unsigned char *out) {
+  uint64_t bits = state->bits; // Bits not written yet, in the lowest bits
+  unsigned int nbPending = state->nbPending;
+  size_t outIndex = 0;
+  for (size_t i = 0; i < size; i++) {
+    unsigned int length = tables->lengths[data[i]];
+    const uint64_t *prefix = tables->prefixes[data[i]];
+    // The prefix goes 32 bits at most at a time, so that 7 pending bits fit too
+    for (unsigned int done = 0; done < length; ) {
+      unsigned int step = (length - done < 32) ? length - done : 32;
+      uint64_t word = prefix[done / 64] << (done % 64);
+      bits = (bits << step) | (word >> (64 - step));
+      nbPending += step;
+      done += step;
+      while(nbPending >= 8) {
+        nbPending -= 8;
+        out[outIndex++] = (unsigned char)(bits >> nbPending);
+      }
+    }
+  }
+  state->bits = bits;
+  state->nbPending = nbPending;
+  return outIndex;
+}
+
+/**
+ * @see @file codec.c / @function encodeCodecBlock
+ */
+size_t encodeCodecBlock(const struct codecTables *tables, const unsigned char *block, size_t size, unsigned char *out) {
+  struct codecBits state = { 0, 0 };
+  size_t outIndex = encodeCodecBits(tables, block, size, &state, out);
+  if(state.nbPending > 0) out[outIndex++] = (unsigned char)(state.bits << (8 - state.nbPending));
+  return outIndex;
+}
+
+/**
+ * @see @file codec.c / @function encodeCodecCursor
+ */
+void encodeCodecCursor(const struct codecTables *tables, struct codecCursor *in, size_t length, struct codecCursor *out, size_t payloadSize) {
+  size_t inAvailable, outAvailable;
+  const unsigned char *data = spanCodecCursor(in, &inAvailable);
+  unsigned char *payload = spanCodecCursor(out, &outAvailable);
+  if(inAvailable >= length && outAvailable >= payloadSize) {
+    encodeCodecBlock(tables, data, length, payload);
+    skipCodecCursor(in, length);
+    skipCodecCursor(out, payloadSize);
+    return;
+  }
+  unsigned char buffer[HFM_CODEC_CHUNK * 32 + 1];
+  struct codecBits state = { 0, 0 };
+  while(length > 0) {
+    data = spanCodecCursor(in, &inAvailable);
+    size_t size = (inAvailable < length) ? inAvailable : length;
+    if(size == 0) break;
+    if(size > HFM_CODEC_CHUNK) size = HFM_CODEC_CHUNK;
+    putCodecCursor(out, buffer, encodeCodecBits(tables, data, size, &state, buffer));
+    skipCodecCursor(in, size);
+    length -= size;
+  }
+  if(state.nbPending > 0) {
+    buffer[0] = (unsigned char)(state.bits << (8 - state.nbPending));
+    putCodecCursor(out, buffer, 1);
+  }
+}
+
+/**
+ * @see @file codec.c / @function decodeCodecBlock
+ */
+int decodeCodecBlock(const struct codecTables *tables, const unsigned char *payload, size_t size, unsigned char *out, size_t length) {
+  if(length == 0) return HFM_OK;
+  if(tables->nbLeaves == 0) return HFM_ERROR_CORRUPTED;
+  return (codecDecodeTreeBlock(tables->nodes, tables->root, payload, size, out, length) == length) ? HFM_OK : HFM_ERROR_CORRUPTED;
+}
+
+/**
+ * @see @file codec.c / @function decodeCodecCursor
+ */
+int decodeCodecCursor(const struct codecTables *tables, unsigned char type, struct codecCursor *payload, size_t payloadSize, struct codecCursor *out, size_t length) {
+  size_t inAvailable, outAvailable;
+  const unsigned char *data = spanCodecCursor(payload, &inAvailable);
+  unsigned char *block = spanCodecCursor(out, &outAvailable);
+  if(inAvailable >= payloadSize && outAvailable >= length) {
+    skipCodecCursor(out, length);
+    return decodeCodecDataBlock(tables, type, data, payloadSize, block, length);
+  }
+  if(type == HFM_BLOCK_STORED && payloadSize == length) {
+    copyCodecCursor(out, payload, length);
+    return HFM_OK;
+  }
+  if(type != HFM_BLOCK_HUFFMAN || (length > 0 && tables->nbLeaves == 0)) return HFM_ERROR_CORRUPTED;
+  // A payload byte gives 8 bytes at most
+  unsigned char buffer[HFM_CODEC_CHUNK * 8];
+  if(tables->root < 0) memset(buffer, -tables->root - 1, sizeof(buffer));
+  int16_t node = tables->root;
+  size_t done = 0;
+  while(done < length && (tables->root < 0 || payloadSize > 0)) {
+    size_t size = 0, decoded;
+    if(tables->root < 0) { // A single byte has an empty prefix
+      decoded = (length - done < sizeof(buffer)) ? length - done : sizeof(buffer);
+    } else {
+      data = spanCodecCursor(payload, &inAvailable);
+      size = (inAvailable < payloadSize) ? inAvailable : payloadSize;
+      if(size == 0) break;
+      if(size > HFM_CODEC_CHUNK) size = HFM_CODEC_CHUNK;
+      decoded = codecDecodeTree(tables->nodes, tables->root, data, size, &node, buffer, length - done);
+      skipCodecCursor(payload, size);
+      payloadSize -= size;
+    }
+    putCodecCursor(out, buffer, decoded);
+    done += decoded;
+  }
+  return (done == length) ? HFM_OK : HFM_ERROR_CORRUPTED;
+}
+
+/**
+ * @see @file codec.c / @function planCodecBlock
+ */
+size_t planCodecBlock(const struct codecTables *tables, size_t *histogram, const unsigned char *block, size_t length) {
+  for (size_t c = 0; c < 256; c++) histogram[c] = 0;
+  for (size_t j = 0; j < length; j++) histogram[block[j]]++;
+  size_t payloadSize = codecCodedSize(tables, histogram);
+  return (payloadSize >= length) ? length : payloadSize;
+}
+
+/**
+ * @see @file codec.c / @function writeCodecBlock
+ */
+void writeCodecBlock(const struct codecTables *tables, const unsigned char *block, size_t length, size_t payloadSize, unsigned char *out) {
+  out[0] = (payloadSize == length) ? HFM_BLOCK_STORED : HFM_BLOCK_HUFFMAN;
+  storeLittleEndian(out + 1, payloadSize, 4);
+  storeLittleEndian(out + 5, length, 4);
+  if(payloadSize == length) memcpy(out + HFM_BLOCK_HEADER_SIZE, block, length);
+  else encodeCodecBlock(tables, block, length, out + HFM_BLOCK_HEADER_SIZE);
+}
+
+/**
+ * @see @file codec.c / @function checkCodecBlock
+ */
+int checkCodecBlock(const unsigned char *block, size_t storedSize, size_t length) {
+  size_t payloadSize = (size_t)loadLittleEndian((unsigned char*)block + 1, 4);
+  if(storedSize < HFM_BLOCK_HEADER_SIZE || payloadSize > HFM_BLOCK_SIZE || length > HFM_BLOCK_SIZE
+     || HFM_BLOCK_HEADER_SIZE + payloadSize != storedSize || loadLittleEndian((unsigned char*)block + 5, 4) != length)
+    return HFM_ERROR_CORRUPTED;
+  // A table block has no original data, and only it
+  if((block[0] == HFM_BLOCK_TABLE) != (length == 0 && payloadSize > 0)) return HFM_ERROR_CORRUPTED;
+  return HFM_OK;
+}
+
+/**
+ * @see @file codec.c / @function decodeCodecDataBlock
+ */
+int decodeCodecDataBlock(const struct codecTables *tables, unsigned char type, const unsigned char *payload, size_t payloadSize, unsigned char *out, size_t length) {
+  if(type == HFM_BLOCK_STORED && payloadSize == length) {
+    memcpy(out, payload, length);
+    return HFM_OK;
+  }
+  if(type == HFM_BLOCK_HUFFMAN) return decodeCodecBlock(tables, payload, payloadSize, out, length);
+  return HFM_ERROR_CORRUPTED;
+}
+
+/**
+ * @see @file codec.c / @function initCodecCursor
+ */
+void initCodecCursor(struct codecCursor *cursor, const struct iovec *vector, int count, size_t position) {
+  cursor->vector = vector;
+  cursor->count = count;
+  cursor->index = 0;
+  cursor->offset = 0;
+  skipCodecCursor(cursor, position);
+}
+
+/**
+ * @see @file codec.c / @function spanCodecCursor
+ */
+unsigned char* spanCodecCursor(struct codecCursor *cursor, size_t *available) {
+  while(cursor->index < cursor->count && cursor->offset == cursor->vector[cursor->index].iov_len) {
+    cursor->index++;
+    cursor->offset = 0;
+  }
+  if(cursor->index == cursor->count) {
+    *available = 0;
+    return NULL;
+  }
+  *available = cursor->vector[cursor->index].iov_len - cursor->offset;
+  return (unsigned char*)cursor->vector[cursor->index].iov_base + cursor->offset;
+}
+
+/**
+ * @see @file codec.c / @function skipCodecCursor
+ */
+void skipCodecCursor(struct codecCursor *cursor, size_t size) {
+  while(size > 0) {
+    size_t available;
+    if(spanCodecCursor(cursor, &available) == NULL) return;
+    size_t step = (available < size) ? available : size;
+    cursor->offset += step;
+    size -= step;
+  }
+}
+
+/**
+ * @see @file codec.c / @function getCodecCursor
+ */
+void getCodecCursor(struct codecCursor *cursor, void *bytes, size_t size) {
+  unsigned char *to = (unsigned char*)bytes;
+  while(size > 0) {
+    size_t available;
+    const unsigned char *from = spanCodecCursor(cursor, &available);
+    if(from == NULL) return;
+    size_t step = (available < size) ? available : size;
+    memcpy(to, from, step);
+    cursor->offset += step;
+    to += step;
+    size -= step;
+  }
+}
+
+/**
+ * @see @file codec.c / @function putCodecCursor
+ */
+void putCodecCursor(struct codecCursor *cursor, const void *bytes, size_t size) {
+  const unsigned char *from = (const unsigned char*)bytes;
+  while(size > 0) {
+    size_t available;
+    unsigned char *to = spanCodecCursor(cursor, &available);
+    if(to == NULL) return;
+    size_t step = (available < size) ? available : size;
+    memcpy(to, from, step);
+    cursor->offset += step;
+    from += step;
+    size -= step;
+  }
+}
+
+/**
+ * @see @file codec.c / @function copyCodecCursor
+ */
+void copyCodecCursor(struct codecCursor *to, struct codecCursor *from, size_t size) {
+  while(size > 0) {
+    size_t toAvailable, fromAvailable;
+    unsigned char *target = spanCodecCursor(to, &toAvailable);
+    const unsigned char *source = spanCodecCursor(from, &fromAvailable);
+    if(target == NULL || source == NULL) return;
+    size_t step = (toAvailable < fromAvailable) ? toAvailable : fromAvailable;
+    if(step > size) step = size;
+    memmove(target, source, step);
+    to->offset += step;
+    from->offset += step;
+    size -= step;
+  }
+}
+
+/**
+ * @see @file codec.c / @function codecVectorSize
+ */
+size_t codecVectorSize(const struct iovec *vector, int count) {
+  if(count < 0 || (vector == NULL && count > 0)) return SIZE_MAX;
+  size_t size = 0;
+  for (int i = 0; i < count; i++) {
+    if((vector[i].iov_base == NULL && vector[i].iov_len > 0) || vector[i].iov_len >= SIZE_MAX - size) return SIZE_MAX;
+    size += vector[i].iov_len;
+  }
+  return size;
+}
+
+/**
+ * @see @file codec.c / @function putCodecBytes
+ */
+int putCodecBytes(unsigned char *out, size_t limit, size_t *position, const void *bytes, size_t size) {
+  int fits = *position <= limit && size <= limit - *position;
+  if(fits && bytes != NULL) memcpy(out + *position, bytes, size);
+  *position += size;
+  return fits;
+}
+
+/**
+ * @see @file codec.c / @function putCodecVarint
+ */
+void putCodecVarint(unsigned char *out, size_t limit, size_t *position, size_t value) {
+  unsigned char bytes[HFM_CODEC_MAX_VARINT];
+  size_t size = 0;
+  while(value >= 0x80) {
+    bytes[size++] = (unsigned char)((value & 0x7F) | 0x80);
+    value >>= 7;
+  }
+  bytes[size++] = (unsigned char)value;
+  putCodecBytes(out, limit, position, bytes, size);
+}
+
+/**
+ * @see @file codec.c / @function putCodecHeader
+ */
+int putCodecHeader(unsigned char *out, size_t limit, size_t *position, size_t size, size_t nbBlocks, unsigned int flags, const size_t *histogram) {
+  unsigned char header[HFM_CONTAINER_HEADER_SIZE];
+  memset(header, 0, HFM_CONTAINER_HEADER_SIZE);
+  memcpy(header, HFM_CONTAINER_MAGIC, 4);
+  header[4] = 1; // No table block
+  header[5] = (unsigned char)flags;
+  storeLittleEndian(header + 8, size, 8);
+  storeLittleEndian(header + 16, nbBlocks, 8);
+  int fits = putCodecBytes(out, limit, position, header, HFM_CONTAINER_HEADER_SIZE);
+  if(flags & HFM_CONTAINER_TABLE)
+    for (size_t c = 0; c < 256; c++) putCodecVarint(out, limit, position, histogram[c]);
+  return fits && *position <= limit;
+}
+
+/**
+ * @see @file codec.c / @function readCodecVarint
+ */
+int readCodecVarint(const unsigned char *data, size_t end, size_t *position, size_t *value) {
+  unsigned int shift = 0;
+  *value = 0;
+  while(*position < end && shift < 64) {
+    unsigned char c = data[(*position)++];
+    *value |= (size_t)(c & 0x7F) << shift;
+    if((c & 0x80) == 0) return 0;
+    shift += 7;
+  }
+  return -1;
+}
+
+/**
+ * @see @file codec.c / @function readCodecHeader
+ */
+int readCodecHeader(const unsigned char *data, size_t size, struct codecHeader *header, size_t *histogram) {
+  memset(header, 0, sizeof(struct codecHeader));
+  if(size < HFM_CONTAINER_HEADER_SIZE || memcmp(data, HFM_CONTAINER_MAGIC, 4)) return HFM_ERROR_CORRUPTED;
+  header->version = data[4];
+  header->flags = data[5];
+  header->originalSize = loadLittleEndian((unsigned char*)data + 8, 8);
+  header->nbBlocks = loadLittleEndian((unsigned char*)data + 16, 8);
+  header->indexOffset = loadLittleEndian((unsigned char*)data + 24, 8);
+  header->firstBlockOffset = HFM_CONTAINER_HEADER_SIZE;
+  if(header->version < 1 || header->version > HFM_CONTAINER_VERSION
+     || (header->flags & ~(HFM_CONTAINER_TABLE | HFM_CONTAINER_CHECKSUMS)) != 0 || header->originalSize > SIZE_MAX)
+    return HFM_ERROR_CORRUPTED;
+  if(header->flags & HFM_CONTAINER_TABLE) {
+    size_t value;
+    for (size_t c = 0; c < 256; c++) {
+      if(readCodecVarint(data, size, &header->firstBlockOffset, &value) != 0) return HFM_ERROR_CORRUPTED;
+      if(histogram != NULL) histogram[c] += value;
+    }
+  }
+  return HFM_OK;
+}
+
+/**
+ * @see @file codec.c / @function codecCostOf
+ */
+uint64_t codecCostOf(cct context, const unsigned char *data, size_t size) {
+  // By pieces, up to a byte with no prefix, so that the sum never overflows
+  uint64_t bits = 0;
+  for (size_t i = 0; i < size && bits < HFM_CODEC_NO_PREFIX; ) {
+    size_t end = (size - i < HFM_BLOCK_SIZE) ? size : i + HFM_BLOCK_SIZE;
+    for (; i < end; i++) bits += context->costs[data[i]];
+  }
+  return bits;
+}
+
+/**
+ * @see @file codec.c / @function openCodecFile
+ */
+int openCodecFile(const struct iovec *data, int count, size_t size, const size_t *key, size_t capacity, size_t *outSize, struct codecHeader *header, size_t *histogram) {
+  // The header and its table are read from a copy, the index where it is
+  unsigned char head[HFM_CODEC_HEAD_SIZE];
+  size_t headSize = (size < HFM_CODEC_HEAD_SIZE) ? size : HFM_CODEC_HEAD_SIZE;
+  struct codecCursor cursor;
+  initCodecCursor(&cursor, data, count, 0);
+  getCodecCursor(&cursor, head, headSize);
+  for (size_t c = 0; c < 256; c++) histogram[c] = 0;
+  int result = readCodecHeader(head, headSize, header, histogram);
+  if(result != HFM_OK) return result;
+  // The index must be in the data, and describe the blocks between the table and itself
+  size_t entrySize = HFM_INDEX_ENTRY_SIZE + ((header->flags & HFM_CONTAINER_BLOCK_CRC) ? HFM_INDEX_CRC_SIZE : 0);
+  size_t trailerSize = (header->flags & HFM_CONTAINER_STREAM_CRC) ? HFM_INDEX_CRC_SIZE : 0;
+  if(header->indexOffset < header->firstBlockOffset || header->indexOffset > size - trailerSize
+     || header->nbBlocks > (size - trailerSize - header->indexOffset) / entrySize)
+    return HFM_ERROR_CORRUPTED;
+  initCodecCursor(&cursor, data, count, (size_t)header->indexOffset);
+  uint64_t storedTotal = 0, lengthTotal = 0;
+  for (uint64_t i = 0; i < header->nbBlocks; i++) {
+    unsigned char entry[HFM_INDEX_ENTRY_SIZE + HFM_INDEX_CRC_SIZE];
+    getCodecCursor(&cursor, entry, entrySize);
+    storedTotal += loadLittleEndian(entry, 4);
+    lengthTotal += loadLittleEndian(entry + 4, 4);
+  }
+  if(storedTotal != header->indexOffset - header->firstBlockOffset || lengthTotal != header->originalSize)
+    return HFM_ERROR_CORRUPTED;
+  if(!(header->flags & HFM_CONTAINER_TABLE) && key == NULL) {
+    // Without a table in the header, the key is only needed by the blocks coded with it
+    struct codecCursor block;
+    initCodecCursor(&cursor, data, count, (size_t)header->indexOffset);
+    initCodecCursor(&block, data, count, header->firstBlockOffset);
+    int usesKey = 1;
+    for (uint64_t i = 0; i < header->nbBlocks; i++) {
+      unsigned char entry[HFM_INDEX_ENTRY_SIZE + HFM_INDEX_CRC_SIZE], blockHeader[HFM_BLOCK_HEADER_SIZE + 1];
+      getCodecCursor(&cursor, entry, entrySize);
+      size_t storedSize = (size_t)loadLittleEndian(entry, 4);
+      struct codecCursor peek = block;
+      getCodecCursor(&peek, blockHeader, (storedSize < sizeof(blockHeader)) ? storedSize : sizeof(blockHeader));
+      skipCodecCursor(&block, storedSize);
+      if(storedSize > HFM_BLOCK_HEADER_SIZE && blockHeader[0] == HFM_BLOCK_TABLE)
+        usesKey = blockHeader[HFM_BLOCK_HEADER_SIZE] == HFM_TABLE_KEY;
+      else if(storedSize > 0 && blockHeader[0] == HFM_BLOCK_HUFFMAN && usesKey)
+        return HFM_ERROR_KEY;
+    }
+  }
+  *outSize = (size_t)header->originalSize;
+  return (header->originalSize > capacity) ? HFM_ERROR_OVERFLOW : HFM_OK;
+}
+
+/**
+ * @see @file codec.c / @function recordCodecError
+ */
+void recordCodecError(struct codecJob *job, size_t block, int error) {
+  uint64_t value = ((uint64_t)block << 8) | (uint64_t)(-error & 0xFF);
+  uint64_t current = __atomic_load_n(&job->error, __ATOMIC_RELAXED);
+  while(value < current && !__atomic_compare_exchange_n(&job->error, &current, value, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+}
+
+/**
+ * @see @file codec.c / @function runCodecTasks
+ */
+void runCodecTasks(sch scheduler, schedulerFunction function, struct codecTask *tasks, size_t nbTasks, csc scratch) {
+  sgp group = createSchedulerGroup();
+  for (size_t i = 0; i < nbTasks; i++)
+    if(group == NULL || submitSchedulerTask(scheduler, group, function, &tasks[i]) != 0) function(&tasks[i], scratch);
+  if(group != NULL) waitSchedulerGroup(scheduler, group);
+  destroySchedulerGroup(&group);
+}
+
+/**
+ * @see @file codec.c / @function countCodecTask
+ */
+void countCodecTask(void *arg, csc scratch) {
+  struct codecTask *task = (struct codecTask*)arg;
+  struct codecJob *job = task->job;
+  size_t *histogram = scratch->blockHistogram;
+  size_t end = (task->last * HFM_BLOCK_SIZE < job->size) ? task->last * HFM_BLOCK_SIZE : job->size;
+  for (size_t c = 0; c < 256; c++) histogram[c] = 0;
+  for (size_t i = task->first * HFM_BLOCK_SIZE; i < end; i++) histogram[job->data[i]]++;
+  for (size_t c = 0; c < 256; c++)
+    if(histogram[c] > 0) __atomic_add_fetch(&job->histogram[c], histogram[c], __ATOMIC_RELAXED);
+}
+
+/**
+ * @see @file codec.c / @function planCodecTask
+ */
+void planCodecTask(void *arg, csc scratch) {
+  struct codecTask *task = (struct codecTask*)arg;
+  struct codecJob *job = task->job;
+  for (size_t i = task->first; i < task->last; i++) {
+    size_t length = (job->size - i * HFM_BLOCK_SIZE < HFM_BLOCK_SIZE) ? job->size - i * HFM_BLOCK_SIZE : HFM_BLOCK_SIZE;
+    job->offsets[i + 1] = HFM_BLOCK_HEADER_SIZE + planCodecBlock(job->tables, scratch->blockHistogram, job->data + i * HFM_BLOCK_SIZE, length);
+  }
+}
+
+/**
+ * @see @file codec.c / @function encodeCodecTask
+ */
+void encodeCodecTask(void *arg, csc scratch) {
+  struct codecTask *task = (struct codecTask*)arg;
+  struct codecJob *job = task->job;
+  (void)scratch;
+  for (size_t i = task->first; i < task->last; i++) {
+    const unsigned char *block = job->data + i * HFM_BLOCK_SIZE;
+    size_t length = (job->size - i * HFM_BLOCK_SIZE < HFM_BLOCK_SIZE) ? job->size - i * HFM_BLOCK_SIZE : HFM_BLOCK_SIZE;
+    size_t storedSize = job->offsets[i + 1] - job->offsets[i];
+    writeCodecBlock(job->tables, block, length, storedSize - HFM_BLOCK_HEADER_SIZE, job->out + job->offsets[i]);
+    unsigned char *entry = job->index + i * job->entrySize;
+    storeLittleEndian(entry, storedSize, 4);
+    storeLittleEndian(entry + 4, length, 4);
+    if(job->flags & HFM_CONTAINER_CHECKSUMS) job->checksums[i] = crc32c(0, block, length);
+    if(job->flags & HFM_CONTAINER_BLOCK_CRC) storeLittleEndian(entry + 8, job->checksums[i], 4);
+  }
+}
+
+/**
+ * @see @file codec.c / @function decodeCodecTask
+ */
+void decodeCodecTask(void *arg, csc scratch) {
+  struct codecTask *task = (struct codecTask*)arg;
+  struct codecJob *job = task->job;
+  (void)scratch;
+  for (size_t i = task->first; i < task->last; i++) {
+    unsigned char *entry = job->index + i * job->entrySize;
+    size_t storedSize = (size_t)loadLittleEndian(entry, 4);
+    size_t length = (size_t)loadLittleEndian(entry + 4, 4);
+    const unsigned char *block = job->data + job->offsets[i];
+    unsigned char *out = job->out + job->positions[i];
+    int result = checkCodecBlock(block, storedSize, length);
+    if(result == HFM_OK)
+      result = decodeCodecDataBlock(job->tables, block[0], block + HFM_BLOCK_HEADER_SIZE, storedSize - HFM_BLOCK_HEADER_SIZE, out, length);
+    if(result == HFM_OK && (job->flags & HFM_CONTAINER_CHECKSUMS)) job->checksums[i] = crc32c(0, out, length);
+    if(result == HFM_OK && (job->flags & HFM_CONTAINER_BLOCK_CRC) && job->checksums[i] != (uint32_t)loadLittleEndian(entry + 8, 4))
+      result = HFM_ERROR_CHECKSUM;
+    if(result != HFM_OK) recordCodecError(job, i, result);
+  }
+}
+
+/* ========================================================================== */
+/* ========================================================================== */
@@ -0,0 +1,506 @@
+/**
+ * @file container.c
+ * @author agent <agent@local>
+ * @standard C99
+ * @version 1.0
+ * @date 18th October 2026
+ *
+ * @brief Implementation file for "container.h"
+ *
+ * This file implements the writing and the reading of the header and of the
+ * block index of the ".hfm" files.
+ *
+ * Overview about private functions of container:
+ *  - writeLittleEndian
+ *  - readLittleEndian
+ *  - appendIndexEntry
+ *
+ * Overview about the container structure functions:
+ *  - createContainer
+ *  - destroyContainer
+ *  - getContainerVersion
+ *  - hasContainerTable
+ *  - getContainerHistogram
+ *  - getContainerOriginalSize
+ *  - getContainerNbBlocks
+ *  - getContainerBlockStoredSize
+ *  - getContainerBlockLength
+ *  - getContainerFirstBlockOffset
+ *  - getContainerIndexOffset
+ *  - getContainerChecksums
+ *  - getContainerBlockChecksum
+ *  - getContainerChecksum
+ *  - setContainerChecksum
+ *  - getContainerBlockOffset
+ *  - getContainerBlockStart
+ *  - findContainerBlock
+ *  - isContainerTableBlock
+ *
+ * Overview about public functions of container:
+ *  - writeContainerHeader
+ *  - addContainerBlock
+ *  - appendContainer
+ *  - restoreContainerBlock
+ *  - finishContainer
+ *  - readContainer
+ *  - readContainerHeader
+ */
+
+#define _GNU_SOURCE
+#include "container.h"
+
+
+/**
+ * @struct container
+ * @brief The header and the block index of a ".hfm" file.
+ */
+struct container {
+  unsigned int version; /**< Version of the format */
+  unsigned int flags; /**< HFM_CONTAINER_TABLE if the table is in the header */
+  size_t histogram[256]; /**< The code table, if it is in the header */
+  long long originalSize; /**< Size of the original file */
+  long long blocksSize; /**< Size of the blocks in the file */
+  size_t nbBlocks; /**< Number of blocks */
+  size_t capacity; /**< Number of blocks the index can hold */
+  uint32_t *storedSizes; /**< Size of each block in the file, header included */
+  uint32_t *lengths; /**< Size of each block in the original file */
+  uint32_t *checksums; /**< CRC32C of each block, with HFM_CONTAINER_BLOCK_CRC */
+  long long *offsets; /**< Offset of each block from the first one, in the file */
+  long long *starts; /**< Offset of each block in the original file */
+  uint32_t checksum; /**< CRC32C of the file, with HFM_CONTAINER_STREAM_CRC */
+  long long headerOffset; /**< Offset of the header in the file */
+  long long firstBlockOffset; /**< Offset of the first block in the file */
+  long long indexOffset; /**< Offset of the block index in the file */
+  int incomplete; /**< 1 if a block couldn't be added to the index */
+};
+
+
+/* ================================================== */
+/* ============== DEF PRIVATE FUNCTIONS ============= */
+/* ========================================================================== */
+
+
+/**
+ * @function writeLittleEndian
+ * @brief Writes an integer in little endian.
+ *
+ * @param{FILE*} file: the file already opened.
+ * @param{uint64_t} value: the integer.
+ * @param{size_t} nbBytes: number of bytes to write.
+ *
+ * @return{void}
+ */
+void writeLittleEndian(FILE *file, uint64_t value, size_t nbBytes);
+
+/**
+ * @function readLittleEndian
+ * @brief Reads an integer written by writeLittleEndian.
+ *
+ * @param{FILE*} file: the file already opened.
+ * @param{size_t} nbBytes: number of bytes to read.
+ * @param{uint64_t*} value: receives the integer.
+ *
+ * @return{int}: 0 if the integer has been read, -1 otherwise.
+ */
+int readLittleEndian(FILE *file, size_t nbBytes, uint64_t *value);
+
+/**
+ * @function appendIndexEntry
+ * @brief Adds an entry at the end of the block index.
+ *
+ * @param{ctn} container: the container.
+ * @param{size_t} storedSize: size of the block in the file, header included.
+ * @param{size_t} length: size of the block in the original file.
+ * @param{uint32_t} checksum: CRC32C of the block (ignored without
+ *                            HFM_CONTAINER_BLOCK_CRC).
+ *
+ * @return{int}: 0 if the entry has been added, -1 if memory can't be
+ *               allocated (the container is then marked incomplete).
+ */
+int appendIndexEntry(ctn container, size_t storedSize, size_t length, uint32_t checksum);
+
+/**
+ * @function readHeaderFields
+ * @brief Reads the fixed part of the header and the code table.
+ *
+ * @param{ctn} container: the container receiving the version, the flags and
+ *                        the code table.
+ * @param{FILE*} file: the file, positioned at the header.
+ * @param{uint64_t*} originalSize: receives the size of the original file.
+ * @param{uint64_t*} nbBlocks: receives the number of blocks.
+ * @param{uint64_t*} indexOffset: receives the offset of the block index.
+ *
+ * @return{int}: 1 if the header is valid, 0 otherwise.
+ */
+int readHeaderFields(ctn container, FILE *file, uint64_t *originalSize, uint64_t *nbBlocks, uint64_t *indexOffset);
+
+
+/* ================================================== */
+/* ================ STRUCT FUNCTIONS ================ */
+/* ========================================================================== */
+
+
+/**
+ * @see @file container.h / @function createContainer
+ */
+ctn createContainer(size_t *histogram, unsigned int checksums) {
+  ctn container = (ctn)calloc(1, sizeof(struct container));
+  if(container == NULL) return NULL;
+  container->version = 1; // Until a table block is added
+  container->flags = checksums & HFM_CONTAINER_CHECKSUMS;
+  if(histogram != NULL) {
+    container->flags |= HFM_CONTAINER_TABLE;
+    memcpy(container->histogram, histogram, sizeof(container->histogram));
+  }
+  return container;
+}
+
+/**
+ * @see @file container.h / @function destroyContainer
+ */
+void destroyContainer(ctn *container) {
+  if(*container != NULL) {
+    free((*container)->storedSizes);
+    free((*container)->lengths);
+    free((*container)->checksums);
+    free((*container)->offsets);
+    free((*container)->starts);
+    free(*container);
+    *container = NULL;
+  }
+}
+
+/**
+ * @see @file container.h / @function getContainerVersion
+ */
+unsigned int getContainerVersion(ctn container) {
+  return container->version;
+}
+
+/**
+ * @see @file container.h / @function hasContainerTable
+ */
+int hasContainerTable(ctn container) {
+  return (container->flags & HFM_CONTAINER_TABLE) != 0;
+}
+
+/**
+ * @see @file container.h / @function getContainerHistogram
+ */
+size_t* getContainerHistogram(ctn container) {
+  return hasContainerTable(container) ? container->histogram : NULL;
+}
+
+/**
+ * @see @file container.h / @function getContainerOriginalSize
+ */
+long long getContainerOriginalSize(ctn container) {
+  return container->originalSize;
+}
+
+/**
+ * @see @file container.h / @function getContainerNbBlocks
+ */
+size_t getContainerNbBlocks(ctn container) {
+  return container->nbBlocks;
+}
+
+/**
+ * @see @file container.h / @function getContainerBlockStoredSize
+ */
+size_t getContainerBlockStoredSize(ctn container, size_t index) {
+  return container->storedSizes[index];
+}
+
+/**
+ * @see @file container.h / @function getContainerBlockLength
+ */
+size_t getContainerBlockLength(ctn container, size_t index) {
+  return container->lengths[index];
+}
+
+/**
+ * @see @file container.h / @function getContainerFirstBlockOffset
+ */
+long long getContainerFirstBlockOffset(ctn container) {
+  return container->firstBlockOffset;
+}
+
+/**
+ * @see @file container.h / @function getContainerIndexOffset
+ */
+long long getContainerIndexOffset(ctn container) {
+  return container->indexOffset;
+}
+
+/**
+ * @see @file container.h / @function getContainerChecksums
+ */
+unsigned int getContainerChecksums(ctn container) {
+  return container->flags & HFM_CONTAINER_CHECKSUMS;
+}
+
+/**
+ * @see @file container.h / @function getContainerBlockChecksum
+ */
+uint32_t getContainerBlockChecksum(ctn container, size_t index) {
+  return container->checksums[index];
+}
+
+/**
+ * @see @file container.h / @function getContainerChecksum
+ */
+uint32_t getContainerChecksum(ctn container) {
+  return container->checksum;
+}
+
+/**
+ * @see @file container.h / @function setContainerChecksum
+ */
+void setContainerChecksum(ctn container, uint32_t checksum) {
+  container->checksum = checksum;
+}
+
+/**
+ * @see @file container.h / @function getContainerBlockOffset
+ */
+long long getContainerBlockOffset(ctn container, size_t index) {
+  return container->firstBlockOffset + container->offsets[index];
+}
+
+/**
+ * @see @file container.h / @function getContainerBlockStart
+ */
+long long getContainerBlockStart(ctn container, size_t index) {
+  return container->starts[index];
+}
+
+/**
+ * @see @file container.h / @function findContainerBlock
+ */
+size_t findContainerBlock(ctn container, long long position) {
+  if(position < 0 || position >= container->originalSize) return SIZE_MAX;
+  size_t low = 0, high = container->nbBlocks - 1;
+  while(low < high) { // Last block starting before the position
+    size_t middle = low + (high - low + 1) / 2;
+    if(container->starts[middle] <= position) low = middle;
+    else high = middle - 1;
+  }
+  return low;
+}
+
+/**
+ * @see @file container.h / @function isContainerTableBlock
+ */
+int isContainerTableBlock(ctn container, size_t index) {
+  return container->lengths[index] == 0 && container->storedSizes[index] > HFM_BLOCK_HEADER_SIZE;
+}
+
+
+/* ================================================== */
+/* ===================== PUBLIC ===================== */
+/* ========================================================================== */
+
+
+/**
+ * @see @file container.h / @function writeContainerHeader
+ */
+int writeContainerHeader(ctn container, FILE *file) {
+  container->headerOffset = (long long)ftello(file);
+  if(container->headerOffset < 0) return -1;
+  fwrite(HFM_CONTAINER_MAGIC, 1, 4, file);
+  fputc((int)container->version, file);
+  fputc((int)container->flags, file);
+  writeLittleEndian(file, 0, 2); // Reserved
+  writeLittleEndian(file, 0, 8); // Original size
+  writeLittleEndian(file, 0, 8); // Number of blocks
+  writeLittleEndian(file, 0, 8); // Offset of the index
+  if(hasContainerTable(container)) writeHistogramInOpenedFile(file, container->histogram);
+  container->firstBlockOffset = (long long)ftello(file);
+  return ferror(file) ? -1 : 0;
+}
+
+/**
+ * @see @file container.h / @function addContainerBlock
+ */
+int addContainerBlock(ctn container, size_t storedSize, unsigned char *block, size_t length) {
+  uint32_t checksum = 0;
+  if(container->flags & HFM_CONTAINER_BLOCK_CRC) checksum = crc32c(0, block, length);
+  if(container->flags & HFM_CONTAINER_STREAM_CRC) container->checksum = crc32c(container->checksum, block, length);
+  return appendIndexEntry(container, storedSize, length, checksum);
+}
+
+/**
+ * @see @file container.h / @function appendContainer
+ */
+void appendContainer(ctn container, ctn other) {
+  for (size_t i = 0; i < other->nbBlocks; i++)
+    appendIndexEntry(container, other->storedSizes[i], other->lengths[i], other->checksums[i]);
+  if(container->flags & HFM_CONTAINER_STREAM_CRC)
+    container->checksum = crc32cCombine(container->checksum, other->checksum, other->originalSize);
+}
+
+/**
+ * @see @file container.h / @function restoreContainerBlock
+ */
+void restoreContainerBlock(ctn container, size_t storedSize, size_t length, uint32_t checksum) {
+  appendIndexEntry(container, storedSize, length, checksum);
+}
+
+/**
+ * @see @file container.h / @function finishContainer
+ */
+int finishContainer(ctn container, FILE *file) {
+  if(container->incomplete) return -1; // The index misses blocks
+  container->indexOffset = (long long)ftello(file);
+  if(container->indexOffset < 0) return -1;
+  for (size_t i = 0; i < container->nbBlocks; i++) {
+    writeLittleEndian(file, container->storedSizes[i], 4);
+    writeLittleEndian(file, container->lengths[i], 4);
+    if(container->flags & HFM_CONTAINER_BLOCK_CRC) writeLittleEndian(file, container->checksums[i], 4);
+  }
+  if(container->flags & HFM_CONTAINER_STREAM_CRC) writeLittleEndian(file, container->checksum, 4);
+  if(fseeko(file, (off_t)(container->headerOffset + 4), SEEK_SET) != 0) return -1;
+  fputc((int)container->version, file);
+  fputc((int)container->flags, file);
+  writeLittleEndian(file, 0, 2); // Reserved
+  writeLittleEndian(file, (uint64_t)container->originalSize, 8);
+  writeLittleEndian(file, container->nbBlocks, 8);
+  writeLittleEndian(file, (uint64_t)(container->indexOffset - container->headerOffset), 8);
+  if(fseeko(file, 0, SEEK_END) != 0) return -1;
+  return ferror(file) ? -1 : 0;
+}
+
+/**
+ * @see @file container.h / @function readContainer
+ */
+ctn readContainer(FILE *file) {
+  ctn container = createContainer(NULL, 0);
+  if(container == NULL) return NULL;
+  uint64_t originalSize, nbBlocks, indexOffset;
+  int valid = readHeaderFields(container, file, &originalSize, &nbBlocks, &indexOffset);
+  if(valid) {
+    container->indexOffset = container->headerOffset + (long long)indexOffset;
+    // The index must be in the file (this also bounds its allocation)
+    long long fileSize = (fseeko(file, 0, SEEK_END) == 0) ? (long long)ftello(file) : -1;
+    uint64_t entrySize = HFM_INDEX_ENTRY_SIZE + ((container->flags & HFM_CONTAINER_BLOCK_CRC) ? HFM_INDEX_CRC_SIZE : 0);
+    long long trailerSize = (container->flags & HFM_CONTAINER_STREAM_CRC) ? HFM_INDEX_CRC_SIZE : 0;
+    valid = container->indexOffset >= container->firstBlockOffset && fileSize >= container->indexOffset + trailerSize
+            && nbBlocks <= (uint64_t)(fileSize - container->indexOffset - trailerSize) / entrySize
+            && fseeko(file, (off_t)container->indexOffset, SEEK_SET) == 0;
+  }
+  for (uint64_t i = 0; valid && i < nbBlocks; i++) {
+    uint64_t storedSize, length, checksum = 0;
+    valid = readLittleEndian(file, 4, &storedSize) == 0 && readLittleEndian(file, 4, &length) == 0
+            && (!(container->flags & HFM_CONTAINER_BLOCK_CRC) || readLittleEndian(file, 4, &checksum) == 0);
+    valid = valid && appendIndexEntry(container, (size_t)storedSize, (size_t)length, (uint32_t)checksum) == 0;
+  }
+  if(valid && (container->flags & HFM_CONTAINER_STREAM_CRC)) {
+    uint64_t checksum;
+    valid = readLittleEndian(file, 4, &checksum) == 0;
+    container->checksum = (uint32_t)checksum;
+  }
+  valid = valid && container->originalSize == (long long)originalSize
+          && container->firstBlockOffset + container->blocksSize == container->indexOffset
+          && fseeko(file, (off_t)container->firstBlockOffset, SEEK_SET) == 0;
+  if(!valid) destroyContainer(&container);
+  return container;
+}
+
+
+/**
+ * @see @file container.h / @function readContainerHeader
+ */
+ctn readContainerHeader(FILE *file) {
+  ctn container = createContainer(NULL, 0);
+  if(container == NULL) return NULL;
+  uint64_t originalSize, nbBlocks, indexOffset;
+  if(!readHeaderFields(container, file, &originalSize, &nbBlocks, &indexOffset)) destroyContainer(&container);
+  return container;
+}
+
+
+/* ================================================== */
+/* ===================== PRIVATE ==================== */
+/* ========================================================================== */
+
+
+/**
+ * @see @file container.c / @function writeLittleEndian
+ */
+void writeLittleEndian(FILE *file, uint64_t value, size_t nbBytes) {
+  for (size_t i = 0; i < nbBytes; i++) fputc((int)((value >> (8 * i)) & 0xFF), file);
+}
+
+/**
+ * @see @file container.c / @function readLittleEndian
+ */
+int readLittleEndian(FILE *file, size_t nbBytes, uint64_t *value) {
+  int c;
+  *value = 0;
+  for (size_t i = 0; i < nbBytes; i++) {
+    if((c = fgetc(file)) == EOF) return -1;
+    *value |= (uint64_t)c << (8 * i);
+  }
+  return 0;
+}
+
+/**
+ * @see @file container.c / @function appendIndexEntry
+ */
+int appendIndexEntry(ctn container, size_t storedSize, size_t length, uint32_t checksum) {
+  if(container->nbBlocks == container->capacity) {
+    size_t capacity = (container->capacity > 0) ? container->capacity * 2 : 16;
+    // Each array is kept by the container even if the next one fails
+    void *array;
+    if((array = realloc(container->storedSizes, capacity * sizeof(uint32_t))) != NULL) container->storedSizes = (uint32_t*)array;
+    if(array != NULL && (array = realloc(container->lengths, capacity * sizeof(uint32_t))) != NULL) container->lengths = (uint32_t*)array;
+    if(array != NULL && (array = realloc(container->checksums, capacity * sizeof(uint32_t))) != NULL) container->checksums = (uint32_t*)array;
+    if(array != NULL && (array = realloc(container->offsets, capacity * sizeof(long long))) != NULL) container->offsets = (long long*)array;
+    if(array != NULL && (array = realloc(container->starts, capacity * sizeof(long long))) != NULL) container->starts = (long long*)array;
+    if(array == NULL) {
+      container->incomplete = 1;
+      return -1;
+    }
+    container->capacity = capacity;
+  }
+  container->storedSizes[container->nbBlocks] = (uint32_t)storedSize;
+  container->lengths[container->nbBlocks] = (uint32_t)length;
+  container->checksums[container->nbBlocks] = checksum;
+  if(length == 0 && storedSize > HFM_BLOCK_HEADER_SIZE) container->version = 2; // Table block
+  container->offsets[container->nbBlocks] = container->blocksSize;
+  container->starts[container->nbBlocks] = container->originalSize;
+  container->blocksSize += (long long)storedSize;
+  container->originalSize += (long long)length;
+  container->nbBlocks++;
+  return 0;
+}
+
+
+/**
+ * @see @file container.c / @function readHeaderFields
+ */
+int readHeaderFields(ctn container, FILE *file, uint64_t *originalSize, uint64_t *nbBlocks, uint64_t *indexOffset) {
+  char magic[4];
+  uint64_t reserved;
+  container->headerOffset = (long long)ftello(file);
+  int valid = container->headerOffset >= 0
+              && fread(magic, 1, 4, file) == 4 && !memcmp(magic, HFM_CONTAINER_MAGIC, 4);
+  if(valid) {
+    container->version = (unsigned int)fgetc(file);
+    container->flags = (unsigned int)fgetc(file);
+    valid = container->version >= 1 && container->version <= HFM_CONTAINER_VERSION
+            && (container->flags & ~(HFM_CONTAINER_TABLE | HFM_CONTAINER_CHECKSUMS)) == 0
+            && readLittleEndian(file, 2, &reserved) == 0
+            && readLittleEndian(file, 8, originalSize) == 0
+            && readLittleEndian(file, 8, nbBlocks) == 0
+            && readLittleEndian(file, 8, indexOffset) == 0;
+  }
+  if(valid && hasContainerTable(container))
+    valid = readHistogramFromOpenedFile(file, container->histogram) == 0;
+  if(valid) container->firstBlockOffset = (long long)ftello(file);
+  return valid;
+}
+
+/* ========================================================================== */
+/* ========================================================================== */
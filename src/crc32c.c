@@ -0,0 +1,262 @@
+/**
+ * @file crc32c.c
+ * @author agent <agent@local>
+ * @standard C99
+ * @version 1.0
+ * @date 18th October 2026
+ *
+ * @brief Implementation file for "crc32c.h"
+ *
+ * The hardware version is chosen at run time, so that the library built
+ * without -march=native still uses the crc32 instructions when the processor
+ * has them.
+ *
+ * Overview about private functions of crc32c:
+ *  - crc32cSoftware
+ *  - crc32cHardware
+ *  - hasCrc32cInstructions
+ *  - gf2MatrixTimes
+ *  - gf2MatrixSquare
+ *
+ * Overview about public functions of crc32c:
+ *  - crc32c
+ *  - crc32cCombine
+ */
+
+#include "crc32c.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#include <nmmintrin.h>
+#define HFM_CRC32C_X86 /**< The SSE4.2 version can be compiled */
+#elif defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#define HFM_CRC32C_ARM /**< The ARMv8 version is always available */
+#endif
+
+#define CRC32C_POLYNOMIAL 0x82F63B78 /**< Castagnoli polynomial, reversed */
+
+static uint32_t CRC32C_TABLE[8][256]; /**< Tables of the slicing-by-8 */
+static int CRC32C_TABLE_READY = 0; /**< 1 once CRC32C_TABLE is filled */
+
+
+/* ================================================== */
+/* ============== DEF PRIVATE FUNCTIONS ============= */
+/* ========================================================================== */
+
+
+/**
+ * @function crc32cSoftware
+ * @brief Updates a CRC32C (not inverted) with a slicing-by-8 table.
+ *
+ * @param{uint32_t} crc: the current value of the register.
+ * @param{const unsigned char*} data: the data.
+ * @param{size_t} size: size of the data.
+ *
+ * @return{uint32_t}: the new value of the register.
+ */
+uint32_t crc32cSoftware(uint32_t crc, const unsigned char *data, size_t size);
+
+/**
+ * @function crc32cHardware
+ * @brief Updates a CRC32C (not inverted) with the crc32 instructions.
+ *
+ * Must only be called if hasCrc32cInstructions returns 1.
+ *
+ * @param{uint32_t} crc: the current value of the register.
+ * @param{const unsigned char*} data: the data.
+ * @param{size_t} size: size of the data.
+ *
+ * @return{uint32_t}: the new value of the register.
+ */
+uint32_t crc32cHardware(uint32_t crc, const unsigned char *data, size_t size);
+
+/**
+ * @function hasCrc32cInstructions
+ * @brief Tells if the processor has the crc32 instructions.
+ *
+ * @return{int}: 1 if crc32cHardware can be used, 0 otherwise.
+ */
+int hasCrc32cInstructions();
+
+/**
+ * @function gf2MatrixTimes
+ * @brief Multiplies a vector by a 32x32 matrix over GF(2).
+ *
+ * @param{const uint32_t*} matrix: the 32 columns of the matrix.
+ * @param{uint32_t} vector: the vector.
+ *
+ * @return{uint32_t}: the product.
+ */
+uint32_t gf2MatrixTimes(const uint32_t *matrix, uint32_t vector);
+
+/**
+ * @function gf2MatrixSquare
+ * @brief Squares a 32x32 matrix over GF(2).
+ *
+ * @param{uint32_t*} square: receives the 32 columns of the square.
+ * @param{const uint32_t*} matrix: the 32 columns of the matrix.
+ *
+ * @return{void}
+ */
+void gf2MatrixSquare(uint32_t *square, const uint32_t *matrix);
+
+
+/* ================================================== */
+/* ===================== PUBLIC ===================== */
+/* ========================================================================== */
+
+
+/**
+ * @see @file crc32c.h / @function crc32c
+ */
+uint32_t crc32c(uint32_t crc, const unsigned char *data, size_t size) {
+  crc = ~crc;
+  crc = hasCrc32cInstructions() ? crc32cHardware(crc, data, size) : crc32cSoftware(crc, data, size);
+  return ~crc;
+}
+
+/**
+ * @see @file crc32c.h / @function crc32cCombine
+ */
+uint32_t crc32cCombine(uint32_t crc1, uint32_t crc2, long long size2) {
+  if(size2 <= 0) return crc1;
+  uint32_t even[32]; // Operator for an even power of two zero bits
+  uint32_t odd[32]; // Operator for an odd power of two zero bits
+  odd[0] = CRC32C_POLYNOMIAL; // Operator for one zero bit
+  for (int n = 1; n < 32; n++) odd[n] = (uint32_t)1 << (n - 1);
+  gf2MatrixSquare(even, odd); // Two zero bits
+  gf2MatrixSquare(odd, even); // Four zero bits
+  // Applies size2 zero bytes to crc1, one bit of size2 at a time
+  do {
+    gf2MatrixSquare(even, odd);
+    if(size2 & 1) crc1 = gf2MatrixTimes(even, crc1);
+    size2 >>= 1;
+    if(size2 == 0) break;
+    gf2MatrixSquare(odd, even);
+    if(size2 & 1) crc1 = gf2MatrixTimes(odd, crc1);
+    size2 >>= 1;
+  } while(size2 != 0);
+  return crc1 ^ crc2;
+}
+
+
+/* ================================================== */
+/* ===================== PRIVATE ==================== */
+/* ========================================================================== */
+
+
+/**
+ * @see @file crc32c.c / @function crc32cSoftware
+ */
+uint32_t crc32cSoftware(uint32_t crc, const unsigned char *data, size_t size) {
+  if(!CRC32C_TABLE_READY) { // Every thread would write the same values
+    for (uint32_t n = 0; n < 256; n++) {
+      uint32_t c = n;
+      for (int k = 0; k < 8; k++) c = (c & 1) ? (c >> 1) ^ CRC32C_POLYNOMIAL : c >> 1;
+      CRC32C_TABLE[0][n] = c;
+    }
+    for (uint32_t n = 0; n < 256; n++)
+      for (int k = 1; k < 8; k++)
+        CRC32C_TABLE[k][n] = (CRC32C_TABLE[k-1][n] >> 8) ^ CRC32C_TABLE[0][CRC32C_TABLE[k-1][n] & 0xFF];
+    CRC32C_TABLE_READY = 1;
+  }
+  while(size >= 8) {
+    uint32_t low = crc ^ ((uint32_t)data[0] | (uint32_t)data[1] << 8 | (uint32_t)data[2] << 16 | (uint32_t)data[3] << 24);
+    uint32_t high = (uint32_t)data[4] | (uint32_t)data[5] << 8 | (uint32_t)data[6] << 16 | (uint32_t)data[7] << 24;
+    crc = CRC32C_TABLE[7][low & 0xFF] ^ CRC32C_TABLE[6][(low >> 8) & 0xFF]
+          ^ CRC32C_TABLE[5][(low >> 16) & 0xFF] ^ CRC32C_TABLE[4][low >> 24]
+          ^ CRC32C_TABLE[3][high & 0xFF] ^ CRC32C_TABLE[2][(high >> 8) & 0xFF]
+          ^ CRC32C_TABLE[1][(high >> 16) & 0xFF] ^ CRC32C_TABLE[0][high >> 24];
+    data += 8;
+    size -= 8;
+  }
+  while(size-- > 0) crc = (crc >> 8) ^ CRC32C_TABLE[0][(crc ^ *data++) & 0xFF];
+  return crc;
+}
+
+/**
+ * @see @file crc32c.c / @function gf2MatrixTimes
+ */
+uint32_t gf2MatrixTimes(const uint32_t *matrix, uint32_t vector) {
+  uint32_t sum = 0;
+  for (; vector != 0; vector >>= 1, matrix++)
+    if(vector & 1) sum ^= *matrix;
+  return sum;
+}
+
+/**
+ * @see @file crc32c.c / @function gf2MatrixSquare
+ */
+void gf2MatrixSquare(uint32_t *square, const uint32_t *matrix) {
+  for (int n = 0; n < 32; n++) square[n] = gf2MatrixTimes(matrix, matrix[n]);
+}
+
+#if defined(HFM_CRC32C_X86)
+
+/**
+ * @see @file crc32c.c / @function crc32cHardware
+ */
+__attribute__((target("sse4.2")))
+uint32_t crc32cHardware(uint32_t crc, const unsigned char *data, size_t size) {
+#if defined(__x86_64__)
+  uint64_t crc64 = crc;
+  for (; size >= 8; data += 8, size -= 8) {
+    uint64_t word;
+    memcpy(&word, data, 8);
+    crc64 = _mm_crc32_u64(crc64, word);
+  }
+  crc = (uint32_t)crc64;
+#endif
+  for (; size > 0; data++, size--) crc = _mm_crc32_u8(crc, *data);
+  return crc;
+}
+
+/**
+ * @see @file crc32c.c / @function hasCrc32cInstructions
+ */
+int hasCrc32cInstructions() {
+  return __builtin_cpu_supports("sse4.2");
+}
+
+#elif defined(HFM_CRC32C_ARM)
+
+/**
+ * @see @file crc32c.c / @function crc32cHardware
+ */
+uint32_t crc32cHardware(uint32_t crc, const unsigned char *data, size_t size) {
+  for (; size >= 8; data += 8, size -= 8) {
+    uint64_t word;
+    memcpy(&word, data, 8);
+    crc = __crc32cd(crc, word);
+  }
+  for (; size > 0; data++, size--) crc = __crc32cb(crc, *data);
+  return crc;
+}
+
+/**
+ * @see @file crc32c.c / @function hasCrc32cInstructions
+ */
+int hasCrc32cInstructions() {
+  return 1;
+}
+
+#else
+
+/**
+ * @see @file crc32c.c / @function crc32cHardware
+ */
+uint32_t crc32cHardware(uint32_t crc, const unsigned char *data, size_t size) {
+  return crc32cSoftware(crc, data, size);
+}
+
+/**
+ * @see @file crc32c.c / @function hasCrc32cInstructions
+ */
+int hasCrc32cInstructions() {
+  return 0;
+}
+
+#endif
+
+/* ========================================================================== */
+/* ========================================================================== */
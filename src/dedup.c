@@ -0,0 +1,621 @@
+/**
+ * @file dedup.c
+ * @author agent <agent@local>
+ * @standard C99
+ * @version 1.0
+ * @date 18th October 2026
+ *
+ * @brief Implementation file for "dedup.h"
+ *
+ * This file implements the cutting of the files in chunks, the table of the
+ * unique chunks with the packs holding them, and the decoding of the chunks.
+ *
+ * The unique chunks are found in a hash table (open addressing, the index of
+ * each chunk plus one, 0 for a free slot) kept at most half full. The table is
+ * shared by the threads packing the files, under one lock held only to look the
+ * chunks up and to copy the new ones in the pack being filled.
+ *
+ * Overview about private functions of dedup:
+ *  - initGearTable
+ *  - findDedupChunk
+ *  - growDedupTable
+ *  - sealDedupPack
+ *  - writeDedupPack
+ *  - getDedupPackReader
+ *
+ * Overview about the dedup structure functions:
+ *  - createDedup
+ *  - destroyDedup
+ *  - getDedupNbChunks
+ *  - getDedupUniqueSize
+ *  - getDedupStoredSize
+ *  - openDedupReader
+ *  - closeDedupReader
+ *
+ * Overview about public functions of dedup:
+ *  - findChunkLength
+ *  - addDedupData
+ *  - flushDedup
+ *  - getDedupTablesSize
+ *  - storeDedupTables
+ *  - loadDedupTables
+ *  - readDedupChunks
+ */
+
+#define _GNU_SOURCE /**< fseeko, ftello and the pthreads */
+#include "dedup.h"
+
+#include <stdint.h>
+
+#define HFM_DEDUP_MASK_SMALL 0x0000d9f003530000ULL /**< 15 bits: chunks shorter than the average are rare */
+#define HFM_DEDUP_MASK_LARGE 0x0000d90003530000ULL /**< 11 bits: chunks longer than the average are rare */
+#define HFM_DEDUP_SEED1 0x6866616465647570ULL /**< Seed of the first hash of a chunk */
+#define HFM_DEDUP_SEED2 0x636b6e7568636b73ULL /**< Seed of the second hash of a chunk */
+#define HFM_DEDUP_MIN_TABLE 65536 /**< First size of the hash table */
+
+
+/**
+ * @struct dedupChunk
+ * @brief A unique chunk.
+ */
+struct dedupChunk {
+  uint64_t hash1; /**< First hash of the content, 0 when read from an archive */
+  uint64_t hash2; /**< Second hash of the content */
+  uint32_t pack; /**< Index of its pack */
+  uint32_t start; /**< Offset in the original content of the pack */
+  uint32_t length; /**< Length of the chunk */
+};
+
+/**
+ * @struct dedupPack
+ * @brief A pack of unique chunks.
+ */
+struct dedupPack {
+  long long offset; /**< Offset of its container in the archive, -1 until written */
+  long long storedSize; /**< Size of its container */
+};
+
+/**
+ * @struct dedupCut
+ * @brief A chunk of the data added, before it is looked up.
+ */
+struct dedupCut {
+  size_t start; /**< Offset in the data */
+  size_t length; /**< Length of the chunk */
+  uint64_t hash1; /**< First hash */
+  uint64_t hash2; /**< Second hash */
+};
+
+/**
+ * @struct dedup
+ * @brief The unique chunks and their packs.
+ */
+struct dedup {
+  struct dedupChunk *chunks; /**< The unique chunks */
+  size_t nbChunks; /**< Number of chunks */
+  size_t chunksAllocated; /**< Number of chunks allocated */
+  uint32_t *table; /**< Hash table of the chunks, NULL when read from an archive */
+  size_t tableSize; /**< Number of slots, a power of 2 */
+  struct dedupPack *packs; /**< The packs sealed */
+  size_t nbPacks; /**< Number of packs sealed, the index of the one being filled */
+  size_t packsAllocated; /**< Number of packs allocated */
+  unsigned char *pack; /**< Original content of the pack being filled */
+  size_t packLength; /**< Bytes in the pack being filled */
+  long long uniqueSize; /**< Size of the unique chunks */
+  int failed; /**< 1 once a pack can't be written */
+  FILE *archive; /**< Archive receiving the packs */
+  pthread_mutex_t *archiveLock; /**< Lock of the writes in the archive */
+  unsigned int checksums; /**< Checksums written in each pack */
+  cch cache; /**< Packs already coded, NULL if none */
+  pthread_mutex_t lock; /**< Lock of the chunks and the packs */
+};
+
+/**
+ * @struct dedupReader
+ * @brief Readers on the last packs used, for one thread.
+ */
+struct dedupReader {
+  ddp dedup; /**< The table */
+  char *fileArchive; /**< Name of the archive */
+  rdr readers[HFM_DEDUP_OPEN_PACKS]; /**< Readers, NULL if free */
+  size_t packs[HFM_DEDUP_OPEN_PACKS]; /**< Pack of each reader */
+  unsigned long long lastUse[HFM_DEDUP_OPEN_PACKS]; /**< Value of the clock at the last use */
+  unsigned long long clock; /**< Incremented at each use of a reader */
+  unsigned char *buffer; /**< A chunk decoded */
+};
+
+static uint64_t GEAR_TABLE[256]; /**< Random value of each byte, for the rolling hash */
+static pthread_once_t GEAR_ONCE = PTHREAD_ONCE_INIT; /**< Fills GEAR_TABLE once */
+
+
+/* ================================================== */
+/* ============== DEF PRIVATE FUNCTIONS ============= */
+/* ========================================================================== */
+
+
+/**
+ * @function initGearTable
+ * @brief Fills the gear table with pseudo-random values (splitmix64 with a
+ * fixed seed, so that the same data is always cut the same way).
+ *
+ * @return{void}
+ */
+void initGearTable();
+
+/**
+ * @function findDedupChunk
+ * @brief Looks a chunk up in the hash table. The lock must be held.
+ *
+ * @param{ddp} dedup: the table.
+ * @param{struct dedupCut*} cut: the chunk.
+ * @param{size_t*} slot: receives its slot, or the free slot where to add it.
+ *
+ * @return{size_t}: the index of the chunk, SIZE_MAX if it is new.
+ */
+size_t findDedupChunk(ddp dedup, struct dedupCut *cut, size_t *slot);
+
+/**
+ * @function growDedupTable
+ * @brief Doubles the hash table. The lock must be held.
+ *
+ * @param{ddp} dedup: the table.
+ *
+ * @return{void}
+ */
+void growDedupTable(ddp dedup);
+
+/**
+ * @function sealDedupPack
+ * @brief Ends the pack being filled and starts a new one. The lock must be
+ * held.
+ *
+ * @param{ddp} dedup: the table.
+ * @param{size_t*} index: receives the index of the pack sealed.
+ * @param{size_t*} length: receives the length of its original content.
+ *
+ * @return{unsigned char*}: the original content of the pack, to free.
+ */
+unsigned char* sealDedupPack(ddp dedup, size_t *index, size_t *length);
+
+/**
+ * @function writeDedupPack
+ * @brief Codes a pack sealed and appends it to the archive.
+ *
+ * @param{ddp} dedup: the table.
+ * @param{size_t} index: index of the pack.
+ * @param{unsigned char*} pack: original content of the pack, freed.
+ * @param{size_t} length: length of the content.
+ *
+ * @return{int}: 0 if the pack has been written, -1 otherwise.
+ */
+int writeDedupPack(ddp dedup, size_t index, unsigned char *pack, size_t length);
+
+/**
+ * @function getDedupPackReader
+ * @brief Gives a reader on a pack, opening it in place of the least recently
+ * used one if needed.
+ *
+ * @param{ddr} reader: the reader of the chunks.
+ * @param{size_t} pack: index of the pack.
+ *
+ * @return{rdr}: the reader of the pack, NULL if it is corrupted.
+ */
+rdr getDedupPackReader(ddr reader, size_t pack);
+
+
+/* ================================================== */
+/* ================ STRUCT FUNCTIONS ================ */
+/* ========================================================================== */
+
+
+/**
+ * @see @file dedup.h / @function createDedup
+ */
+ddp createDedup(FILE *archive, pthread_mutex_t *archiveLock, unsigned int checksums, cch cache) {
+  ddp dedup = (ddp)calloc(1, sizeof(struct dedup));
+  if(dedup == NULL) pointerAllocError();
+  dedup->tableSize = HFM_DEDUP_MIN_TABLE;
+  dedup->table = (uint32_t*)calloc(dedup->tableSize, sizeof(uint32_t));
+  dedup->pack = (unsigned char*)malloc(HFM_DEDUP_PACK_SIZE);
+  if(dedup->table == NULL || dedup->pack == NULL) pointerAllocError();
+  dedup->archive = archive;
+  dedup->archiveLock = archiveLock;
+  dedup->checksums = checksums;
+  dedup->cache = cache;
+  pthread_mutex_init(&dedup->lock, NULL);
+  return dedup;
+}
+
+/**
+ * @see @file dedup.h / @function destroyDedup
+ */
+void destroyDedup(ddp *dedup) {
+  if(*dedup == NULL) return;
+  pthread_mutex_destroy(&(*dedup)->lock);
+  free((*dedup)->chunks);
+  free((*dedup)->table);
+  free((*dedup)->packs);
+  free((*dedup)->pack);
+  free(*dedup);
+  *dedup = NULL;
+}
+
+/**
+ * @see @file dedup.h / @function getDedupNbChunks
+ */
+size_t getDedupNbChunks(ddp dedup) {
+  return dedup->nbChunks;
+}
+
+/**
+ * @see @file dedup.h / @function getDedupUniqueSize
+ */
+long long getDedupUniqueSize(ddp dedup) {
+  return dedup->uniqueSize;
+}
+
+/**
+ * @see @file dedup.h / @function getDedupStoredSize
+ */
+long long getDedupStoredSize(ddp dedup) {
+  long long size = 0;
+  for (size_t i = 0; i < dedup->nbPacks; i++) size += dedup->packs[i].storedSize;
+  return size;
+}
+
+/**
+ * @see @file dedup.h / @function openDedupReader
+ */
+ddr openDedupReader(ddp dedup, char *fileArchive) {
+  ddr reader = (ddr)calloc(1, sizeof(struct dedupReader));
+  if(reader == NULL) pointerAllocError();
+  reader->dedup = dedup;
+  reader->fileArchive = fileArchive;
+  reader->buffer = (unsigned char*)malloc(HFM_DEDUP_MAX_CHUNK);
+  if(reader->buffer == NULL) pointerAllocError();
+  return reader;
+}
+
+/**
+ * @see @file dedup.h / @function closeDedupReader
+ */
+void closeDedupReader(ddr *reader) {
+  if(*reader == NULL) return;
+  for (size_t i = 0; i < HFM_DEDUP_OPEN_PACKS; i++) closeReader(&(*reader)->readers[i]);
+  free((*reader)->buffer);
+  free(*reader);
+  *reader = NULL;
+}
+
+
+/* ================================================== */
+/* ===================== PUBLIC ===================== */
+/* ========================================================================== */
+
+
+/**
+ * @see @file dedup.h / @function findChunkLength
+ */
+size_t findChunkLength(const unsigned char *data, size_t size) {
+  pthread_once(&GEAR_ONCE, initGearTable);
+  if(size <= HFM_DEDUP_MIN_CHUNK) return size;
+  if(size > HFM_DEDUP_MAX_CHUNK) size = HFM_DEDUP_MAX_CHUNK;
+  size_t normal = (size < HFM_DEDUP_AVG_CHUNK) ? size : HFM_DEDUP_AVG_CHUNK;
+  uint64_t hash = 0;
+  size_t i = HFM_DEDUP_MIN_CHUNK; // No cut before: its bytes are not even hashed
+  for (; i < normal; i++) {
+    hash = (hash << 1) + GEAR_TABLE[data[i]];
+    if(!(hash & HFM_DEDUP_MASK_SMALL)) return i;
+  }
+  for (; i < size; i++) {
+    hash = (hash << 1) + GEAR_TABLE[data[i]];
+    if(!(hash & HFM_DEDUP_MASK_LARGE)) return i;
+  }
+  return size;
+}
+
+/**
+ * @see @file dedup.h / @function addDedupData
+ */
+int addDedupData(ddp dedup, unsigned char *data, size_t size, uint32_t **chunks, size_t *nbChunks) {
+  size_t nbCuts = 0, allocated = size / HFM_DEDUP_AVG_CHUNK + 1;
+  struct dedupCut *cuts = (struct dedupCut*)malloc(allocated * sizeof(struct dedupCut));
+  if(cuts == NULL) pointerAllocError();
+  for (size_t start = 0; start < size; start += cuts[nbCuts++].length) {
+    if(nbCuts == allocated) {
+      allocated *= 2;
+      struct dedupCut *ptr = (struct dedupCut*)realloc(cuts, allocated * sizeof(struct dedupCut));
+      if(ptr == NULL) pointerAllocError();
+      cuts = ptr;
+    }
+    cuts[nbCuts].start = start;
+    cuts[nbCuts].length = findChunkLength(data + start, size - start);
+    cuts[nbCuts].hash1 = xxHash64(data + start, cuts[nbCuts].length, HFM_DEDUP_SEED1);
+    cuts[nbCuts].hash2 = xxHash64(data + start, cuts[nbCuts].length, HFM_DEDUP_SEED2);
+  }
+  *chunks = (uint32_t*)malloc((nbCuts > 0 ? nbCuts : 1) * sizeof(uint32_t));
+  if(*chunks == NULL) pointerAllocError();
+  *nbChunks = nbCuts;
+  int result = 0;
+  size_t i = 0;
+  while(i < nbCuts && result == 0) {
+    unsigned char *sealed = NULL;
+    size_t sealedIndex = 0, sealedLength = 0;
+    pthread_mutex_lock(&dedup->lock);
+    for (; i < nbCuts && sealed == NULL && result == 0; i++) {
+      size_t slot;
+      size_t index = findDedupChunk(dedup, &cuts[i], &slot);
+      if(index == SIZE_MAX && (dedup->nbChunks >= UINT32_MAX || dedup->nbPacks >= UINT32_MAX)) {
+        result = -1;
+        break;
+      }
+      if(index == SIZE_MAX) {
+        if(dedup->packLength + cuts[i].length > HFM_DEDUP_PACK_SIZE) sealed = sealDedupPack(dedup, &sealedIndex, &sealedLength);
+        if(dedup->nbChunks == dedup->chunksAllocated) {
+          dedup->chunksAllocated = (dedup->chunksAllocated > 0) ? 2 * dedup->chunksAllocated : 1024;
+          struct dedupChunk *ptr = (struct dedupChunk*)realloc(dedup->chunks, dedup->chunksAllocated * sizeof(struct dedupChunk));
+          if(ptr == NULL) pointerAllocError();
+          dedup->chunks = ptr;
+        }
+        index = dedup->nbChunks++;
+        struct dedupChunk *chunk = &dedup->chunks[index];
+        chunk->hash1 = cuts[i].hash1;
+        chunk->hash2 = cuts[i].hash2;
+        chunk->pack = (uint32_t)dedup->nbPacks;
+        chunk->start = (uint32_t)dedup->packLength;
+        chunk->length = (uint32_t)cuts[i].length;
+        memcpy(dedup->pack + dedup->packLength, data + cuts[i].start, cuts[i].length);
+        dedup->packLength += cuts[i].length;
+        dedup->uniqueSize += (long long)cuts[i].length;
+        dedup->table[slot] = (uint32_t)(index + 1);
+        if(2 * dedup->nbChunks > dedup->tableSize) growDedupTable(dedup);
+      }
+      (*chunks)[i] = (uint32_t)index;
+    }
+    if(dedup->failed) result = -1;
+    pthread_mutex_unlock(&dedup->lock);
+    // Coded while the other threads go on filling the next pack
+    if(sealed != NULL && writeDedupPack(dedup, sealedIndex, sealed, sealedLength) != 0) result = -1;
+  }
+  free(cuts);
+  return result;
+}
+
+/**
+ * @see @file dedup.h / @function flushDedup
+ */
+int flushDedup(ddp dedup) {
+  if(dedup->packLength > 0) {
+    size_t index, length;
+    unsigned char *sealed = sealDedupPack(dedup, &index, &length);
+    writeDedupPack(dedup, index, sealed, length);
+  }
+  return dedup->failed ? -1 : 0;
+}
+
+/**
+ * @see @file dedup.h / @function getDedupTablesSize
+ */
+size_t getDedupTablesSize(ddp dedup) {
+  return 16 + dedup->nbPacks * HFM_DEDUP_PACK_ENTRY_SIZE + dedup->nbChunks * HFM_DEDUP_CHUNK_ENTRY_SIZE;
+}
+
+/**
+ * @see @file dedup.h / @function storeDedupTables
+ */
+void storeDedupTables(ddp dedup, unsigned char *out) {
+  storeLittleEndian(out, dedup->nbPacks, 8);
+  out += 8;
+  for (size_t i = 0; i < dedup->nbPacks; i++, out += HFM_DEDUP_PACK_ENTRY_SIZE) {
+    storeLittleEndian(out, (uint64_t)dedup->packs[i].offset, 8);
+    storeLittleEndian(out + 8, (uint64_t)dedup->packs[i].storedSize, 8);
+  }
+  storeLittleEndian(out, dedup->nbChunks, 8);
+  out += 8;
+  for (size_t i = 0; i < dedup->nbChunks; i++, out += HFM_DEDUP_CHUNK_ENTRY_SIZE) {
+    storeLittleEndian(out, dedup->chunks[i].pack, 4);
+    storeLittleEndian(out + 4, dedup->chunks[i].start, 4);
+    storeLittleEndian(out + 8, dedup->chunks[i].length, 4);
+  }
+}
+
+/**
+ * @see @file dedup.h / @function loadDedupTables
+ */
+ddp loadDedupTables(unsigned char *tables, size_t size, long long start, long long end, size_t *used) {
+  if(size < 8) return NULL;
+  uint64_t nbPacks = loadLittleEndian(tables, 8);
+  if(nbPacks > (size - 8) / HFM_DEDUP_PACK_ENTRY_SIZE) return NULL;
+  size_t offset = 8 + (size_t)nbPacks * HFM_DEDUP_PACK_ENTRY_SIZE;
+  if(size - offset < 8) return NULL;
+  uint64_t nbChunks = loadLittleEndian(tables + offset, 8);
+  offset += 8;
+  if(nbChunks > (size - offset) / HFM_DEDUP_CHUNK_ENTRY_SIZE) return NULL;
+  ddp dedup = (ddp)calloc(1, sizeof(struct dedup));
+  if(dedup == NULL) pointerAllocError();
+  dedup->nbPacks = dedup->packsAllocated = (size_t)nbPacks;
+  dedup->nbChunks = dedup->chunksAllocated = (size_t)nbChunks;
+  dedup->packs = (struct dedupPack*)malloc((nbPacks > 0 ? (size_t)nbPacks : 1) * sizeof(struct dedupPack));
+  dedup->chunks = (struct dedupChunk*)calloc(nbChunks > 0 ? (size_t)nbChunks : 1, sizeof(struct dedupChunk));
+  if(dedup->packs == NULL || dedup->chunks == NULL) pointerAllocError();
+  pthread_mutex_init(&dedup->lock, NULL);
+  int valid = 1;
+  unsigned char *entry = tables + 8;
+  for (size_t i = 0; valid && i < dedup->nbPacks; i++, entry += HFM_DEDUP_PACK_ENTRY_SIZE) {
+    dedup->packs[i].offset = (long long)loadLittleEndian(entry, 8);
+    dedup->packs[i].storedSize = (long long)loadLittleEndian(entry + 8, 8);
+    valid = dedup->packs[i].offset >= start && dedup->packs[i].offset <= end
+            && dedup->packs[i].storedSize >= HFM_CONTAINER_HEADER_SIZE && dedup->packs[i].storedSize <= end - dedup->packs[i].offset;
+  }
+  entry += 8;
+  for (size_t i = 0; valid && i < dedup->nbChunks; i++, entry += HFM_DEDUP_CHUNK_ENTRY_SIZE) {
+    struct dedupChunk *chunk = &dedup->chunks[i];
+    chunk->pack = (uint32_t)loadLittleEndian(entry, 4);
+    chunk->start = (uint32_t)loadLittleEndian(entry + 4, 4);
+    chunk->length = (uint32_t)loadLittleEndian(entry + 8, 4);
+    valid = chunk->pack < dedup->nbPacks && chunk->length > 0 && chunk->length <= HFM_DEDUP_MAX_CHUNK
+            && chunk->start <= HFM_DEDUP_PACK_SIZE - chunk->length;
+    dedup->uniqueSize += chunk->length;
+  }
+  if(!valid) {
+    destroyDedup(&dedup);
+    return NULL;
+  }
+  *used = offset + (size_t)nbChunks * HFM_DEDUP_CHUNK_ENTRY_SIZE;
+  return dedup;
+}
+
+/**
+ * @see @file dedup.h / @function readDedupChunks
+ */
+long long readDedupChunks(ddr reader, uint32_t *chunks, size_t nbChunks, FILE *fileOut) {
+  long long written = 0;
+  for (size_t i = 0; i < nbChunks; i++) {
+    if(chunks[i] >= reader->dedup->nbChunks) return -2;
+    struct dedupChunk *chunk = &reader->dedup->chunks[chunks[i]];
+    rdr pack = getDedupPackReader(reader, chunk->pack);
+    if(pack == NULL) return -2;
+    long long result = readRange(pack, chunk->start, chunk->length, reader->buffer);
+    if(result < 0) return result;
+    if(result != (long long)chunk->length) return -2; // The chunk is not in its pack
+    if(fwrite(reader->buffer, 1, chunk->length, fileOut) != chunk->length) return -1;
+    written += result;
+  }
+  return written;
+}
+
+
+/* ================================================== */
+/* ===================== PRIVATE ==================== */
+/* ========================================================================== */
+
+
+/**
+ * @see @file dedup.c / @function initGearTable
+ */
+void initGearTable() {
+  uint64_t state = 0x9E3779B97F4A7C15ULL;
+  for (size_t i = 0; i < 256; i++) {
+    uint64_t value = (state += 0x9E3779B97F4A7C15ULL);
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+    GEAR_TABLE[i] = value ^ (value >> 31);
+  }
+}
+
+/**
+ * @see @file dedup.c / @function findDedupChunk
+ */
+size_t findDedupChunk(ddp dedup, struct dedupCut *cut, size_t *slot) {
+  size_t mask = dedup->tableSize - 1;
+  for (size_t i = (size_t)cut->hash1 & mask; ; i = (i + 1) & mask) {
+    if(dedup->table[i] == 0) {
+      *slot = i;
+      return SIZE_MAX;
+    }
+    struct dedupChunk *chunk = &dedup->chunks[dedup->table[i] - 1];
+    if(chunk->hash1 == cut->hash1 && chunk->hash2 == cut->hash2 && chunk->length == cut->length) {
+      *slot = i;
+      return dedup->table[i] - 1;
+    }
+  }
+}
+
+/**
+ * @see @file dedup.c / @function growDedupTable
+ */
+void growDedupTable(ddp dedup) {
+  size_t tableSize = 2 * dedup->tableSize;
+  uint32_t *table = (uint32_t*)calloc(tableSize, sizeof(uint32_t));
+  if(table == NULL) pointerAllocError();
+  for (size_t i = 0; i < dedup->nbChunks; i++) {
+    size_t slot = (size_t)dedup->chunks[i].hash1 & (tableSize - 1);
+    while(table[slot] != 0) slot = (slot + 1) & (tableSize - 1);
+    table[slot] = (uint32_t)(i + 1);
+  }
+  free(dedup->table);
+  dedup->table = table;
+  dedup->tableSize = tableSize;
+}
+
+/**
+ * @see @file dedup.c / @function sealDedupPack
+ */
+unsigned char* sealDedupPack(ddp dedup, size_t *index, size_t *length) {
+  if(dedup->nbPacks == dedup->packsAllocated) {
+    dedup->packsAllocated = (dedup->packsAllocated > 0) ? 2 * dedup->packsAllocated : 64;
+    struct dedupPack *ptr = (struct dedupPack*)realloc(dedup->packs, dedup->packsAllocated * sizeof(struct dedupPack));
+    if(ptr == NULL) pointerAllocError();
+    dedup->packs = ptr;
+  }
+  *index = dedup->nbPacks++;
+  *length = dedup->packLength;
+  dedup->packs[*index].offset = -1;
+  dedup->packs[*index].storedSize = 0;
+  unsigned char *sealed = dedup->pack;
+  dedup->pack = (unsigned char*)malloc(HFM_DEDUP_PACK_SIZE);
+  if(dedup->pack == NULL) pointerAllocError();
+  dedup->packLength = 0;
+  return sealed;
+}
+
+/**
+ * @see @file dedup.c / @function writeDedupPack
+ */
+int writeDedupPack(ddp dedup, size_t index, unsigned char *pack, size_t length) {
+  size_t outSize = 0;
+  unsigned char *out = encryptBufferCached(dedup->cache, pack, length, dedup->checksums, &outSize);
+  free(pack);
+  long long offset = -1;
+  if(out != NULL) {
+    pthread_mutex_lock(dedup->archiveLock);
+    offset = (long long)ftello(dedup->archive);
+    if(offset >= 0 && fwrite(out, 1, outSize, dedup->archive) != outSize) offset = -1;
+    pthread_mutex_unlock(dedup->archiveLock);
+    free(out);
+  }
+  pthread_mutex_lock(&dedup->lock); // The packs may be reallocated by another thread
+  dedup->packs[index].offset = offset;
+  dedup->packs[index].storedSize = (long long)outSize;
+  if(offset < 0) dedup->failed = 1;
+  pthread_mutex_unlock(&dedup->lock);
+  return (offset >= 0) ? 0 : -1;
+}
+
+/**
+ * @see @file dedup.c / @function getDedupPackReader
+ */
+rdr getDedupPackReader(ddr reader, size_t pack) {
+  size_t oldest = 0;
+  for (size_t i = 0; i < HFM_DEDUP_OPEN_PACKS; i++) {
+    if(reader->readers[i] != NULL && reader->packs[i] == pack) {
+      reader->lastUse[i] = ++reader->clock;
+      return reader->readers[i];
+    }
+    if(reader->readers[i] == NULL || reader->lastUse[i] < reader->lastUse[oldest]) oldest = i;
+    if(reader->readers[i] == NULL) break;
+  }
+  closeReader(&reader->readers[oldest]);
+  struct dedupPack *packEntry = &reader->dedup->packs[pack];
+  FILE *file = fopen(reader->fileArchive, "rb");
+  if(file == NULL) {
+    perror(reader->fileArchive);
+    return NULL;
+  }
+  rdr packReader = NULL;
+  if(fseeko(file, (off_t)packEntry->offset, SEEK_SET) != 0 || (packReader = openReaderOfOpenedFile(file, NULL, HFM_READER_CACHE_BLOCKS)) == NULL) {
+    fclose(file);
+    return NULL;
+  }
+  if(getContainerIndexOffset(getReaderContainer(packReader)) > packEntry->offset + packEntry->storedSize) {
+    closeReader(&packReader); // Its index is out of the pack
+    return NULL;
+  }
+  reader->readers[oldest] = packReader;
+  reader->packs[oldest] = pack;
+  reader->lastUse[oldest] = ++reader->clock;
+  return packReader;
+}
+
+/* ========================================================================== */
+/* ========================================================================== */
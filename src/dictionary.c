@@ -0,0 +1,325 @@
+/**
+ * @file dictionary.c
+ * @author agent <agent@local>
+ * @standard C99
+ * @version 1.0
+ * @date 18th October 2026
+ *
+ * @brief Implementation file for the struct dictionary and the functions in
+ * "dictionary.h".
+ *
+ * This file implements the struct "dictionary" described in the file
+ * "dictionary.h", and the layout of the dictionary files.
+ *
+ * Overview about private functions of dictionary:
+ *  - isValidDictionary
+ *
+ * Overview about public functions of dictionary:
+ *  - trainDictionary
+ *  - loadDictionary
+ *  - destroyDictionary
+ *  - getDictionaryCode
+ *  - getDictionaryLength
+ *  - getDictionaryNode
+ *  - getDictionaryNbNodes
+ *  - dictionaryEncryptBound
+ *  - dictionaryEncrypt
+ *  - dictionaryDecrypt
+ *  - flattenTree
+ */
+
+#include "dictionary.h"
+#include "huffman.h" /**< Contains the construction of the huffman tree */
+#include <fcntl.h> /**< used for open */
+#include <unistd.h> /**< used for close */
+#include <sys/mman.h> /**< used for mmap and munmap */
+#include <sys/stat.h> /**< used for fstat */
+
+
+/* ================================================== */
+/* ==================== STRUCT DEF ================== */
+/* ========================================================================== */
+
+
+/**
+ * @struct dictionaryTables
+ * @brief The content of a dictionary file.
+ *
+ * The tables are written in the file as they are in memory, so that a mapped
+ * file can be used directly.
+ *
+ * In the flattened tree, a child greater or equal to 0 is the index of another
+ * node, and a negative child c is a leaf of the character -(c+1). The root is
+ * the node 0.
+ */
+struct dictionaryTables {
+  char magic[4]; /**< HFM_DICTIONARY_MAGIC */
+  uint32_t version; /**< HFM_DICTIONARY_VERSION */
+  uint32_t byteOrder; /**< 0x01020304 written by the machine that trained it */
+  uint32_t nbNodes; /**< Number of nodes used in 'nodes' */
+  uint32_t codes[256]; /**< Prefix of each character, in the lowest bits */
+  uint8_t lengths[256]; /**< Size of the prefix of each character */
+  int16_t nodes[256][2]; /**< Tree flattened: left and right child of a node */
+};
+
+/**
+ * @struct dictionary
+ * @brief A dictionary loaded in memory.
+ */
+struct dictionary {
+  struct dictionaryTables *tables; /**< Tables in the mapped file */
+  size_t mappedSize; /**< Size of the mapping */
+};
+
+
+/* ================================================== */
+/* ============== DEF PRIVATE FUNCTIONS ============= */
+/* ========================================================================== */
+
+
+/**
+ * @function isValidDictionary
+ * @brief Tells if mapped tables are a valid dictionary.
+ *
+ * Checks the magic, the version and the byte order, that every character has a
+ * prefix, and that the flattened tree can't lead outside of the array of nodes.
+ *
+ * @param{struct dictionaryTables*} tables: the tables.
+ *
+ * @return{int}: 1 if the dictionary is valid, 0 otherwise.
+ */
+int isValidDictionary(struct dictionaryTables *tables);
+
+
+/* ================================================== */
+/* ================ STRUCT FUNCTIONS ================ */
+/* ========================================================================== */
+
+
+/**
+ * @see @file dictionary.h / @function trainDictionary
+ */
+int trainDictionary(char **files, int nbFiles, char *fileDict) {
+  size_t histogram[256];
+  for (size_t c = 0; c < 256; c++) histogram[c] = 0;
+  for (int i = 0; i < nbFiles; i++) {
+    if(histogramOfFile(files[i], histogram) != 0) return -1;
+  }
+  for (size_t c = 0; c < 256; c++) histogram[c]++; // Every byte gets a prefix
+  nd tree = NULL;
+  int isTooDeep = 1;
+  while(isTooDeep) {
+    lst occurrences = occurrencesFromHistogram(histogram);
+    tree = contructBinaryTree(occurrences);
+    destroyList(&occurrences);
+    if(tree == NULL) return -1; // The 256 bytes always give a tree
+    isTooDeep = (getNodeDepth(tree) > HFM_DICTIONARY_MAX_LENGTH);
+    if(isTooDeep) {
+      // Flattening the occurrences shortens the longest prefixes
+      destroyNode(&tree);
+      for (size_t c = 0; c < 256; c++) histogram[c] = (histogram[c] + 1) / 2;
+    }
+  }
+  struct dictionaryTables *tables = (struct dictionaryTables*)calloc(1, sizeof(struct dictionaryTables));
+  int maxPrefixLength = 0;
+  lst prefixes = (tables != NULL) ? prefixesList(tree, &maxPrefixLength) : NULL;
+  if(prefixes == NULL) {
+    free(tables);
+    destroyNode(&tree);
+    return -1;
+  }
+  memcpy(tables->magic, HFM_DICTIONARY_MAGIC, 4);
+  tables->version = HFM_DICTIONARY_VERSION;
+  tables->byteOrder = 0x01020304;
+  tpl prefixTuple = NULL;
+  for (size_t i = 0; i < getListSize(prefixes); i++) {
+    prefixTuple = (tpl)getOfList(prefixes, i);
+    unsigned char c = *((unsigned char*)getTupleKey(prefixTuple));
+    char *prefix = (char*)getTupleValue(prefixTuple);
+    tables->lengths[c] = (uint8_t)strlen(prefix);
+    for (size_t j = 0; prefix[j] != '\0'; j++)
+      tables->codes[c] = (tables->codes[c] << 1) | (prefix[j] == '1');
+  }
+  destroyList(&prefixes);
+  flattenTree(tree, tables->nodes, &tables->nbNodes);
+  destroyNode(&tree);
+  int result = -1;
+  FILE *file = fopen(fileDict, "wb");
+  if(file != NULL) {
+    if(fwrite(tables, sizeof(struct dictionaryTables), 1, file) == 1) result = 0;
+    fclose(file);
+  }
+  if(result != 0) perror(fileDict);
+  free(tables);
+  return result;
+}
+
+/**
+ * @see @file dictionary.h / @function loadDictionary
+ */
+dct loadDictionary(char *fileDict) {
+  int fd = open(fileDict, O_RDONLY);
+  if(fd < 0) {
+    perror(fileDict);
+    return NULL;
+  }
+  struct stat fileStat;
+  void *mapped = MAP_FAILED;
+  if(fstat(fd, &fileStat) == 0 && (size_t)fileStat.st_size == sizeof(struct dictionaryTables))
+    mapped = mmap(NULL, sizeof(struct dictionaryTables), PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if(mapped == MAP_FAILED || !isValidDictionary((struct dictionaryTables*)mapped)) {
+    if(mapped != MAP_FAILED) munmap(mapped, sizeof(struct dictionaryTables));
+    printf("'%s' is not a valid dictionary file\n", fileDict);
+    return NULL;
+  }
+  dct dict = (dct)malloc(sizeof(struct dictionary));
+  if(dict == NULL) {
+    munmap(mapped, sizeof(struct dictionaryTables));
+    return NULL;
+  }
+  dict->tables = (struct dictionaryTables*)mapped;
+  dict->mappedSize = sizeof(struct dictionaryTables);
+  return dict;
+}
+
+/**
+ * @see @file dictionary.h / @function destroyDictionary
+ */
+void destroyDictionary(dct *dict) {
+  if(*dict != NULL) {
+    munmap((*dict)->tables, (*dict)->mappedSize);
+    free(*dict);
+    *dict = NULL;
+  }
+}
+
+
+/**
+ * @see @file dictionary.h / @function getDictionaryCode
+ */
+uint32_t getDictionaryCode(dct dict, size_t index) {
+  return dict->tables->codes[index];
+}
+
+/**
+ * @see @file dictionary.h / @function getDictionaryLength
+ */
+uint8_t getDictionaryLength(dct dict, size_t index) {
+  return dict->tables->lengths[index];
+}
+
+/**
+ * @see @file dictionary.h / @function getDictionaryNode
+ */
+int16_t getDictionaryNode(dct dict, size_t node, int bit) {
+  return dict->tables->nodes[node][bit];
+}
+
+/**
+ * @see @file dictionary.h / @function getDictionaryNbNodes
+ */
+uint32_t getDictionaryNbNodes(dct dict) {
+  return dict->tables->nbNodes;
+}
+
+
+/* ================================================== */
+/* ===================== PUBLIC ===================== */
+/* ========================================================================== */
+
+
+/**
+ * @see @file dictionary.h / @function dictionaryEncryptBound
+ */
+size_t dictionaryEncryptBound(dct dict, size_t size) {
+  size_t maxLength = 0;
+  for (size_t c = 0; c < 256; c++)
+    if(dict->tables->lengths[c] > maxLength) maxLength = dict->tables->lengths[c];
+  return (size * maxLength + 7) / 8;
+}
+
+/**
+ * @see @file dictionary.h / @function dictionaryEncrypt
+ */
+size_t dictionaryEncrypt(dct dict, unsigned char *message, size_t size, unsigned char *out, size_t outSize) {
+  struct dictionaryTables *tables = dict->tables;
+  uint64_t bits = 0;
+  unsigned int nbBits = 0;
+  size_t outIndex = 0;
+  for (size_t i = 0; i < size; i++) {
+    unsigned int length = tables->lengths[message[i]];
+    bits = (bits << length) | tables->codes[message[i]];
+    nbBits += length;
+    while(nbBits >= 8) {
+      nbBits -= 8;
+      if(outIndex < outSize) out[outIndex] = (unsigned char)(bits >> nbBits);
+      outIndex++;
+    }
+  }
+  if(nbBits > 0) { // Padding with 0, not read by the decryption
+    if(outIndex < outSize) out[outIndex] = (unsigned char)(bits << (8 - nbBits));
+    outIndex++;
+  }
+  return outIndex;
+}
+
+/**
+ * @see @file dictionary.h / @function dictionaryDecrypt
+ */
+size_t dictionaryDecrypt(dct dict, unsigned char *in, size_t size, unsigned char *out, size_t length) {
+  if(length == 0 || size == 0) return (length == 0 && size == 0) ? 0 : SIZE_MAX;
+  const int16_t (*nodes)[2] = (const int16_t (*)[2])dict->tables->nodes;
+  int16_t node = 0;
+  // The last prefix must end in the last byte, the bits after it being the padding
+  size_t outIndex = codecDecodeTree(nodes, 0, in, size - 1, &node, out, length);
+  if(outIndex == length) return SIZE_MAX;
+  outIndex += codecDecodeTree(nodes, 0, in + size - 1, 1, &node, out + outIndex, length - outIndex);
+  return (outIndex == length) ? length : SIZE_MAX;
+}
+
+/**
+ * @see @file dictionary.h / @function flattenTree
+ */
+int16_t flattenTree(nd node, int16_t (*nodes)[2], uint32_t *nbNodes) {
+  if(isLeafNode(node)) {
+    unsigned char c = *((unsigned char*)getTupleKey((tpl)getNodeTag(node)));
+    return (int16_t)(-c - 1);
+  }
+  uint32_t index = (*nbNodes)++;
+  int16_t left = flattenTree(getNodeLeft(node), nodes, nbNodes);
+  int16_t right = flattenTree(getNodeRight(node), nodes, nbNodes);
+  if(index < 256) {
+    nodes[index][0] = left;
+    nodes[index][1] = right;
+  }
+  return (int16_t)index;
+}
+
+
+/* ================================================== */
+/* ===================== PRIVATE ==================== */
+/* ========================================================================== */
+
+
+/**
+ * @see @file dictionary.c / @function isValidDictionary
+ */
+int isValidDictionary(struct dictionaryTables *tables) {
+  if(memcmp(tables->magic, HFM_DICTIONARY_MAGIC, 4) != 0 || tables->version != HFM_DICTIONARY_VERSION
+     || tables->byteOrder != 0x01020304 || tables->nbNodes == 0 || tables->nbNodes > 256)
+    return 0;
+  for (size_t i = 0; i < tables->nbNodes; i++) {
+    for (size_t j = 0; j < 2; j++) {
+      int16_t child = tables->nodes[i][j];
+      if(child >= (int16_t)tables->nbNodes || child < -256 || child == 0) return 0;
+    }
+  }
+  for (size_t c = 0; c < 256; c++)
+    if(tables->lengths[c] == 0 || tables->lengths[c] > HFM_DICTIONARY_MAX_LENGTH) return 0;
+  return 1;
+}
+
+
+/* ========================================================================== */
+/* ========================================================================== */
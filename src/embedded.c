@@ -0,0 +1,266 @@
+/**
+ * @file embedded.c
+ * @author agent <agent@local>
+ * @standard C99
+ * @version 1.0
+ * @date 18th October 2026
+ *
+ * @brief Implementation file for "embedded.h"
+ *
+ * This file implements the generation of the code tables as C headers, and the
+ * encoder and the decoder specialized for the table compiled in the program
+ * (the header given by HFM_EMBEDDED_TABLE).
+ *
+ * Overview about private functions of embedded:
+ *  - tablesFromKey
+ *  - tablesFromDictionary
+ *  - writeTables
+ *
+ * Overview about public functions of embedded:
+ *  - generateEmbeddedTable
+ *  - hasEmbeddedTable
+ *  - embeddedEncodeBlock (only with HFM_EMBEDDED_TABLE)
+ *  - embeddedDecodeBlock (only with HFM_EMBEDDED_TABLE)
+ *  - huffmanEncryptFileEmbedded (only with HFM_EMBEDDED_TABLE)
+ *  - huffmanDecryptFileEmbedded (only with HFM_EMBEDDED_TABLE)
+ */
+
+#include "embedded.h"
+
+#ifdef HFM_EMBEDDED_TABLE
+#include HFM_EMBEDDED_TABLE
+#endif
+
+
+/**
+ * @struct embeddedTables
+ * @brief The tables written in a generated header.
+ */
+struct embeddedTables {
+  uint64_t codes[256]; /**< Prefix of each character, in the lowest bits */
+  uint8_t lengths[256]; /**< Size of each prefix */
+  uint8_t hasCode[256]; /**< 1 if the character has a prefix */
+  int16_t nodes[256][2]; /**< The flattened tree (@see flattenTree) */
+  uint32_t nbNodes; /**< Number of nodes of the tree */
+  int16_t root; /**< 0, or the leaf if the tree is a single character */
+};
+
+
+/* ================================================== */
+/* ============== DEF PRIVATE FUNCTIONS ============= */
+/* ========================================================================== */
+
+
+/**
+ * @function tablesFromKey
+ * @brief Builds the tables of a key file.
+ *
+ * @param{char*} fileKey: name of the key file, that can be opened.
+ * @param{struct embeddedTables*} tables: the tables to fill.
+ *
+ * @return{int}: 0 if the tables are built, -1 otherwise.
+ */
+int tablesFromKey(char *fileKey, struct embeddedTables *tables);
+
+/**
+ * @function tablesFromDictionary
+ * @brief Builds the tables of a dictionary file.
+ *
+ * @param{char*} fileDict: name of the dictionary file.
+ * @param{struct embeddedTables*} tables: the tables to fill.
+ *
+ * @return{int}: 0 if the tables are built, -1 otherwise.
+ */
+int tablesFromDictionary(char *fileDict, struct embeddedTables *tables);
+
+/**
+ * @function writeTables
+ * @brief Writes the tables as a C header.
+ *
+ * @param{FILE*} fileOut: the file already opened.
+ * @param{char*} source: name of the key the tables come from.
+ * @param{struct embeddedTables*} tables: the tables.
+ *
+ * @return{void}
+ */
+void writeTables(FILE *fileOut, char *source, struct embeddedTables *tables);
+
+
+/* ================================================== */
+/* ===================== PUBLIC ===================== */
+/* ========================================================================== */
+
+
+/**
+ * @see @file embedded.h / @function generateEmbeddedTable
+ */
+int generateEmbeddedTable(char *fileKey, FILE *fileOut) {
+  FILE *file = fopen(fileKey, "rb");
+  if(file == NULL) {
+    perror(fileKey);
+    return -1;
+  }
+  char magic[4] = {0};
+  int isDictionary = fread(magic, 1, 4, file) == 4 && memcmp(magic, HFM_DICTIONARY_MAGIC, 4) == 0;
+  fclose(file);
+  struct embeddedTables *tables = (struct embeddedTables*)calloc(1, sizeof(struct embeddedTables));
+  if(tables == NULL) return -1;
+  int result = isDictionary ? tablesFromDictionary(fileKey, tables) : tablesFromKey(fileKey, tables);
+  if(result == 0) writeTables(fileOut, fileKey, tables);
+  free(tables);
+  return result;
+}
+
+/**
+ * @see @file embedded.h / @function hasEmbeddedTable
+ */
+int hasEmbeddedTable() {
+#ifdef HFM_EMBEDDED_TABLE
+  return 1;
+#else
+  return 0;
+#endif
+}
+
+#ifdef HFM_EMBEDDED_TABLE
+
+/**
+ * @see @file embedded.h / @function embeddedEncodeBlock
+ */
+size_t embeddedEncodeBlock(unsigned char *block, size_t size, unsigned char *out, void *context) {
+  (void)context;
+  size_t nbBits = 0;
+  for (size_t i = 0; i < size; i++) {
+    if(!HFM_EMBEDDED_HAS_CODE[block[i]]) return SIZE_MAX;
+    nbBits += HFM_EMBEDDED_LENGTHS[block[i]];
+  }
+  if((nbBits + 7) / 8 >= size) return SIZE_MAX;
+  uint64_t bits = 0; // Bits not written yet, in the lowest bits
+  unsigned int nbPending = 0;
+  size_t outIndex = 0;
+  for (size_t i = 0; i < size; i++) {
+    bits = (bits << HFM_EMBEDDED_LENGTHS[block[i]]) | HFM_EMBEDDED_CODES[block[i]];
+    nbPending += HFM_EMBEDDED_LENGTHS[block[i]];
+    while(nbPending >= 8) {
+      nbPending -= 8;
+      out[outIndex++] = (unsigned char)(bits >> nbPending);
+    }
+  }
+  if(nbPending > 0) out[outIndex++] = (unsigned char)(bits << (8 - nbPending));
+  return outIndex;
+}
+
+/**
+ * @see @file embedded.h / @function embeddedDecodeBlock
+ */
+size_t embeddedDecodeBlock(unsigned char *payload, size_t size, unsigned char *out, size_t length, void *context) {
+  (void)context;
+  if(length > HFM_BLOCK_SIZE) return SIZE_MAX;
+  if(HFM_EMBEDDED_ROOT >= 0 && HFM_EMBEDDED_NB_NODES == 0) return SIZE_MAX; // The table codes nothing
+  return codecDecodeTreeBlock(HFM_EMBEDDED_NODES, HFM_EMBEDDED_ROOT, payload, size, out, length);
+}
+
+/**
+ * @see @file embedded.h / @function huffmanEncryptFileEmbedded
+ */
+int huffmanEncryptFileEmbedded(char *fileIn, char *fileOut, unsigned int checksums) {
+  if(encryptBlocksOfFile(fileIn, fileOut, NULL, checksums, embeddedEncodeBlock, NULL) != 0) return -1;
+  printf("Encryption process completed\n");
+  return 0;
+}
+
+/**
+ * @see @file embedded.h / @function huffmanDecryptFileEmbedded
+ */
+int huffmanDecryptFileEmbedded(char *fileIn, char *fileOut) {
+  int result = decryptBlocksOfFile(fileIn, fileOut, embeddedDecodeBlock, NULL);
+  if(result == 0) printf("Decryption process completed\n");
+  else if(result == -2) fprintf(stderr, "Decryption failed: '%s' is corrupted\n", fileIn);
+  else if(result == -3) fprintf(stderr, "Decryption failed: '%s' does not match its checksums\n", fileIn);
+  return result;
+}
+
+#endif
+
+
+/* ================================================== */
+/* ===================== PRIVATE ==================== */
+/* ========================================================================== */
+
+
+/**
+ * @see @file embedded.c / @function tablesFromKey
+ */
+int tablesFromKey(char *fileKey, struct embeddedTables *tables) {
+  nd tree = getTreeFromKeyFile(fileKey);
+  if(tree == NULL) return (getFileSize(fileKey) > 0) ? -1 : 0; // An empty key codes nothing
+  int maxPrefixLength = 0;
+  lst prefixes = prefixesList(tree, &maxPrefixLength);
+  if(prefixes == NULL) {
+    destroyNode(&tree);
+    return -1;
+  }
+  if(maxPrefixLength > HFM_EMBEDDED_MAX_LENGTH) {
+    fprintf(stderr, "%s: prefixes of %d bits can't be embedded\n", fileKey, maxPrefixLength);
+    destroyList(&prefixes);
+    destroyNode(&tree);
+    return -1;
+  }
+  for (size_t i = 0; i < getListSize(prefixes); i++) {
+    tpl tuple = (tpl)getOfList(prefixes, i);
+    unsigned char c = *((unsigned char*)getTupleKey(tuple));
+    char *prefix = (char*)getTupleValue(tuple);
+    tables->hasCode[c] = 1;
+    tables->lengths[c] = (uint8_t)strlen(prefix);
+    for (size_t j = 0; prefix[j] != '\0'; j++)
+      tables->codes[c] = (tables->codes[c] << 1) | (prefix[j] == '1');
+  }
+  destroyList(&prefixes);
+  tables->root = flattenTree(tree, tables->nodes, &tables->nbNodes);
+  destroyNode(&tree);
+  return 0;
+}
+
+/**
+ * @see @file embedded.c / @function tablesFromDictionary
+ */
+int tablesFromDictionary(char *fileDict, struct embeddedTables *tables) {
+  dct dict = loadDictionary(fileDict);
+  if(dict == NULL) return -1;
+  for (size_t c = 0; c < 256; c++) {
+    tables->codes[c] = getDictionaryCode(dict, c);
+    tables->lengths[c] = getDictionaryLength(dict, c);
+    tables->hasCode[c] = (tables->lengths[c] > 0);
+  }
+  tables->nbNodes = getDictionaryNbNodes(dict);
+  for (size_t i = 0; i < tables->nbNodes; i++)
+    for (int bit = 0; bit < 2; bit++) tables->nodes[i][bit] = getDictionaryNode(dict, i, bit);
+  destroyDictionary(&dict);
+  return 0;
+}
+
+/**
+ * @see @file embedded.c / @function writeTables
+ */
+void writeTables(FILE *fileOut, char *source, struct embeddedTables *tables) {
+  fprintf(fileOut, "/* Code table generated by \"huffman_exec gen-table %s\" */\n\n", source);
+  fprintf(fileOut, "#define HFM_EMBEDDED_NB_NODES %u\n", (unsigned int)tables->nbNodes);
+  fprintf(fileOut, "#define HFM_EMBEDDED_ROOT (%d)\n\n", tables->root);
+  fprintf(fileOut, "static const uint64_t HFM_EMBEDDED_CODES[256] = {");
+  for (size_t c = 0; c < 256; c++)
+    fprintf(fileOut, "%s0x%llx,", (c % 8 == 0) ? "\n  " : " ", (unsigned long long)tables->codes[c]);
+  fprintf(fileOut, "\n};\n\nstatic const uint8_t HFM_EMBEDDED_LENGTHS[256] = {");
+  for (size_t c = 0; c < 256; c++)
+    fprintf(fileOut, "%s%u,", (c % 16 == 0) ? "\n  " : " ", (unsigned int)tables->lengths[c]);
+  fprintf(fileOut, "\n};\n\nstatic const uint8_t HFM_EMBEDDED_HAS_CODE[256] = {");
+  for (size_t c = 0; c < 256; c++)
+    fprintf(fileOut, "%s%u,", (c % 16 == 0) ? "\n  " : " ", (unsigned int)tables->hasCode[c]);
+  fprintf(fileOut, "\n};\n\nstatic const int16_t HFM_EMBEDDED_NODES[256][2] = {");
+  if(tables->nbNodes == 0) fprintf(fileOut, "\n  {0, 0},");
+  for (size_t i = 0; i < tables->nbNodes; i++)
+    fprintf(fileOut, "%s{%d, %d},", (i % 6 == 0) ? "\n  " : " ", tables->nodes[i][0], tables->nodes[i][1]);
+  fprintf(fileOut, "\n};\n");
+}
+
+/* ========================================================================== */
+/* ========================================================================== */
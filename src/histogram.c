@@ -0,0 +1,198 @@
+/**
+ * @file histogram.c
+ * @author agent <agent@local>
+ * @standard C99
+ * @version 1.0
+ * @date 18th October 2026
+ *
+ * @brief Implementation file for "histogram.h"
+ *
+ * This file implements the reading, the saving and the merging of the
+ * histograms of files.
+ *
+ * Overview about private functions of histogram:
+ *  - writeVarint
+ *  - readVarint
+ *
+ * Overview about public functions of histogram:
+ *  - histogramOfFile
+ *  - saveHistogramInFile
+ *  - loadHistogramFromFile
+ *  - mergeHistogramFiles
+ *  - writeHistogramInOpenedFile
+ *  - readHistogramFromOpenedFile
+ *  - histogramEncodedSize
+ */
+
+#include "histogram.h"
+
+
+/* ================================================== */
+/* ============== DEF PRIVATE FUNCTIONS ============= */
+/* ========================================================================== */
+
+
+/**
+ * @function writeVarint
+ * @brief Writes an integer with a variable length in a file.
+ *
+ * The integer is written 7 bits per byte, lowest bits first, the high bit of
+ * each byte being set if another byte follows.
+ *
+ * @param{FILE*} file: the file already opened.
+ * @param{size_t} value: the integer.
+ *
+ * @return{void}
+ */
+void writeVarint(FILE *file, size_t value);
+
+/**
+ * @function readVarint
+ * @brief Reads an integer written by writeVarint.
+ *
+ * @param{FILE*} file: the file already opened.
+ * @param{size_t*} value: receives the integer.
+ *
+ * @return{int}: 0 if the integer has been read, -1 otherwise.
+ */
+int readVarint(FILE *file, size_t *value);
+
+
+/* ================================================== */
+/* ===================== PUBLIC ===================== */
+/* ========================================================================== */
+
+
+/**
+ * @see @file histogram.h / @function histogramOfFile
+ */
+int histogramOfFile(char *srcFile, size_t *histogram) {
+  FILE *file = fopen(srcFile, "rb");
+  if(file != NULL) {
+    unsigned char buffer[4096];
+    size_t size;
+    while((size = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+      for(size_t i = 0; i < size; i++) histogram[buffer[i]]++;
+    }
+    fclose(file);
+    return 0;
+  }
+  perror(srcFile);
+  return -1;
+}
+
+/**
+ * @see @file histogram.h / @function saveHistogramInFile
+ */
+int saveHistogramInFile(size_t *histogram, char *fileHist) {
+  FILE *file = fopen(fileHist, "wb");
+  if(file != NULL) {
+    fwrite(HFM_HISTOGRAM_MAGIC, 1, strlen(HFM_HISTOGRAM_MAGIC), file);
+    fputc(HFM_HISTOGRAM_VERSION, file);
+    writeHistogramInOpenedFile(file, histogram);
+    fclose(file);
+    return 0;
+  }
+  perror(fileHist);
+  return -1;
+}
+
+/**
+ * @see @file histogram.h / @function loadHistogramFromFile
+ */
+int loadHistogramFromFile(char *fileHist, size_t *histogram) {
+  FILE *file = fopen(fileHist, "rb");
+  if(file != NULL) {
+    char magic[4];
+    int valid = fread(magic, 1, 4, file) == 4 && !memcmp(magic, HFM_HISTOGRAM_MAGIC, 4)
+                && fgetc(file) == HFM_HISTOGRAM_VERSION
+                && readHistogramFromOpenedFile(file, histogram) == 0;
+    fclose(file);
+    if(!valid) printf("'%s' is not a valid histogram file\n", fileHist);
+    return valid ? 0 : -1;
+  }
+  perror(fileHist);
+  return -1;
+}
+
+/**
+ * @see @file histogram.h / @function mergeHistogramFiles
+ */
+int mergeHistogramFiles(char **filesHist, int nbFiles, char *fileOut) {
+  size_t histogram[256];
+  for (size_t c = 0; c < 256; c++) histogram[c] = 0;
+  for (int i = 0; i < nbFiles; i++) {
+    if(loadHistogramFromFile(filesHist[i], histogram) != 0) return -1;
+  }
+  return saveHistogramInFile(histogram, fileOut);
+}
+
+/**
+ * @see @file histogram.h / @function writeHistogramInOpenedFile
+ */
+void writeHistogramInOpenedFile(FILE *file, size_t *histogram) {
+  for (size_t c = 0; c < 256; c++) writeVarint(file, histogram[c]);
+}
+
+/**
+ * @see @file histogram.h / @function readHistogramFromOpenedFile
+ */
+int readHistogramFromOpenedFile(FILE *file, size_t *histogram) {
+  size_t value = 0;
+  for (size_t c = 0; c < 256; c++) {
+    if(readVarint(file, &value) != 0) return -1;
+    histogram[c] += value;
+  }
+  return 0;
+}
+
+/**
+ * @see @file histogram.h / @function histogramEncodedSize
+ */
+size_t histogramEncodedSize(size_t *histogram) {
+  size_t size = 0;
+  for (size_t c = 0; c < 256; c++) {
+    size_t value = histogram[c];
+    do {
+      size++;
+      value >>= 7;
+    } while(value > 0);
+  }
+  return size;
+}
+
+
+/* ================================================== */
+/* ===================== PRIVATE ==================== */
+/* ========================================================================== */
+
+
+/**
+ * @see @file histogram.c / @function writeVarint
+ */
+void writeVarint(FILE *file, size_t value) {
+  while(value >= 0x80) {
+    fputc((int)(value & 0x7F) | 0x80, file);
+    value >>= 7;
+  }
+  fputc((int)value, file);
+}
+
+/**
+ * @see @file histogram.c / @function readVarint
+ */
+int readVarint(FILE *file, size_t *value) {
+  int c;
+  unsigned int shift = 0;
+  *value = 0;
+  while((c = fgetc(file)) != EOF && shift < 64) {
+    *value |= (size_t)(c & 0x7F) << shift;
+    if((c & 0x80) == 0) return 0;
+    shift += 7;
+  }
+  return -1;
+}
+
+
+/* ========================================================================== */
+/* ========================================================================== */
@@ -24,18 +24,42 @@
  * Overview about public functions of the file huffman:
  *    - huffmanEncrypt
  *    - huffmanEncryptFile
+ *    - huffmanEncryptFileSampled
+ *    - huffmanEncryptFileWithKey
+ *    - huffmanResumeEncryptFile
+ *    - huffmanKeyFromHistogramFile
  *    - huffmanDecrypt
  *    - huffmanDecryptStr
  *    - huffmanDecryptFile
+ *    - huffmanResumeDecryptFile
  *    - getEncryptionOf
  *    - makeCharactersFromBits
  *    - writeEncryptionInFile
+ *    - encryptBlocksOfFile
+ *    - resumeEncryptBlocksOfFile
+ *    - writeBlockOfOpenedFile
+ *    - encryptBufferInOpenedFile
+ *    - encryptBufferInMemory
+ *    - encryptBufferWithCodesInMemory
+ *    - decryptBufferInMemory
  *    - saveKeyInFile
  *    - getDecryptionOf
  *    - writeDecryptionInFile
+ *    - decryptBlocksOfFile
+ *    - resumeDecryptBlocksOfFile
+ *    - decryptBlocksOfOpenedFile
+ *    - readBlockOfOpenedFile
+ *    - writeTableBlockOfOpenedFile
+ *    - readTableBlockOfOpenedFile
  *    - getTreeFromKeyFile
+ *    - getHistogramFromKeyFile
+ *    - getTreeFromContainer
+ *    - getTreeFromHistogram
  *    - charOccurrencesOfStr
  *    - charOccurrencesOfFile
+ *    - charOccurrencesOfFileSampled
+ *    - occurrencesFromHistogram
+ *    - histogramOfOccurrences
  *    - contructBinaryTree
  *    - mergeTwoSmallerNodes
  *    - mergeNodes
@@ -44,9 +68,41 @@
  *    - getTupleInListByKey
  *    - weightNode
  *    - writeBitsInOpenedFile
+ *    - prefixesTable
+ *    - estimateCodedSize
+ *    - encodeBlock
+ *    - decodeBlock
+ *    - encodeBlockWithCodes
+ *    - decodeBlockWithTree
+ *    - copyStoredBlock
+ *    - estimateEncryptionOfFile
+ *
+ * Overview about private functions of the file huffman:
+ *    - isCodingWorthIt
+ *    - writeEncryptionWithTable
+ *    - writeBufferWithCodes
+ *    - encryptInMemory
+ *    - writeBlocksWithCheckpoints
+ *    - decryptBlocksWithCheckpoints
+ *    - decryptBlocksFromCheckpoint
+ *    - decryptFileWithTree
+ *    - readBlockToEncrypt
+ *    - encodePipelineBlock
+ *    - writeEncryptedBlock
+ *    - readBlockToDecrypt
+ *    - decodePipelineBlock
+ *    - writeDecryptedBlock
+ *    - readBlockHeaderInOpenedFile
+ *    - writeBlockInOpenedFile
+ *    - writeCodedBlockInOpenedFile
+ *    - keySizeOf
  */
 
+#define _GNU_SOURCE /**< copy_file_range, fseeko and ftello */
 #include "huffman.h"
+#ifdef __linux__
+#include <unistd.h> /**< used for copy_file_range */
+#endif
 
 
 /* ================================================== */
@@ -67,6 +123,312 @@ struct huffman {
   char *encryption; /**< The encrypted string of characters */
 };
 
+/**
+ * @struct encryptionStages
+ * @brief The state of the stages of the pipeline of an encryption.
+ *
+ * Each member is used by one stage only (@see @file pipeline.h).
+ */
+struct encryptionStages {
+  FILE *fileIn; /**< The file to encrypt, read by the reader */
+  FILE *fileOut; /**< The ".hfm" file, written by the writer */
+  ctn container; /**< The header and the index of fileOut, for the writer */
+  ckp checkpoint; /**< Checkpoint written by the writer, NULL for none */
+  long long inputOffset; /**< Offset in fileIn after the blocks written */
+  size_t(*encode)(unsigned char *block, size_t size, unsigned char *out, void *context); /**< Function used by the coder */
+  void *context; /**< Context given to 'encode' */
+};
+
+/**
+ * @struct decryptionStages
+ * @brief The state of the stages of the pipeline of a decryption.
+ *
+ * The container is only read, by the three stages.
+ */
+struct decryptionStages {
+  FILE *fileIn; /**< The ".hfm" file, read by the reader */
+  FILE *fileOut; /**< The file to write, written by the writer */
+  ctn container; /**< The header and the index of fileIn */
+  ckp checkpoint; /**< Checkpoint written by the writer, NULL for none */
+  size_t first; /**< Index of the first block to decrypt */
+  uint32_t checksum; /**< CRC32C of the data written, for the writer */
+  nd tableTree; /**< Tree of the last table block, NULL to use 'decode' */
+  size_t(*decode)(unsigned char *payload, size_t size, unsigned char *out, size_t length, void *context); /**< Function used by the coder */
+  void *context; /**< Context given to 'decode' */
+};
+
+
+/* ================================================== */
+/* ============== DEF PRIVATE FUNCTIONS ============= */
+/* ========================================================================== */
+
+
+/**
+ * @function isCodingWorthIt
+ * @brief Tells if the huffman coding makes a file smaller.
+ *
+ * Estimates from the occurrences and the prefixes the size of the encryption of
+ * a file (blocks headers and code table included), and compares it with the
+ * size of the file stored raw.
+ *
+ * @param{lst} occurrences: occurrences of the characters of the file.
+ * @param{lst} prefixes: prefixes of the characters.
+ * @param{long long} fileSize: size of the file.
+ * @param{size_t} tableSize: size of the code table (in the header or in the
+ *                           key file).
+ *
+ * @return{int}: 1 if the coding is worth it, 0 otherwise.
+ */
+int isCodingWorthIt(lst occurrences, lst prefixes, long long fileSize, size_t tableSize);
+
+/**
+ * @function writeEncryptionWithTable
+ * @brief Writes the encryption in a file, with the code table in its header.
+ * @see @function writeEncryptionInFile
+ *
+ * @param{char*} fileIn: name of the file we want to encrypt.
+ * @param{char*} fileOut: name of the file to write.
+ * @param{lst} prefixes: list of prefixes (NULL to store every block).
+ * @param{size_t*} histogram: code table written in the header, NULL if it is
+ *                            in a separate key file.
+ * @param{unsigned int} checksums: checksums to write (@see @function
+ *                                 encryptBlocksOfFile).
+ *
+ * @return{int}: 0 if the file has been encrypted, -1 otherwise.
+ */
+int writeEncryptionWithTable(char *fileIn, char *fileOut, lst prefixes, size_t *histogram, unsigned int checksums);
+
+/**
+ * @function writeBufferWithCodes
+ * @brief Writes a whole ".hfm" file of data in memory, with given codes.
+ * @see @function encryptBufferInOpenedFile
+ *
+ * @param{unsigned char*} data: the data to encrypt.
+ * @param{size_t} size: size of the data.
+ * @param{FILE*} fileOut: the file to write, already opened.
+ * @param{size_t*} histogram: code table written in the header, NULL if it is
+ *                            in a separate key file.
+ * @param{char**} codes: code of each character (NULL to store the block).
+ * @param{unsigned int} checksums: checksums to write.
+ *
+ * @return{int}: 0 if the data has been written, -1 otherwise.
+ */
+int writeBufferWithCodes(unsigned char *data, size_t size, FILE *fileOut, size_t *histogram, char **codes, unsigned int checksums);
+
+/**
+ * @function encryptInMemory
+ * @brief Writes a ".hfm" file of data in memory, in memory.
+ * @see @function encryptBufferInMemory
+ *
+ * @param{unsigned char*} data: the data to encrypt.
+ * @param{size_t} size: size of the data.
+ * @param{char**} codes: code of each character, NULL for a code table made
+ *                       from the data and written in the header.
+ * @param{unsigned int} checksums: checksums to write.
+ * @param{size_t*} outSize: receives the size of the ".hfm" file.
+ *
+ * @return{unsigned char*}: the ".hfm" file, to free, NULL if it can't be
+ *                          written.
+ */
+unsigned char* encryptInMemory(unsigned char *data, size_t size, char **codes, unsigned int checksums, size_t *outSize);
+
+/**
+ * @function writeBlocksWithCheckpoints
+ * @brief Writes the blocks of a file from its current position, and the index.
+ * @see @function encryptBlocksOfFile
+ *
+ * @param{FILE*} fileIn: the file to encrypt.
+ * @param{FILE*} fileOut: the ".hfm" file, after the header or the last block.
+ * @param{ctn} container: the header and the index of fileOut.
+ * @param{ckp} checkpoint: the checkpoint written every HFM_CHECKPOINT_BLOCKS
+ *                         blocks, NULL for none.
+ * @param{size_t()} encode: function coding the blocks.
+ * @param{void*} context: context given to 'encode'.
+ *
+ * @return{int}: 0 if the file has been written, -1 otherwise.
+ */
+int writeBlocksWithCheckpoints(FILE *fileIn, FILE *fileOut, ctn container, ckp checkpoint, size_t(*encode)(unsigned char *block, size_t size, unsigned char *out, void *context), void *context);
+
+/**
+ * @function decryptBlocksWithCheckpoints
+ * @brief Decrypts a file, writing checkpoints or resuming from them.
+ * @see @function decryptBlocksOfFile
+ *
+ * @param{char*} fileIn: name of the file we want to decrypt.
+ * @param{char*} fileOut: name of the file to write.
+ * @param{int} resume: 1 to resume an interrupted decryption, 0 to start.
+ * @param{size_t()} decode: function decoding the huffman blocks.
+ * @param{void*} context: context given to 'decode'.
+ *
+ * @return{int}: same as decryptBlocksOfFile.
+ */
+int decryptBlocksWithCheckpoints(char *fileIn, char *fileOut, int resume, size_t(*decode)(unsigned char *payload, size_t size, unsigned char *out, size_t length, void *context), void *context);
+
+/**
+ * @function decryptBlocksFromCheckpoint
+ * @brief Writes the blocks of an encrypted file already opened, from the last
+ * block of a checkpoint.
+ * @see @function decryptBlocksOfOpenedFile
+ *
+ * @param{FILE*} fileIn: the ".hfm" file.
+ * @param{FILE*} fileOut: the file to write.
+ * @param{ctn} container: the header and the index of fileIn.
+ * @param{ckp} checkpoint: the checkpoint to resume from and to update every
+ *                         HFM_CHECKPOINT_BLOCKS blocks, NULL for none.
+ * @param{size_t()} decode: function decoding the huffman blocks.
+ * @param{void*} context: context given to 'decode'.
+ *
+ * @return{int}: 0 if the file has been decrypted, -1 if fileOut can't be
+ *               written, -2 if fileIn is corrupted, -3 if a checksum does not
+ *               match.
+ */
+int decryptBlocksFromCheckpoint(FILE *fileIn, FILE *fileOut, ctn container, ckp checkpoint, size_t(*decode)(unsigned char *payload, size_t size, unsigned char *out, size_t length, void *context), void *context);
+
+/**
+ * @function decryptFileWithTree
+ * @brief Decrypts a file with the tree of its header or of its key.
+ * @see @function huffmanDecryptFile
+ *
+ * @param{char*} fileIn: name of the file we want to decrypt.
+ * @param{char*} fileOut: name of the file to write.
+ * @param{char*} fileKey: name of the key file, only read if fileIn has no code
+ *                        table.
+ * @param{int} resume: 1 to resume an interrupted decryption, 0 to start.
+ *
+ * @return{int}: same as decryptBlocksOfFile.
+ */
+int decryptFileWithTree(char *fileIn, char *fileOut, char *fileKey, int resume);
+
+/**
+ * @function readBlockToEncrypt
+ * @brief Reader stage of an encryption: reads a block of the file.
+ *
+ * @param{pbk} block: the block to fill.
+ * @param{void*} stages: the struct encryptionStages.
+ *
+ * @return{int}: 0 if a block has been read, 1 at the end of the file, -1 if
+ *               the file can't be read.
+ */
+int readBlockToEncrypt(pbk block, void *stages);
+
+/**
+ * @function encodePipelineBlock
+ * @brief Coder stage of an encryption: codes a block.
+ *
+ * @param{pbk} block: the block read.
+ * @param{void*} stages: the struct encryptionStages.
+ *
+ * @return{int}: 0.
+ */
+int encodePipelineBlock(pbk block, void *stages);
+
+/**
+ * @function writeEncryptedBlock
+ * @brief Writer stage of an encryption: writes a block, coded or stored if
+ * the coding doesn't make it smaller, and the checkpoints.
+ *
+ * @param{pbk} block: the block coded.
+ * @param{void*} stages: the struct encryptionStages.
+ *
+ * @return{int}: 0 if the block has been written, -1 otherwise.
+ */
+int writeEncryptedBlock(pbk block, void *stages);
+
+/**
+ * @function readBlockToDecrypt
+ * @brief Reader stage of a decryption: reads the payload of a block.
+ *
+ * The kind of the block is its type. The histogram of a table block is read
+ * in the data of the block (its size is 0 for the table of the header or the
+ * key), the tree being made by the coder which uses it.
+ *
+ * @param{pbk} block: the block to fill.
+ * @param{void*} stages: the struct decryptionStages.
+ *
+ * @return{int}: 0 if a block has been read, 1 after the last block, -2 if the
+ *               file is corrupted.
+ */
+int readBlockToDecrypt(pbk block, void *stages);
+
+/**
+ * @function decodePipelineBlock
+ * @brief Coder stage of a decryption: decodes a block and checks its CRC32C.
+ *
+ * @param{pbk} block: the block read.
+ * @param{void*} stages: the struct decryptionStages.
+ *
+ * @return{int}: 0 if the block is valid, -2 if it is corrupted, -3 if it
+ *               doesn't match its checksum.
+ */
+int decodePipelineBlock(pbk block, void *stages);
+
+/**
+ * @function writeDecryptedBlock
+ * @brief Writer stage of a decryption: writes a block and the checkpoints.
+ *
+ * @param{pbk} block: the block decoded.
+ * @param{void*} stages: the struct decryptionStages.
+ *
+ * @return{int}: 0 if the block has been written, -1 otherwise.
+ */
+int writeDecryptedBlock(pbk block, void *stages);
+
+/**
+ * @function readBlockHeaderInOpenedFile
+ * @brief Reads the header of a block and checks it against the block index.
+ *
+ * @param{FILE*} fileIn: the ".hfm" file, positioned at the block.
+ * @param{ctn} container: the header and the index of fileIn.
+ * @param{size_t} index: index of the block.
+ * @param{char*} type: receives HFM_BLOCK_STORED or HFM_BLOCK_HUFFMAN.
+ *
+ * @return{int}: 0 if the header matches the index, -2 otherwise.
+ */
+int readBlockHeaderInOpenedFile(FILE *fileIn, ctn container, size_t index, char *type);
+
+/**
+ * @function writeBlockInOpenedFile
+ * @brief Writes a block (header and payload) in a file.
+ *
+ * @param{FILE*} fileW: the file already opened.
+ * @param{char} type: type of the block (HFM_BLOCK_STORED, HFM_BLOCK_HUFFMAN
+ *                     or HFM_BLOCK_TABLE).
+ * @param{unsigned char*} payload: the payload of the block, NULL if the caller
+ *                                 writes it after the header.
+ * @param{size_t} size: size of the payload.
+ * @param{size_t} length: size of the original block.
+ *
+ * @return{void}
+ */
+void writeBlockInOpenedFile(FILE *fileW, char type, unsigned char *payload, size_t size, size_t length);
+
+/**
+ * @function writeCodedBlockInOpenedFile
+ * @brief Writes a block coded, or stored if the coding doesn't make it
+ * smaller, and adds it to the index.
+ *
+ * @param{FILE*} fileOut: the ".hfm" file.
+ * @param{ctn} container: the header and the index of fileOut.
+ * @param{unsigned char*} block: the original block.
+ * @param{size_t} size: size of the block.
+ * @param{unsigned char*} payload: the block coded.
+ * @param{size_t} payloadSize: size of the block coded.
+ *
+ * @return{void}
+ */
+void writeCodedBlockInOpenedFile(FILE *fileOut, ctn container, unsigned char *block, size_t size, unsigned char *payload, size_t payloadSize);
+
+/**
+ * @function keySizeOf
+ * @brief Returns the size of the key file written for some occurrences.
+ *
+ * @param{lst} occurrences: the occurrences (@see @function saveKeyInFile).
+ *
+ * @return{size_t}: size of the key file in bytes.
+ */
+size_t keySizeOf(lst occurrences);
+
+
 
 /* ================================================== */
 /* ================ STRUCT FUNCTIONS ================ */
@@ -78,6 +440,7 @@ struct huffman {
  */
 hfm createHuffman(){
   hfm newHuffman = (hfm)malloc(sizeof(struct huffman));
+  if(newHuffman == NULL) return NULL;
   newHuffman->encryption = NULL;
   newHuffman->tree = NULL;
   return newHuffman;
@@ -88,6 +451,7 @@ hfm createHuffman(){
  */
 hfm createDefinedHuffman(char *str, nd tree){
   hfm newHuffman = (hfm)malloc(sizeof(struct huffman));
+  if(newHuffman == NULL) return NULL;
   newHuffman->encryption = str;
   newHuffman->tree = tree;
   return newHuffman;
@@ -151,15 +515,24 @@ void destroyHuffman(hfm *huffman){
 hfm huffmanEncrypt(char *str) {
   if(str != NULL) {
     lst charOccurrences = charOccurrencesOfStr(str);
+    if(charOccurrences == NULL) return NULL;
     nd tree = contructBinaryTree(charOccurrences);
     destroyList(&charOccurrences);
-    int maxPrefixLength = 0;
-    lst prefixes = prefixesList(tree, &maxPrefixLength);
-    char *bitsEncryption = getEncryptionOf(str, prefixes, maxPrefixLength);
-    tpl tupleEndChar = (tpl)getTupleInListByKey(prefixes, '\0');
-    char *encr = makeCharactersFromBits(bitsEncryption, (char*)getTupleValue(tupleEndChar));
-    destroyList(&prefixes);
-    return createDefinedHuffman(encr, tree);
+    char *encr = NULL;
+    if(tree == NULL) {
+      if(str[0] != '\0' || (encr = (char*)copyString("")) == NULL) return NULL;
+    } else {
+      int maxPrefixLength = 0;
+      lst prefixes = prefixesList(tree, &maxPrefixLength);
+      if(prefixes != NULL) encr = makeCharactersFromBits(getEncryptionOf(str, prefixes, maxPrefixLength));
+      destroyList(&prefixes);
+    }
+    hfm huffman = (encr != NULL) ? createDefinedHuffman(encr, tree) : NULL;
+    if(huffman == NULL) {
+      free(encr);
+      destroyNode(&tree);
+    }
+    return huffman;
   }
   return NULL;
 }
@@ -167,18 +540,110 @@ hfm huffmanEncrypt(char *str) {
 /**
  * @see @file huffman.h / @function huffmanEncryptFile
  */
-void huffmanEncryptFile(char *fileIn, char *fileOut, char *fileKey) {
-  if(fileIn != NULL && fileOut != NULL && fileKey != NULL) {
-    lst charOccurrences = charOccurrencesOfFile(fileIn);
-    saveKeyInFile(charOccurrences, fileKey);
+int huffmanEncryptFile(char *fileIn, char *fileOut, char *fileKey) {
+  return huffmanEncryptFileSampled(fileIn, fileOut, fileKey, 1, 0);
+}
+
+/**
+ * @see @file huffman.h / @function huffmanEncryptFileSampled
+ */
+int huffmanEncryptFileSampled(char *fileIn, char *fileOut, char *fileKey, double samplingRate, unsigned int checksums) {
+  int result = -1;
+  lst charOccurrences = NULL;
+  if(fileIn != NULL && fileOut != NULL && (charOccurrences = charOccurrencesOfFileSampled(fileIn, samplingRate)) != NULL) {
     nd tree = contructBinaryTree(charOccurrences);
-    destroyList(&charOccurrences);
     int maxPrefixLength = 0;
-    lst prefixes = prefixesList(tree, &maxPrefixLength);
+    lst prefixes = (tree != NULL) ? prefixesList(tree, &maxPrefixLength) : createList();
     destroyNode(&tree);
-    writeEncryptionInFile(fileIn, fileOut, prefixes, maxPrefixLength);
+    if(prefixes == NULL || (getListSize(prefixes) == 0 && getListSize(charOccurrences) > 0)) {
+      destroyList(&prefixes);
+      destroyList(&charOccurrences);
+      return -1;
+    }
+    size_t histogram[256];
+    histogramOfOccurrences(charOccurrences, histogram);
+    size_t tableSize = (fileKey != NULL) ? keySizeOf(charOccurrences) : histogramEncodedSize(histogram);
+    int isStored = !isCodingWorthIt(charOccurrences, prefixes, getFileSize(fileIn), tableSize);
+    if(isStored) {
+      emptyTheList(charOccurrences); // Every block is stored: the key is empty, the header has no table
+      destroyList(&prefixes);
+    }
+    if(fileKey == NULL || saveKeyInFile(charOccurrences, fileKey) == 0)
+      result = writeEncryptionWithTable(fileIn, fileOut, prefixes, (fileKey != NULL || isStored) ? NULL : histogram, checksums);
+    destroyList(&charOccurrences);
+    destroyList(&prefixes);
+  }
+  return result;
+}
+
+
+/**
+ * @see @file huffman.h / @function huffmanEncryptFileWithKey
+ */
+int huffmanEncryptFileWithKey(char *fileIn, char *fileOut, char *fileKey, unsigned int checksums) {
+  int result = -1;
+  if(fileIn != NULL && fileOut != NULL && fileKey != NULL) {
+    nd tree = getTreeFromKeyFile(fileKey);
+    if(tree != NULL) {
+      int maxPrefixLength = 0;
+      lst prefixes = prefixesList(tree, &maxPrefixLength);
+      destroyNode(&tree);
+      if(prefixes != NULL) result = writeEncryptionWithTable(fileIn, fileOut, prefixes, NULL, checksums);
+      destroyList(&prefixes);
+    }
+  }
+  return result;
+}
+
+/**
+ * @see @file huffman.h / @function huffmanResumeEncryptFile
+ */
+int huffmanResumeEncryptFile(char *fileIn, char *fileOut, char *fileKey) {
+  FILE *file = fopen(fileOut, "rb");
+  if(file == NULL) {
+    perror(fileOut);
+    return -1;
+  }
+  ctn container = readContainerHeader(file);
+  fclose(file);
+  if(container == NULL) {
+    printf("'%s' is not a .hfm file\n", fileOut);
+    return -1;
+  }
+  // The codes are the ones of the table the header or the key already gives
+  nd tree = NULL;
+  int hasCodes = hasContainerTable(container) || (fileKey != NULL && getFileSize(fileKey) > 0); // An empty key codes nothing
+  if(hasContainerTable(container) || (fileKey != NULL && getFileSize(fileKey) >= 0))
+    tree = getTreeFromContainer(container, fileKey);
+  else
+    printf("No code table nor key for '%s': the next blocks are stored\n", fileOut);
+  destroyContainer(&container);
+  int maxPrefixLength = 0;
+  lst prefixes = (tree != NULL) ? prefixesList(tree, &maxPrefixLength) : createList();
+  destroyNode(&tree);
+  if(prefixes == NULL || (hasCodes && getListSize(prefixes) == 0)) {
     destroyList(&prefixes);
+    return -1;
   }
+  char *codes[256];
+  prefixesTable(prefixes, codes);
+  int result = resumeEncryptBlocksOfFile(fileIn, fileOut, encodeBlockWithCodes, codes);
+  if(result == 0) printf("Encryption process completed\n");
+  destroyList(&prefixes);
+  return result;
+}
+
+/**
+ * @see @file huffman.h / @function huffmanKeyFromHistogramFile
+ */
+int huffmanKeyFromHistogramFile(char *fileHist, char *fileKey) {
+  size_t histogram[256];
+  for (size_t i = 0; i < 256; i++) histogram[i] = 0;
+  if(loadHistogramFromFile(fileHist, histogram) != 0) return -1;
+  lst charOccurrences = occurrencesFromHistogram(histogram);
+  int result = saveKeyInFile(charOccurrences, fileKey); // -1 as well if the occurrences are NULL
+  destroyList(&charOccurrences);
+  return result;
 }
 
 
@@ -201,12 +666,15 @@ char* huffmanDecryptStr(char *str, nd tree) {
 /**
  * @see @file huffman.h / @function huffmanDecryptFile
  */
-void huffmanDecryptFile(char *fileIn, char *fileOut, char *fileKey) {
-  if(fileIn != NULL && fileOut != NULL && fileKey != NULL) {
-    nd tree = getTreeFromKeyFile(fileKey);
-    writeDecryptionInFile(fileIn, fileOut, tree);
-    destroyNode(&tree);
-  }
+int huffmanDecryptFile(char *fileIn, char *fileOut, char *fileKey) {
+  return decryptFileWithTree(fileIn, fileOut, fileKey, 0);
+}
+
+/**
+ * @see @file huffman.h / @function huffmanResumeDecryptFile
+ */
+int huffmanResumeDecryptFile(char *fileIn, char *fileOut, char *fileKey) {
+  return decryptFileWithTree(fileIn, fileOut, fileKey, 1);
 }
 
 
@@ -214,42 +682,55 @@ void huffmanDecryptFile(char *fileIn, char *fileOut, char *fileKey) {
  * @see @file huffman.h / @function getEncryptionOf
  */
 char* getEncryptionOf(char *str, lst prefixes, int maxPrefixLength) {
-  char *encr = (char*)calloc(sizeof(char), maxPrefixLength * strlen(str) + 1);
+  (void)maxPrefixLength; // The exact size is computed from the prefixes
   if(str != NULL && prefixes != NULL) {
-    tpl prefixTuple = NULL;
+    char *codes[256];
+    prefixesTable(prefixes, codes);
+    size_t length = strlen(str);
+    size_t encrSize = 0;
+    for(size_t i = 0; i < length; i++)
+      if(codes[(unsigned char)str[i]] != NULL) encrSize += strlen(codes[(unsigned char)str[i]]);
+    char *encr = (char*)malloc(sizeof(char) * (encrSize + 1));
+    if(encr == NULL) return NULL;
+    size_t encrIndex = 0;
     char *prefix = NULL;
-    for(size_t i = 0; i < strlen(str); i++) {
-      prefixTuple = getTupleInListByKey(prefixes, str[i]);
-      prefix = (char*)getTupleValue(prefixTuple);
-      strcat(encr, prefix);
+    for(size_t i = 0; i < length; i++) {
+      prefix = codes[(unsigned char)str[i]];
+      if(prefix != NULL) {
+        size_t prefixLength = strlen(prefix);
+        memcpy(encr + encrIndex, prefix, prefixLength);
+        encrIndex += prefixLength;
+      }
     }
+    encr[encrIndex] = '\0';
+    return encr;
   }
-  // if(strlen(encr) < (unsigned int)maxPrefixLength) {
-  //   char *tmp = (char*)realloc(encr, strlen(encr) + 1);
-  //   if(tmp != NULL) encr = tmp;
-  // }
-  return encr;
+  return (char*)calloc(sizeof(char), 1);
 }
 
 /**
  * @see @file huffman.h / @function makeCharactersFromBits
  */
-char* makeCharactersFromBits(char *bits, char *endChar) {
-  int size = (strlen(bits) + strlen(endChar))/7 + 2;
-  char *encr = (char*)calloc(sizeof(char), size);
+char* makeCharactersFromBits(char *bits) {
+  if(bits == NULL) return NULL;
+  size_t length = strlen(bits);
+  char *encr = (char*)calloc(sizeof(char), length / 7 + 2);
+  if(encr == NULL) {
+    free(bits);
+    return NULL;
+  }
+  size_t encrIndex = 0;
   int actualBitIndex = 0;
   char chars[9];
   for (size_t i = 0; i < 9; i++) chars[i] = '\0';
   const int E_CHAR = 7;
-  chars[7] = '0';
-  for(size_t i = 0; i < strlen(bits) + strlen(endChar); i++) {
+  chars[7] = '1'; // Never read, it avoids the generation of \0
+  for(size_t i = 0; i < length; i++) {
       if(actualBitIndex >= E_CHAR) {
         actualBitIndex = 0;
-        encr[strlen(encr)] = charBitsToChar(chars);
+        encr[encrIndex++] = charBitsToChar(chars);
       }
-      if(i < strlen(bits)) chars[actualBitIndex] = bits[i];
-      else
-        chars[actualBitIndex] = endChar[i-strlen(bits)];
+      chars[actualBitIndex] = bits[i];
       actualBitIndex++;
   }
   if(actualBitIndex != 0) {
@@ -257,7 +738,7 @@ char* makeCharactersFromBits(char *bits, char *endChar) {
       chars[actualBitIndex] = '0';
       actualBitIndex++;
     }
-    encr[strlen(encr)] = charBitsToChar(chars);
+    encr[encrIndex++] = charBitsToChar(chars);
   }
   free(bits);
   return encr;
@@ -266,77 +747,187 @@ char* makeCharactersFromBits(char *bits, char *endChar) {
 /**
  * @see @file huffman.h / @function writeEncryptionInFile
  */
-void writeEncryptionInFile(char *fileIn, char *fileOut, lst prefixes, int maxPrefixLength) {
-  if(fileIn != NULL && fileOut != NULL && prefixes != NULL) {
-    FILE *file = fopen(fileIn, "r");
-    FILE *fileW = fopen(fileOut, "wb");
-    if(file != NULL && fileOut != NULL) {
-      char ligne[255];
-      int actualBitIndex = 0;
-      char bits[9];
-      for (size_t i = 0; i < 9; i++) bits[i] = '\0';
-      const int E_CHAR = 7;
-      bits[E_CHAR] = '0';
-      char *endChar = (char*)getTupleValue((tpl)getTupleInListByKey(prefixes, '\0'));
-      while(fgets(ligne, sizeof(ligne), file) != NULL) {
-        char *encrOfLigne = getEncryptionOf(ligne, prefixes, maxPrefixLength);
-        for(size_t i = 0; i < strlen(encrOfLigne); i++) {
-          if(actualBitIndex >= E_CHAR) {
-            actualBitIndex = 0;
-            writeBitsInOpenedFile(fileW, bits);
-          }
-          bits[actualBitIndex] = encrOfLigne[i];
-          actualBitIndex++;
-        }
-        free(encrOfLigne);
-      }
-      for (size_t i = 0; i < strlen(endChar); i++) {
-        if(actualBitIndex >= E_CHAR) {
-          actualBitIndex = 0;
-          writeBitsInOpenedFile(fileW, bits);
-        }
-        bits[actualBitIndex] = endChar[i];
-        actualBitIndex++;
-      }
-      if(actualBitIndex != 0) {
-        while(actualBitIndex != 0) {
-          bits[actualBitIndex] = '0';
-          actualBitIndex++;
-          if(actualBitIndex >= E_CHAR) actualBitIndex = 0;
-        }
-        writeBitsInOpenedFile(fileW, bits);
-      }
-      printf("Encryption process completed\n");
-      fclose(fileW);
-      fclose(file);
+int writeEncryptionInFile(char *fileIn, char *fileOut, lst prefixes, int maxPrefixLength) {
+  (void)maxPrefixLength; // The payload size is bounded by the block estimation
+  return writeEncryptionWithTable(fileIn, fileOut, prefixes, NULL, 0);
+}
+
+/**
+ * @see @file huffman.h / @function encryptBlocksOfFile
+ */
+int encryptBlocksOfFile(char *fileIn, char *fileOut, size_t *histogram, unsigned int checksums, size_t(*encode)(unsigned char *block, size_t size, unsigned char *out, void *context), void *context) {
+  FILE *file = fopen(fileIn, "rb");
+  FILE *fileW = fopen(fileOut, "wb");
+  if(file != NULL && fileW != NULL) {
+    long long fileSize = getFileSize(fileIn);
+    ctn container = createContainer(histogram, checksums);
+    ckp checkpoint = NULL;
+    int result = (container != NULL) ? writeContainerHeader(container, fileW) : -1;
+    // The header must be in the file for a resume: it gives the code table
+    if(result == 0 && fflush(fileW) == 0 && fileSize > (long long)HFM_CHECKPOINT_BLOCKS * HFM_BLOCK_SIZE)
+      checkpoint = createCheckpoint(fileOut, HFM_CHECKPOINT_ENCRYPTION, fileSize);
+    if(result == 0) result = writeBlocksWithCheckpoints(file, fileW, container, checkpoint, encode, context);
+    if(result != 0) perror(fileOut);
+    closeCheckpoint(&checkpoint, result == 0);
+    destroyContainer(&container);
+    fclose(fileW);
+    fclose(file);
+    return result;
+  }
+  if(file == NULL) perror(fileIn);
+  else fclose(file);
+  if(fileW == NULL) perror(fileOut);
+  else fclose(fileW);
+  return -1;
+}
+
+/**
+ * @see @file huffman.h / @function resumeEncryptBlocksOfFile
+ */
+int resumeEncryptBlocksOfFile(char *fileIn, char *fileOut, size_t(*encode)(unsigned char *block, size_t size, unsigned char *out, void *context), void *context) {
+  ckp checkpoint = loadCheckpoint(fileOut, HFM_CHECKPOINT_ENCRYPTION, getFileSize(fileIn));
+  if(checkpoint == NULL) return -1;
+  FILE *file = fopen(fileIn, "rb");
+  FILE *fileW = fopen(fileOut, "r+b");
+  int result = -1;
+  if(file != NULL && fileW != NULL) {
+    ctn container = readContainerHeader(fileW);
+    if(container != NULL) {
+      restoreCheckpointBlocks(checkpoint, container);
+      long long inputOffset = getCheckpointInputOffset(checkpoint);
+      long long outputOffset = (getCheckpointNbBlocks(checkpoint) > 0) ? getCheckpointOutputOffset(checkpoint) : getContainerFirstBlockOffset(container);
+      // What has been written after the checkpoint is written again
+      if(ftruncate(fileno(fileW), (off_t)outputOffset) == 0 && fseeko(fileW, (off_t)outputOffset, SEEK_SET) == 0
+         && fseeko(file, (off_t)inputOffset, SEEK_SET) == 0)
+        result = writeBlocksWithCheckpoints(file, fileW, container, checkpoint, encode, context);
+      if(result != 0) perror(fileOut);
+      destroyContainer(&container);
     } else {
-      if(file == NULL) perror(fileIn);
-      if(fileW == NULL) perror(fileOut);
-      exit(0);
+      printf("'%s' is not a .hfm file\n", fileOut);
     }
   }
+  if(file == NULL) perror(fileIn);
+  else fclose(file);
+  if(fileW == NULL) perror(fileOut);
+  else fclose(fileW);
+  closeCheckpoint(&checkpoint, result == 0);
+  return result;
+}
+
+/**
+ * @see @file huffman.h / @function writeBlockOfOpenedFile
+ */
+void writeBlockOfOpenedFile(FILE *fileOut, ctn container, unsigned char *block, size_t size, unsigned char *payload, size_t(*encode)(unsigned char *block, size_t size, unsigned char *out, void *context), void *context) {
+  writeCodedBlockInOpenedFile(fileOut, container, block, size, payload, encode(block, size, payload, context));
+}
+
+/**
+ * @see @file huffman.h / @function encryptBufferInOpenedFile
+ */
+int encryptBufferInOpenedFile(unsigned char *data, size_t size, FILE *fileOut, unsigned int checksums) {
+  size_t histogram[256];
+  for (size_t c = 0; c < 256; c++) histogram[c] = 0;
+  for (size_t i = 0; i < size; i++) histogram[data[i]]++;
+  lst occurrences = occurrencesFromHistogram(histogram);
+  if(occurrences == NULL) return -1;
+  nd tree = contructBinaryTree(occurrences);
+  int maxPrefixLength = 0;
+  lst prefixes = (tree != NULL) ? prefixesList(tree, &maxPrefixLength) : createList();
+  destroyNode(&tree);
+  if(prefixes == NULL || (getListSize(prefixes) == 0 && getListSize(occurrences) > 0)) {
+    destroyList(&prefixes);
+    destroyList(&occurrences);
+    return -1;
+  }
+  int isStored = !isCodingWorthIt(occurrences, prefixes, (long long)size, histogramEncodedSize(histogram));
+  if(isStored) emptyTheList(prefixes); // Every block is stored: the header has no table
+  destroyList(&occurrences);
+  char *codes[256];
+  prefixesTable(prefixes, codes);
+  int result = writeBufferWithCodes(data, size, fileOut, isStored ? NULL : histogram, codes, checksums);
+  destroyList(&prefixes);
+  return result;
+}
+
+/**
+ * @see @file huffman.h / @function encryptBufferInMemory
+ */
+unsigned char* encryptBufferInMemory(unsigned char *data, size_t size, unsigned int checksums, size_t *outSize) {
+  // The reentrant core writes the same file, without tree nor stream
+  size_t capacity = codecCompressBound(size);
+  unsigned char *out = (unsigned char*)malloc(capacity);
+  if(out == NULL) return NULL;
+  if(codecCompress(NULL, data, size, NULL, checksums, out, capacity, outSize) != HFM_OK) {
+    free(out);
+    return NULL;
+  }
+  return out;
+}
+
+/**
+ * @see @file huffman.h / @function encryptBufferWithCodesInMemory
+ */
+unsigned char* encryptBufferWithCodesInMemory(unsigned char *data, size_t size, char **codes, unsigned int checksums, size_t *outSize) {
+  return encryptInMemory(data, size, codes, checksums, outSize);
+}
+
+/**
+ * @see @file huffman.h / @function decryptBufferInMemory
+ */
+int decryptBufferInMemory(unsigned char *data, size_t size, nd tree, size_t maxSize, unsigned char **out, size_t *outSize) {
+  *out = NULL;
+  *outSize = 0;
+  FILE *fileIn = fmemopen(data, size, "rb");
+  if(fileIn == NULL) return -1;
+  ctn container = readContainer(fileIn);
+  if(container == NULL || getContainerOriginalSize(container) > (long long)maxSize) {
+    destroyContainer(&container);
+    fclose(fileIn);
+    return -2;
+  }
+  nd headerTree = hasContainerTable(container) ? getTreeFromContainer(container, NULL) : NULL;
+  if(hasContainerTable(container) && headerTree == NULL) {
+    destroyContainer(&container);
+    fclose(fileIn);
+    return -1;
+  }
+  size_t originalSize = (size_t)getContainerOriginalSize(container);
+  *out = (unsigned char*)malloc(originalSize + 1);
+  FILE *fileOut = (*out != NULL) ? fmemopen(*out, originalSize + 1, "wb") : NULL;
+  int result = (fileOut != NULL) ? 0 : -1;
+  if(result == 0) result = decryptBlocksOfOpenedFile(fileIn, fileOut, container, decodeBlockWithTree, (headerTree != NULL) ? headerTree : tree);
+  if(result == -2 && !hasContainerTable(container) && tree == NULL) result = -1; // A block is coded with the key
+  if(result == 0 && ftello(fileOut) != (off_t)originalSize) result = -2;
+  if(fileOut != NULL && fclose(fileOut) != 0 && result == 0) result = -1;
+  fclose(fileIn);
+  destroyNode(&headerTree);
+  destroyContainer(&container);
+  if(result != 0) {
+    free(*out);
+    *out = NULL;
+  } else {
+    *outSize = originalSize;
+  }
+  return result;
 }
 
 /**
  * @see @file huffman.h / @function saveKeyInFile
  */
-void saveKeyInFile(lst occurrences, char *fileKey) {
-  if(occurrences != NULL && fileKey != NULL) {
-    FILE *file = fopen(fileKey, "w");
-    tpl occurrence = NULL;
-    if(file != NULL) {
-      for (size_t i = 0; i < getListSize(occurrences); i++) {
-        occurrence = getOfList(occurrences, i);
-        if(*((char*)getTupleKey(occurrence)) != '\0') {
-          fprintf(file, "%c:%d;", *((char*)getTupleKey(occurrence)), *((int*)getTupleValue(occurrence)));
-        }
-      }
-      fclose(file);
-    } else {
-      if(file == NULL) perror(fileKey);
-      exit(0);
-    }
+int saveKeyInFile(lst occurrences, char *fileKey) {
+  if(occurrences == NULL || fileKey == NULL) return -1;
+  FILE *file = fopen(fileKey, "w");
+  if(file == NULL) {
+    perror(fileKey);
+    return -1;
+  }
+  tpl occurrence = NULL;
+  for (size_t i = 0; i < getListSize(occurrences); i++) {
+    occurrence = getOfList(occurrences, i);
+    fputc(*((char*)getTupleKey(occurrence)), file); // Can be \0
+    fprintf(file, ":%zu;", *((size_t*)getTupleValue(occurrence)));
   }
+  return (fclose(file) == 0) ? 0 : -1;
 }
 
 
@@ -344,131 +935,145 @@ void saveKeyInFile(lst occurrences, char *fileKey) {
  * @see @file huffman.h / @function getDecryptionOf
  */
 char* getDecryptionOf(char *str, nd tree) {
-  unsigned int resultSize = strlen(str)*3 + 1;
-  char *result = (char*)calloc(sizeof(char), resultSize);
+  // The weight of the tree is the number of characters encrypted
+  size_t resultSize = (tree != NULL) ? weightNode(tree) : 0;
+  char *result = (char*)calloc(sizeof(char), resultSize + 1);
+  if(result == NULL) return NULL;
+  if(tree == NULL) return result;
+  if(isLeafNode(tree)) { // A single character has an empty prefix
+    memset(result, *((char*)getTupleKey((tpl)getNodeTag(tree))), resultSize);
+    return result;
+  }
   nd currentNode = tree;
   char path[9]; path[8] = '\0';
   for (size_t i = 0; i < 8; i++) path[i] = '0';
-  char *charToWrite;
-  int resultIndex = 0;
-  int endFound = 0;
-  for(size_t i = 0; i < strlen(str); i++) {
+  size_t resultIndex = 0;
+  size_t length = strlen(str);
+  for(size_t i = 0; i < length && resultIndex < resultSize; i++) {
     decimalToBinary((unsigned int)str[i], 8, path);
-    for(size_t j = 0; j < strlen(path)-1; j++) {
-      if(isLeafNode((currentNode))) {
-        charToWrite = (char*)getTupleKey((tpl)getNodeTag(currentNode));
-        result[resultIndex] = *charToWrite;
-        currentNode = tree;
-        resultIndex++;
-        if(*charToWrite == '\0') endFound = 1;
-      }
+    for(size_t j = 0; j < 7 && resultIndex < resultSize; j++) {
       if(path[j] == '0') {
         currentNode = getNodeLeft(currentNode);
       } else if(path[j] == '1') {
         currentNode = getNodeRight(currentNode);
       }
-      if(endFound == 1) break;
+      if(isLeafNode(currentNode)) {
+        result[resultIndex++] = *((char*)getTupleKey((tpl)getNodeTag(currentNode)));
+        currentNode = tree;
+      }
     }
-    if(endFound == 1) break;
   }
-  // if(strlen(result) < resultSize) {
-  //   char *tmp = (char*)realloc(result, strlen(result) + 1);
-  //   if(tmp != NULL) result = tmp;
-  // }
   return result;
 }
 
 /**
  * @see @file huffman.h / @function writeDecryptionInFile
  */
-void writeDecryptionInFile(char *fileIn, char *fileOut, nd tree) {
-  FILE *fileToRead = fopen(fileIn, "r");
-  FILE *fileToWrite = fopen(fileOut, "w");
-  if(fileToRead != NULL && fileToWrite != NULL) {
-    nd currentNode = tree;
-    char currentCharBits[9]; currentCharBits[8] = '\0';
-    for (size_t i = 0; i < 8; i++) currentCharBits[i] = '0';
-    char charToWrite;
-    char c;
-    int again = 1;
-    while((c = fgetc(fileToRead)) != EOF && again == 1) {
-      decimalToBinary(c, 8, currentCharBits);
-      currentCharBits[7] = '\0';
-      for (size_t i = 0; i < strlen(currentCharBits); i++) {
-        if(isLeafNode(currentNode)) {
-          charToWrite = *((char*)getTupleKey((tpl)getNodeTag(currentNode)));
-          if (charToWrite == '\0') {
-            again = 0;
-            break;
-          }
-          fprintf(fileToWrite, "%c", charToWrite);
-          currentNode = tree;
-        }
-        if(currentCharBits[i] == '0') {
-          currentNode = getNodeLeft(currentNode);
-        } else if(currentCharBits[i] == '1') {
-          currentNode = getNodeRight(currentNode);
-        }
-      }
-    }
+int writeDecryptionInFile(char *fileIn, char *fileOut, nd tree) {
+  int result = decryptBlocksOfFile(fileIn, fileOut, decodeBlockWithTree, tree);
+  if(result == 0) {
     printf("Decryption process completed\n");
-    fclose(fileToRead);
-    fclose(fileToWrite);
-  } else {
-    if(fileToRead == NULL) perror(fileIn);
-    if(fileToWrite == NULL) perror(fileOut);
-    destroyNode(&tree);
-    exit(0);
+  } else if(result == -2) {
+    printf("Decryption failed: '%s' is corrupted\n", fileIn);
+  } else if(result == -3) {
+    printf("Decryption failed: '%s' does not match its checksums\n", fileIn);
+  }
+  return result;
+}
+
+/**
+ * @see @file huffman.h / @function decryptBlocksOfFile
+ */
+int decryptBlocksOfFile(char *fileIn, char *fileOut, size_t(*decode)(unsigned char *payload, size_t size, unsigned char *out, size_t length, void *context), void *context) {
+  return decryptBlocksWithCheckpoints(fileIn, fileOut, 0, decode, context);
+}
+
+/**
+ * @see @file huffman.h / @function resumeDecryptBlocksOfFile
+ */
+int resumeDecryptBlocksOfFile(char *fileIn, char *fileOut, size_t(*decode)(unsigned char *payload, size_t size, unsigned char *out, size_t length, void *context), void *context) {
+  return decryptBlocksWithCheckpoints(fileIn, fileOut, 1, decode, context);
+}
+
+/**
+ * @see @file huffman.h / @function decryptBlocksOfOpenedFile
+ */
+int decryptBlocksOfOpenedFile(FILE *fileIn, FILE *fileOut, ctn container, size_t(*decode)(unsigned char *payload, size_t size, unsigned char *out, size_t length, void *context), void *context) {
+  return decryptBlocksFromCheckpoint(fileIn, fileOut, container, NULL, decode, context);
+}
+
+/**
+ * @see @file huffman.h / @function writeTableBlockOfOpenedFile
+ */
+void writeTableBlockOfOpenedFile(FILE *fileOut, ctn container, size_t *histogram) {
+  size_t payloadSize = 1 + ((histogram != NULL) ? histogramEncodedSize(histogram) : 0);
+  writeBlockInOpenedFile(fileOut, HFM_BLOCK_TABLE, NULL, payloadSize, 0);
+  fputc((histogram != NULL) ? HFM_TABLE_HISTOGRAM : HFM_TABLE_KEY, fileOut);
+  if(histogram != NULL) writeHistogramInOpenedFile(fileOut, histogram);
+  addContainerBlock(container, HFM_BLOCK_HEADER_SIZE + payloadSize, NULL, 0);
+}
+
+/**
+ * @see @file huffman.h / @function readTableBlockOfOpenedFile
+ */
+int readTableBlockOfOpenedFile(FILE *fileIn, ctn container, size_t index, size_t *histogram) {
+  char type;
+  if(readBlockHeaderInOpenedFile(fileIn, container, index, &type) != 0 || type != HFM_BLOCK_TABLE) return -2;
+  size_t payloadSize = getContainerBlockStoredSize(container, index) - HFM_BLOCK_HEADER_SIZE;
+  int kind = fgetc(fileIn);
+  if(kind == HFM_TABLE_KEY) return (payloadSize == 1) ? 0 : -2;
+  if(kind != HFM_TABLE_HISTOGRAM) return -2;
+  for (size_t c = 0; c < 256; c++) histogram[c] = 0;
+  off_t start = ftello(fileIn);
+  if(readHistogramFromOpenedFile(fileIn, histogram) != 0 || ftello(fileIn) - start != (off_t)payloadSize - 1)
+    return -2;
+  return 1;
+}
+
+/**
+ * @see @file huffman.h / @function readBlockOfOpenedFile
+ */
+int readBlockOfOpenedFile(FILE *fileIn, ctn container, size_t index, unsigned char *payload, unsigned char *block, size_t(*decode)(unsigned char *payload, size_t size, unsigned char *out, size_t length, void *context), void *context) {
+  char type;
+  if(readBlockHeaderInOpenedFile(fileIn, container, index, &type) != 0 || type == HFM_BLOCK_TABLE) return -2;
+  size_t length = getContainerBlockLength(container, index);
+  size_t payloadSize = getContainerBlockStoredSize(container, index) - HFM_BLOCK_HEADER_SIZE;
+  if(type == HFM_BLOCK_STORED) {
+    if(fread(block, 1, length, fileIn) != length) return -2;
+  } else if(fread(payload, 1, payloadSize, fileIn) != payloadSize
+            || decode(payload, payloadSize, block, length, context) != length) {
+    return -2;
   }
+  if((getContainerChecksums(container) & HFM_CONTAINER_BLOCK_CRC)
+     && crc32c(0, block, length) != getContainerBlockChecksum(container, index))
+    return -3;
+  return 0;
 }
 
 /**
  * @see @file huffman.h / @function getTreeFromKeyFile
  */
 nd getTreeFromKeyFile(char *fileKey) {
-  FILE *file = fopen (fileKey, "r");
+  FILE *file = fopen (fileKey, "rb");
   if(file != NULL) {
-    char ligne[255];
     tpl occurrence = NULL;
-    int etape = 1;
-    char l = 0;
-    unsigned int tmp = 0;
-    char nb[11];
-    for (size_t i = 0; i < 11; i++) nb[i] = '\0';
+    int l = 0;
+    int c = 0;
     lst occurrences = createDefinedList(&destroyTupleGen, &printTupleGen);
-    while(fgets(ligne, sizeof(ligne), file) != NULL) {
-      for (unsigned int i = 0; i < strlen(ligne); i++) {
-        if (etape == 1) {
-          l = ligne[i];
-          etape++;
-        } else if(etape == 2) {
-          if (ligne[i] == ':') etape++;
-        } else if(etape == 3) {
-          nb[tmp] = ligne[i];
-          tmp++;
-          if(ligne[i+1] == ';') {
-            while(tmp < 11) {
-              nb[tmp] = 0;
-              tmp++;
-            }
-            tmp = 0;
-            char *letter = (char*)malloc(sizeof(char)); *letter = l;
-            int *value = (int*)malloc(sizeof(int)); *value = strToInt(nb);
-            occurrence = createTuple(letter, value, NULL, printChar, NULL, printInt);
-            addInList(occurrences, occurrence);
-            etape++;
-          }
-        } else if(etape == 4) {
-          if (ligne[i] == ';') etape = 1;
-        }
+    int failed = (occurrences == NULL);
+    // Each occurrence is written "l:n;", the character l can be any byte
+    while(!failed && (l = fgetc(file)) != EOF && fgetc(file) == ':') {
+      size_t value = 0;
+      while((c = fgetc(file)) != EOF && c != ';') value = value * 10 + (size_t)(c - '0');
+      char letter = (char)l;
+      occurrence = createTupleByCopy(&letter, &value, &copyChar, NULL, &printChar, &copySize, NULL, &printSize);
+      if(occurrence == NULL || addInList(occurrences, occurrence) != 0) {
+        destroyTuple(&occurrence);
+        failed = 1;
       }
     }
     fclose(file);
-    char *letter = (char*)malloc(sizeof(char)); *letter = '\0';
-    int *value = (int*)malloc(sizeof(int)); *value = 1;
-    occurrence = createTuple(letter, value, NULL, printChar, NULL, printInt);
-    addInList(occurrences, occurrence);
-    nd tree = contructBinaryTree(occurrences);
+    nd tree = !failed ? contructBinaryTree(occurrences) : NULL;
     destroyList(&occurrences);
     return tree;
   } else {
@@ -477,29 +1082,69 @@ nd getTreeFromKeyFile(char *fileKey) {
   return NULL;
 }
 
+/**
+ * @see @file huffman.h / @function getHistogramFromKeyFile
+ */
+int getHistogramFromKeyFile(char *fileKey, size_t *histogram) {
+  FILE *file = fopen(fileKey, "rb");
+  if(file == NULL) return -1;
+  int l = 0;
+  int c = 0;
+  for (size_t i = 0; i < 256; i++) histogram[i] = 0;
+  // Same format as getTreeFromKeyFile: "l:n;" for each byte l
+  while((l = fgetc(file)) != EOF && fgetc(file) == ':') {
+    size_t value = 0;
+    while((c = fgetc(file)) != EOF && c != ';') value = value * 10 + (size_t)(c - '0');
+    histogram[(unsigned char)l] = value;
+  }
+  fclose(file);
+  return 0;
+}
+
+
+/**
+ * @see @file huffman.h / @function getTreeFromContainer
+ */
+nd getTreeFromContainer(ctn container, char *fileKey) {
+  if(hasContainerTable(container)) return getTreeFromHistogram(getContainerHistogram(container));
+  return (fileKey != NULL) ? getTreeFromKeyFile(fileKey) : NULL;
+}
+
+/**
+ * @see @file huffman.h / @function getTreeFromHistogram
+ */
+nd getTreeFromHistogram(size_t *histogram) {
+  lst occurrences = occurrencesFromHistogram(histogram);
+  nd tree = contructBinaryTree(occurrences);
+  destroyList(&occurrences);
+  return tree;
+}
 
 /**
  * @see @file huffman.h / @function charOccurrencesOfStr
  */
 lst charOccurrencesOfStr(char *str) {
   lst occurrences = createDefinedList(&destroyTupleGen, &printTupleGen);
+  if(occurrences == NULL) return NULL;
   char key;
-  int val = 1;
+  size_t val = 1;
   tpl tupleTmp = NULL;
-  for(size_t i = 0; i < strlen(str); i++) {
+  size_t length = strlen(str);
+  for(size_t i = 0; i < length; i++) {
     tupleTmp = getTupleInListByKey(occurrences, str[i]);
     if(tupleTmp == NULL) {
       key = str[i];
-      tpl tuple = createTupleByCopy(&key, &val, &copyChar, NULL, &printChar, &copyInt, NULL, &printInt);
-      addInList(occurrences, tuple);
+      tpl tuple = createTupleByCopy(&key, &val, &copyChar, NULL, &printChar, &copySize, NULL, &printSize);
+      if(tuple == NULL || addInList(occurrences, tuple) != 0) {
+        destroyTuple(&tuple);
+        destroyList(&occurrences);
+        return NULL;
+      }
     } else {
-      (*((int*)getTupleValue(tupleTmp)))++;
+      (*((size_t*)getTupleValue(tupleTmp)))++;
       tupleTmp = NULL;
     }
   }
-  key = '\0';
-  tpl tuple = createTupleByCopy(&key, &val, &copyChar, NULL, &printChar, &copyInt, NULL, &printInt);
-  addInList(occurrences, tuple);
   return occurrences;
 }
 
@@ -507,56 +1152,110 @@ lst charOccurrencesOfStr(char *str) {
  * @see @file huffman.h / @function charOccurrencesOfFile
  */
 lst charOccurrencesOfFile(char *srcFile) {
-  FILE *file = fopen (srcFile, "r");
+  size_t histogram[256];
+  for (size_t i = 0; i < 256; i++) histogram[i] = 0;
+  if(histogramOfFile(srcFile, histogram) != 0) return NULL;
+  return occurrencesFromHistogram(histogram);
+}
+
+/**
+ * @see @file huffman.h / @function charOccurrencesOfFileSampled
+ */
+lst charOccurrencesOfFileSampled(char *srcFile, double samplingRate) {
+  long long fileSize = getFileSize(srcFile);
+  if(samplingRate >= 1 || samplingRate <= 0 || fileSize <= 0) return charOccurrencesOfFile(srcFile);
+  long long nbChunks = (long long)(fileSize * samplingRate) / HFM_SAMPLE_CHUNK;
+  if(nbChunks < 1) nbChunks = 1;
+  long long stride = fileSize / nbChunks;
+  if(stride <= HFM_SAMPLE_CHUNK) return charOccurrencesOfFile(srcFile);
+  FILE *file = fopen (srcFile, "rb");
   if(file != NULL) {
-    char ligne[512];
-    lst occurrences = createDefinedList(&destroyTupleGen, &printTupleGen);
-    char key;
-    int val = 1;
-    tpl tupleTmp = NULL;
-    while(fgets(ligne, sizeof(ligne), file) != NULL) {
-      for(unsigned int i = 0; i < strlen(ligne); i++) {
-        tupleTmp = getTupleInListByKey(occurrences, ligne[i]);
-        if(tupleTmp == NULL) {
-          key = ligne[i];
-          tpl tuple = createTupleByCopy(&key, &val, &copyChar, NULL, &printChar, &copyInt, NULL, &printInt);
-          addInList(occurrences, tuple);
-        } else {
-          (*((int*)getTupleValue(tupleTmp)))++;
-          tupleTmp = NULL;
-        }
-      }
+    unsigned char *buffer = (unsigned char*)malloc(HFM_SAMPLE_CHUNK);
+    if(buffer == NULL) {
+      fclose(file);
+      return NULL;
+    }
+    size_t histogram[256];
+    for (size_t i = 0; i < 256; i++) histogram[i] = 0;
+    size_t sampled = 0;
+    size_t size;
+    for (long long i = 0; i < nbChunks; i++) {
+      if(fseeko(file, (off_t)(i * stride), SEEK_SET) != 0) break;
+      size = fread(buffer, 1, HFM_SAMPLE_CHUNK, file);
+      for(size_t j = 0; j < size; j++) histogram[buffer[j]]++;
+      sampled += size;
     }
-    key = '\0';
-    tpl tuple = createTupleByCopy(&key, &val, &copyChar, NULL, &printChar, &copyInt, NULL, &printInt);
-    addInList(occurrences, tuple);
+    free(buffer);
     fclose(file);
-    return occurrences;
-  } else {
-    perror(srcFile);
-    exit(0);
+    // Counts scaled to the whole file, and a floor of 1 for the unseen bytes
+    for (size_t c = 0; c < 256; c++) {
+      histogram[c] = (size_t)((double)histogram[c] * fileSize / (sampled > 0 ? sampled : 1) + 0.5);
+      if(histogram[c] == 0) histogram[c] = 1;
+    }
+    return occurrencesFromHistogram(histogram);
   }
+  perror(srcFile);
   return NULL;
 }
 
+/**
+ * @see @file huffman.h / @function occurrencesFromHistogram
+ */
+lst occurrencesFromHistogram(size_t *histogram) {
+  lst occurrences = createDefinedList(&destroyTupleGen, &printTupleGen);
+  if(occurrences == NULL) return NULL;
+  char key;
+  for(size_t c = 0; c < 256; c++) {
+    if(histogram[c] > 0) {
+      key = (char)c;
+      tpl tuple = createTupleByCopy(&key, &histogram[c], &copyChar, NULL, &printChar, &copySize, NULL, &printSize);
+      if(tuple == NULL || addInList(occurrences, tuple) != 0) {
+        destroyTuple(&tuple);
+        destroyList(&occurrences);
+        return NULL;
+      }
+    }
+  }
+  return occurrences;
+}
+
+/**
+ * @see @file huffman.h / @function histogramOfOccurrences
+ */
+void histogramOfOccurrences(lst occurrences, size_t *histogram) {
+  for (size_t c = 0; c < 256; c++) histogram[c] = 0;
+  tpl occurrence = NULL;
+  for (size_t i = 0; i < getListSize(occurrences); i++) {
+    occurrence = (tpl)getOfList(occurrences, i);
+    histogram[*((unsigned char*)getTupleKey(occurrence))] = *((size_t*)getTupleValue(occurrence));
+  }
+}
+
 /**
  * @see @file huffman.h / @function contructBinaryTree
  */
 nd contructBinaryTree(lst occurrences) {
+  if(occurrences == NULL) return NULL;
   lst treeNodes = createDefinedList(destroyNodeGen, printNodeGen);
+  if(treeNodes == NULL) return NULL;
   nd tree = NULL;
   tpl tuple = NULL;
-  for(size_t i = 0; i < getListSize(occurrences); i++) {
+  int failed = 0;
+  for(size_t i = 0; i < getListSize(occurrences) && !failed; i++) {
     tuple = getOfList(occurrences, i);
-    tpl tmp = makeCopyTuple(tuple, copyChar, copyInt);
-    nd node = createDefinedNode(tmp, destroyTupleGen, printTupleGen);
-    addInList(treeNodes, node);
+    tpl tmp = makeCopyTuple(tuple, copyChar, copySize);
+    nd node = (tmp != NULL) ? createDefinedNode(tmp, destroyTupleGen, printTupleGen) : NULL;
+    if(node == NULL) destroyTuple(&tmp);
+    if(node == NULL || addInList(treeNodes, node) != 0) {
+      destroyNode(&node);
+      failed = 1;
+    }
   }
-  if(getListSize(treeNodes) > 0) {
-    while(getListSize(treeNodes) > 1) {
-      mergeTwoSmallerNodes(treeNodes, weightNode);
+  if(!failed && getListSize(treeNodes) > 0) {
+    while(getListSize(treeNodes) > 1 && !failed) {
+      failed = (mergeTwoSmallerNodes(treeNodes, weightNode) != 0);
     }
-    if(getListSize(treeNodes) == 1) tree = (nd)removeFromList(treeNodes, 0);
+    if(!failed && getListSize(treeNodes) == 1) tree = (nd)removeFromList(treeNodes, 0);
   }
   destroyList(&treeNodes);
   return tree;
@@ -565,12 +1264,12 @@ nd contructBinaryTree(lst occurrences) {
 /**
  * @see @file huffman.h / @function mergeTwoSmallerNodes
  */
-void mergeTwoSmallerNodes(lst list, int(*weight)(void *elem)) {
+int mergeTwoSmallerNodes(lst list, size_t(*weight)(void *elem)) {
   size_t j = 0;
   size_t k = 1;
-  int valueJ = weight((nd)getOfList(list, j));
-  int valueK = weight((nd)getOfList(list, k));
-  int currentValue;
+  size_t valueJ = weight((nd)getOfList(list, j));
+  size_t valueK = weight((nd)getOfList(list, k));
+  size_t currentValue;
   for(size_t i = 2; i < getListSize(list); i++) {
     currentValue = weight((nd)getOfList(list, i));
     if(k < j) {
@@ -589,19 +1288,37 @@ void mergeTwoSmallerNodes(lst list, int(*weight)(void *elem)) {
   nd child1 = (nd)removeFromList(list, j);
   nd child2 = (nd)removeFromList(list, k);
   nd newNode = mergeNodes(child1, child2, weightNode);
-  addInList(list, newNode);
+  if(newNode == NULL) {
+    destroyNode(&child1);
+    destroyNode(&child2);
+    return -1;
+  }
+  if(addInList(list, newNode) != 0) {
+    destroyNode(&newNode);
+    return -1;
+  }
+  return 0;
 }
 
 /**
  * @see @file huffman.h / @function mergeNodes
  */
-nd mergeNodes(nd node1, nd node2, int(*weight)(void *elem)) {
-  int val1 = weight(node1);
-  int val2 = weight(node2);
-  int *newValue = (int*)malloc(sizeof(int));
+nd mergeNodes(nd node1, nd node2, size_t(*weight)(void *elem)) {
+  size_t val1 = weight(node1);
+  size_t val2 = weight(node2);
+  size_t *newValue = (size_t*)malloc(sizeof(size_t));
+  if(newValue == NULL) return NULL;
   *newValue = val1 + val2;
-  tpl newTuple = createTuple(NULL, newValue, NULL, printChar, NULL, printInt);
+  tpl newTuple = createTuple(NULL, newValue, NULL, printChar, NULL, printSize);
+  if(newTuple == NULL) {
+    free(newValue);
+    return NULL;
+  }
   nd newNode = createDefinedNode(newTuple, destroyTupleGen, printTupleGen);
+  if(newNode == NULL) {
+    destroyTuple(&newTuple);
+    return NULL;
+  }
   if(val1 <= val2) {
     setNodeLeft(newNode, node1);
     setNodeRight(newNode, node2);
@@ -618,37 +1335,42 @@ nd mergeNodes(nd node1, nd node2, int(*weight)(void *elem)) {
 lst prefixesList(nd tree, int *maxPrefixLength) {
   *maxPrefixLength = getNodeDepth(tree);
   lst prefixes = createDefinedList(&destroyTupleGen, &printTupleGen);
+  if(prefixes == NULL) return NULL;
   char prefix[*maxPrefixLength+1];
   for (int i = 0; i < *maxPrefixLength+1; i++) prefix[i] = '\0';
-  calculatePrefixes(tree, prefixes, prefix);
+  if(calculatePrefixes(tree, prefixes, prefix) != 0) destroyList(&prefixes);
   return prefixes;
 }
 
 /**
  * @see @file huffman.h / @function calculatePrefixes
  */
-void calculatePrefixes(nd node, lst prefixes, char *prefix) {
-  if(node == NULL || prefix == NULL || prefixes == NULL) pointerNullError();
+int calculatePrefixes(nd node, lst prefixes, char *prefix) {
+  if(node == NULL || prefix == NULL || prefixes == NULL) return -1;
   int next = (int)strlen(prefix);
   if(isLeafNode(node)) {
-    char *ch = (char*)copyChar(getTupleKey((tpl)getNodeTag(node)));
-    char *pr = copyString(prefix);
-    tpl prefixTuple = createTuple(ch, pr, NULL, printChar, NULL, printString);
-    addInList(prefixes, prefixTuple);
+    tpl prefixTuple = createTupleByCopy(getTupleKey((tpl)getNodeTag(node)), prefix, &copyChar, NULL, &printChar, &copyString, NULL, &printString);
+    if(prefixTuple == NULL || addInList(prefixes, prefixTuple) != 0) {
+      destroyTuple(&prefixTuple);
+      return -1;
+    }
   } else {
     nd left = getNodeLeft(node);
     nd right = getNodeRight(node);
+    int result = 0;
     if(left != NULL) {
       prefix[next] = '0';
-      calculatePrefixes(left, prefixes, prefix);
+      result = calculatePrefixes(left, prefixes, prefix);
       prefix[next] = 0;
     }
-    if(right != NULL) {
+    if(right != NULL && result == 0) {
       prefix[next] = '1';
-      calculatePrefixes(right, prefixes, prefix);
+      result = calculatePrefixes(right, prefixes, prefix);
       prefix[next] = 0;
     }
+    return result;
   }
+  return 0;
 }
 
 
@@ -667,8 +1389,8 @@ tpl getTupleInListByKey(lst list, char key) {
 /**
  * @see @file huffman.h / @function weightNode
  */
-int weightNode(void *elem) {
-  return *((int*)getTupleValue(getNodeTag((nd)elem)));
+size_t weightNode(void *elem) {
+  return *((size_t*)getTupleValue(getNodeTag((nd)elem)));
 }
 
 /**
@@ -684,5 +1406,542 @@ void writeBitsInOpenedFile(FILE *fileW, char *bits) {
 }
 
 
+/**
+ * @see @file huffman.h / @function prefixesTable
+ */
+void prefixesTable(lst prefixes, char **codes) {
+  for (size_t i = 0; i < 256; i++) codes[i] = NULL;
+  tpl prefixTuple = NULL;
+  for (size_t i = 0; i < getListSize(prefixes); i++) {
+    prefixTuple = (tpl)getOfList(prefixes, i);
+    codes[*((unsigned char*)getTupleKey(prefixTuple))] = (char*)getTupleValue(prefixTuple);
+  }
+}
+
+/**
+ * @see @file huffman.h / @function estimateCodedSize
+ */
+size_t estimateCodedSize(size_t *histogram, char **codes) {
+  size_t bits = 0;
+  for (size_t c = 0; c < 256; c++) {
+    if(histogram[c] > 0) {
+      if(codes[c] == NULL) return SIZE_MAX;
+      bits += histogram[c] * strlen(codes[c]);
+    }
+  }
+  return (bits + 7) / 8;
+}
+
+/**
+ * @see @file huffman.h / @function encodeBlock
+ */
+size_t encodeBlock(unsigned char *block, size_t size, char **codes, unsigned char *out) {
+  size_t outIndex = 0;
+  unsigned char bits = 0;
+  int actualBitIndex = 0;
+  char *prefix = NULL;
+  for (size_t i = 0; i < size; i++) {
+    prefix = codes[block[i]];
+    for (size_t j = 0; prefix[j] != '\0'; j++) {
+      bits = (unsigned char)(bits << 1) | (prefix[j] == '1');
+      actualBitIndex++;
+      if(actualBitIndex == 8) {
+        out[outIndex++] = bits;
+        actualBitIndex = 0;
+        bits = 0;
+      }
+    }
+  }
+  if(actualBitIndex != 0) out[outIndex++] = (unsigned char)(bits << (8 - actualBitIndex));
+  return outIndex;
+}
+
+/**
+ * @see @file huffman.h / @function decodeBlock
+ */
+size_t decodeBlock(unsigned char *payload, size_t size, nd tree, unsigned char *out, size_t length) {
+  if(tree == NULL || length > HFM_BLOCK_SIZE) return SIZE_MAX;
+  // 256 nodes flattened are nothing next to the bits of a block
+  int16_t nodes[256][2];
+  uint32_t nbNodes = 0;
+  int16_t root = flattenTree(tree, nodes, &nbNodes);
+  if(nbNodes > 256) return SIZE_MAX;
+  return codecDecodeTreeBlock((const int16_t (*)[2])nodes, root, payload, size, out, length);
+}
+
+/**
+ * @see @file huffman.h / @function encodeBlockWithCodes
+ */
+size_t encodeBlockWithCodes(unsigned char *block, size_t size, unsigned char *out, void *context) {
+  char **codes = (char**)context;
+  size_t histogram[256];
+  for (size_t i = 0; i < 256; i++) histogram[i] = 0;
+  for (size_t i = 0; i < size; i++) histogram[block[i]]++;
+  size_t payloadSize = estimateCodedSize(histogram, codes);
+  if(payloadSize >= size) return SIZE_MAX;
+  return encodeBlock(block, size, codes, out);
+}
+
+/**
+ * @see @file huffman.h / @function decodeBlockWithTree
+ */
+size_t decodeBlockWithTree(unsigned char *payload, size_t size, unsigned char *out, size_t length, void *context) {
+  return decodeBlock(payload, size, (nd)context, out, length);
+}
+
+/**
+ * @see @file huffman.h / @function copyStoredBlock
+ */
+int copyStoredBlock(FILE *fileIn, FILE *fileOut, size_t size, unsigned char *buffer) {
+#ifdef __linux__
+  off_t offIn = ftello(fileIn);
+  off_t offOut = (fflush(fileOut) == 0) ? ftello(fileOut) : -1;
+  if(offIn >= 0 && offOut >= 0) {
+    ssize_t copied = 0;
+    while(size > 0 && (copied = copy_file_range(fileno(fileIn), &offIn, fileno(fileOut), &offOut, size, 0)) > 0)
+      size -= (size_t)copied;
+    // The offsets given to copy_file_range are updated, not the FILE streams
+    if(fseeko(fileIn, offIn, SEEK_SET) != 0 || fseeko(fileOut, offOut, SEEK_SET) != 0) return -1;
+    if(size == 0) return 0;
+  }
+#endif
+  if(fread(buffer, 1, size, fileIn) != size) return -1;
+  return (fwrite(buffer, 1, size, fileOut) == size) ? 0 : -1;
+}
+
+
+/**
+ * @see @file huffman.h / @function estimateEncryptionOfFile
+ */
+long long estimateEncryptionOfFile(char *fileIn, double samplingRate, long long *keySize, unsigned int checksums) {
+  long long fileSize = getFileSize(fileIn);
+  if(fileSize < 0) {
+    perror(fileIn);
+    return -1;
+  }
+  lst charOccurrences = charOccurrencesOfFileSampled(fileIn, samplingRate);
+  if(charOccurrences == NULL) return -1;
+  nd tree = contructBinaryTree(charOccurrences);
+  int maxPrefixLength = 0;
+  lst prefixes = (tree != NULL) ? prefixesList(tree, &maxPrefixLength) : createList();
+  destroyNode(&tree);
+  if(prefixes == NULL || (getListSize(prefixes) == 0 && getListSize(charOccurrences) > 0)) {
+    destroyList(&prefixes);
+    destroyList(&charOccurrences);
+    return -1;
+  }
+  long long nbBlocks = (fileSize + HFM_BLOCK_SIZE - 1) / HFM_BLOCK_SIZE;
+  long long containerSize = HFM_CONTAINER_HEADER_SIZE + nbBlocks * HFM_INDEX_ENTRY_SIZE;
+  if(checksums & HFM_CONTAINER_BLOCK_CRC) containerSize += nbBlocks * HFM_INDEX_CRC_SIZE;
+  if(checksums & HFM_CONTAINER_STREAM_CRC) containerSize += HFM_INDEX_CRC_SIZE;
+  size_t histogram[256];
+  histogramOfOccurrences(charOccurrences, histogram);
+  size_t tableSize = (keySize != NULL) ? keySizeOf(charOccurrences) : histogramEncodedSize(histogram);
+  long long size = fileSize + nbBlocks * HFM_BLOCK_HEADER_SIZE; // Stored, without table
+  if(keySize != NULL) *keySize = 0;
+  if(isCodingWorthIt(charOccurrences, prefixes, fileSize, tableSize)) {
+    FILE *file = fopen(fileIn, "rb");
+    if(file != NULL) {
+      char *codes[256];
+      prefixesTable(prefixes, codes);
+      unsigned char *block = (unsigned char*)malloc(HFM_BLOCK_SIZE);
+      size_t blockSize;
+      size = 0;
+      while(block != NULL && (blockSize = fread(block, 1, HFM_BLOCK_SIZE, file)) > 0) {
+        for (size_t i = 0; i < 256; i++) histogram[i] = 0;
+        for (size_t i = 0; i < blockSize; i++) histogram[block[i]]++;
+        size_t payloadSize = estimateCodedSize(histogram, codes);
+        size += HFM_BLOCK_HEADER_SIZE + (long long)((payloadSize < blockSize) ? payloadSize : blockSize);
+      }
+      if(block == NULL) size = -1;
+      else if(keySize != NULL) *keySize = (long long)tableSize;
+      else size += (long long)tableSize;
+      free(block);
+      fclose(file);
+    } else {
+      perror(fileIn);
+      size = -1;
+    }
+  }
+  if(size >= 0) size += containerSize;
+  destroyList(&charOccurrences);
+  destroyList(&prefixes);
+  return size;
+}
+
+
+/* ================================================== */
+/* ===================== PRIVATE ==================== */
+/* ========================================================================== */
+
+
+/**
+ * @see @file huffman.c / @function isCodingWorthIt
+ */
+int isCodingWorthIt(lst occurrences, lst prefixes, long long fileSize, size_t tableSize) {
+  if(fileSize <= 0 || getListSize(prefixes) == 0) return 0;
+  size_t histogram[256];
+  histogramOfOccurrences(occurrences, histogram);
+  char *codes[256];
+  prefixesTable(prefixes, codes);
+  size_t codedSize = estimateCodedSize(histogram, codes);
+  if(codedSize == SIZE_MAX) return 0;
+  // Each block may lose a byte to the padding
+  size_t nbBlocks = (size_t)fileSize / HFM_BLOCK_SIZE + 1;
+  codedSize += nbBlocks;
+  return codedSize + tableSize < (size_t)fileSize;
+}
+
+/**
+ * @see @file huffman.c / @function writeEncryptionWithTable
+ */
+int writeEncryptionWithTable(char *fileIn, char *fileOut, lst prefixes, size_t *histogram, unsigned int checksums) {
+  if(fileIn == NULL || fileOut == NULL) return -1;
+  char *codes[256];
+  for (size_t i = 0; i < 256; i++) codes[i] = NULL;
+  if(prefixes != NULL) prefixesTable(prefixes, codes);
+  if(encryptBlocksOfFile(fileIn, fileOut, histogram, checksums, encodeBlockWithCodes, codes) != 0) return -1;
+  printf("Encryption process completed\n");
+  return 0;
+}
+
+/**
+ * @see @file huffman.c / @function writeBufferWithCodes
+ */
+int writeBufferWithCodes(unsigned char *data, size_t size, FILE *fileOut, size_t *histogram, char **codes, unsigned int checksums) {
+  unsigned char *payload = (unsigned char*)malloc(HFM_BLOCK_SIZE);
+  ctn container = createContainer(histogram, checksums);
+  int result = (payload != NULL && container != NULL) ? writeContainerHeader(container, fileOut) : -1;
+  for (size_t offset = 0; result == 0 && offset < size; offset += HFM_BLOCK_SIZE) {
+    size_t blockSize = (size - offset < HFM_BLOCK_SIZE) ? size - offset : HFM_BLOCK_SIZE;
+    writeBlockOfOpenedFile(fileOut, container, data + offset, blockSize, payload, encodeBlockWithCodes, codes);
+  }
+  if(result == 0) result = finishContainer(container, fileOut);
+  destroyContainer(&container);
+  free(payload);
+  return result;
+}
+
+/**
+ * @see @file huffman.c / @function encryptInMemory
+ */
+unsigned char* encryptInMemory(unsigned char *data, size_t size, char **codes, unsigned int checksums, size_t *outSize) {
+  // Bigger than any ".hfm" file of this size: a stored block is never bigger than the data
+  size_t nbBlocks = (size + HFM_BLOCK_SIZE - 1) / HFM_BLOCK_SIZE;
+  size_t maxSize = HFM_CONTAINER_HEADER_SIZE + 256 * 10 + 64 + size
+                   + nbBlocks * (HFM_BLOCK_HEADER_SIZE + HFM_INDEX_ENTRY_SIZE + HFM_INDEX_CRC_SIZE);
+  unsigned char *out = (unsigned char*)malloc(maxSize);
+  if(out == NULL) return NULL;
+  // Unlike open_memstream, the size of fmemopen is not cut when the header is written again
+  FILE *stream = fmemopen(out, maxSize, "w+");
+  int result = -1;
+  if(stream != NULL && codes == NULL) result = encryptBufferInOpenedFile(data, size, stream, checksums);
+  else if(stream != NULL) result = writeBufferWithCodes(data, size, stream, NULL, codes, checksums);
+  off_t end = (result == 0) ? ftello(stream) : -1;
+  if(stream != NULL && fclose(stream) != 0) result = -1;
+  if(result != 0 || end < 0) {
+    free(out);
+    return NULL;
+  }
+  *outSize = (size_t)end;
+  return out;
+}
+
+/**
+ * @see @file huffman.c / @function writeBlocksWithCheckpoints
+ */
+int writeBlocksWithCheckpoints(FILE *fileIn, FILE *fileOut, ctn container, ckp checkpoint, size_t(*encode)(unsigned char *block, size_t size, unsigned char *out, void *context), void *context) {
+  struct encryptionStages stages;
+  stages.fileIn = fileIn;
+  stages.fileOut = fileOut;
+  stages.container = container;
+  stages.checkpoint = checkpoint;
+  stages.inputOffset = (long long)ftello(fileIn);
+  stages.encode = encode;
+  stages.context = context;
+  int result = runPipeline(HFM_BLOCK_SIZE, readBlockToEncrypt, encodePipelineBlock, writeEncryptedBlock, &stages);
+  if(result == 0) result = finishContainer(container, fileOut);
+  return result;
+}
+
+/**
+ * @see @file huffman.c / @function decryptBlocksWithCheckpoints
+ */
+int decryptBlocksWithCheckpoints(char *fileIn, char *fileOut, int resume, size_t(*decode)(unsigned char *payload, size_t size, unsigned char *out, size_t length, void *context), void *context) {
+  long long fileSize = getFileSize(fileIn);
+  ckp checkpoint = NULL;
+  if(resume && (checkpoint = loadCheckpoint(fileOut, HFM_CHECKPOINT_DECRYPTION, fileSize)) == NULL) return -1;
+  FILE *fileToRead = fopen(fileIn, "rb");
+  FILE *fileToWrite = fopen(fileOut, resume ? "r+b" : "wb");
+  int result = -1;
+  if(fileToRead != NULL && fileToWrite != NULL) {
+    ctn container = readContainer(fileToRead);
+    if(!resume && container != NULL && getContainerNbBlocks(container) > HFM_CHECKPOINT_BLOCKS)
+      checkpoint = createCheckpoint(fileOut, HFM_CHECKPOINT_DECRYPTION, fileSize);
+    result = (container != NULL) ? decryptBlocksFromCheckpoint(fileToRead, fileToWrite, container, checkpoint, decode, context) : -2;
+    destroyContainer(&container);
+  }
+  if(fileToRead == NULL) perror(fileIn);
+  else fclose(fileToRead);
+  if(fileToWrite == NULL) perror(fileOut);
+  else if(fclose(fileToWrite) != 0 && result == 0) result = -1;
+  // A corrupted file fails again when resumed: nothing is kept of it
+  int corrupted = !resume && (result == -2 || result == -3);
+  closeCheckpoint(&checkpoint, result == 0 || corrupted);
+  if(corrupted) remove(fileOut);
+  return result;
+}
+
+/**
+ * @see @file huffman.c / @function decryptFileWithTree
+ */
+int decryptFileWithTree(char *fileIn, char *fileOut, char *fileKey, int resume) {
+  if(fileIn == NULL || fileOut == NULL) return -1;
+  FILE *file = fopen(fileIn, "rb");
+  if(file == NULL) {
+    perror(fileIn);
+    return -1;
+  }
+  ctn container = readContainerHeader(file); // The index is read by the decryption
+  fclose(file);
+  if(container == NULL) {
+    printf("Decryption failed: '%s' is not a .hfm file\n", fileIn);
+    return -2;
+  }
+  // A file stored has neither table nor key
+  int hasTable = hasContainerTable(container);
+  nd tree = (hasTable || (fileKey != NULL && getFileSize(fileKey) >= 0)) ? getTreeFromContainer(container, fileKey) : NULL;
+  destroyContainer(&container);
+  if(hasTable && tree == NULL) {
+    printf("Decryption failed: not enough memory for the code table of '%s'\n", fileIn);
+    return -1;
+  }
+  int result = decryptBlocksWithCheckpoints(fileIn, fileOut, resume, decodeBlockWithTree, tree);
+  if(result == -2 && !hasTable && tree == NULL) {
+    printf("Decryption failed: the key of '%s' is needed\n", fileIn);
+    result = -1;
+  } else if(result == 0)
+    printf("Decryption process completed\n");
+  else if(result == -3)
+    printf("Decryption failed: '%s' does not match its checksums\n", fileIn);
+  else if(result == -2)
+    printf("Decryption failed: '%s' is corrupted\n", fileIn);
+  destroyNode(&tree);
+  return result;
+}
+
+/**
+ * @see @file huffman.c / @function decryptBlocksFromCheckpoint
+ */
+int decryptBlocksFromCheckpoint(FILE *fileIn, FILE *fileOut, ctn container, ckp checkpoint, size_t(*decode)(unsigned char *payload, size_t size, unsigned char *out, size_t length, void *context), void *context) {
+  uint32_t checksum = 0;
+  nd tableTree = NULL; // Tree of the last table block, NULL to use 'decode'
+  int result = 0;
+  size_t first = 0;
+  if(checkpoint != NULL) { // The decoding goes on after the last block of the checkpoint
+    first = getCheckpointNbBlocks(checkpoint);
+    checksum = getCheckpointChecksum(checkpoint);
+    for (size_t i = first; i > 0 && result == 0; i--) {
+      if(isContainerTableBlock(container, i - 1)) {
+        size_t histogram[256];
+        if(fseeko(fileIn, (off_t)getContainerBlockOffset(container, i - 1), SEEK_SET) != 0) result = -2;
+        else result = readTableBlockOfOpenedFile(fileIn, container, i - 1, histogram);
+        if(result == 1 && (tableTree = getTreeFromHistogram(histogram)) == NULL) result = -1;
+        result = (result < 0) ? result : 0;
+        break;
+      }
+    }
+    long long outputOffset = (first > 0) ? getCheckpointOutputOffset(checkpoint) : 0;
+    if(result == 0 && fseeko(fileIn, (off_t)getContainerBlockOffset(container, first), SEEK_SET) != 0) result = -2;
+    if(result == 0 && (fflush(fileOut) != 0 || ftruncate(fileno(fileOut), (off_t)outputOffset) != 0
+                       || fseeko(fileOut, (off_t)outputOffset, SEEK_SET) != 0))
+      result = -1;
+  }
+  struct decryptionStages stages;
+  stages.fileIn = fileIn;
+  stages.fileOut = fileOut;
+  stages.container = container;
+  stages.checkpoint = checkpoint;
+  stages.first = first;
+  stages.checksum = checksum;
+  stages.tableTree = tableTree;
+  stages.decode = decode;
+  stages.context = context;
+  if(result == 0) result = runPipeline(HFM_BLOCK_SIZE, readBlockToDecrypt, decodePipelineBlock, writeDecryptedBlock, &stages);
+  if(result == 0 && (getContainerChecksums(container) & HFM_CONTAINER_STREAM_CRC)
+     && stages.checksum != getContainerChecksum(container))
+    result = -3;
+  destroyNode(&stages.tableTree);
+  return result;
+}
+
+/**
+ * @see @file huffman.c / @function readBlockToEncrypt
+ */
+int readBlockToEncrypt(pbk block, void *stages) {
+  struct encryptionStages *encryption = (struct encryptionStages*)stages;
+  size_t size = fread(getPipelineBlockData(block), 1, HFM_BLOCK_SIZE, encryption->fileIn);
+  setPipelineBlockSize(block, size);
+  if(size > 0) return 0;
+  return ferror(encryption->fileIn) ? -1 : 1;
+}
+
+/**
+ * @see @file huffman.c / @function encodePipelineBlock
+ */
+int encodePipelineBlock(pbk block, void *stages) {
+  struct encryptionStages *encryption = (struct encryptionStages*)stages;
+  setPipelineBlockOutSize(block, encryption->encode(getPipelineBlockData(block), getPipelineBlockSize(block),
+                                                    getPipelineBlockOut(block), encryption->context));
+  return 0;
+}
+
+/**
+ * @see @file huffman.c / @function writeEncryptedBlock
+ */
+int writeEncryptedBlock(pbk block, void *stages) {
+  struct encryptionStages *encryption = (struct encryptionStages*)stages;
+  size_t size = getPipelineBlockSize(block);
+  writeCodedBlockInOpenedFile(encryption->fileOut, encryption->container, getPipelineBlockData(block), size,
+                              getPipelineBlockOut(block), getPipelineBlockOutSize(block));
+  encryption->inputOffset += (long long)size;
+  size_t nbBlocks = getContainerNbBlocks(encryption->container);
+  if(encryption->checkpoint != NULL && nbBlocks % HFM_CHECKPOINT_BLOCKS == 0)
+    return commitCheckpoint(encryption->checkpoint, encryption->fileOut, encryption->container, nbBlocks,
+                            encryption->inputOffset, getContainerChecksum(encryption->container));
+  return 0;
+}
+
+/**
+ * @see @file huffman.c / @function readBlockToDecrypt
+ */
+int readBlockToDecrypt(pbk block, void *stages) {
+  struct decryptionStages *decryption = (struct decryptionStages*)stages;
+  size_t index = decryption->first + getPipelineBlockNumber(block);
+  if(index >= getContainerNbBlocks(decryption->container)) return 1;
+  unsigned char *data = getPipelineBlockData(block);
+  if(isContainerTableBlock(decryption->container, index)) {
+    int result = readTableBlockOfOpenedFile(decryption->fileIn, decryption->container, index, (size_t*)data);
+    setPipelineBlockKind(block, HFM_BLOCK_TABLE);
+    setPipelineBlockSize(block, (result == 1) ? 256 * sizeof(size_t) : 0);
+    return (result < 0) ? result : 0;
+  }
+  char type;
+  if(readBlockHeaderInOpenedFile(decryption->fileIn, decryption->container, index, &type) != 0) return -2;
+  size_t size = getContainerBlockStoredSize(decryption->container, index) - HFM_BLOCK_HEADER_SIZE;
+  if(fread(data, 1, size, decryption->fileIn) != size) return -2;
+  setPipelineBlockKind(block, type);
+  setPipelineBlockSize(block, size);
+  return 0;
+}
+
+/**
+ * @see @file huffman.c / @function decodePipelineBlock
+ */
+int decodePipelineBlock(pbk block, void *stages) {
+  struct decryptionStages *decryption = (struct decryptionStages*)stages;
+  size_t index = decryption->first + getPipelineBlockNumber(block);
+  unsigned char *data = getPipelineBlockData(block);
+  size_t size = getPipelineBlockSize(block);
+  if(getPipelineBlockKind(block) == HFM_BLOCK_TABLE) {
+    destroyNode(&decryption->tableTree);
+    if(size > 0 && (decryption->tableTree = getTreeFromHistogram((size_t*)data)) == NULL) return -1;
+    return 0;
+  }
+  size_t length = getContainerBlockLength(decryption->container, index);
+  if(getPipelineBlockKind(block) == HFM_BLOCK_HUFFMAN) {
+    unsigned char *out = getPipelineBlockOut(block);
+    size_t decoded = (decryption->tableTree != NULL)
+                   ? decodeBlockWithTree(data, size, out, length, decryption->tableTree)
+                   : decryption->decode(data, size, out, length, decryption->context);
+    if(decoded != length) return -2;
+    data = out;
+  }
+  if((getContainerChecksums(decryption->container) & HFM_CONTAINER_BLOCK_CRC)
+     && crc32c(0, data, length) != getContainerBlockChecksum(decryption->container, index))
+    return -3;
+  return 0;
+}
+
+/**
+ * @see @file huffman.c / @function writeDecryptedBlock
+ */
+int writeDecryptedBlock(pbk block, void *stages) {
+  struct decryptionStages *decryption = (struct decryptionStages*)stages;
+  ctn container = decryption->container;
+  size_t index = decryption->first + getPipelineBlockNumber(block);
+  if(getPipelineBlockKind(block) != HFM_BLOCK_TABLE) {
+    unsigned char *data = (getPipelineBlockKind(block) == HFM_BLOCK_HUFFMAN) ? getPipelineBlockOut(block) : getPipelineBlockData(block);
+    size_t length = getContainerBlockLength(container, index);
+    if(getContainerChecksums(container) & HFM_CONTAINER_STREAM_CRC)
+      decryption->checksum = crc32c(decryption->checksum, data, length);
+    if(fwrite(data, 1, length, decryption->fileOut) != length) return -1;
+  }
+  if(decryption->checkpoint != NULL && (index + 1) % HFM_CHECKPOINT_BLOCKS == 0)
+    return commitCheckpoint(decryption->checkpoint, decryption->fileOut, NULL, index + 1,
+                            getContainerBlockOffset(container, index) + (long long)getContainerBlockStoredSize(container, index),
+                            decryption->checksum);
+  return 0;
+}
+
+/**
+ * @see @file huffman.c / @function readBlockHeaderInOpenedFile
+ */
+int readBlockHeaderInOpenedFile(FILE *fileIn, ctn container, size_t index, char *type) {
+  unsigned char header[HFM_BLOCK_HEADER_SIZE];
+  if(fread(header, 1, HFM_BLOCK_HEADER_SIZE, fileIn) != HFM_BLOCK_HEADER_SIZE) return -2;
+  size_t payloadSize = (size_t)header[1] | (size_t)header[2] << 8 | (size_t)header[3] << 16 | (size_t)header[4] << 24;
+  size_t length = (size_t)header[5] | (size_t)header[6] << 8 | (size_t)header[7] << 16 | (size_t)header[8] << 24;
+  *type = (char)header[0];
+  if(payloadSize > HFM_BLOCK_SIZE || length > HFM_BLOCK_SIZE
+     || HFM_BLOCK_HEADER_SIZE + payloadSize != getContainerBlockStoredSize(container, index)
+     || length != getContainerBlockLength(container, index))
+    return -2;
+  if(*type == HFM_BLOCK_STORED) return (payloadSize == length) ? 0 : -2;
+  if(*type == HFM_BLOCK_TABLE) return (length == 0 && payloadSize > 0) ? 0 : -2;
+  return (*type == HFM_BLOCK_HUFFMAN) ? 0 : -2;
+}
+
+/**
+ * @see @file huffman.c / @function writeBlockInOpenedFile
+ */
+void writeBlockInOpenedFile(FILE *fileW, char type, unsigned char *payload, size_t size, size_t length) {
+  unsigned char header[HFM_BLOCK_HEADER_SIZE];
+  header[0] = (unsigned char)type;
+  for (size_t i = 0; i < 4; i++) {
+    header[i+1] = (unsigned char)(size >> (8 * i));
+    header[i+5] = (unsigned char)(length >> (8 * i));
+  }
+  fwrite(header, 1, HFM_BLOCK_HEADER_SIZE, fileW);
+  if(payload != NULL) fwrite(payload, 1, size, fileW);
+}
+
+/**
+ * @see @file huffman.c / @function writeCodedBlockInOpenedFile
+ */
+void writeCodedBlockInOpenedFile(FILE *fileOut, ctn container, unsigned char *block, size_t size, unsigned char *payload, size_t payloadSize) {
+  if(payloadSize < size) {
+    writeBlockInOpenedFile(fileOut, HFM_BLOCK_HUFFMAN, payload, payloadSize, size);
+    addContainerBlock(container, HFM_BLOCK_HEADER_SIZE + payloadSize, block, size);
+  } else {
+    writeBlockInOpenedFile(fileOut, HFM_BLOCK_STORED, block, size, size);
+    addContainerBlock(container, HFM_BLOCK_HEADER_SIZE + size, block, size);
+  }
+}
+
+/**
+ * @see @file huffman.c / @function keySizeOf
+ */
+size_t keySizeOf(lst occurrences) {
+  size_t keySize = 0;
+  tpl occurrence = NULL;
+  for (size_t i = 0; i < getListSize(occurrences); i++) {
+    occurrence = (tpl)getOfList(occurrences, i);
+    keySize += 3 + (size_t)snprintf(NULL, 0, "%zu", *((size_t*)getTupleValue(occurrence))); // "c:n;"
+  }
+  return keySize;
+}
+
+
 /* ========================================================================== */
 /* ========================================================================== */
@@ -13,6 +13,15 @@
  */
 
 #include "huffman.h"
+#include "embedded.h"
+#include "reader.h"
+#include "append.h"
+#include "batch.h"
+#include "archive.h"
+#include "cache.h"
+#include "server.h"
+#include <errno.h> /**< used to check the values of the options */
+#include <limits.h> /**< used for INT_MAX and LLONG_MAX */
 
 char* TESTS_V[4] = {
   "Hello World!",
@@ -68,26 +77,278 @@ void emptyBuffer();
  */
 void setFilesNames(char *argv[], int argc, char **fileIn, char **fileOut, char **fileKey);
 
+/**
+ * @function extractOption
+ * @brief Function used to get the value of an option and remove it from argv.
+ *
+ * The option can be given as "--name value" or "--name=value". The option and
+ * its value are removed from argv so that the positional arguments keep their
+ * index.
+ *
+ * @param{char**} argv: list of argument pass to the executable.
+ * @param{int*} argc: pointer on the size of argv, updated.
+ * @param{char*} name: name of the option (ex: "--sample").
+ *
+ * @return{char*}: value of the option, NULL if the option is not given.
+ */
+char* extractOption(char *argv[], int *argc, char *name);
+
+/**
+ * @function extractFlag
+ * @brief Function used to know if a flag is given and remove it from argv.
+ *
+ * @param{char**} argv: list of argument pass to the executable.
+ * @param{int*} argc: pointer on the size of argv, updated.
+ * @param{char*} name: name of the flag (ex: "--embedded").
+ *
+ * @return{int}: 1 if the flag is given, 0 otherwise.
+ */
+int extractFlag(char *argv[], int *argc, char *name);
+
+/**
+ * @function parseRate
+ * @brief Function used to read the whole value of an option as a rate.
+ *
+ * @param{char*} value: value of the option.
+ * @param{double*} rate: receives the rate.
+ *
+ * @return{int}: 1 if the value is a number in ]0, 1], 0 otherwise.
+ */
+int parseRate(char *value, double *rate);
+
+/**
+ * @function parseInteger
+ * @brief Function used to read the whole value of an option as an integer.
+ *
+ * @param{char*} value: value of the option.
+ * @param{long long} min: smallest integer accepted.
+ * @param{long long} max: biggest integer accepted.
+ * @param{long long*} number: receives the integer.
+ *
+ * @return{int}: 1 if the value is an integer between min and max, 0 otherwise.
+ */
+int parseInteger(char *value, long long min, long long max, long long *number);
+
+/**
+ * @function parseRange
+ * @brief Function used to read the value of the option "--range".
+ *
+ * The value is "offset:length", "offset:" or "offset", the length being
+ * positive or 0. Without length, the range goes up to the end of the file.
+ *
+ * @param{char*} value: value of the option.
+ * @param{long long*} offset: receives the offset.
+ * @param{long long*} length: receives the length, -1 if it is not given.
+ *
+ * @return{int}: 1 if the value is valid, 0 otherwise.
+ */
+int parseRange(char *value, long long *offset, long long *length);
+
+/**
+ * @function displayContainerInfo
+ * @brief Function used to display the header of a ".hfm" file.
+ *
+ * Only the header and the block index are read, nothing is decoded.
+ *
+ * @param{char*} fileIn: name of the ".hfm" file.
+ *
+ * @return{int}: 0 if the header has been displayed, -1 if the file can't be
+ *               opened, -2 if it is not a ".hfm" file.
+ */
+int displayContainerInfo(char *fileIn);
+
 
 /* ================================================== */
 /* ====================== MAIN ====================== */
 /* ========================================================================== */
 
 int main(int argc, char *argv[]) {
-  printf("%c\n", 50089);
+  char *sample = extractOption(argv, &argc, "--sample");
+  char *useKey = extractOption(argv, &argc, "--use-key");
+  char *range = extractOption(argv, &argc, "--range");
+  char *threads = extractOption(argv, &argc, "--threads");
+  char *cacheDirectory = extractOption(argv, &argc, "--cache");
+  char *cacheSize = extractOption(argv, &argc, "--cache-size");
+  int embedded = extractFlag(argv, &argc, "--embedded");
+  int separateKey = extractFlag(argv, &argc, "--separate-key");
+  int resume = extractFlag(argv, &argc, "--resume");
+  int dedup = extractFlag(argv, &argc, "--dedup");
+  unsigned int checksums = extractFlag(argv, &argc, "--checksum") ? HFM_CONTAINER_CHECKSUMS : 0;
+  if(embedded && !hasEmbeddedTable()) {
+    fprintf(stderr, "No code table embedded: build with \"make TABLE=table.h\"\n");
+    return EXIT_FAILURE;
+  }
+  double samplingRate = 1;
+  long long offset = 0, length = -1, nbThreads = 0, maxCacheSize = HFM_CACHE_DEFAULT_SIZE;
+  char *usage = NULL; // Usage of the first option whose value is not valid
+  if(sample != NULL && !parseRate(sample, &samplingRate)) usage = "--sample {rate}, with 0 < rate <= 1";
+  else if(range != NULL && !parseRange(range, &offset, &length)) usage = "--range {offset}:{length}, with length >= 0";
+  else if(threads != NULL && !parseInteger(threads, 0, INT_MAX, &nbThreads)) usage = "--threads N, with N >= 0";
+  else if(cacheSize != NULL && !parseInteger(cacheSize, 0, LLONG_MAX, &maxCacheSize)) usage = "--cache-size BYTES, with BYTES >= 0";
+  if(usage != NULL) {
+    fprintf(stderr, "Wrong option value, usage: %s\n", usage);
+    return EXIT_FAILURE;
+  }
+  int result = 0; // Negative if the command failed
   if (argc >= 3) {
     char *fileOut = NULL;
     char *fileKey = NULL;
     char *fileIn = NULL;
     setFilesNames(argv, argc, &fileIn, &fileOut, &fileKey);
-    if(!strcmp("encrypt", argv[1])) {
-      printf("Encrypt file: '%s'. Output file: '%s' (Key file generated: '%s').\n", fileIn, fileOut, fileKey);
-      huffmanEncryptFile(fileIn, fileOut, fileKey);
+    if(!strcmp("encrypt", argv[1]) && resume) {
+      if(embedded) {
+#ifdef HFM_EMBEDDED_TABLE
+        printf("Resume encryption of file: '%s'. Output file: '%s' (Embedded key).\n", fileIn, fileOut);
+        result = resumeEncryptBlocksOfFile(fileIn, fileOut, embeddedEncodeBlock, NULL);
+#endif
+      } else {
+        char *key = (useKey != NULL) ? useKey : fileKey;
+        printf("Resume encryption of file: '%s'. Output file: '%s' (Key file if needed: '%s').\n", fileIn, fileOut, key);
+        result = huffmanResumeEncryptFile(fileIn, fileOut, key);
+      }
+    } else if(!strcmp("encrypt", argv[1])) {
+      if(embedded) {
+#ifdef HFM_EMBEDDED_TABLE
+        printf("Encrypt file: '%s'. Output file: '%s' (Embedded key).\n", fileIn, fileOut);
+        result = huffmanEncryptFileEmbedded(fileIn, fileOut, checksums);
+#endif
+      } else if(useKey != NULL) {
+        printf("Encrypt file: '%s'. Output file: '%s' (Key file given: '%s').\n", fileIn, fileOut, useKey);
+        result = huffmanEncryptFileWithKey(fileIn, fileOut, useKey, checksums);
+      } else if(separateKey) {
+        printf("Encrypt file: '%s'. Output file: '%s' (Key file generated: '%s').\n", fileIn, fileOut, fileKey);
+        result = huffmanEncryptFileSampled(fileIn, fileOut, fileKey, samplingRate, checksums);
+      } else {
+        printf("Encrypt file: '%s'. Output file: '%s' (Code table in the header).\n", fileIn, fileOut);
+        result = huffmanEncryptFileSampled(fileIn, fileOut, NULL, samplingRate, checksums);
+      }
+    } else if (!strcmp("decrypt", argv[1]) && resume) {
+      if(embedded) {
+#ifdef HFM_EMBEDDED_TABLE
+        if(argc >= 4) { // No key: the output comes first
+          free(fileOut);
+          fileOut = (char*)copyString(argv[3]);
+        }
+        if(fileOut != NULL) {
+          printf("Resume decryption of file: '%s'. Output file: '%s' (Embedded key).\n", fileIn, fileOut);
+          result = resumeDecryptBlocksOfFile(fileIn, fileOut, embeddedDecodeBlock, NULL);
+        } else result = -1;
+#endif
+      } else {
+        printf("Resume decryption of file: '%s'. Output file: '%s' (Key file if needed: '%s').\n", fileIn, fileOut, fileKey);
+        result = huffmanResumeDecryptFile(fileIn, fileOut, fileKey);
+      }
     } else if (!strcmp("decrypt", argv[1])) {
-      printf("Decrypt file: '%s'. Output file: '%s' (Key file given: '%s').\n", fileIn, fileOut, fileKey);
-      huffmanDecryptFile(fileIn, fileOut, fileKey);
+      if(embedded) {
+#ifdef HFM_EMBEDDED_TABLE
+        if(argc >= 4) { // No key: the output comes first
+          free(fileOut);
+          fileOut = (char*)copyString(argv[3]);
+        }
+        if(fileOut != NULL) {
+          printf("Decrypt file: '%s'. Output file: '%s' (Embedded key).\n", fileIn, fileOut);
+          result = huffmanDecryptFileEmbedded(fileIn, fileOut);
+        } else result = -1;
+#endif
+      } else if(range != NULL) {
+        printf("Decrypt bytes %s of file: '%s'. Output file: '%s' (Key file if needed: '%s').\n", range, fileIn, fileOut, fileKey);
+        result = huffmanDecryptRange(fileIn, fileOut, fileKey, offset, length);
+      } else {
+        printf("Decrypt file: '%s'. Output file: '%s' (Key file if needed: '%s').\n", fileIn, fileOut, fileKey);
+        result = huffmanDecryptFile(fileIn, fileOut, fileKey);
+      }
+    } else if (!strcmp("estimate", argv[1])) {
+      long long keySize = 0;
+      long long fileSize = getFileSize(fileIn);
+      long long size = estimateEncryptionOfFile(fileIn, samplingRate, separateKey ? &keySize : NULL, checksums);
+      if(size < 0) result = -1;
+      else {
+        printf("Estimate file: '%s'. Size: %lld bytes. Encrypted: %lld bytes + key %lld bytes", fileIn, fileSize, size, keySize);
+        if(fileSize > 0) printf(" (%.2f%%)", 100.0 * (size + keySize) / fileSize);
+        printf("\n");
+      }
+    } else if (!strcmp("info", argv[1])) {
+      result = displayContainerInfo(fileIn);
+    } else if (!strcmp("histogram", argv[1])) {
+      char *fileHist = (argc >= 4) ? copyString(argv[3]) : withExtension(fileIn, ".hist");
+      size_t histogram[256];
+      for (size_t i = 0; i < 256; i++) histogram[i] = 0;
+      if(fileHist == NULL) result = -1;
+      else if((result = histogramOfFile(fileIn, histogram)) == 0 && (result = saveHistogramInFile(histogram, fileHist)) == 0)
+        printf("Histogram of '%s' saved in '%s'\n", fileIn, fileHist);
+      free(fileHist);
+    } else if (!strcmp("merge", argv[1])) {
+      result = (argc >= 4) ? mergeHistogramFiles(argv + 3, argc - 3, argv[2]) : -1;
+      if(result == 0)
+        printf("%d histograms merged in '%s'\n", argc - 3, argv[2]);
+    } else if (!strcmp("key", argv[1])) {
+      char *keyOut = (argc >= 4) ? copyString(argv[3]) : withExtension(fileIn, ".key");
+      if(keyOut == NULL) result = -1;
+      else if((result = huffmanKeyFromHistogramFile(fileIn, keyOut)) == 0)
+        printf("Key of the histogram '%s' saved in '%s'\n", fileIn, keyOut);
+      free(keyOut);
+    } else if (!strcmp("gen-table", argv[1])) {
+      FILE *fileTable = (argc >= 4) ? fopen(argv[3], "w") : stdout;
+      if(fileTable == NULL) {
+        perror(argv[3]);
+        result = -1;
+      } else {
+        result = generateEmbeddedTable(fileIn, fileTable);
+        if(fileTable != stdout && fclose(fileTable) != 0) result = -1;
+      }
+    } else if (!strcmp("append", argv[1])) {
+      result = (argc >= 4) ? huffmanAppendFile(argv[2], argv[3], useKey, samplingRate) : -1;
+      if(result == 0)
+        printf("'%s' appended to '%s'\n", argv[2], argv[3]);
+    } else if (!strcmp("concat", argv[1])) {
+      result = (argc >= 4) ? concatenateFiles(argv + 3, argc - 3, argv[2]) : -1;
+      if(result == 0)
+        printf("%d files joined in '%s'\n", argc - 3, argv[2]);
+    } else if (!strcmp("batch", argv[1]) || !strcmp("archive", argv[1])) {
+      cch cache = NULL;
+      if(cacheDirectory != NULL)
+        cache = openCache(cacheDirectory, maxCacheSize);
+      if(!strcmp("batch", argv[1])) {
+        size_t nbFiles = 0;
+        char **files = listBatchFiles(argv[2], &nbFiles);
+        if(files == NULL) result = -1;
+        else {
+          size_t nbFailed = huffmanEncryptBatch(files, nbFiles, checksums, (int)nbThreads, cache);
+          printf("%zu files encrypted, %zu failed\n", nbFiles - nbFailed, nbFailed);
+          if(nbFailed > 0) result = -1;
+          destroyBatchFiles(&files, nbFiles);
+        }
+      } else {
+        result = (argc >= 4) ? huffmanArchiveFiles(argv + 3, argc - 3, argv[2], checksums, (int)nbThreads, cache, dedup) : -1;
+        if(result == 0) printf("Files packed in '%s'\n", argv[2]);
+      }
+      if(cache != NULL) printf("Cache '%s': %zu files reused, %zu coded\n", cacheDirectory, getCacheHits(cache), getCacheMisses(cache));
+      closeCache(&cache);
+    } else if (!strcmp("extract", argv[1])) {
+      char *directory = (argc >= 4) ? argv[3] : ".";
+      if((result = huffmanExtractFiles(argv[2], directory, argv + 4, (argc >= 5) ? argc - 4 : 0, (int)nbThreads)) == 0)
+        printf("Files of '%s' extracted in '%s'\n", argv[2], directory);
+    } else if (!strcmp("list", argv[1])) {
+      result = listArchiveMembers(argv[2]);
+    } else if (!strcmp("serve", argv[1])) {
+      result = huffmanServe(argv[2], (int)nbThreads);
+    } else if (!strcmp("request", argv[1])) {
+      int operation = (argc >= 4 && !strcmp("compress", argv[3])) ? HFM_SERVER_COMPRESS
+                    : (argc >= 4 && !strcmp("decompress", argv[3])) ? HFM_SERVER_DECOMPRESS
+                    : (argc >= 4 && !strcmp("stats", argv[3])) ? HFM_SERVER_STATS : 0;
+      if(operation == HFM_SERVER_STATS) result = huffmanServerRequest(argv[2], operation, NULL, 0, NULL, NULL);
+      else if(operation != 0 && argc >= 5) result = huffmanServerRequest(argv[2], operation, useKey, checksums, argv[4], (argc >= 6) ? argv[5] : NULL);
+      else {
+        printf("Wrong request\n");
+        result = -1;
+      }
+    } else if (!strcmp("train", argv[1])) {
+      result = (argc >= 4) ? trainDictionary(argv + 3, argc - 3, argv[2]) : -1;
+      if(result == 0)
+        printf("Dictionary trained on %d files saved in '%s'\n", argc - 3, argv[2]);
     } else {
       printf("Wrong command\n");
+      result = -1;
     }
     free(fileOut);
     free(fileKey);
@@ -115,7 +376,7 @@ int main(int argc, char *argv[]) {
     =================================================*/
     testStr(TESTS_V[0]); // example of test
   }
-  return EXIT_SUCCESS;
+  return (result < 0) ? EXIT_FAILURE : EXIT_SUCCESS;
 }
 
 
@@ -283,8 +544,14 @@ void emptyBuffer() {
  * @see @file huffman_exec.c / @function setFilesNames
  */
 void setFilesNames(char *argv[], int argc, char **fileIn, char **fileOut, char **fileKey) {
-  *(fileOut) = (char*)malloc(sizeof(char) * 101);
-  *(fileKey) = (char*)malloc(sizeof(char) * 105);
+  size_t size = 0; // Longest name given, the two extensions added to it included
+  for (int i = 2; i < argc && i < 5; i++) {
+    if(strlen(argv[i]) > size) size = strlen(argv[i]);
+  }
+  size += 9;
+  *(fileOut) = (char*)malloc(sizeof(char) * size);
+  *(fileKey) = (char*)malloc(sizeof(char) * size);
+  if(*(fileOut) == NULL || *(fileKey) == NULL) pointerAllocError();
   *(fileIn) = argv[2];
   if(!strcmp("encrypt", argv[1])) {
     if(argc >= 4) {
@@ -316,5 +583,121 @@ void setFilesNames(char *argv[], int argc, char **fileIn, char **fileOut, char *
 }
 
 
+/**
+ * @see @file huffman_exec.c / @function extractOption
+ */
+char* extractOption(char *argv[], int *argc, char *name) {
+  size_t nameLength = strlen(name);
+  for (int i = 1; i < *argc; i++) {
+    if(!strncmp(argv[i], name, nameLength)) {
+      char *value = NULL;
+      int nbArgs = 0;
+      if(argv[i][nameLength] == '=') {
+        value = argv[i] + nameLength + 1;
+        nbArgs = 1;
+      } else if(argv[i][nameLength] == '\0' && i + 1 < *argc) {
+        value = argv[i+1];
+        nbArgs = 2;
+      }
+      if(value != NULL) {
+        for (int j = i; j + nbArgs < *argc; j++) argv[j] = argv[j+nbArgs];
+        *argc -= nbArgs;
+        return value;
+      }
+    }
+  }
+  return NULL;
+}
+
+
+/**
+ * @see @file huffman_exec.c / @function extractFlag
+ */
+int extractFlag(char *argv[], int *argc, char *name) {
+  for (int i = 1; i < *argc; i++) {
+    if(!strcmp(argv[i], name)) {
+      for (int j = i; j + 1 < *argc; j++) argv[j] = argv[j+1];
+      (*argc)--;
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/**
+ * @see @file huffman_exec.c / @function parseRate
+ */
+int parseRate(char *value, double *rate) {
+  char *end = NULL;
+  errno = 0;
+  *rate = strtod(value, &end);
+  return errno == 0 && end != value && *end == '\0' && *rate > 0 && *rate <= 1; // NaN is refused too
+}
+
+/**
+ * @see @file huffman_exec.c / @function parseInteger
+ */
+int parseInteger(char *value, long long min, long long max, long long *number) {
+  char *end = NULL;
+  errno = 0;
+  *number = strtoll(value, &end, 10);
+  return errno == 0 && end != value && *end == '\0' && *number >= min && *number <= max;
+}
+
+/**
+ * @see @file huffman_exec.c / @function parseRange
+ */
+int parseRange(char *value, long long *offset, long long *length) {
+  char *end = NULL;
+  errno = 0;
+  *offset = strtoll(value, &end, 10);
+  *length = -1;
+  if(errno != 0 || end == value || (*end != '\0' && *end != ':')) return 0;
+  if(*end == '\0' || end[1] == '\0') return 1; // Up to the end of the file
+  return parseInteger(end + 1, 0, LLONG_MAX, length);
+}
+
+
+
+/**
+ * @see @file huffman_exec.c / @function displayContainerInfo
+ */
+int displayContainerInfo(char *fileIn) {
+  FILE *file = fopen(fileIn, "rb");
+  if(file == NULL) {
+    perror(fileIn);
+    return -1;
+  }
+  ctn container = readContainer(file);
+  fclose(file);
+  if(container == NULL) {
+    printf("'%s' is not a .hfm file\n", fileIn);
+    return -2;
+  }
+  long long originalSize = getContainerOriginalSize(container);
+  long long fileSize = getFileSize(fileIn);
+  size_t nbStored = 0, nbTables = 0;
+  for (size_t i = 0; i < getContainerNbBlocks(container); i++) {
+    if(isContainerTableBlock(container, i)) nbTables++;
+    else nbStored += (getContainerBlockStoredSize(container, i) - HFM_BLOCK_HEADER_SIZE == getContainerBlockLength(container, i));
+  }
+  printf("File: '%s' (format version %u)\n", fileIn, getContainerVersion(container));
+  printf("Original size: %lld bytes. Encrypted: %lld bytes", originalSize, fileSize);
+  if(originalSize > 0) printf(" (%.2f%%)", 100.0 * fileSize / originalSize);
+  printf("\nBlocks: %zu (%zu coded, %zu stored", getContainerNbBlocks(container) - nbTables, getContainerNbBlocks(container) - nbTables - nbStored, nbStored);
+  printf((nbTables > 0) ? ", %zu code tables)\n" : ")\n", nbTables);
+  if(hasContainerTable(container))
+    printf("Code table: in the header (%zu bytes)\n", histogramEncodedSize(getContainerHistogram(container)));
+  else
+    printf("Code table: in a separate key file\n");
+  unsigned int checksums = getContainerChecksums(container);
+  if(checksums & HFM_CONTAINER_STREAM_CRC) printf("Checksum: CRC32C %08x", (unsigned int)getContainerChecksum(container));
+  else printf("Checksum: none");
+  printf((checksums & HFM_CONTAINER_BLOCK_CRC) ? ", CRC32C of each block\n" : "\n");
+  destroyContainer(&container);
+  return 0;
+}
+
+
 /* ========================================================================== */
 /* ========================================================================== */
@@ -90,12 +90,13 @@ void destroyElemInList(lst l, size_t pos);
  * number of items that will be added soon if necessary.
  *
  * @param{lst} l: pointer of the list.
- * @param{int} nbNewElements: number of new elements to add in the list (can be
- * inferior to 0 if elements are removed).
+ * @param{long long} nbNewElements: number of new elements to add in the list
+ * (can be inferior to 0 if elements are removed).
  *
- * @return{void}
+ * @return{int}: 0 if the list can hold its new elements, -1 if memory can't be
+ *               allocated (the list is unchanged).
  */
-void resizeAlloc(lst l, int nbNewElements);
+int resizeAlloc(lst l, long long nbNewElements);
 
 
 /* ================================================== */
@@ -108,7 +109,7 @@ void resizeAlloc(lst l, int nbNewElements);
  */
 lst createList() {
   lst l = (lst)malloc(sizeof(struct list));
-  if(l == NULL) exit(1);
+  if(l == NULL) return NULL;
   l->numberOfElements = 0;
   l->allocatedBlocks  = 0;
   l->objectList       = NULL;
@@ -122,7 +123,7 @@ lst createList() {
  */
 lst createDefinedList(void(*destroyElem)(void **elem), void(*printElem)(void *elem)) {
   lst l = (lst)malloc(sizeof(struct list));
-  if(l == NULL) pointerAllocError();
+  if(l == NULL) return NULL;
   l->numberOfElements = 0;
   l->allocatedBlocks  = 0;
   l->objectList       = NULL;
@@ -187,7 +188,7 @@ void printList(lst l) {
   if(l == NULL) {
     printf("<List destroyed>\n");
   } else {
-    printf("<List | size: %zd ; blocks: %zd>[", l->numberOfElements, l->allocatedBlocks);
+    printf("<List | size: %zu ; blocks: %zu>[", l->numberOfElements, l->allocatedBlocks);
     if(l->objectList != NULL) {
       for(size_t i = 0; i < l->numberOfElements; i++) {
         if(l->printElem != NULL) {
@@ -205,12 +206,11 @@ void printList(lst l) {
 /**
  * @see @file list.h / @function addInList
  */
-void addInList(lst l, void *elem) {
-  if(l != NULL) {
-    resizeAlloc(l, 1);
-    l->objectList[l->numberOfElements] = elem;
-    l->numberOfElements++;
-  }
+int addInList(lst l, void *elem) {
+  if(l == NULL || resizeAlloc(l, 1) != 0) return -1;
+  l->objectList[l->numberOfElements] = elem;
+  l->numberOfElements++;
+  return 0;
 }
 
 /**
@@ -282,28 +282,28 @@ void destroyElemInList(lst l, size_t pos) {
 /**
  * @see @file list.c / @function resizeAlloc
  */
-void resizeAlloc(lst l, int nbNewElements) {
+int resizeAlloc(lst l, long long nbNewElements) {
   if(l != NULL) {
-    unsigned int size = 0;
-    int N = l->numberOfElements + nbNewElements;
-    int B = l->allocatedBlocks;
+    size_t size = 0;
+    size_t N = (size_t)((long long)l->numberOfElements + nbNewElements);
+    size_t B = l->allocatedBlocks;
     if(l->objectList == NULL) {
       size = 2 * sizeof(void*);
       l->objectList = (void**)malloc(size);
-      if(l->objectList == NULL) pointerAllocError();
+      if(l->objectList == NULL) return -1;
       l->allocatedBlocks = size;
       B = size;
     }
-    int actualSize = (int)(N*sizeof(void*));
-    // printf("%d: %d <-> %d\n", N, actualSize, B);
+    size_t actualSize = N*sizeof(void*);
+    // printf("%zu: %zu <-> %zu\n", N, actualSize, B);
     if(N == 0) {
       emptyTheList(l);
     } else if(actualSize > B) {
       // printf("RESIZE +\n");
       size = actualSize + B / 2;
       void **ptr = (void**)realloc(l->objectList, size);
-      if(ptr != NULL) l->objectList = ptr;
-      else pointerAllocError();
+      if(ptr == NULL) return -1;
+      l->objectList = ptr;
       l->allocatedBlocks = size;
     } else if(actualSize < B/2) {
       // printf("RESIZE -\n");
@@ -314,6 +314,7 @@ void resizeAlloc(lst l, int nbNewElements) {
       // l->allocatedBlocks = size;
     }
   }
+  return 0;
 }
 
 
@@ -65,6 +65,7 @@ struct node {
  */
 nd createNode(void *tag) {
   nd node = (nd)malloc(sizeof(struct node));
+  if(node == NULL) return NULL;
 
   node->left       = NULL;
   node->right      = NULL;
@@ -80,6 +81,7 @@ nd createNode(void *tag) {
  */
 nd createDefinedNode(void *tag, void(*destroyTag)(void **elem), void(*printTag)(void *elem)) {
   nd node = (nd)malloc(sizeof(struct node));
+  if(node == NULL) return NULL;
 
   node->left       = NULL;
   node->right      = NULL;
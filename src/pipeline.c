@@ -0,0 +1,449 @@
+/**
+ * @file pipeline.c
+ * @author agent <agent@local>
+ * @standard C99
+ * @version 1.0
+ * @date 18th October 2026
+ *
+ * @brief Implementation file for "pipeline.h"
+ *
+ * This file implements the pipeline running a reader, a coder and a writer at
+ * the same time on a ring of blocks.
+ *
+ * Each stage counts the blocks it has handed over in a counter of its own,
+ * which only it writes: the ring between two stages is a single producer and
+ * single consumer ring, its head and its tail being these atomic counters. A
+ * stage waiting for a counter reads it a few times, then sleeps. As in the
+ * scheduler, a stage counts itself sleeping before reading the counter under
+ * the lock, and a stage counts its block before reading the stages sleeping,
+ * so that one of them at least sees the other. The lock is only taken when a
+ * ring is empty or full.
+ *
+ * Overview about private functions of pipeline:
+ *  - readerThread
+ *  - coderThread
+ *  - writeBlocks
+ *  - runStagesInOrder
+ *  - waitBlocks
+ *  - giveBlock
+ *  - isPipelineStopped
+ *  - stopPipeline
+ *
+ * Overview about the pipeline block structure functions:
+ *  - getPipelineBlockNumber
+ *  - getPipelineBlockData
+ *  - getPipelineBlockSize
+ *  - setPipelineBlockSize
+ *  - getPipelineBlockOut
+ *  - getPipelineBlockOutSize
+ *  - setPipelineBlockOutSize
+ *  - getPipelineBlockKind
+ *  - setPipelineBlockKind
+ *
+ * Overview about public functions of pipeline:
+ *  - runPipeline
+ */
+
+#define _GNU_SOURCE /**< the pthreads */
+#include "pipeline.h"
+
+#include <pthread.h>
+
+#define HFM_PIPELINE_SPINS 256 /**< Readings of a counter before sleeping */
+
+
+/**
+ * @struct pipelineBlock
+ * @brief A block of the ring of a pipeline.
+ */
+struct pipelineBlock {
+  size_t number; /**< Number of the block in the sequence */
+  unsigned char *data; /**< Data read */
+  size_t size; /**< Size of the data read */
+  unsigned char *out; /**< Data coded */
+  size_t outSize; /**< Size of the data coded */
+  int kind; /**< Free for the stages */
+  int status; /**< Given by the reader: 0, 1 after the last block, < 0 on error */
+  int error; /**< Given by the coder: 0, < 0 on error */
+};
+
+/**
+ * @struct pipeline
+ * @brief The ring of blocks and the stages of a pipeline.
+ *
+ * Each stage takes the blocks of the ring in order. The reader can fill the
+ * blocks up to 'nbWritten' + HFM_PIPELINE_SLOTS, the coder can code the ones
+ * up to 'nbRead', and the writer can write the ones up to 'nbCoded'.
+ */
+struct pipeline {
+  struct pipelineBlock blocks[HFM_PIPELINE_SLOTS]; /**< The ring of blocks */
+  size_t nbRead; /**< Blocks given by the reader (atomic) */
+  size_t nbCoded; /**< Blocks given by the coder (atomic) */
+  size_t nbWritten; /**< Blocks given back by the writer (atomic) */
+  int sleeping; /**< Stages sleeping (atomic) */
+  pthread_mutex_t lock; /**< Taken to sleep, or to wake the stages sleeping */
+  pthread_cond_t given; /**< Signaled when a block is given to a stage sleeping */
+  int stopped; /**< 1 once a stage has failed */
+  int (*readBlock)(pbk block, void *context); /**< Reader stage */
+  int (*codeBlock)(pbk block, void *context); /**< Coder stage */
+  int (*writeBlock)(pbk block, void *context); /**< Writer stage */
+  void *context; /**< Context given to the stages */
+};
+
+
+/* ================================================== */
+/* ============== DEF PRIVATE FUNCTIONS ============= */
+/* ========================================================================== */
+
+
+/**
+ * @function readerThread
+ * @brief Fills the blocks given back by the writer, until the end of the input.
+ *
+ * Once the pipeline is stopped, the next block is marked as the last one
+ * without being read, so that the other stages end too.
+ *
+ * @param{void*} pipeline: the struct pipeline.
+ *
+ * @return{void*}: NULL.
+ */
+void* readerThread(void *pipeline);
+
+/**
+ * @function coderThread
+ * @brief Codes the blocks given by the reader, until the last one.
+ *
+ * @param{void*} pipeline: the struct pipeline.
+ *
+ * @return{void*}: NULL.
+ */
+void* coderThread(void *pipeline);
+
+/**
+ * @function writeBlocks
+ * @brief Writes the blocks given by the coder, until the last one.
+ *
+ * After an error, the blocks are given back to the reader without being
+ * written, until the reader stops.
+ *
+ * @param{struct pipeline*} pipeline: the pipeline.
+ *
+ * @return{int}: 0 or the first error of the stages.
+ */
+int writeBlocks(struct pipeline *pipeline);
+
+/**
+ * @function runStagesInOrder
+ * @brief Reads, codes and writes each block in the calling thread.
+ *
+ * @param{struct pipeline*} pipeline: the pipeline.
+ *
+ * @return{int}: 0 or the first error of the stages.
+ */
+int runStagesInOrder(struct pipeline *pipeline);
+
+/**
+ * @function waitBlocks
+ * @brief Waits until a stage has given a number of blocks.
+ *
+ * @param{struct pipeline*} pipeline: the pipeline.
+ * @param{size_t*} counter: the counter of the blocks given by the stage.
+ * @param{size_t} nbBlocks: number of blocks to wait for.
+ *
+ * @return{void}
+ */
+void waitBlocks(struct pipeline *pipeline, size_t *counter, size_t nbBlocks);
+
+/**
+ * @function giveBlock
+ * @brief Gives the next block to the next stage, and wakes the stages
+ * sleeping.
+ *
+ * @param{struct pipeline*} pipeline: the pipeline.
+ * @param{size_t*} counter: the counter of the blocks given by the stage.
+ *
+ * @return{void}
+ */
+void giveBlock(struct pipeline *pipeline, size_t *counter);
+
+/**
+ * @function isPipelineStopped
+ * @brief Tells if a stage has failed.
+ *
+ * @param{struct pipeline*} pipeline: the pipeline.
+ *
+ * @return{int}: 1 if the pipeline is stopped, 0 otherwise.
+ */
+int isPipelineStopped(struct pipeline *pipeline);
+
+/**
+ * @function stopPipeline
+ * @brief Stops the pipeline after an error.
+ *
+ * @param{struct pipeline*} pipeline: the pipeline.
+ *
+ * @return{void}
+ */
+void stopPipeline(struct pipeline *pipeline);
+
+
+/* ================================================== */
+/* ================ STRUCT FUNCTIONS ================ */
+/* ========================================================================== */
+
+
+/**
+ * @see @file pipeline.h / @function getPipelineBlockNumber
+ */
+size_t getPipelineBlockNumber(pbk block) {
+  return block->number;
+}
+
+/**
+ * @see @file pipeline.h / @function getPipelineBlockData
+ */
+unsigned char* getPipelineBlockData(pbk block) {
+  return block->data;
+}
+
+/**
+ * @see @file pipeline.h / @function getPipelineBlockSize
+ */
+size_t getPipelineBlockSize(pbk block) {
+  return block->size;
+}
+
+/**
+ * @see @file pipeline.h / @function setPipelineBlockSize
+ */
+void setPipelineBlockSize(pbk block, size_t size) {
+  block->size = size;
+}
+
+/**
+ * @see @file pipeline.h / @function getPipelineBlockOut
+ */
+unsigned char* getPipelineBlockOut(pbk block) {
+  return block->out;
+}
+
+/**
+ * @see @file pipeline.h / @function getPipelineBlockOutSize
+ */
+size_t getPipelineBlockOutSize(pbk block) {
+  return block->outSize;
+}
+
+/**
+ * @see @file pipeline.h / @function setPipelineBlockOutSize
+ */
+void setPipelineBlockOutSize(pbk block, size_t size) {
+  block->outSize = size;
+}
+
+/**
+ * @see @file pipeline.h / @function getPipelineBlockKind
+ */
+int getPipelineBlockKind(pbk block) {
+  return block->kind;
+}
+
+/**
+ * @see @file pipeline.h / @function setPipelineBlockKind
+ */
+void setPipelineBlockKind(pbk block, int kind) {
+  block->kind = kind;
+}
+
+
+/* ================================================== */
+/* ===================== PUBLIC ===================== */
+/* ========================================================================== */
+
+
+/**
+ * @see @file pipeline.h / @function runPipeline
+ */
+int runPipeline(size_t bufferSize, int(*readBlock)(pbk block, void *context), int(*codeBlock)(pbk block, void *context), int(*writeBlock)(pbk block, void *context), void *context) {
+  struct pipeline *pipeline = (struct pipeline*)malloc(sizeof(struct pipeline));
+  if(pipeline == NULL) return -1;
+  int allocated = 1;
+  for (size_t i = 0; i < HFM_PIPELINE_SLOTS; i++) {
+    pipeline->blocks[i].data = (unsigned char*)malloc(bufferSize);
+    pipeline->blocks[i].out = (unsigned char*)malloc(bufferSize);
+    if(pipeline->blocks[i].data == NULL || pipeline->blocks[i].out == NULL) allocated = 0;
+  }
+  if(!allocated) {
+    for (size_t i = 0; i < HFM_PIPELINE_SLOTS; i++) {
+      free(pipeline->blocks[i].data);
+      free(pipeline->blocks[i].out);
+    }
+    free(pipeline);
+    return -1;
+  }
+  pipeline->stopped = 0;
+  pipeline->readBlock = readBlock;
+  pipeline->codeBlock = codeBlock;
+  pipeline->writeBlock = writeBlock;
+  pipeline->context = context;
+  pipeline->nbRead = 0;
+  pipeline->nbCoded = 0;
+  pipeline->nbWritten = 0;
+  pipeline->sleeping = 0;
+  pthread_mutex_init(&pipeline->lock, NULL);
+  pthread_cond_init(&pipeline->given, NULL);
+  int result;
+  pthread_t coder, reader;
+  if(pthread_create(&coder, NULL, coderThread, pipeline) != 0) {
+    result = runStagesInOrder(pipeline);
+  } else if(pthread_create(&reader, NULL, readerThread, pipeline) != 0) {
+    pipeline->blocks[0].status = 1; // The coder ends at once
+    giveBlock(pipeline, &pipeline->nbRead);
+    pthread_join(coder, NULL);
+    result = runStagesInOrder(pipeline);
+  } else {
+    result = writeBlocks(pipeline);
+    pthread_join(reader, NULL);
+    pthread_join(coder, NULL);
+  }
+  pthread_cond_destroy(&pipeline->given);
+  pthread_mutex_destroy(&pipeline->lock);
+  for (size_t i = 0; i < HFM_PIPELINE_SLOTS; i++) {
+    free(pipeline->blocks[i].data);
+    free(pipeline->blocks[i].out);
+  }
+  free(pipeline);
+  return result;
+}
+
+
+/* ================================================== */
+/* ===================== PRIVATE ==================== */
+/* ========================================================================== */
+
+
+/**
+ * @see @file pipeline.c / @function readerThread
+ */
+void* readerThread(void *pipeline) {
+  struct pipeline *p = (struct pipeline*)pipeline;
+  for (size_t n = 0; ; n++) {
+    if(n >= HFM_PIPELINE_SLOTS) waitBlocks(p, &p->nbWritten, n + 1 - HFM_PIPELINE_SLOTS);
+    pbk block = &p->blocks[n % HFM_PIPELINE_SLOTS];
+    block->number = n;
+    block->size = 0;
+    block->outSize = 0;
+    block->kind = 0;
+    block->error = 0;
+    block->status = isPipelineStopped(p) ? 1 : p->readBlock(block, p->context);
+    if(block->status > 0) block->status = 1;
+    giveBlock(p, &p->nbRead);
+    if(block->status != 0) break;
+  }
+  return NULL;
+}
+
+/**
+ * @see @file pipeline.c / @function coderThread
+ */
+void* coderThread(void *pipeline) {
+  struct pipeline *p = (struct pipeline*)pipeline;
+  for (size_t n = 0; ; n++) {
+    waitBlocks(p, &p->nbRead, n + 1);
+    pbk block = &p->blocks[n % HFM_PIPELINE_SLOTS];
+    if(block->status == 0 && !isPipelineStopped(p)) {
+      block->error = p->codeBlock(block, p->context);
+      if(block->error < 0) stopPipeline(p);
+    }
+    int last = block->status != 0;
+    giveBlock(p, &p->nbCoded);
+    if(last) break;
+  }
+  return NULL;
+}
+
+/**
+ * @see @file pipeline.c / @function writeBlocks
+ */
+int writeBlocks(struct pipeline *pipeline) {
+  int result = 0;
+  for (size_t n = 0; ; n++) {
+    waitBlocks(pipeline, &pipeline->nbCoded, n + 1);
+    pbk block = &pipeline->blocks[n % HFM_PIPELINE_SLOTS];
+    if(block->status != 0) {
+      if(block->status < 0 && result == 0) result = block->status;
+      break;
+    }
+    if(result == 0 && block->error < 0) result = block->error;
+    else if(result == 0) result = pipeline->writeBlock(block, pipeline->context);
+    if(result < 0) stopPipeline(pipeline);
+    else result = 0;
+    giveBlock(pipeline, &pipeline->nbWritten);
+  }
+  return result;
+}
+
+/**
+ * @see @file pipeline.c / @function runStagesInOrder
+ */
+int runStagesInOrder(struct pipeline *pipeline) {
+  pbk block = &pipeline->blocks[0];
+  int result = 0;
+  for (size_t n = 0; result == 0; n++) {
+    block->number = n;
+    block->size = 0;
+    block->outSize = 0;
+    block->kind = 0;
+    result = pipeline->readBlock(block, pipeline->context);
+    if(result > 0) return 0;
+    if(result == 0) result = pipeline->codeBlock(block, pipeline->context);
+    if(result == 0) result = pipeline->writeBlock(block, pipeline->context);
+    if(result > 0) result = 0;
+  }
+  return result;
+}
+
+/**
+ * @see @file pipeline.c / @function waitBlocks
+ */
+void waitBlocks(struct pipeline *pipeline, size_t *counter, size_t nbBlocks) {
+  for (int i = 0; i < HFM_PIPELINE_SPINS; i++) {
+    if(__atomic_load_n(counter, __ATOMIC_ACQUIRE) >= nbBlocks) return;
+  }
+  pthread_mutex_lock(&pipeline->lock);
+  __atomic_add_fetch(&pipeline->sleeping, 1, __ATOMIC_SEQ_CST);
+  while(__atomic_load_n(counter, __ATOMIC_SEQ_CST) < nbBlocks)
+    pthread_cond_wait(&pipeline->given, &pipeline->lock);
+  __atomic_sub_fetch(&pipeline->sleeping, 1, __ATOMIC_SEQ_CST);
+  pthread_mutex_unlock(&pipeline->lock);
+}
+
+/**
+ * @see @file pipeline.c / @function giveBlock
+ */
+void giveBlock(struct pipeline *pipeline, size_t *counter) {
+  // Only the stage writes its counter
+  __atomic_store_n(counter, *counter + 1, __ATOMIC_SEQ_CST);
+  if(__atomic_load_n(&pipeline->sleeping, __ATOMIC_SEQ_CST) > 0) {
+    pthread_mutex_lock(&pipeline->lock);
+    pthread_cond_broadcast(&pipeline->given);
+    pthread_mutex_unlock(&pipeline->lock);
+  }
+}
+
+/**
+ * @see @file pipeline.c / @function isPipelineStopped
+ */
+int isPipelineStopped(struct pipeline *pipeline) {
+  return __atomic_load_n(&pipeline->stopped, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * @see @file pipeline.c / @function stopPipeline
+ */
+void stopPipeline(struct pipeline *pipeline) {
+  __atomic_store_n(&pipeline->stopped, 1, __ATOMIC_RELEASE);
+}
+
+/* ========================================================================== */
+/* ========================================================================== */
@@ -0,0 +1,322 @@
+/**
+ * @file reader.c
+ * @author agent <agent@local>
+ * @standard C99
+ * @version 1.0
+ * @date 18th October 2026
+ *
+ * @brief Implementation file for "reader.h"
+ *
+ * This file implements the random access to the ".hfm" files and the cache of
+ * the blocks decoded.
+ *
+ * Overview about private functions of reader:
+ *  - getCachedBlock
+ *  - getBlockTree
+ *
+ * Overview about the reader structure functions:
+ *  - openReader
+ *  - openReaderOfOpenedFile
+ *  - closeReader
+ *  - getReaderSize
+ *  - getReaderContainer
+ *
+ * Overview about public functions of reader:
+ *  - readRange
+ *  - huffmanDecryptRange
+ */
+
+#define _GNU_SOURCE
+#include "reader.h"
+
+
+/**
+ * @struct cachedBlock
+ * @brief A block decoded and kept in the cache.
+ */
+struct cachedBlock {
+  size_t index; /**< Index of the block, SIZE_MAX if the entry is free */
+  unsigned long long lastUse; /**< Value of the clock of the reader at the last use */
+  unsigned char *data; /**< The decoded block (HFM_BLOCK_SIZE bytes) */
+};
+
+/**
+ * @struct reader
+ * @brief An opened ".hfm" file with its tree and its cache.
+ */
+struct reader {
+  FILE *file; /**< The ".hfm" file */
+  ctn container; /**< Its header and its block index */
+  nd tree; /**< The tree decoding its blocks */
+  size_t *tables; /**< Table block governing each block, SIZE_MAX for 'tree' */
+  nd *tableTrees; /**< Tree of each table block, loaded at its first use */
+  signed char *tableStates; /**< -1 if not loaded, else 1 with a histogram, 0 for the key */
+  unsigned char *payload; /**< Buffer for the payloads read */
+  struct cachedBlock *cache; /**< The blocks decoded */
+  size_t cacheSize; /**< Number of entries of the cache */
+  unsigned long long clock; /**< Incremented at each use of the cache */
+};
+
+
+/* ================================================== */
+/* ============== DEF PRIVATE FUNCTIONS ============= */
+/* ========================================================================== */
+
+
+/**
+ * @function getCachedBlock
+ * @brief Gives a decoded block, from the cache or decoded in it.
+ *
+ * If the block is not in the cache, it replaces the least recently used one.
+ *
+ * @param{rdr} reader: the reader.
+ * @param{size_t} index: index of the block.
+ * @param{unsigned char**} block: receives the decoded block.
+ *
+ * @return{int}: 0 if the block is given, -1 if memory can't be allocated, -2
+ *               if it is corrupted, -3 if it does not match its checksum.
+ */
+int getCachedBlock(rdr reader, size_t index, unsigned char **block);
+
+/**
+ * @function getBlockTree
+ * @brief Gives the tree decoding a block, reading its table block if needed.
+ *
+ * @param{rdr} reader: the reader.
+ * @param{size_t} index: index of the block.
+ * @param{nd*} tree: receives the tree.
+ *
+ * @return{int}: 0 if the tree is given, -1 if memory can't be allocated, -2 if
+ *               its table block is corrupted.
+ */
+int getBlockTree(rdr reader, size_t index, nd *tree);
+
+
+/* ================================================== */
+/* ================ STRUCT FUNCTIONS ================ */
+/* ========================================================================== */
+
+
+/**
+ * @see @file reader.h / @function openReader
+ */
+rdr openReader(char *fileIn, char *fileKey, size_t cacheSize) {
+  FILE *file = fopen(fileIn, "rb");
+  if(file == NULL) {
+    perror(fileIn);
+    return NULL;
+  }
+  rdr reader = openReaderOfOpenedFile(file, fileKey, cacheSize);
+  if(reader == NULL) {
+    printf("'%s' is not a .hfm file\n", fileIn);
+    fclose(file);
+  }
+  return reader;
+}
+
+/**
+ * @see @file reader.h / @function openReaderOfOpenedFile
+ */
+rdr openReaderOfOpenedFile(FILE *file, char *fileKey, size_t cacheSize) {
+  ctn container = readContainer(file);
+  if(container == NULL) return NULL;
+  rdr reader = (rdr)malloc(sizeof(struct reader));
+  if(reader == NULL) {
+    destroyContainer(&container);
+    return NULL;
+  }
+  reader->file = file;
+  reader->container = container;
+  size_t nbBlocks = getContainerNbBlocks(container);
+  reader->cacheSize = (cacheSize > 0) ? cacheSize : 1;
+  reader->tables = (size_t*)malloc((nbBlocks > 0 ? nbBlocks : 1) * sizeof(size_t));
+  reader->tableTrees = (nd*)calloc(nbBlocks > 0 ? nbBlocks : 1, sizeof(nd));
+  reader->tableStates = (signed char*)malloc(nbBlocks > 0 ? nbBlocks : 1);
+  reader->payload = (unsigned char*)malloc(HFM_BLOCK_SIZE);
+  reader->cache = (struct cachedBlock*)malloc(reader->cacheSize * sizeof(struct cachedBlock));
+  int isAllocated = reader->tables != NULL && reader->tableTrees != NULL && reader->tableStates != NULL
+                    && reader->payload != NULL && reader->cache != NULL;
+  reader->tree = isAllocated ? getTreeFromContainer(container, fileKey) : NULL;
+  if(!isAllocated || (reader->tree == NULL && hasContainerTable(container))) {
+    free(reader->cache);
+    free(reader->payload);
+    free(reader->tableStates);
+    free(reader->tableTrees);
+    free(reader->tables);
+    destroyContainer(&reader->container);
+    free(reader);
+    return NULL;
+  }
+  size_t table = SIZE_MAX;
+  for (size_t i = 0; i < nbBlocks; i++) {
+    if(isContainerTableBlock(container, i)) table = i;
+    reader->tables[i] = table;
+    reader->tableStates[i] = -1;
+  }
+  reader->clock = 0;
+  for (size_t i = 0; i < reader->cacheSize; i++) {
+    reader->cache[i].index = SIZE_MAX;
+    reader->cache[i].lastUse = 0;
+    reader->cache[i].data = NULL; // Allocated at its first use
+  }
+  return reader;
+}
+
+/**
+ * @see @file reader.h / @function closeReader
+ */
+void closeReader(rdr *reader) {
+  if(*reader != NULL) {
+    for (size_t i = 0; i < (*reader)->cacheSize; i++) free((*reader)->cache[i].data);
+    free((*reader)->cache);
+    free((*reader)->payload);
+    for (size_t i = 0; i < getContainerNbBlocks((*reader)->container); i++) destroyNode(&(*reader)->tableTrees[i]);
+    free((*reader)->tableTrees);
+    free((*reader)->tableStates);
+    free((*reader)->tables);
+    destroyNode(&(*reader)->tree);
+    destroyContainer(&(*reader)->container);
+    fclose((*reader)->file);
+    free(*reader);
+    *reader = NULL;
+  }
+}
+
+/**
+ * @see @file reader.h / @function getReaderSize
+ */
+long long getReaderSize(rdr reader) {
+  return getContainerOriginalSize(reader->container);
+}
+
+/**
+ * @see @file reader.h / @function getReaderContainer
+ */
+ctn getReaderContainer(rdr reader) {
+  return reader->container;
+}
+
+
+/* ================================================== */
+/* ===================== PUBLIC ===================== */
+/* ========================================================================== */
+
+
+/**
+ * @see @file reader.h / @function readRange
+ */
+long long readRange(rdr reader, long long offset, size_t length, unsigned char *out) {
+  long long size = getReaderSize(reader);
+  if(offset < 0 || offset >= size) return 0;
+  if((long long)length > size - offset) length = (size_t)(size - offset);
+  size_t index = findContainerBlock(reader->container, offset);
+  size_t done = 0;
+  while(done < length) {
+    if(getContainerBlockLength(reader->container, index) == 0) { // Table block
+      index++;
+      continue;
+    }
+    unsigned char *block = NULL;
+    int result = getCachedBlock(reader, index, &block);
+    if(result != 0) return result;
+    size_t start = (size_t)(offset + (long long)done - getContainerBlockStart(reader->container, index));
+    size_t part = getContainerBlockLength(reader->container, index) - start;
+    if(part > length - done) part = length - done;
+    memcpy(out + done, block + start, part);
+    done += part;
+    index++;
+  }
+  return (long long)done;
+}
+
+/**
+ * @see @file reader.h / @function huffmanDecryptRange
+ */
+int huffmanDecryptRange(char *fileIn, char *fileOut, char *fileKey, long long offset, long long length) {
+  rdr reader = openReader(fileIn, fileKey, HFM_READER_CACHE_BLOCKS);
+  if(reader == NULL) return -1;
+  long long size = getReaderSize(reader);
+  if(offset < 0) offset = (size + offset > 0) ? size + offset : 0;
+  if(length < 0 || length > size - offset) length = (offset < size) ? size - offset : 0;
+  FILE *fileToWrite = fopen(fileOut, "wb");
+  if(fileToWrite == NULL) {
+    perror(fileOut);
+    closeReader(&reader);
+    return -1;
+  }
+  unsigned char *buffer = (unsigned char*)malloc(HFM_BLOCK_SIZE);
+  long long result = (buffer != NULL) ? 0 : -1;
+  while(length > 0 && result >= 0) {
+    result = readRange(reader, offset, (length < HFM_BLOCK_SIZE) ? (size_t)length : HFM_BLOCK_SIZE, buffer);
+    if(result > 0) {
+      fwrite(buffer, 1, (size_t)result, fileToWrite);
+      offset += result;
+      length -= result;
+    }
+  }
+  if(result >= 0) printf("Decryption process completed\n");
+  else if(result == -1) perror(fileOut);
+  else if(result == -3) printf("Decryption failed: '%s' does not match its checksums\n", fileIn);
+  else printf("Decryption failed: '%s' is corrupted\n", fileIn);
+  free(buffer);
+  fclose(fileToWrite);
+  closeReader(&reader);
+  return (result >= 0) ? 0 : (int)result;
+}
+
+
+/* ================================================== */
+/* ===================== PRIVATE ==================== */
+/* ========================================================================== */
+
+
+/**
+ * @see @file reader.c / @function getCachedBlock
+ */
+int getCachedBlock(rdr reader, size_t index, unsigned char **block) {
+  struct cachedBlock *entry = &reader->cache[0];
+  for (size_t i = 0; i < reader->cacheSize; i++) {
+    if(reader->cache[i].index == index) {
+      reader->cache[i].lastUse = ++reader->clock;
+      *block = reader->cache[i].data;
+      return 0;
+    }
+    if(reader->cache[i].lastUse < entry->lastUse) entry = &reader->cache[i];
+  }
+  if(entry->data == NULL) {
+    entry->data = (unsigned char*)malloc(HFM_BLOCK_SIZE);
+    if(entry->data == NULL) return -1;
+  }
+  entry->index = SIZE_MAX; // Free until the block is decoded
+  entry->lastUse = 0;
+  nd tree = NULL;
+  int result = getBlockTree(reader, index, &tree);
+  if(result != 0) return result;
+  if(fseeko(reader->file, (off_t)getContainerBlockOffset(reader->container, index), SEEK_SET) != 0) return -2;
+  result = readBlockOfOpenedFile(reader->file, reader->container, index, reader->payload, entry->data, decodeBlockWithTree, tree);
+  if(result != 0) return result;
+  entry->index = index;
+  entry->lastUse = ++reader->clock;
+  *block = entry->data;
+  return 0;
+}
+
+/**
+ * @see @file reader.c / @function getBlockTree
+ */
+int getBlockTree(rdr reader, size_t index, nd *tree) {
+  size_t table = reader->tables[index];
+  if(table != SIZE_MAX && reader->tableStates[table] < 0) {
+    size_t histogram[256];
+    if(fseeko(reader->file, (off_t)getContainerBlockOffset(reader->container, table), SEEK_SET) != 0) return -2;
+    int result = readTableBlockOfOpenedFile(reader->file, reader->container, table, histogram);
+    if(result < 0) return -2;
+    if(result == 1 && (reader->tableTrees[table] = getTreeFromHistogram(histogram)) == NULL) return -1;
+    reader->tableStates[table] = (signed char)result;
+  }
+  *tree = (table != SIZE_MAX && reader->tableStates[table] == 1) ? reader->tableTrees[table] : reader->tree;
+  return 0;
+}
+
+/* ========================================================================== */
+/* ========================================================================== */
@@ -0,0 +1,608 @@
+/**
+ * @file scheduler.c
+ * @author agent <agent@local>
+ * @standard C99
+ * @version 1.0
+ * @date 18th October 2026
+ *
+ * @brief Implementation file for "scheduler.h"
+ *
+ * This file implements the workers and their queues, the placement of the
+ * workers on the processors, the groups of tasks and the counters.
+ *
+ * A queue is a ring of tasks with its own lock, grown when it is full: its
+ * worker pops at its end, and the others steal at its start. The number of
+ * tasks in the queues is an atomic counter, and so is the number of workers
+ * sleeping: a worker counts itself sleeping before reading the tasks under the
+ * lock of the scheduler, and a submitter counts its task before reading the
+ * workers sleeping, so that one of them at least sees the other, and a task is
+ * never left with all the workers asleep.
+ *
+ * A task of a group is only counted done under the lock of its group, so that
+ * the group can be freed as soon as its waiter has seen it done.
+ *
+ * With HFM_SCHEDULER_NUMA, the processors of each node are read in
+ * "/sys/devices/system/node", and the workers are given to the nodes in turn:
+ * a worker is bound to the processors of its node (to one of them with
+ * HFM_SCHEDULER_PIN) before allocating its queue and its scratch space, so the
+ * system puts their pages in the memory of the node.
+ *
+ * Overview about private functions of scheduler:
+ *  - schedulerNanos
+ *  - readSchedulerCpuList
+ *  - placeSchedulerWorkers
+ *  - pushSchedulerTask
+ *  - takeSchedulerTask
+ *  - runSchedulerTask
+ *  - schedulerWorkerThread
+ *
+ * Overview about the scheduler structure functions:
+ *  - createScheduler
+ *  - destroyScheduler
+ *  - getSchedulerSize
+ *  - getSchedulerWorker
+ *  - getSchedulerCounters
+ *  - printSchedulerStats
+ *
+ * Overview about the task functions:
+ *  - createSchedulerGroup
+ *  - destroySchedulerGroup
+ *  - submitSchedulerTask
+ *  - waitSchedulerGroup
+ */
+
+#define _GNU_SOURCE /**< pthread_setaffinity_np and the CPU sets */
+#include "scheduler.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+
+#define HFM_SCHEDULER_QUEUE_SIZE 256 /**< First capacity of a queue */
+#define HFM_SCHEDULER_MAX_NODES 64 /**< NUMA nodes looked for */
+#define HFM_SCHEDULER_HELP_DELAY 1000000 /**< Nanoseconds a waiting worker sleeps without task */
+
+
+/**
+ * @struct schedulerTask
+ * @brief A function to run, with its argument.
+ */
+struct schedulerTask {
+  schedulerFunction function; /**< The function */
+  void *arg; /**< Its argument */
+  sgp group; /**< Group of the task, NULL if none */
+};
+
+/**
+ * @struct schedulerGroup
+ * @brief Tasks waited together.
+ */
+struct schedulerGroup {
+  long pending; /**< Tasks submitted and not done */
+  pthread_mutex_t lock; /**< Lock of the counter */
+  pthread_cond_t done; /**< Signaled when the last task is done */
+};
+
+/**
+ * @struct schedulerWorker
+ * @brief A worker, its queue and its counters.
+ */
+struct schedulerWorker {
+  sch scheduler; /**< The scheduler */
+  int index; /**< Index of the worker */
+  pthread_t thread; /**< The thread */
+  int started; /**< 1 if the thread has been started */
+  int placed; /**< 1 if the worker is bound to 'cpus' */
+  cpu_set_t cpus; /**< Processors of the worker */
+  csc scratch; /**< Scratch space of the worker */
+  struct schedulerTask *tasks; /**< Ring of the tasks */
+  size_t capacity; /**< Size of the ring */
+  size_t first; /**< Index of the first task in the ring */
+  size_t count; /**< Number of tasks in the ring */
+  pthread_mutex_t lock; /**< Lock of the ring */
+  unsigned long long nbTasks; /**< Tasks run (atomic) */
+  unsigned long long nbSteals; /**< Tasks stolen (atomic) */
+  unsigned long long busyNanos; /**< Time spent in the tasks (atomic) */
+};
+
+/**
+ * @struct scheduler
+ * @brief The workers and the state they share.
+ */
+struct scheduler {
+  struct schedulerWorker *workers; /**< The workers */
+  int nbWorkers; /**< Number of workers */
+  long waiting; /**< Tasks in the queues (atomic) */
+  int sleeping; /**< Workers sleeping (atomic) */
+  size_t nextWorker; /**< Queue of the next task submitted from outside (atomic) */
+  int closed; /**< 1 once the scheduler stops (atomic) */
+  int nbReady; /**< Workers ready, their memory allocated */
+  int nbFailed; /**< Workers which could not allocate their memory */
+  unsigned long long startNanos; /**< Time of the creation */
+  pthread_key_t self; /**< Worker of the calling thread */
+  pthread_mutex_t lock; /**< Lock of the sleep and of the start */
+  pthread_cond_t ready; /**< Signaled when a task is submitted or the scheduler stops */
+  pthread_cond_t started; /**< Signaled when a worker is ready or has failed */
+};
+
+
+/* ================================================== */
+/* ============== DEF PRIVATE FUNCTIONS ============= */
+/* ========================================================================== */
+
+
+/**
+ * @function schedulerNanos
+ * @brief Gives the time of the monotonic clock.
+ *
+ * @return{unsigned long long}: the time in nanoseconds.
+ */
+unsigned long long schedulerNanos(void);
+
+/**
+ * @function readSchedulerCpuList
+ * @brief Reads a list of processors, as "0-3,8-11".
+ *
+ * @param{char*} path: the file of the list.
+ * @param{cpu_set_t*} cpus: receives the processors.
+ *
+ * @return{int}: the number of processors read, 0 if the file can't be read.
+ */
+int readSchedulerCpuList(char *path, cpu_set_t *cpus);
+
+/**
+ * @function placeSchedulerWorkers
+ * @brief Chooses the processors of each worker.
+ *
+ * @param{sch} scheduler: the scheduler.
+ * @param{unsigned int} options: HFM_SCHEDULER_PIN and/or HFM_SCHEDULER_NUMA.
+ *
+ * @return{void}
+ */
+void placeSchedulerWorkers(sch scheduler, unsigned int options);
+
+/**
+ * @function pushSchedulerTask
+ * @brief Adds a task at the end of the queue of a worker.
+ *
+ * @param{struct schedulerWorker*} worker: the worker.
+ * @param{struct schedulerTask*} task: the task.
+ *
+ * @return{int}: 0 if the task has been added, -1 if the queue can't grow.
+ */
+int pushSchedulerTask(struct schedulerWorker *worker, struct schedulerTask *task);
+
+/**
+ * @function takeSchedulerTask
+ * @brief Takes the last task of the queue of a worker, or else steals the
+ * first task of the queue of another one.
+ *
+ * @param{struct schedulerWorker*} worker: the worker.
+ * @param{struct schedulerTask*} task: receives the task.
+ *
+ * @return{int}: 1 if a task has been taken, 0 if the queues are empty.
+ */
+int takeSchedulerTask(struct schedulerWorker *worker, struct schedulerTask *task);
+
+/**
+ * @function runSchedulerTask
+ * @brief Runs a task taken, counts it and marks it done in its group.
+ *
+ * @param{struct schedulerWorker*} worker: the worker.
+ * @param{struct schedulerTask*} task: the task.
+ *
+ * @return{void}
+ */
+void runSchedulerTask(struct schedulerWorker *worker, struct schedulerTask *task);
+
+/**
+ * @function schedulerWorkerThread
+ * @brief Routine of a worker: allocates its memory, then runs the tasks of its
+ * queue, or stolen from the others, until the scheduler stops and the queues
+ * are empty.
+ *
+ * @param{void*} arg: the struct schedulerWorker of the worker.
+ *
+ * @return{void*}: NULL.
+ */
+void* schedulerWorkerThread(void *arg);
+
+
+/* ================================================== */
+/* ================ STRUCT FUNCTIONS ================ */
+/* ========================================================================== */
+
+
+/**
+ * @see @file scheduler.h / @function createScheduler
+ */
+sch createScheduler(int nbWorkers, unsigned int options) {
+  if(nbWorkers < 1) nbWorkers = (int)sysconf(_SC_NPROCESSORS_ONLN);
+  if(nbWorkers < 1) nbWorkers = 1;
+  if(nbWorkers > HFM_SCHEDULER_MAX_WORKERS) nbWorkers = HFM_SCHEDULER_MAX_WORKERS;
+  sch scheduler = (sch)calloc(1, sizeof(struct scheduler));
+  if(scheduler == NULL) return NULL;
+  scheduler->workers = (struct schedulerWorker*)calloc((size_t)nbWorkers, sizeof(struct schedulerWorker));
+  if(scheduler->workers == NULL || pthread_key_create(&scheduler->self, NULL) != 0) {
+    free(scheduler->workers);
+    free(scheduler);
+    return NULL;
+  }
+  scheduler->nbWorkers = nbWorkers;
+  scheduler->startNanos = schedulerNanos();
+  pthread_mutex_init(&scheduler->lock, NULL);
+  pthread_cond_init(&scheduler->ready, NULL);
+  pthread_cond_init(&scheduler->started, NULL);
+  for (int i = 0; i < nbWorkers; i++) {
+    scheduler->workers[i].scheduler = scheduler;
+    scheduler->workers[i].index = i;
+    pthread_mutex_init(&scheduler->workers[i].lock, NULL);
+  }
+  placeSchedulerWorkers(scheduler, options);
+  int nbStarted = 0;
+  for (int i = 0; i < nbWorkers; i++) {
+    struct schedulerWorker *worker = &scheduler->workers[i];
+    worker->started = pthread_create(&worker->thread, NULL, schedulerWorkerThread, worker) == 0;
+    nbStarted += worker->started;
+  }
+  // The queue of a worker not started stays empty: nothing is submitted until all are ready
+  pthread_mutex_lock(&scheduler->lock);
+  while(scheduler->nbReady + scheduler->nbFailed < nbStarted) pthread_cond_wait(&scheduler->started, &scheduler->lock);
+  int failed = scheduler->nbFailed > 0 || nbStarted < nbWorkers;
+  pthread_mutex_unlock(&scheduler->lock);
+  if(failed) destroyScheduler(&scheduler);
+  return scheduler;
+}
+
+/**
+ * @see @file scheduler.h / @function destroyScheduler
+ */
+void destroyScheduler(sch *scheduler) {
+  if(*scheduler == NULL) return;
+  sch s = *scheduler;
+  pthread_mutex_lock(&s->lock);
+  __atomic_store_n(&s->closed, 1, __ATOMIC_SEQ_CST);
+  pthread_cond_broadcast(&s->ready);
+  pthread_mutex_unlock(&s->lock);
+  // A worker running steals from all the others: none is freed before all stop
+  for (int i = 0; i < s->nbWorkers; i++)
+    if(s->workers[i].started) pthread_join(s->workers[i].thread, NULL);
+  for (int i = 0; i < s->nbWorkers; i++) {
+    struct schedulerWorker *worker = &s->workers[i];
+    destroyCodecScratch(&worker->scratch);
+    free(worker->tasks);
+    pthread_mutex_destroy(&worker->lock);
+  }
+  pthread_key_delete(s->self);
+  pthread_cond_destroy(&s->started);
+  pthread_cond_destroy(&s->ready);
+  pthread_mutex_destroy(&s->lock);
+  free(s->workers);
+  free(s);
+  *scheduler = NULL;
+}
+
+/**
+ * @see @file scheduler.h / @function getSchedulerSize
+ */
+int getSchedulerSize(sch scheduler) {
+  return scheduler->nbWorkers;
+}
+
+/**
+ * @see @file scheduler.h / @function getSchedulerWorker
+ */
+int getSchedulerWorker(sch scheduler) {
+  struct schedulerWorker *worker = (struct schedulerWorker*)pthread_getspecific(scheduler->self);
+  return (worker != NULL) ? worker->index : -1;
+}
+
+/**
+ * @see @file scheduler.h / @function getSchedulerCounters
+ */
+void getSchedulerCounters(sch scheduler, int worker, unsigned long long *tasks, unsigned long long *steals, double *utilization) {
+  struct schedulerWorker *w = &scheduler->workers[worker];
+  unsigned long long elapsed = schedulerNanos() - scheduler->startNanos;
+  if(tasks != NULL) *tasks = __atomic_load_n(&w->nbTasks, __ATOMIC_RELAXED);
+  if(steals != NULL) *steals = __atomic_load_n(&w->nbSteals, __ATOMIC_RELAXED);
+  if(utilization != NULL)
+    *utilization = (elapsed > 0) ? (double)__atomic_load_n(&w->busyNanos, __ATOMIC_RELAXED) / (double)elapsed : 0;
+}
+
+/**
+ * @see @file scheduler.h / @function printSchedulerStats
+ */
+void printSchedulerStats(sch scheduler, FILE *stream) {
+  unsigned long long totalTasks = 0, totalSteals = 0;
+  double totalUtilization = 0;
+  for (int i = 0; i < scheduler->nbWorkers; i++) {
+    unsigned long long tasks, steals;
+    double utilization;
+    getSchedulerCounters(scheduler, i, &tasks, &steals, &utilization);
+    fprintf(stream, "worker %d: %llu tasks, %llu stolen, %.1f%% busy\n", i, tasks, steals, 100 * utilization);
+    totalTasks += tasks;
+    totalSteals += steals;
+    totalUtilization += utilization;
+  }
+  fprintf(stream, "total: %llu tasks, %llu stolen, %.1f%% busy\n", totalTasks, totalSteals,
+          100 * totalUtilization / scheduler->nbWorkers);
+}
+
+
+/* ================================================== */
+/* ===================== PUBLIC ===================== */
+/* ========================================================================== */
+
+
+/**
+ * @see @file scheduler.h / @function createSchedulerGroup
+ */
+sgp createSchedulerGroup(void) {
+  sgp group = (sgp)malloc(sizeof(struct schedulerGroup));
+  if(group == NULL) return NULL;
+  group->pending = 0;
+  pthread_mutex_init(&group->lock, NULL);
+  pthread_cond_init(&group->done, NULL);
+  return group;
+}
+
+/**
+ * @see @file scheduler.h / @function destroySchedulerGroup
+ */
+void destroySchedulerGroup(sgp *group) {
+  if(*group == NULL) return;
+  pthread_cond_destroy(&(*group)->done);
+  pthread_mutex_destroy(&(*group)->lock);
+  free(*group);
+  *group = NULL;
+}
+
+/**
+ * @see @file scheduler.h / @function submitSchedulerTask
+ */
+int submitSchedulerTask(sch scheduler, sgp group, schedulerFunction function, void *arg) {
+  struct schedulerWorker *self = (struct schedulerWorker*)pthread_getspecific(scheduler->self);
+  if(self == NULL && __atomic_load_n(&scheduler->closed, __ATOMIC_SEQ_CST)) return -1;
+  struct schedulerTask task;
+  task.function = function;
+  task.arg = arg;
+  task.group = group;
+  if(group != NULL) {
+    pthread_mutex_lock(&group->lock);
+    group->pending++;
+    pthread_mutex_unlock(&group->lock);
+  }
+  // A worker keeps its tasks, the ones from outside are spread
+  struct schedulerWorker *worker = self;
+  if(worker == NULL)
+    worker = &scheduler->workers[__atomic_fetch_add(&scheduler->nextWorker, 1, __ATOMIC_RELAXED) % (size_t)scheduler->nbWorkers];
+  if(pushSchedulerTask(worker, &task) != 0) {
+    if(group != NULL) {
+      pthread_mutex_lock(&group->lock);
+      group->pending--;
+      pthread_mutex_unlock(&group->lock);
+    }
+    return -1;
+  }
+  __atomic_add_fetch(&scheduler->waiting, 1, __ATOMIC_SEQ_CST);
+  if(__atomic_load_n(&scheduler->sleeping, __ATOMIC_SEQ_CST) > 0) {
+    pthread_mutex_lock(&scheduler->lock);
+    pthread_cond_signal(&scheduler->ready);
+    pthread_mutex_unlock(&scheduler->lock);
+  }
+  return 0;
+}
+
+/**
+ * @see @file scheduler.h / @function waitSchedulerGroup
+ */
+void waitSchedulerGroup(sch scheduler, sgp group) {
+  struct schedulerWorker *self = (struct schedulerWorker*)pthread_getspecific(scheduler->self);
+  pthread_mutex_lock(&group->lock);
+  while(group->pending > 0) {
+    if(self == NULL) {
+      pthread_cond_wait(&group->done, &group->lock);
+      continue;
+    }
+    // A worker runs the tasks meanwhile, maybe the ones of the group
+    pthread_mutex_unlock(&group->lock);
+    struct schedulerTask task;
+    int taken = takeSchedulerTask(self, &task);
+    if(taken) runSchedulerTask(self, &task);
+    pthread_mutex_lock(&group->lock);
+    if(!taken && group->pending > 0) {
+      struct timespec until;
+      clock_gettime(CLOCK_REALTIME, &until);
+      until.tv_nsec += HFM_SCHEDULER_HELP_DELAY;
+      if(until.tv_nsec >= 1000000000) {
+        until.tv_sec++;
+        until.tv_nsec -= 1000000000;
+      }
+      pthread_cond_timedwait(&group->done, &group->lock, &until);
+    }
+  }
+  pthread_mutex_unlock(&group->lock);
+}
+
+
+/* ================================================== */
+/* ===================== PRIVATE ==================== */
+/* ========================================================================== */
+
+
+/**
+ * @see @file scheduler.c / @function schedulerNanos
+ */
+unsigned long long schedulerNanos(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (unsigned long long)now.tv_sec * 1000000000ULL + (unsigned long long)now.tv_nsec;
+}
+
+/**
+ * @see @file scheduler.c / @function readSchedulerCpuList
+ */
+int readSchedulerCpuList(char *path, cpu_set_t *cpus) {
+  CPU_ZERO(cpus);
+  FILE *file = fopen(path, "r");
+  if(file == NULL) return 0;
+  int first, last;
+  char separator = ',';
+  while(separator == ',' && fscanf(file, "%d", &first) == 1) {
+    last = first;
+    if(fscanf(file, "%c", &separator) == 1 && separator == '-' && fscanf(file, "%d%c", &last, &separator) < 1) break;
+    for (int cpu = first; cpu <= last && cpu < CPU_SETSIZE; cpu++) CPU_SET(cpu, cpus);
+  }
+  fclose(file);
+  return CPU_COUNT(cpus);
+}
+
+/**
+ * @see @file scheduler.c / @function placeSchedulerWorkers
+ */
+void placeSchedulerWorkers(sch scheduler, unsigned int options) {
+  cpu_set_t allowed;
+  if(options == 0 || sched_getaffinity(0, sizeof(cpu_set_t), &allowed) != 0) return;
+  // Processors of each node allowed to the process, a single node without NUMA
+  cpu_set_t nodes[HFM_SCHEDULER_MAX_NODES];
+  int nbNodes = 0;
+  if(options & HFM_SCHEDULER_NUMA) {
+    for (int node = 0; node < HFM_SCHEDULER_MAX_NODES; node++) {
+      char path[64];
+      sprintf(path, "/sys/devices/system/node/node%d/cpulist", node);
+      if(readSchedulerCpuList(path, &nodes[nbNodes]) == 0) continue;
+      CPU_AND(&nodes[nbNodes], &nodes[nbNodes], &allowed);
+      if(CPU_COUNT(&nodes[nbNodes]) > 0) nbNodes++;
+    }
+  }
+  if(nbNodes == 0) {
+    nodes[0] = allowed;
+    nbNodes = 1;
+  }
+  for (int i = 0; i < scheduler->nbWorkers; i++) {
+    struct schedulerWorker *worker = &scheduler->workers[i];
+    cpu_set_t *node = &nodes[i % nbNodes];
+    worker->placed = 1;
+    if(!(options & HFM_SCHEDULER_PIN)) {
+      worker->cpus = *node;
+      continue;
+    }
+    // The k-th worker of a node takes the k-th processor of the node, in turn
+    int rank = (i / nbNodes) % CPU_COUNT(node);
+    CPU_ZERO(&worker->cpus);
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+      if(CPU_ISSET(cpu, node) && rank-- == 0) {
+        CPU_SET(cpu, &worker->cpus);
+        break;
+      }
+    }
+  }
+}
+
+/**
+ * @see @file scheduler.c / @function pushSchedulerTask
+ */
+int pushSchedulerTask(struct schedulerWorker *worker, struct schedulerTask *task) {
+  pthread_mutex_lock(&worker->lock);
+  if(worker->count == worker->capacity) {
+    struct schedulerTask *tasks = (struct schedulerTask*)malloc(2 * worker->capacity * sizeof(struct schedulerTask));
+    if(tasks == NULL) {
+      pthread_mutex_unlock(&worker->lock);
+      return -1;
+    }
+    for (size_t i = 0; i < worker->count; i++) tasks[i] = worker->tasks[(worker->first + i) % worker->capacity];
+    free(worker->tasks);
+    worker->tasks = tasks;
+    worker->capacity *= 2;
+    worker->first = 0;
+  }
+  worker->tasks[(worker->first + worker->count) % worker->capacity] = *task;
+  worker->count++;
+  pthread_mutex_unlock(&worker->lock);
+  return 0;
+}
+
+/**
+ * @see @file scheduler.c / @function takeSchedulerTask
+ */
+int takeSchedulerTask(struct schedulerWorker *worker, struct schedulerTask *task) {
+  sch scheduler = worker->scheduler;
+  for (int i = 0; i < scheduler->nbWorkers; i++) {
+    struct schedulerWorker *victim = &scheduler->workers[(worker->index + i) % scheduler->nbWorkers];
+    int taken = 0;
+    pthread_mutex_lock(&victim->lock);
+    if(victim->count > 0 && victim == worker) {
+      *task = victim->tasks[(victim->first + --victim->count) % victim->capacity];
+      taken = 1;
+    } else if(victim->count > 0) {
+      *task = victim->tasks[victim->first];
+      victim->first = (victim->first + 1) % victim->capacity;
+      victim->count--;
+      taken = 1;
+    }
+    pthread_mutex_unlock(&victim->lock);
+    if(taken) {
+      __atomic_sub_fetch(&scheduler->waiting, 1, __ATOMIC_SEQ_CST);
+      if(victim != worker) __atomic_store_n(&worker->nbSteals, worker->nbSteals + 1, __ATOMIC_RELAXED);
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/**
+ * @see @file scheduler.c / @function runSchedulerTask
+ */
+void runSchedulerTask(struct schedulerWorker *worker, struct schedulerTask *task) {
+  unsigned long long start = schedulerNanos();
+  task->function(task->arg, worker->scratch);
+  // Only the worker writes its counters: the atomic stores are for the readers
+  __atomic_store_n(&worker->busyNanos, worker->busyNanos + (schedulerNanos() - start), __ATOMIC_RELAXED);
+  __atomic_store_n(&worker->nbTasks, worker->nbTasks + 1, __ATOMIC_RELAXED);
+  if(task->group != NULL) {
+    pthread_mutex_lock(&task->group->lock);
+    if(--task->group->pending == 0) pthread_cond_broadcast(&task->group->done);
+    pthread_mutex_unlock(&task->group->lock);
+  }
+}
+
+/**
+ * @see @file scheduler.c / @function schedulerWorkerThread
+ */
+void* schedulerWorkerThread(void *arg) {
+  struct schedulerWorker *worker = (struct schedulerWorker*)arg;
+  sch scheduler = worker->scheduler;
+  pthread_setspecific(scheduler->self, worker);
+  // Bound first: the memory is then taken on the node of the worker
+  if(worker->placed) pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &worker->cpus);
+  worker->scratch = createCodecScratch();
+  worker->tasks = (struct schedulerTask*)malloc(HFM_SCHEDULER_QUEUE_SIZE * sizeof(struct schedulerTask));
+  int ready = worker->scratch != NULL && worker->tasks != NULL;
+  if(ready) worker->capacity = HFM_SCHEDULER_QUEUE_SIZE;
+  pthread_mutex_lock(&scheduler->lock);
+  if(ready) scheduler->nbReady++;
+  else scheduler->nbFailed++;
+  pthread_cond_broadcast(&scheduler->started);
+  pthread_mutex_unlock(&scheduler->lock);
+  if(!ready) return NULL;
+  while(1) {
+    struct schedulerTask task;
+    if(takeSchedulerTask(worker, &task)) {
+      runSchedulerTask(worker, &task);
+      continue;
+    }
+    pthread_mutex_lock(&scheduler->lock);
+    __atomic_add_fetch(&scheduler->sleeping, 1, __ATOMIC_SEQ_CST);
+    while(__atomic_load_n(&scheduler->waiting, __ATOMIC_SEQ_CST) <= 0 && !scheduler->closed)
+      pthread_cond_wait(&scheduler->ready, &scheduler->lock);
+    __atomic_sub_fetch(&scheduler->sleeping, 1, __ATOMIC_SEQ_CST);
+    int stop = scheduler->closed && __atomic_load_n(&scheduler->waiting, __ATOMIC_SEQ_CST) <= 0;
+    pthread_mutex_unlock(&scheduler->lock);
+    if(stop) break;
+  }
+  return NULL;
+}
+
+/* ========================================================================== */
+/* ========================================================================== */
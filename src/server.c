@@ -0,0 +1,845 @@
+/**
+ * @file server.c
+ * @author agent <agent@local>
+ * @standard C99
+ * @version 1.0
+ * @date 18th October 2026
+ *
+ * @brief Implementation file for "server.h"
+ *
+ * This file implements the daemon and its client: the socket accepted by the
+ * calling thread, the queue of the connections taken by the pool, the requests
+ * and the responses, the table of the keys and the histograms of the latencies.
+ *
+ * A key is found by its path, and built again if the size or the time of
+ * modification of its file have changed. A key used by a request is not freed:
+ * a key replaced or evicted while used is freed by its last user. The unused
+ * key used the least recently is evicted when the table is full, and a key is
+ * only used by its request when all the keys of the table are used.
+ *
+ * The counters of the histograms are only updated with atomic operations.
+ *
+ * Overview about private functions of server:
+ *  - stopServer
+ *  - receiveBytes
+ *  - sendBytes
+ *  - sendResponse
+ *  - readFileInMemory
+ *  - acquireServerKey
+ *  - releaseServerKey
+ *  - destroyServerKey
+ *  - runServerOperation
+ *  - handleServerRequest
+ *  - recordLatency
+ *  - printServerStats
+ *  - serverWorkerThread
+ *
+ * Overview about public functions of server:
+ *  - huffmanServe
+ *  - huffmanServerRequest
+ */
+
+#define _GNU_SOURCE /**< accept4, open_memstream, realpath and the pthreads */
+#include "server.h"
+
+#include <pthread.h>
+#include <signal.h>
+#include <errno.h>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#define HFM_SERVER_BAD_REQUEST -4 /**< Status of a request not valid */
+#define HFM_SERVER_POLL_DELAY 500 /**< Milliseconds between two checks of the stop */
+#define HFM_SERVER_IO_SIZE 65536 /**< Size of the reads and the writes of the client */
+
+
+/**
+ * @struct serverKey
+ * @brief A key file read, with its tree and its codes.
+ */
+struct serverKey {
+  char *path; /**< Path of the key file */
+  long long size; /**< Size of the key file */
+  long long mtime; /**< Time of modification of the key file, in nanoseconds */
+  nd tree; /**< Tree of the key */
+  lst prefixes; /**< Prefixes of the tree, holding the codes */
+  char *codes[256]; /**< Code of each character */
+  int users; /**< Requests using the key */
+  int detached; /**< 1 once out of the table, freed by its last user */
+  unsigned long long lastUse; /**< Clock of the table at its last use */
+};
+
+/**
+ * @struct serverConnection
+ * @brief A connection accepted, waiting for a thread of the pool.
+ */
+struct serverConnection {
+  int fd; /**< Socket of the connection */
+  struct serverConnection *next; /**< Next connection of the queue */
+};
+
+/**
+ * @struct server
+ * @brief The state shared by the threads of the daemon.
+ */
+struct server {
+  struct serverConnection *head; /**< First connection waiting, NULL if none */
+  struct serverConnection *tail; /**< Last connection waiting */
+  int closed; /**< 1 once the daemon stops */
+  int active[HFM_SERVER_MAX_THREADS]; /**< Connection of each thread, -1 if none */
+  pthread_mutex_t lock; /**< Lock of the queue and the connections */
+  pthread_cond_t ready; /**< Signaled when a connection is added or the daemon stops */
+  struct serverKey *keys[HFM_SERVER_MAX_KEYS]; /**< Keys kept, NULL if free */
+  unsigned long long keyClock; /**< Clock of the uses of the keys */
+  size_t keyLoads; /**< Keys built */
+  size_t keyHits; /**< Keys found already built */
+  pthread_mutex_t keysLock; /**< Lock of the keys */
+  unsigned long long latencies[HFM_SERVER_NB_OPERATIONS][HFM_SERVER_BUCKETS]; /**< Histograms */
+  unsigned long long totalMicros[HFM_SERVER_NB_OPERATIONS]; /**< Sum of the latencies */
+  unsigned long long maxMicros[HFM_SERVER_NB_OPERATIONS]; /**< Longest latency */
+  unsigned long long failures[HFM_SERVER_NB_OPERATIONS]; /**< Requests failed */
+};
+
+/**
+ * @struct serverWorker
+ * @brief A thread of the pool.
+ */
+struct serverWorker {
+  struct server *server; /**< The daemon */
+  int index; /**< Index of the thread, in 'active' */
+};
+
+static volatile sig_atomic_t SERVER_STOP = 0; /**< Set by SIGINT and SIGTERM */
+
+static const char *SERVER_OPERATIONS[HFM_SERVER_NB_OPERATIONS] = {
+  "invalid", "compress", "decompress", "compress-file", "decompress-file", "stats"
+}; /**< Names of the operations in the statistics */
+
+
+/* ================================================== */
+/* ============== DEF PRIVATE FUNCTIONS ============= */
+/* ========================================================================== */
+
+
+/**
+ * @function stopServer
+ * @brief Handler of SIGINT and SIGTERM, asking the daemon to stop.
+ *
+ * @param{int} signal: the signal.
+ *
+ * @return{void}
+ */
+void stopServer(int signal);
+
+/**
+ * @function receiveBytes
+ * @brief Reads an exact number of bytes from a socket.
+ *
+ * @param{int} fd: the socket.
+ * @param{void*} buffer: the bytes read.
+ * @param{size_t} size: number of bytes to read.
+ *
+ * @return{int}: 0 if all the bytes have been read, -1 on an error or at the
+ *               end of the connection.
+ */
+int receiveBytes(int fd, void *buffer, size_t size);
+
+/**
+ * @function sendBytes
+ * @brief Writes bytes in a socket, without SIGPIPE if the peer has left.
+ *
+ * @param{int} fd: the socket.
+ * @param{const void*} buffer: the bytes to write.
+ * @param{size_t} size: number of bytes to write.
+ *
+ * @return{int}: 0 if all the bytes have been written, -1 otherwise.
+ */
+int sendBytes(int fd, const void *buffer, size_t size);
+
+/**
+ * @function sendResponse
+ * @brief Writes a response in a socket.
+ *
+ * @param{int} fd: the socket.
+ * @param{int} status: status of the response.
+ * @param{const void*} payload: payload of the response (can be NULL if empty).
+ * @param{size_t} length: size of the payload.
+ *
+ * @return{int}: 0 if the response has been written, -1 otherwise.
+ */
+int sendResponse(int fd, int status, const void *payload, size_t length);
+
+/**
+ * @function readFileInMemory
+ * @brief Reads a whole file in memory.
+ *
+ * @param{char*} fileName: name of the file.
+ * @param{size_t} maxSize: maximal size of the file accepted.
+ * @param{size_t*} size: receives the size of the file.
+ *
+ * @return{unsigned char*}: the content of the file, to free (one more byte
+ *                          is allocated), NULL if it can't be read.
+ */
+unsigned char* readFileInMemory(char *fileName, size_t maxSize, size_t *size);
+
+/**
+ * @function acquireServerKey
+ * @brief Gives the key of a key file, built if it is not in the table or has
+ * changed since.
+ *
+ * @param{struct server*} server: the daemon.
+ * @param{char*} path: path of the key file.
+ *
+ * @return{struct serverKey*}: the key, to release, NULL if it can't be read or
+ *                             memory can't be allocated.
+ */
+struct serverKey* acquireServerKey(struct server *server, char *path);
+
+/**
+ * @function releaseServerKey
+ * @brief Releases a key given by acquireServerKey.
+ *
+ * @param{struct server*} server: the daemon.
+ * @param{struct serverKey*} key: the key (can be NULL).
+ *
+ * @return{void}
+ */
+void releaseServerKey(struct server *server, struct serverKey *key);
+
+/**
+ * @function destroyServerKey
+ * @brief Frees a key.
+ *
+ * @param{struct serverKey*} key: the key.
+ *
+ * @return{void}
+ */
+void destroyServerKey(struct serverKey *key);
+
+/**
+ * @function runServerOperation
+ * @brief Codes or decodes the payload of a request.
+ *
+ * @param{int} operation: HFM_SERVER_COMPRESS or HFM_SERVER_DECOMPRESS.
+ * @param{unsigned int} checksums: checksums to write.
+ * @param{struct serverKey*} key: the key (can be NULL).
+ * @param{unsigned char*} data: the payload.
+ * @param{size_t} size: size of the payload.
+ * @param{unsigned char**} out: receives the result, to free.
+ * @param{size_t*} outSize: receives the size of the result.
+ * @param{const char**} message: receives the message of an error.
+ *
+ * @return{int}: the status of the response.
+ */
+int runServerOperation(int operation, unsigned int checksums, struct serverKey *key, unsigned char *data, size_t size, unsigned char **out, size_t *outSize, const char **message);
+
+/**
+ * @function handleServerRequest
+ * @brief Reads a request of a connection, runs it and writes its response.
+ *
+ * @param{struct server*} server: the daemon.
+ * @param{int} fd: the socket of the connection.
+ *
+ * @return{int}: 0 if the connection can send another request, -1 if it has
+ *               to be closed.
+ */
+int handleServerRequest(struct server *server, int fd);
+
+/**
+ * @function recordLatency
+ * @brief Adds the latency of a request in the histogram of its operation.
+ *
+ * @param{struct server*} server: the daemon.
+ * @param{int} operation: the operation, 0 if not valid.
+ * @param{unsigned long long} micros: the latency, in microseconds.
+ * @param{int} failed: 1 if the request has failed.
+ *
+ * @return{void}
+ */
+void recordLatency(struct server *server, int operation, unsigned long long micros, int failed);
+
+/**
+ * @function printServerStats
+ * @brief Writes the histograms of the latencies and the use of the keys.
+ *
+ * @param{struct server*} server: the daemon.
+ * @param{FILE*} fileOut: the file written.
+ *
+ * @return{void}
+ */
+void printServerStats(struct server *server, FILE *fileOut);
+
+/**
+ * @function serverWorkerThread
+ * @brief Thread of the pool, serving the connections of the queue.
+ *
+ * @param{void*} worker: the struct serverWorker of the thread.
+ *
+ * @return{void*}: NULL.
+ */
+void* serverWorkerThread(void *worker);
+
+
+/* ================================================== */
+/* ================ PUBLIC FUNCTIONS ================ */
+/* ========================================================================== */
+
+
+/**
+ * @see @file server.h / @function huffmanServe
+ */
+int huffmanServe(char *socketPath, int nbThreads) {
+  struct sockaddr_un address;
+  memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  if(strlen(socketPath) >= sizeof(address.sun_path)) {
+    printf("'%s': path too long for a socket\n", socketPath);
+    return -1;
+  }
+  strcpy(address.sun_path, socketPath);
+  struct stat info;
+  if(lstat(socketPath, &info) == 0) {
+    if(!S_ISSOCK(info.st_mode)) {
+      printf("'%s' exists and is not a socket\n", socketPath);
+      return -1;
+    }
+    unlink(socketPath);
+  }
+  int listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if(listenFd < 0 || bind(listenFd, (struct sockaddr*)&address, sizeof(address)) != 0 || listen(listenFd, SOMAXCONN) != 0) {
+    perror(socketPath);
+    if(listenFd >= 0) close(listenFd);
+    return -1;
+  }
+  if(nbThreads < 1) nbThreads = 4 * (int)sysconf(_SC_NPROCESSORS_ONLN);
+  if(nbThreads < 1) nbThreads = 4;
+  if(nbThreads > HFM_SERVER_MAX_THREADS) nbThreads = HFM_SERVER_MAX_THREADS;
+
+  struct server *server = (struct server*)calloc(1, sizeof(struct server));
+  if(server == NULL) pointerAllocError();
+  for (int i = 0; i < HFM_SERVER_MAX_THREADS; i++) server->active[i] = -1;
+  pthread_mutex_init(&server->lock, NULL);
+  pthread_cond_init(&server->ready, NULL);
+  pthread_mutex_init(&server->keysLock, NULL);
+
+  // The pool doesn't take the signals: they interrupt the poll of this thread
+  struct sigaction action, previousInt, previousTerm;
+  memset(&action, 0, sizeof(action));
+  action.sa_handler = stopServer;
+  sigemptyset(&action.sa_mask);
+  SERVER_STOP = 0;
+  sigaction(SIGINT, &action, &previousInt);
+  sigaction(SIGTERM, &action, &previousTerm);
+  sigset_t stopSignals, previousMask;
+  sigemptyset(&stopSignals);
+  sigaddset(&stopSignals, SIGINT);
+  sigaddset(&stopSignals, SIGTERM);
+  pthread_sigmask(SIG_BLOCK, &stopSignals, &previousMask);
+  struct serverWorker *workers = (struct serverWorker*)malloc(nbThreads * sizeof(struct serverWorker));
+  pthread_t *threads = (pthread_t*)malloc(nbThreads * sizeof(pthread_t));
+  if(workers == NULL || threads == NULL) pointerAllocError();
+  for (int i = 0; i < nbThreads; i++) {
+    workers[i].server = server;
+    workers[i].index = i;
+    pthread_create(&threads[i], NULL, serverWorkerThread, &workers[i]);
+  }
+  pthread_sigmask(SIG_SETMASK, &previousMask, NULL);
+  printf("Listening on '%s' with %d threads\n", socketPath, nbThreads);
+  fflush(stdout);
+
+  struct pollfd listening = { .fd = listenFd, .events = POLLIN, .revents = 0 };
+  while(!SERVER_STOP) {
+    if(poll(&listening, 1, HFM_SERVER_POLL_DELAY) <= 0) continue;
+    int fd = accept4(listenFd, NULL, NULL, SOCK_CLOEXEC);
+    if(fd < 0) continue;
+    // An idle client makes its recv or its send fail, and gives its thread back
+    struct timeval timeout = { .tv_sec = HFM_SERVER_IDLE_TIMEOUT, .tv_usec = 0 };
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+    struct serverConnection *connection = (struct serverConnection*)malloc(sizeof(struct serverConnection));
+    if(connection == NULL) pointerAllocError();
+    connection->fd = fd;
+    connection->next = NULL;
+    pthread_mutex_lock(&server->lock);
+    if(server->tail != NULL) server->tail->next = connection;
+    else server->head = connection;
+    server->tail = connection;
+    pthread_cond_signal(&server->ready);
+    pthread_mutex_unlock(&server->lock);
+  }
+
+  // The connections served are cut: their threads end with their request
+  pthread_mutex_lock(&server->lock);
+  server->closed = 1;
+  for (int i = 0; i < nbThreads; i++)
+    if(server->active[i] >= 0) shutdown(server->active[i], SHUT_RDWR);
+  pthread_cond_broadcast(&server->ready);
+  pthread_mutex_unlock(&server->lock);
+  for (int i = 0; i < nbThreads; i++) pthread_join(threads[i], NULL);
+  while(server->head != NULL) {
+    struct serverConnection *connection = server->head;
+    server->head = connection->next;
+    close(connection->fd);
+    free(connection);
+  }
+  close(listenFd);
+  unlink(socketPath);
+  sigaction(SIGINT, &previousInt, NULL);
+  sigaction(SIGTERM, &previousTerm, NULL);
+
+  printf("Server stopped\n");
+  printServerStats(server, stdout);
+  for (int i = 0; i < HFM_SERVER_MAX_KEYS; i++)
+    if(server->keys[i] != NULL) destroyServerKey(server->keys[i]);
+  pthread_mutex_destroy(&server->lock);
+  pthread_cond_destroy(&server->ready);
+  pthread_mutex_destroy(&server->keysLock);
+  free(server);
+  free(workers);
+  free(threads);
+  return 0;
+}
+
+/**
+ * @see @file server.h / @function huffmanServerRequest
+ */
+int huffmanServerRequest(char *socketPath, int operation, char *fileKey, unsigned int checksums, char *fileIn, char *fileOut) {
+  struct sockaddr_un address;
+  memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  if(strlen(socketPath) >= sizeof(address.sun_path)) {
+    printf("'%s': path too long for a socket\n", socketPath);
+    return -1;
+  }
+  strcpy(address.sun_path, socketPath);
+  // The daemon may not run in the same directory: its key is given by an absolute path
+  char *key = NULL;
+  if(fileKey != NULL && (key = realpath(fileKey, NULL)) == NULL) {
+    perror(fileKey);
+    return -1;
+  }
+  size_t keyLength = (key != NULL) ? strlen(key) : 0;
+  size_t size = 0;
+  unsigned char *data = NULL;
+  if(operation != HFM_SERVER_STATS && (data = readFileInMemory(fileIn, HFM_SERVER_MAX_SIZE, &size)) == NULL) {
+    free(key);
+    return -1;
+  }
+  int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if(fd < 0 || connect(fd, (struct sockaddr*)&address, sizeof(address)) != 0) {
+    perror(socketPath);
+    if(fd >= 0) close(fd);
+    free(key);
+    free(data);
+    return -1;
+  }
+
+  unsigned char header[HFM_SERVER_HEADER_SIZE];
+  memcpy(header, HFM_SERVER_REQUEST_MAGIC, 4);
+  header[4] = (unsigned char)operation;
+  header[5] = (checksums != 0) ? HFM_SERVER_CHECKSUMS : 0;
+  storeLittleEndian(header + 6, keyLength, 2);
+  storeLittleEndian(header + 8, size, 8);
+  int result = -1;
+  if(keyLength <= 0xffff && sendBytes(fd, header, HFM_SERVER_HEADER_SIZE) == 0 && sendBytes(fd, key, keyLength) == 0
+     && sendBytes(fd, data, size) == 0 && receiveBytes(fd, header, HFM_SERVER_HEADER_SIZE) == 0
+     && !memcmp(header, HFM_SERVER_RESPONSE_MAGIC, 4)) {
+    result = (signed char)header[4];
+    unsigned long long length = loadLittleEndian(header + 8, 8);
+    FILE *file = stdout;
+    if(result == 0 && fileOut != NULL && (file = fopen(fileOut, "wb")) == NULL) perror(fileOut);
+    if(result != 0) fprintf(stderr, "Request failed (%d): ", result);
+    // The result is written while received
+    unsigned char *buffer = (unsigned char*)malloc(HFM_SERVER_IO_SIZE);
+    if(buffer == NULL) pointerAllocError();
+    while(length > 0) {
+      size_t chunk = (length < HFM_SERVER_IO_SIZE) ? (size_t)length : HFM_SERVER_IO_SIZE;
+      if(receiveBytes(fd, buffer, chunk) != 0) {
+        printf("Connection to '%s' lost\n", socketPath);
+        if(result == 0) result = -1;
+        break;
+      }
+      if(result != 0) fwrite(buffer, 1, chunk, stderr);
+      else if(file != NULL) fwrite(buffer, 1, chunk, file);
+      length -= chunk;
+    }
+    if(result != 0) fprintf(stderr, "\n");
+    free(buffer);
+    if(result == 0 && file == NULL) result = -1;
+    if(file != NULL && file != stdout && fclose(file) != 0) {
+      perror(fileOut);
+      result = -1;
+    }
+  } else {
+    printf("No valid response from '%s'\n", socketPath);
+  }
+  close(fd);
+  free(key);
+  free(data);
+  return result;
+}
+
+
+/* ================================================== */
+/* ================ PRIVATE FUNCTIONS =============== */
+/* ========================================================================== */
+
+
+/**
+ * @see @file server.c / @function stopServer
+ */
+void stopServer(int signal) {
+  (void)signal;
+  SERVER_STOP = 1;
+}
+
+/**
+ * @see @file server.c / @function receiveBytes
+ */
+int receiveBytes(int fd, void *buffer, size_t size) {
+  unsigned char *bytes = (unsigned char*)buffer;
+  while(size > 0) {
+    ssize_t got = recv(fd, bytes, size, 0);
+    if(got < 0 && errno == EINTR) continue;
+    if(got <= 0) return -1;
+    bytes += got;
+    size -= (size_t)got;
+  }
+  return 0;
+}
+
+/**
+ * @see @file server.c / @function sendBytes
+ */
+int sendBytes(int fd, const void *buffer, size_t size) {
+  const unsigned char *bytes = (const unsigned char*)buffer;
+  while(size > 0) {
+    ssize_t sent = send(fd, bytes, size, MSG_NOSIGNAL);
+    if(sent < 0 && errno == EINTR) continue;
+    if(sent <= 0) return -1;
+    bytes += sent;
+    size -= (size_t)sent;
+  }
+  return 0;
+}
+
+/**
+ * @see @file server.c / @function sendResponse
+ */
+int sendResponse(int fd, int status, const void *payload, size_t length) {
+  unsigned char header[HFM_SERVER_HEADER_SIZE];
+  memset(header, 0, HFM_SERVER_HEADER_SIZE);
+  memcpy(header, HFM_SERVER_RESPONSE_MAGIC, 4);
+  header[4] = (unsigned char)(signed char)status;
+  storeLittleEndian(header + 8, length, 8);
+  if(sendBytes(fd, header, HFM_SERVER_HEADER_SIZE) != 0) return -1;
+  return sendBytes(fd, payload, length);
+}
+
+/**
+ * @see @file server.c / @function readFileInMemory
+ */
+unsigned char* readFileInMemory(char *fileName, size_t maxSize, size_t *size) {
+  FILE *file = fopen(fileName, "rb");
+  if(file == NULL) {
+    perror(fileName);
+    return NULL;
+  }
+  struct stat info;
+  if(fstat(fileno(file), &info) != 0 || !S_ISREG(info.st_mode) || (unsigned long long)info.st_size > maxSize) {
+    printf("'%s' is not a regular file of at most %zu bytes\n", fileName, maxSize);
+    fclose(file);
+    return NULL;
+  }
+  *size = (size_t)info.st_size;
+  unsigned char *data = (unsigned char*)malloc(*size + 1);
+  if(data == NULL) pointerAllocError();
+  if(fread(data, 1, *size, file) != *size) {
+    printf("'%s' can't be read\n", fileName);
+    free(data);
+    data = NULL;
+  }
+  fclose(file);
+  return data;
+}
+
+/**
+ * @see @file server.c / @function acquireServerKey
+ */
+struct serverKey* acquireServerKey(struct server *server, char *path) {
+  struct stat info;
+  if(stat(path, &info) != 0) return NULL;
+  long long mtime = (long long)info.st_mtim.tv_sec * 1000000000LL + info.st_mtim.tv_nsec;
+  pthread_mutex_lock(&server->keysLock);
+  int slot = -1;
+  for (int i = 0; i < HFM_SERVER_MAX_KEYS; i++) {
+    struct serverKey *key = server->keys[i];
+    if(key == NULL) {
+      if(slot < 0) slot = i;
+    } else if(!strcmp(key->path, path)) {
+      if(key->size == (long long)info.st_size && key->mtime == mtime) {
+        key->users++;
+        key->lastUse = ++server->keyClock;
+        server->keyHits++;
+        pthread_mutex_unlock(&server->keysLock);
+        return key;
+      }
+      // The key file has changed: the key is replaced
+      server->keys[i] = NULL;
+      if(key->users == 0) destroyServerKey(key);
+      else key->detached = 1;
+      slot = i;
+    }
+  }
+  if(slot < 0) {
+    for (int i = 0; i < HFM_SERVER_MAX_KEYS; i++)
+      if(server->keys[i]->users == 0 && (slot < 0 || server->keys[i]->lastUse < server->keys[slot]->lastUse))
+        slot = i;
+    if(slot >= 0) {
+      destroyServerKey(server->keys[slot]);
+      server->keys[slot] = NULL;
+    }
+  }
+  // The key is built under the lock: a key file is small
+  struct serverKey *key = NULL;
+  nd tree = getTreeFromKeyFile(path);
+  if(tree != NULL) {
+    key = (struct serverKey*)calloc(1, sizeof(struct serverKey));
+    int maxPrefixLength = 0;
+    if(key != NULL) {
+      key->tree = tree;
+      key->path = (char*)copyString(path);
+      key->prefixes = prefixesList(tree, &maxPrefixLength);
+    }
+    if(key == NULL || key->path == NULL || key->prefixes == NULL) {
+      if(key != NULL) destroyServerKey(key);
+      else destroyNode(&tree);
+      pthread_mutex_unlock(&server->keysLock);
+      return NULL;
+    }
+    key->size = (long long)info.st_size;
+    key->mtime = mtime;
+    prefixesTable(key->prefixes, key->codes);
+    key->users = 1;
+    key->lastUse = ++server->keyClock;
+    if(slot >= 0) server->keys[slot] = key;
+    else key->detached = 1;
+    server->keyLoads++;
+  }
+  pthread_mutex_unlock(&server->keysLock);
+  return key;
+}
+
+/**
+ * @see @file server.c / @function releaseServerKey
+ */
+void releaseServerKey(struct server *server, struct serverKey *key) {
+  if(key == NULL) return;
+  pthread_mutex_lock(&server->keysLock);
+  key->users--;
+  if(key->users == 0 && key->detached) destroyServerKey(key);
+  pthread_mutex_unlock(&server->keysLock);
+}
+
+/**
+ * @see @file server.c / @function destroyServerKey
+ */
+void destroyServerKey(struct serverKey *key) {
+  destroyList(&key->prefixes);
+  destroyNode(&key->tree);
+  free(key->path);
+  free(key);
+}
+
+/**
+ * @see @file server.c / @function runServerOperation
+ */
+int runServerOperation(int operation, unsigned int checksums, struct serverKey *key, unsigned char *data, size_t size, unsigned char **out, size_t *outSize, const char **message) {
+  if(operation == HFM_SERVER_COMPRESS) {
+    if(key != NULL) *out = encryptBufferWithCodesInMemory(data, size, key->codes, checksums, outSize);
+    else *out = encryptBufferInMemory(data, size, checksums, outSize);
+    if(*out != NULL) return 0;
+    *message = "the data can't be coded";
+    return -1;
+  }
+  int result = decryptBufferInMemory(data, size, (key != NULL) ? key->tree : NULL, HFM_SERVER_MAX_SIZE, out, outSize);
+  if(result == -1) *message = "the key of the file is needed";
+  else if(result == -2) *message = "the file is corrupted or too big";
+  else if(result == -3) *message = "the file does not match its checksums";
+  return result;
+}
+
+/**
+ * @see @file server.c / @function handleServerRequest
+ */
+int handleServerRequest(struct server *server, int fd) {
+  unsigned char header[HFM_SERVER_HEADER_SIZE];
+  if(receiveBytes(fd, header, HFM_SERVER_HEADER_SIZE) != 0) return -1;
+  struct timespec start, end;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  int operation = header[4];
+  unsigned int checksums = (header[5] & HFM_SERVER_CHECKSUMS) ? HFM_CONTAINER_CHECKSUMS : 0;
+  size_t keyLength = (size_t)loadLittleEndian(header + 6, 2);
+  unsigned long long length = loadLittleEndian(header + 8, 8);
+  if(memcmp(header, HFM_SERVER_REQUEST_MAGIC, 4) || length > HFM_SERVER_MAX_SIZE) {
+    // The rest of the connection can't be read: it is closed after the error
+    const char *error = "not a request, or a payload too big";
+    sendResponse(fd, HFM_SERVER_BAD_REQUEST, error, strlen(error));
+    recordLatency(server, 0, 0, 1);
+    return -1;
+  }
+  char *keyPath = (char*)malloc(keyLength + 1);
+  unsigned char *payload = (unsigned char*)malloc((size_t)length + 1);
+  if(keyPath == NULL || payload == NULL) pointerAllocError();
+  if(receiveBytes(fd, keyPath, keyLength) != 0 || receiveBytes(fd, payload, (size_t)length) != 0) {
+    free(keyPath);
+    free(payload);
+    return -1;
+  }
+  keyPath[keyLength] = '\0';
+  payload[length] = '\0';
+
+  int status = 0;
+  const char *message = NULL;
+  unsigned char *out = NULL;
+  size_t outSize = 0;
+  struct serverKey *key = NULL;
+  if(operation < HFM_SERVER_COMPRESS || operation > HFM_SERVER_STATS) {
+    operation = 0;
+    status = HFM_SERVER_BAD_REQUEST;
+    message = "unknown operation";
+  } else if(keyLength > 0 && operation != HFM_SERVER_STATS && (key = acquireServerKey(server, keyPath)) == NULL) {
+    status = -1;
+    message = "the key file can't be read";
+  } else if(operation == HFM_SERVER_STATS) {
+    char *text = NULL;
+    FILE *stream = open_memstream(&text, &outSize);
+    if(stream == NULL) pointerAllocError();
+    printServerStats(server, stream);
+    fclose(stream);
+    out = (unsigned char*)text;
+  } else if(operation == HFM_SERVER_COMPRESS || operation == HFM_SERVER_DECOMPRESS) {
+    status = runServerOperation(operation, checksums, key, payload, (size_t)length, &out, &outSize, &message);
+  } else {
+    // The payload gives the path of the input, '\0', then the path of the output
+    char *fileIn = (char*)payload;
+    size_t inLength = strlen(fileIn);
+    char *fileOut = fileIn + inLength + 1;
+    unsigned char *data = NULL;
+    size_t size = 0;
+    if(inLength >= length || *fileOut == '\0') {
+      status = HFM_SERVER_BAD_REQUEST;
+      message = "the paths of the input and the output are needed";
+    } else if((data = readFileInMemory(fileIn, HFM_SERVER_MAX_SIZE, &size)) == NULL) {
+      status = -1;
+      message = "the input can't be read";
+    } else {
+      int op = (operation == HFM_SERVER_COMPRESS_FILE) ? HFM_SERVER_COMPRESS : HFM_SERVER_DECOMPRESS;
+      status = runServerOperation(op, checksums, key, data, size, &out, &outSize, &message);
+      free(data);
+      FILE *file = NULL;
+      if(status == 0 && ((file = fopen(fileOut, "wb")) == NULL || fwrite(out, 1, outSize, file) != outSize)) {
+        status = -1;
+        message = "the output can't be written";
+      }
+      if(file != NULL && fclose(file) != 0 && status == 0) {
+        status = -1;
+        message = "the output can't be written";
+      }
+      free(out);
+      out = NULL;
+      outSize = 0;
+    }
+  }
+  releaseServerKey(server, key);
+  free(keyPath);
+  free(payload);
+
+  int result = (status == 0) ? sendResponse(fd, 0, out, outSize) : sendResponse(fd, status, message, strlen(message));
+  free(out);
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  long long micros = (end.tv_sec - start.tv_sec) * 1000000LL + (end.tv_nsec - start.tv_nsec) / 1000;
+  recordLatency(server, operation, (micros > 0) ? (unsigned long long)micros : 0, status != 0);
+  return result;
+}
+
+/**
+ * @see @file server.c / @function recordLatency
+ */
+void recordLatency(struct server *server, int operation, unsigned long long micros, int failed) {
+  // Bucket b holds the latencies under 2^b microseconds, from 2^(b-1)
+  int bucket = 0;
+  while(bucket < HFM_SERVER_BUCKETS - 1 && (micros >> bucket) != 0) bucket++;
+  __atomic_fetch_add(&server->latencies[operation][bucket], 1, __ATOMIC_RELAXED);
+  __atomic_fetch_add(&server->totalMicros[operation], micros, __ATOMIC_RELAXED);
+  if(failed) __atomic_fetch_add(&server->failures[operation], 1, __ATOMIC_RELAXED);
+  unsigned long long max = __atomic_load_n(&server->maxMicros[operation], __ATOMIC_RELAXED);
+  while(micros > max && !__atomic_compare_exchange_n(&server->maxMicros[operation], &max, micros, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+}
+
+/**
+ * @see @file server.c / @function printServerStats
+ */
+void printServerStats(struct server *server, FILE *fileOut) {
+  static const double percentiles[3] = { 0.5, 0.9, 0.99 };
+  for (int op = 0; op < HFM_SERVER_NB_OPERATIONS; op++) {
+    unsigned long long counts[HFM_SERVER_BUCKETS];
+    unsigned long long total = 0;
+    for (int b = 0; b < HFM_SERVER_BUCKETS; b++) {
+      counts[b] = __atomic_load_n(&server->latencies[op][b], __ATOMIC_RELAXED);
+      total += counts[b];
+    }
+    if(total == 0) continue;
+    fprintf(fileOut, "%s: %llu requests (%llu failed), mean %llu us",
+            SERVER_OPERATIONS[op], total, __atomic_load_n(&server->failures[op], __ATOMIC_RELAXED),
+            __atomic_load_n(&server->totalMicros[op], __ATOMIC_RELAXED) / total);
+    for (int p = 0; p < 3; p++) {
+      // Upper bound of the bucket holding the percentile
+      unsigned long long rank = (unsigned long long)(percentiles[p] * total + 0.999999), seen = 0;
+      int b = 0;
+      while(b < HFM_SERVER_BUCKETS - 1 && (seen += counts[b]) < rank) b++;
+      fprintf(fileOut, ", p%d < %llu us", (int)(percentiles[p] * 100), 1ULL << b);
+    }
+    fprintf(fileOut, ", max %llu us\n", __atomic_load_n(&server->maxMicros[op], __ATOMIC_RELAXED));
+    for (int b = 0; b < HFM_SERVER_BUCKETS; b++)
+      if(counts[b] != 0) fprintf(fileOut, "  < %12llu us: %llu\n", 1ULL << b, counts[b]);
+  }
+  pthread_mutex_lock(&server->keysLock);
+  fprintf(fileOut, "keys: %zu built, %zu reused\n", server->keyLoads, server->keyHits);
+  pthread_mutex_unlock(&server->keysLock);
+}
+
+/**
+ * @see @file server.c / @function serverWorkerThread
+ */
+void* serverWorkerThread(void *worker) {
+  struct serverWorker *w = (struct serverWorker*)worker;
+  struct server *server = w->server;
+  for (;;) {
+    pthread_mutex_lock(&server->lock);
+    while(server->head == NULL && !server->closed) pthread_cond_wait(&server->ready, &server->lock);
+    if(server->closed) {
+      pthread_mutex_unlock(&server->lock);
+      break;
+    }
+    struct serverConnection *connection = server->head;
+    server->head = connection->next;
+    if(server->head == NULL) server->tail = NULL;
+    server->active[w->index] = connection->fd;
+    pthread_mutex_unlock(&server->lock);
+
+    while(handleServerRequest(server, connection->fd) == 0);
+
+    // The socket is closed once out of 'active', so the stop can't cut another one
+    pthread_mutex_lock(&server->lock);
+    server->active[w->index] = -1;
+    pthread_mutex_unlock(&server->lock);
+    close(connection->fd);
+    free(connection);
+  }
+  return NULL;
+}
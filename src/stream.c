@@ -0,0 +1,371 @@
+/**
+ * @file stream.c
+ * @author agent <agent@local>
+ * @standard C99
+ * @version 1.0
+ * @date 18th October 2026
+ *
+ * @brief Implementation file for "stream.h"
+ *
+ * This file implements the file handles on ".hfm" files, and their plugging in
+ * stdio.h with fopencookie.
+ *
+ * Overview about private functions of stream:
+ *  - prepareWriting
+ *  - flushBlock
+ *  - cookieRead (only with glibc)
+ *  - cookieWrite (only with glibc)
+ *  - cookieSeek (only with glibc)
+ *  - cookieClose (only with glibc)
+ *
+ * Overview about the stream structure functions:
+ *  - hfmOpen
+ *  - hfmClose
+ *
+ * Overview about public functions of stream:
+ *  - hfmRead
+ *  - hfmWrite
+ *  - hfmSeek
+ *  - hfmTell
+ *  - hfmFopen (only with glibc)
+ */
+
+#define _GNU_SOURCE
+#include "stream.h"
+
+
+/**
+ * @struct stream
+ * @brief A ".hfm" file opened for reading or for writing.
+ */
+struct stream {
+  int writing; /**< 1 if the stream is opened for writing */
+  long long position; /**< Position in the original file */
+  rdr reader; /**< In reading, the reader of the file */
+  FILE *file; /**< In writing, the ".hfm" file */
+  ctn container; /**< In writing, its header and its block index */
+  unsigned int checksums; /**< In writing, the checksums to write */
+  int hasTable; /**< 1 if the code table is in the header */
+  lst prefixes; /**< In writing, the prefixes, NULL until they are known */
+  char *codes[256]; /**< In writing, the prefix of each byte value */
+  unsigned char *block; /**< In writing, the block being filled */
+  size_t blockSize; /**< In writing, number of bytes in the block */
+  unsigned char *payload; /**< In writing, buffer for the payloads */
+};
+
+
+/* ================================================== */
+/* ============== DEF PRIVATE FUNCTIONS ============= */
+/* ========================================================================== */
+
+
+/**
+ * @function prepareWriting
+ * @brief Builds the code table from the first block and writes the header.
+ *
+ * Without key, the occurrences of the first block are used, with a floor of 1
+ * so that every byte value has a prefix in the following blocks.
+ *
+ * @param{stm} stream: the stream opened for writing.
+ *
+ * @return{int}: 0 if the header has been written, -1 otherwise.
+ */
+int prepareWriting(stm stream);
+
+/**
+ * @function flushBlock
+ * @brief Codes and writes the block being filled.
+ *
+ * @param{stm} stream: the stream opened for writing.
+ *
+ * @return{int}: 0 if the block has been written, -1 otherwise.
+ */
+int flushBlock(stm stream);
+
+#if defined(__GLIBC__)
+
+/**
+ * @function cookieRead
+ * @brief Read function of the FILE* given by hfmFopen.
+ *
+ * @param{void*} cookie: the stream.
+ * @param{char*} buffer: buffer of 'size' bytes.
+ * @param{size_t} size: number of bytes to read.
+ *
+ * @return{ssize_t}: number of bytes read, -1 on error.
+ */
+ssize_t cookieRead(void *cookie, char *buffer, size_t size);
+
+/**
+ * @function cookieWrite
+ * @brief Write function of the FILE* given by hfmFopen.
+ *
+ * @param{void*} cookie: the stream.
+ * @param{const char*} buffer: the data.
+ * @param{size_t} size: size of the data.
+ *
+ * @return{ssize_t}: number of bytes written, 0 on error.
+ */
+ssize_t cookieWrite(void *cookie, const char *buffer, size_t size);
+
+/**
+ * @function cookieSeek
+ * @brief Seek function of the FILE* given by hfmFopen.
+ *
+ * @param{void*} cookie: the stream.
+ * @param{off64_t*} offset: the offset, receives the new position.
+ * @param{int} whence: SEEK_SET, SEEK_CUR or SEEK_END.
+ *
+ * @return{int}: 0 if the position has been moved, -1 otherwise.
+ */
+int cookieSeek(void *cookie, off64_t *offset, int whence);
+
+/**
+ * @function cookieClose
+ * @brief Close function of the FILE* given by hfmFopen.
+ *
+ * @param{void*} cookie: the stream.
+ *
+ * @return{int}: 0 if the stream has been closed, -1 otherwise.
+ */
+int cookieClose(void *cookie);
+
+#endif
+
+
+/* ================================================== */
+/* ================ STRUCT FUNCTIONS ================ */
+/* ========================================================================== */
+
+
+/**
+ * @see @file stream.h / @function hfmOpen
+ */
+stm hfmOpen(char *file, char *mode, char *fileKey) {
+  if(file == NULL || mode == NULL || (mode[0] != 'r' && mode[0] != 'w')) return NULL;
+  stm stream = (stm)calloc(1, sizeof(struct stream));
+  if(stream == NULL) return NULL;
+  stream->writing = (mode[0] == 'w');
+  if(!stream->writing) {
+    stream->reader = openReader(file, fileKey, HFM_READER_CACHE_BLOCKS);
+    if(stream->reader == NULL) {
+      free(stream);
+      return NULL;
+    }
+    return stream;
+  }
+  nd tree = NULL;
+  if(fileKey != NULL && (tree = getTreeFromKeyFile(fileKey)) == NULL) {
+    fprintf(stderr, "%s: the key can't be used to write\n", fileKey);
+    free(stream);
+    return NULL;
+  }
+  stream->file = fopen(file, "wb");
+  if(stream->file == NULL) {
+    perror(file);
+    destroyNode(&tree);
+    free(stream);
+    return NULL;
+  }
+  stream->checksums = (strchr(mode, 'c') != NULL) ? HFM_CONTAINER_CHECKSUMS : 0;
+  stream->hasTable = (fileKey == NULL);
+  stream->block = (unsigned char*)malloc(HFM_BLOCK_SIZE);
+  stream->payload = (unsigned char*)malloc(HFM_BLOCK_SIZE);
+  int maxPrefixLength = 0;
+  if(tree != NULL && stream->block != NULL && stream->payload != NULL)
+    stream->prefixes = prefixesList(tree, &maxPrefixLength);
+  if(stream->block == NULL || stream->payload == NULL || (tree != NULL && stream->prefixes == NULL)) {
+    fclose(stream->file);
+    remove(file);
+    destroyNode(&tree);
+    free(stream->block);
+    free(stream->payload);
+    free(stream);
+    return NULL;
+  }
+  if(tree != NULL) { // The table of the key is known: the header can be written
+    destroyNode(&tree);
+    prefixesTable(stream->prefixes, stream->codes);
+    stream->container = createContainer(NULL, stream->checksums);
+    if(stream->container == NULL || writeContainerHeader(stream->container, stream->file) != 0) {
+      perror(file);
+      hfmClose(&stream);
+    }
+  }
+  return stream;
+}
+
+/**
+ * @see @file stream.h / @function hfmClose
+ */
+int hfmClose(stm *stream) {
+  int result = 0;
+  if(*stream != NULL) {
+    if((*stream)->writing) {
+      if((*stream)->container == NULL) result = prepareWriting(*stream);
+      if(result == 0 && (*stream)->blockSize > 0) result = flushBlock(*stream);
+      if(result == 0) result = finishContainer((*stream)->container, (*stream)->file);
+      if(fclose((*stream)->file) != 0) result = -1;
+      destroyContainer(&(*stream)->container);
+      destroyList(&(*stream)->prefixes);
+      free((*stream)->block);
+      free((*stream)->payload);
+    } else {
+      closeReader(&(*stream)->reader);
+    }
+    free(*stream);
+    *stream = NULL;
+  }
+  return result;
+}
+
+
+/* ================================================== */
+/* ===================== PUBLIC ===================== */
+/* ========================================================================== */
+
+
+/**
+ * @see @file stream.h / @function hfmRead
+ */
+long long hfmRead(stm stream, void *buffer, size_t size) {
+  if(stream->writing) return -1;
+  long long result = readRange(stream->reader, stream->position, size, (unsigned char*)buffer);
+  if(result > 0) stream->position += result;
+  return result;
+}
+
+/**
+ * @see @file stream.h / @function hfmWrite
+ */
+long long hfmWrite(stm stream, const void *buffer, size_t size) {
+  if(!stream->writing) return -1;
+  const unsigned char *data = (const unsigned char*)buffer;
+  size_t done = 0;
+  while(done < size) {
+    size_t part = HFM_BLOCK_SIZE - stream->blockSize;
+    if(part > size - done) part = size - done;
+    memcpy(stream->block + stream->blockSize, data + done, part);
+    stream->blockSize += part;
+    done += part;
+    if(stream->blockSize == HFM_BLOCK_SIZE) {
+      if(stream->container == NULL && prepareWriting(stream) != 0) return -1;
+      if(flushBlock(stream) != 0) return -1;
+    }
+  }
+  stream->position += (long long)size;
+  return (long long)size;
+}
+
+/**
+ * @see @file stream.h / @function hfmSeek
+ */
+long long hfmSeek(stm stream, long long offset, int whence) {
+  long long position = offset;
+  if(whence == SEEK_CUR) position += stream->position;
+  else if(whence == SEEK_END) position += stream->writing ? stream->position : getReaderSize(stream->reader);
+  else if(whence != SEEK_SET) return -1;
+  if(position < 0 || (stream->writing && position != stream->position)) return -1;
+  stream->position = position;
+  return position;
+}
+
+/**
+ * @see @file stream.h / @function hfmTell
+ */
+long long hfmTell(stm stream) {
+  return stream->position;
+}
+
+#if defined(__GLIBC__)
+
+/**
+ * @see @file stream.h / @function hfmFopen
+ */
+FILE* hfmFopen(char *file, char *mode, char *fileKey) {
+  stm stream = hfmOpen(file, mode, fileKey);
+  if(stream == NULL) return NULL;
+  cookie_io_functions_t functions = {cookieRead, cookieWrite, cookieSeek, cookieClose};
+  FILE *cookieFile = fopencookie(stream, stream->writing ? "w" : "r", functions);
+  if(cookieFile == NULL) hfmClose(&stream);
+  return cookieFile;
+}
+
+#endif
+
+
+/* ================================================== */
+/* ===================== PRIVATE ==================== */
+/* ========================================================================== */
+
+
+/**
+ * @see @file stream.c / @function prepareWriting
+ */
+int prepareWriting(stm stream) {
+  size_t histogram[256];
+  for (size_t c = 0; c < 256; c++) histogram[c] = 1;
+  for (size_t i = 0; i < stream->blockSize; i++) histogram[stream->block[i]]++;
+  lst occurrences = occurrencesFromHistogram(histogram);
+  nd tree = contructBinaryTree(occurrences);
+  destroyList(&occurrences);
+  if(tree == NULL) return -1; // Every byte is counted at least once
+  int maxPrefixLength = 0;
+  destroyList(&stream->prefixes); // Built again if the header could not be written
+  stream->prefixes = prefixesList(tree, &maxPrefixLength);
+  destroyNode(&tree);
+  if(stream->prefixes == NULL) return -1;
+  prefixesTable(stream->prefixes, stream->codes);
+  stream->container = createContainer(histogram, stream->checksums);
+  return (stream->container != NULL) ? writeContainerHeader(stream->container, stream->file) : -1;
+}
+
+/**
+ * @see @file stream.c / @function flushBlock
+ */
+int flushBlock(stm stream) {
+  writeBlockOfOpenedFile(stream->file, stream->container, stream->block, stream->blockSize, stream->payload, encodeBlockWithCodes, stream->codes);
+  stream->blockSize = 0;
+  return ferror(stream->file) ? -1 : 0;
+}
+
+#if defined(__GLIBC__)
+
+/**
+ * @see @file stream.c / @function cookieRead
+ */
+ssize_t cookieRead(void *cookie, char *buffer, size_t size) {
+  long long result = hfmRead((stm)cookie, buffer, size);
+  return (result >= 0) ? (ssize_t)result : -1;
+}
+
+/**
+ * @see @file stream.c / @function cookieWrite
+ */
+ssize_t cookieWrite(void *cookie, const char *buffer, size_t size) {
+  long long result = hfmWrite((stm)cookie, buffer, size);
+  return (result >= 0) ? (ssize_t)result : 0;
+}
+
+/**
+ * @see @file stream.c / @function cookieSeek
+ */
+int cookieSeek(void *cookie, off64_t *offset, int whence) {
+  long long position = hfmSeek((stm)cookie, (long long)*offset, whence);
+  if(position < 0) return -1;
+  *offset = (off64_t)position;
+  return 0;
+}
+
+/**
+ * @see @file stream.c / @function cookieClose
+ */
+int cookieClose(void *cookie) {
+  stm stream = (stm)cookie;
+  return hfmClose(&stream);
+}
+
+#endif
+
+/* ========================================================================== */
+/* ========================================================================== */
@@ -59,6 +59,7 @@ struct tuple {
  */
 tpl createTuple(void *key, void *val, void(*destroyKey)(void **elem), void(*printKey)(void *key), void(*destroyValue)(void **elem), void(*printValue)(void *val)) {
   tpl t = (tpl)malloc(sizeof(struct tuple));
+  if(t == NULL) return NULL;
   t->key = key;
   t->val = val;
   t->destroyKey   = destroyKey;
@@ -73,12 +74,17 @@ tpl createTuple(void *key, void *val, void(*destroyKey)(void **elem), void(*prin
  */
 tpl createTupleByCopy(void *key, void *val, void*(*copyKey)(void *key), void(*destroyKey)(void **elem), void(*printKey)(void *key), void*(*copyValue)(void *val), void(*destroyValue)(void **elem), void(*printValue)(void *val)) {
   tpl t = (tpl)malloc(sizeof(struct tuple));
+  if(t == NULL) return NULL;
   t->key = (*copyKey)(key);
   t->val = (*copyValue)(val);
   t->destroyKey   = destroyKey;
   t->printKey     = printKey;
   t->destroyValue = destroyValue;
   t->printValue   = printValue;
+  if(t->key == NULL || t->val == NULL) { // The copy made is destroyed with the tuple
+    destroyTuple(&t);
+    return NULL;
+  }
   return t;
 }
 
@@ -87,12 +93,17 @@ tpl createTupleByCopy(void *key, void *val, void*(*copyKey)(void *key), void(*de
  */
 tpl makeCopyTuple(tpl tuple, void*(*copyKey)(void *key), void*(*copyValue)(void *val)) {
   tpl t = (tpl)malloc(sizeof(struct tuple));
+  if(t == NULL) return NULL;
   t->key = (*copyKey)(tuple->key);
   t->val = (*copyValue)(tuple->val);
   t->destroyKey   = tuple->destroyKey;
   t->printKey     = tuple->printKey;
   t->destroyValue = tuple->destroyValue;
   t->printValue   = tuple->printValue;
+  if((t->key == NULL && tuple->key != NULL) || (t->val == NULL && tuple->val != NULL)) {
+    destroyTuple(&t);
+    return NULL;
+  }
   return t;
 }
 
@@ -14,18 +14,25 @@
  * Overview about public functions of utils
  *  - equalsInt
  *  - printInt
+ *  - printSize
  *  - printChar
  *  - printString
  *  - copyInt
+ *  - copySize
  *  - copyChar
  *  - copyString
+ *  - withExtension
  *  - charBitsToChar
  *  - strToInt
  *  - decimalToBinary
  *  - pointerAllocError
  *  - pointerNullError
+ *  - getFileSize
+ *  - storeLittleEndian
+ *  - loadLittleEndian
  */
 
+#define _GNU_SOURCE /**< fseeko and ftello */
 #include "utils.h"
 
 
@@ -51,6 +58,16 @@ void printInt(void *elem) {
     printf("NULL");
 }
 
+/**
+ * @see @file utils.h / @function printSize
+ */
+void printSize(void *elem) {
+  if(elem != NULL)
+    printf("%zu", *((size_t*)elem));
+  else
+    printf("NULL");
+}
+
 /**
  * @see @file utils.h / @function printChar
  */
@@ -76,15 +93,27 @@ void printString(void *elem) {
  */
 void* copyInt(void *elem) {
   int *i = (int*)malloc(sizeof(int));
+  if(i == NULL) return NULL;
   *i = *((int*)elem);
   return i;
 }
 
+/**
+ * @see @file utils.h / @function copySize
+ */
+void* copySize(void *elem) {
+  size_t *i = (size_t*)malloc(sizeof(size_t));
+  if(i == NULL) return NULL;
+  *i = *((size_t*)elem);
+  return i;
+}
+
 /**
  * @see @file utils.h / @function copyChar
  */
 void* copyChar(void *elem) {
   char *c = (char*)malloc(sizeof(char));
+  if(c == NULL) return NULL;
   *c = *((char*)elem);
   return c;
 }
@@ -94,10 +123,22 @@ void* copyChar(void *elem) {
  */
 void* copyString(void *elem) {
   char *s = (char*)malloc(sizeof(char) * (strlen((char*)elem)+1));
+  if(s == NULL) return NULL;
   strcpy(s, (char*)elem);
   return s;
 }
 
+/**
+ * @see @file utils.h / @function withExtension
+ */
+char* withExtension(char *name, char *extension) {
+  char *newName = (char*)malloc(sizeof(char) * (strlen(name) + strlen(extension) + 1));
+  if(newName == NULL) return NULL;
+  strcpy(newName, name);
+  strcat(newName, extension);
+  return newName;
+}
+
 /**
  * @see @file utils.h / @function charBitsToChar
  */
@@ -142,7 +183,7 @@ int strToInt(char *str) {
  */
 void pointerAllocError() {
   printf("Memory error: memory allocation can't be done\n");
-  exit(0);
+  exit(EXIT_FAILURE);
 }
 
 /**
@@ -150,7 +191,35 @@ void pointerAllocError() {
  */
 void pointerNullError() {
   printf("Null pointer error: a function pointer needed to not be null has been found null\n");
-  exit(0);
+  exit(EXIT_FAILURE);
+}
+
+/**
+ * @see @file utils.h / @function getFileSize
+ */
+long long getFileSize(char *fileName) {
+  FILE *file = fopen(fileName, "rb");
+  if(file == NULL) return -1;
+  long long size = -1;
+  if(fseeko(file, 0, SEEK_END) == 0) size = (long long)ftello(file);
+  fclose(file);
+  return size;
+}
+
+/**
+ * @see @file utils.h / @function storeLittleEndian
+ */
+void storeLittleEndian(unsigned char *buffer, uint64_t value, size_t nbBytes) {
+  for (size_t i = 0; i < nbBytes; i++) buffer[i] = (unsigned char)(value >> (8 * i));
+}
+
+/**
+ * @see @file utils.h / @function loadLittleEndian
+ */
+uint64_t loadLittleEndian(unsigned char *buffer, size_t nbBytes) {
+  uint64_t value = 0;
+  for (size_t i = 0; i < nbBytes; i++) value |= (uint64_t)buffer[i] << (8 * i);
+  return value;
 }
 
 
@@ -0,0 +1,163 @@
+/**
+ * @file xxhash64.c
+ * @author agent <agent@local>
+ * @standard C99
+ * @version 1.0
+ * @date 18th October 2026
+ *
+ * @brief Implementation file for "xxhash64.h"
+ *
+ * The data is read by stripes of 32 bytes, mixed in 4 independent accumulators
+ * so that the multiplications of a stripe are done at the same time.
+ *
+ * Overview about private functions of xxhash64:
+ *  - xxHash64Round
+ *  - xxHash64Merge
+ *  - xxHash64Read
+ *
+ * Overview about public functions of xxhash64:
+ *  - xxHash64
+ */
+
+#include "xxhash64.h"
+
+#define XXH64_PRIME1 0x9E3779B185EBCA87ULL /**< Primes of XXH64 */
+#define XXH64_PRIME2 0xC2B2AE3D27D4EB4FULL
+#define XXH64_PRIME3 0x165667B19E3779F9ULL
+#define XXH64_PRIME4 0x85EBCA77C2B2AE63ULL
+#define XXH64_PRIME5 0x27D4EB2F165667C5ULL
+
+#define XXH64_ROTATE(x, r) (((x) << (r)) | ((x) >> (64 - (r)))) /**< Rotation to the left */
+
+
+/* ================================================== */
+/* ============== DEF PRIVATE FUNCTIONS ============= */
+/* ========================================================================== */
+
+
+/**
+ * @function xxHash64Round
+ * @brief Mixes 8 bytes in an accumulator.
+ *
+ * @param{uint64_t} accumulator: the accumulator.
+ * @param{uint64_t} input: the 8 bytes.
+ *
+ * @return{uint64_t}: the new accumulator.
+ */
+uint64_t xxHash64Round(uint64_t accumulator, uint64_t input);
+
+/**
+ * @function xxHash64Merge
+ * @brief Mixes an accumulator in the hash.
+ *
+ * @param{uint64_t} hash: the hash.
+ * @param{uint64_t} accumulator: the accumulator.
+ *
+ * @return{uint64_t}: the new hash.
+ */
+uint64_t xxHash64Merge(uint64_t hash, uint64_t accumulator);
+
+/**
+ * @function xxHash64Read
+ * @brief Reads an integer in little endian, at any address.
+ *
+ * @param{const unsigned char*} data: the bytes.
+ * @param{size_t} nbBytes: number of bytes (4 or 8).
+ *
+ * @return{uint64_t}: the integer.
+ */
+uint64_t xxHash64Read(const unsigned char *data, size_t nbBytes);
+
+
+/* ================================================== */
+/* ===================== PUBLIC ===================== */
+/* ========================================================================== */
+
+
+/**
+ * @see @file xxhash64.h / @function xxHash64
+ */
+uint64_t xxHash64(const unsigned char *data, size_t size, uint64_t seed) {
+  const unsigned char *end = data + size;
+  uint64_t hash;
+  if(size >= 32) {
+    uint64_t v1 = seed + XXH64_PRIME1 + XXH64_PRIME2;
+    uint64_t v2 = seed + XXH64_PRIME2;
+    uint64_t v3 = seed;
+    uint64_t v4 = seed - XXH64_PRIME1;
+    for (; end - data >= 32; data += 32) {
+      v1 = xxHash64Round(v1, xxHash64Read(data, 8));
+      v2 = xxHash64Round(v2, xxHash64Read(data + 8, 8));
+      v3 = xxHash64Round(v3, xxHash64Read(data + 16, 8));
+      v4 = xxHash64Round(v4, xxHash64Read(data + 24, 8));
+    }
+    hash = XXH64_ROTATE(v1, 1) + XXH64_ROTATE(v2, 7) + XXH64_ROTATE(v3, 12) + XXH64_ROTATE(v4, 18);
+    hash = xxHash64Merge(hash, v1);
+    hash = xxHash64Merge(hash, v2);
+    hash = xxHash64Merge(hash, v3);
+    hash = xxHash64Merge(hash, v4);
+  } else {
+    hash = seed + XXH64_PRIME5;
+  }
+  hash += (uint64_t)size;
+  for (; end - data >= 8; data += 8) {
+    hash ^= xxHash64Round(0, xxHash64Read(data, 8));
+    hash = XXH64_ROTATE(hash, 27) * XXH64_PRIME1 + XXH64_PRIME4;
+  }
+  if(end - data >= 4) {
+    hash ^= xxHash64Read(data, 4) * XXH64_PRIME1;
+    hash = XXH64_ROTATE(hash, 23) * XXH64_PRIME2 + XXH64_PRIME3;
+    data += 4;
+  }
+  for (; data < end; data++) {
+    hash ^= (uint64_t)*data * XXH64_PRIME5;
+    hash = XXH64_ROTATE(hash, 11) * XXH64_PRIME1;
+  }
+  hash ^= hash >> 33;
+  hash *= XXH64_PRIME2;
+  hash ^= hash >> 29;
+  hash *= XXH64_PRIME3;
+  hash ^= hash >> 32;
+  return hash;
+}
+
+
+/* ================================================== */
+/* ===================== PRIVATE ==================== */
+/* ========================================================================== */
+
+
+/**
+ * @see @file xxhash64.c / @function xxHash64Round
+ */
+uint64_t xxHash64Round(uint64_t accumulator, uint64_t input) {
+  accumulator += input * XXH64_PRIME2;
+  accumulator = XXH64_ROTATE(accumulator, 31);
+  return accumulator * XXH64_PRIME1;
+}
+
+/**
+ * @see @file xxhash64.c / @function xxHash64Merge
+ */
+uint64_t xxHash64Merge(uint64_t hash, uint64_t accumulator) {
+  hash ^= xxHash64Round(0, accumulator);
+  return hash * XXH64_PRIME1 + XXH64_PRIME4;
+}
+
+/**
+ * @see @file xxhash64.c / @function xxHash64Read
+ */
+uint64_t xxHash64Read(const unsigned char *data, size_t nbBytes) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  uint64_t value = 0; // Read at once by the compiler
+  memcpy(&value, data, nbBytes);
+  return value;
+#else
+  uint64_t value = 0;
+  for (size_t i = 0; i < nbBytes; i++) value |= (uint64_t)data[i] << (8 * i);
+  return value;
+#endif
+}
+
+/* ========================================================================== */
+/* ========================================================================== */
@@ -0,0 +1,36 @@
+#!/bin/sh
+# Soak test of the files over 4 GB: a file of SIZE MiB is encrypted, decrypted
+# whole and decrypted by range with at most MEMORY KiB of address space, so the
+# sizes and the offsets past 4 GB are used while the memory stays bounded.
+#
+# Usage: sh tests/soak.sh {pathExecutable} [SIZE] [MEMORY] [DIRECTORY]
+
+EXEC=$(cd "$(dirname "$1")" && pwd)/$(basename "$1")
+SIZE=${2:-4200}
+MEMORY=${3:-262144}
+DIRECTORY=$(mktemp -d "${4:-${TMPDIR:-/tmp}}/soak.XXXXXX") || exit 1
+trap 'rm -rf "$DIRECTORY"' EXIT INT TERM
+
+fail() {
+  echo "Soak test failed: $1"
+  exit 1
+}
+
+# Text from random bytes: every byte value of base64, and blocks all different
+echo "Writing $SIZE MiB in '$DIRECTORY'"
+base64 -w 76 /dev/urandom | head -c "$((SIZE * 1048576))" > "$DIRECTORY/soak" || fail "input not written"
+
+# The limit only applies to the commands of the test
+(
+  ulimit -v "$MEMORY" || exit 1
+  "$EXEC" encrypt "$DIRECTORY/soak" "$DIRECTORY/soak.hfm" --checksum > /dev/null || exit 1
+  "$EXEC" info "$DIRECTORY/soak.hfm" || exit 1
+  "$EXEC" decrypt "$DIRECTORY/soak.hfm" "$DIRECTORY/soak.key" "$DIRECTORY/soak.out" > /dev/null || exit 1
+  # The last MiB, past 4 GB when SIZE is big enough
+  "$EXEC" decrypt "$DIRECTORY/soak.hfm" "$DIRECTORY/soak.key" "$DIRECTORY/soak.end" \
+    --range "$(((SIZE - 1) * 1048576)):1048576" > /dev/null || exit 1
+) || fail "a command failed with $MEMORY KiB"
+
+cmp "$DIRECTORY/soak" "$DIRECTORY/soak.out" || fail "decrypted file differs"
+tail -c 1048576 "$DIRECTORY/soak" | cmp - "$DIRECTORY/soak.end" || fail "decrypted range differs"
+echo "Soak test passed: $SIZE MiB with $MEMORY KiB"